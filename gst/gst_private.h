@@ -126,9 +126,21 @@ G_GNUC_INTERNAL  void  _priv_gst_toc_initialize (void);
 G_GNUC_INTERNAL  void  _priv_gst_date_time_initialize (void);
 
 /* Private registry functions */
+/* allocation cache for mini objects and metadata, see gstminiobject.c */
+G_GNUC_INTERNAL  gpointer priv_gst_mini_object_cache_alloc  (gsize size);
+G_GNUC_INTERNAL  gpointer priv_gst_mini_object_cache_alloc0 (gsize size);
+G_GNUC_INTERNAL  void     priv_gst_mini_object_cache_free   (gpointer mem, gsize size);
+G_GNUC_INTERNAL  void     _priv_gst_mini_object_cleanup     (void);
+
 G_GNUC_INTERNAL
 gboolean _priv_gst_registry_remove_cache_plugins (GstRegistry *registry);
 
+G_GNUC_INTERNAL
+GList * priv_gst_registry_get_uri_factories (GstRegistry * registry, GstURIType type, const gchar * protocol);
+
+G_GNUC_INTERNAL
+gboolean priv_gst_registry_has_uri_factory (GstRegistry * registry, GstURIType type, const gchar * protocol);
+
 G_GNUC_INTERNAL  void _priv_gst_registry_cleanup (void);
 
 gboolean _gst_plugin_loader_client_run (void);
@@ -152,6 +164,11 @@ gboolean priv_gst_structure_parse_name (gchar * str, gchar **start, gchar ** end
 G_GNUC_INTERNAL
 gboolean priv_gst_structure_parse_fields (gchar *str, gchar ** end, GstStructure *structure);
 
+/* used by the registry to attach binary serialized caps to static caps,
+ * takes ownership of @data */
+G_GNUC_INTERNAL
+void priv_gst_static_caps_set_binary (GstStaticCaps * static_caps, guint8 * data, gsize size);
+
 /* registry cache backends */
 G_GNUC_INTERNAL
 gboolean		priv_gst_registry_binary_read_cache	(GstRegistry * registry, const char *location);
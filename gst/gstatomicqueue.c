@@ -35,6 +35,12 @@
  *
  * The #GstAtomicQueue object implements a queue that can be used from multiple
  * threads without performing any blocking operations.
+ *
+ * Multiple items can be pushed and popped in one operation with
+ * gst_atomic_queue_push_many() and gst_atomic_queue_pop_many(). A queue
+ * created with gst_atomic_queue_new_bounded() has a fixed capacity and never
+ * allocates memory after it was created, pushing on a full queue either fails
+ * with gst_atomic_queue_try_push() or waits until there is room.
  */
 
 G_DEFINE_BOXED_TYPE (GstAtomicQueue, gst_atomic_queue,
@@ -51,17 +57,26 @@ G_DEFINE_BOXED_TYPE (GstAtomicQueue, gst_atomic_queue,
  */
 #undef LOW_MEM
 
+/* the head is updated by the readers and the tails by the writers, they are
+ * kept on separate cache lines so that readers and writers don't keep
+ * invalidating each other's caches */
+#define CACHE_LINE_SIZE 64
+
 typedef struct _GstAQueueMem GstAQueueMem;
 
 struct _GstAQueueMem
 {
   gint size;
   gpointer *array;
+  GstAQueueMem *next;
+  GstAQueueMem *free;
+
+  gchar _pad0[CACHE_LINE_SIZE];
   volatile gint head;
+  gchar _pad1[CACHE_LINE_SIZE - sizeof (gint)];
   volatile gint tail_write;
   volatile gint tail_read;
-  GstAQueueMem *next;
-  GstAQueueMem *free;
+  gchar _pad2[CACHE_LINE_SIZE - 2 * sizeof (gint)];
 };
 
 static guint
@@ -107,6 +122,8 @@ struct _GstAtomicQueue
 #ifdef LOW_MEM
   gint num_readers;
 #endif
+  /* maximum number of items for bounded queues, 0 when the queue grows */
+  guint capacity;
   GstAQueueMem *head_mem;
   GstAQueueMem *tail_mem;
   GstAQueueMem *free_list;
@@ -163,12 +180,41 @@ gst_atomic_queue_new (guint initial_size)
 #ifdef LOW_MEM
   queue->num_readers = 0;
 #endif
+  queue->capacity = 0;
   queue->head_mem = queue->tail_mem = new_queue_mem (initial_size, 0);
   queue->free_list = NULL;
 
   return queue;
 }
 
+/**
+ * gst_atomic_queue_new_bounded:
+ * @capacity: the maximum number of items in the queue
+ *
+ * Create a new atomic queue instance that holds at most @capacity items. The
+ * memory for the items is allocated once and the queue never grows.
+ *
+ * gst_atomic_queue_try_push() fails when the queue is full,
+ * gst_atomic_queue_push() and gst_atomic_queue_push_many() wait until
+ * readers made room.
+ *
+ * Returns: a new #GstAtomicQueue
+ *
+ * Since: 1.6
+ */
+GstAtomicQueue *
+gst_atomic_queue_new_bounded (guint capacity)
+{
+  GstAtomicQueue *queue;
+
+  g_return_val_if_fail (capacity > 0 && capacity <= G_MAXINT / 2, NULL);
+
+  queue = gst_atomic_queue_new (capacity);
+  queue->capacity = capacity;
+
+  return queue;
+}
+
 /**
  * gst_atomic_queue_ref:
  * @queue: a #GstAtomicQueue
@@ -258,27 +304,14 @@ gst_atomic_queue_peek (GstAtomicQueue * queue)
   return head_mem->array[head & size];
 }
 
-/**
- * gst_atomic_queue_pop:
- * @queue: a #GstAtomicQueue
- *
- * Get the head element of the queue.
- *
- * Returns: (transfer full): the head element of @queue or %NULL when
- * the queue is empty.
- */
-gpointer
-gst_atomic_queue_pop (GstAtomicQueue * queue)
+/* pop up to @n items from the head memory into @data. Returns the number of
+ * items popped, 0 when the queue is empty. */
+static guint
+pop_head (GstAtomicQueue * queue, gpointer * data, guint n)
 {
-  gpointer ret;
   GstAQueueMem *head_mem;
   gint head, tail, size;
-
-  g_return_val_if_fail (queue != NULL, NULL);
-
-#ifdef LOW_MEM
-  g_atomic_int_inc (&queue->num_readers);
-#endif
+  guint i, avail;
 
   do {
     while (TRUE) {
@@ -298,7 +331,7 @@ gst_atomic_queue_pop (GstAtomicQueue * queue)
       /* else array empty, try to take next */
       next = g_atomic_pointer_get (&head_mem->next);
       if (next == NULL)
-        return NULL;
+        return 0;
 
       /* now we try to move the next array as the head memory. If we fail to do that,
        * some other reader managed to do it first and we retry */
@@ -313,9 +346,36 @@ gst_atomic_queue_pop (GstAtomicQueue * queue)
       add_to_free_list (queue, head_mem);
     }
 
-    ret = head_mem->array[head & size];
+    avail = MIN ((guint) (tail - head), n);
+    for (i = 0; i < avail; i++)
+      data[i] = head_mem->array[(head + i) & size];
   } while G_UNLIKELY
-  (!g_atomic_int_compare_and_exchange (&head_mem->head, head, head + 1));
+  (!g_atomic_int_compare_and_exchange (&head_mem->head, head, head + avail));
+
+  return avail;
+}
+
+/**
+ * gst_atomic_queue_pop:
+ * @queue: a #GstAtomicQueue
+ *
+ * Get the head element of the queue.
+ *
+ * Returns: (transfer full): the head element of @queue or %NULL when
+ * the queue is empty.
+ */
+gpointer
+gst_atomic_queue_pop (GstAtomicQueue * queue)
+{
+  gpointer ret = NULL;
+
+  g_return_val_if_fail (queue != NULL, NULL);
+
+#ifdef LOW_MEM
+  g_atomic_int_inc (&queue->num_readers);
+#endif
+
+  pop_head (queue, &ret, 1);
 
 #ifdef LOW_MEM
   /* decrement number of readers, when we reach 0 readers we can be sure that
@@ -328,19 +388,52 @@ gst_atomic_queue_pop (GstAtomicQueue * queue)
 }
 
 /**
- * gst_atomic_queue_push:
+ * gst_atomic_queue_pop_many:
  * @queue: a #GstAtomicQueue
- * @data: the data
+ * @data: (out caller-allocates) (array length=n): location for the items
+ * @n: the maximum number of items to pop
+ *
+ * Get up to @n elements from the head of the queue. This is cheaper than
+ * calling gst_atomic_queue_pop() @n times as the items that are available
+ * are claimed at once.
  *
- * Append @data to the tail of the queue.
+ * Returns: the number of items stored in @data, 0 when the queue is empty.
+ *
+ * Since: 1.6
  */
-void
-gst_atomic_queue_push (GstAtomicQueue * queue, gpointer data)
+guint
+gst_atomic_queue_pop_many (GstAtomicQueue * queue, gpointer * data, guint n)
+{
+  guint res = 0, popped;
+
+  g_return_val_if_fail (queue != NULL, 0);
+  g_return_val_if_fail (data != NULL || n == 0, 0);
+
+#ifdef LOW_MEM
+  g_atomic_int_inc (&queue->num_readers);
+#endif
+
+  while (res < n && (popped = pop_head (queue, data + res, n - res)))
+    res += popped;
+
+#ifdef LOW_MEM
+  if (g_atomic_int_dec_and_test (&queue->num_readers))
+    clear_free_list (queue);
+#endif
+
+  return res;
+}
+
+/* reserve up to @n slots at the tail of the queue. The memory and position of
+ * the first slot are returned in @tail_mem_p and @tail_p. Returns the number
+ * of reserved slots, 0 when a bounded queue is full. */
+static guint
+reserve_tail (GstAtomicQueue * queue, guint n, GstAQueueMem ** tail_mem_p,
+    gint * tail_p)
 {
   GstAQueueMem *tail_mem;
   gint head, tail, size;
-
-  g_return_if_fail (queue != NULL);
+  guint avail;
 
   do {
     while (TRUE) {
@@ -351,10 +444,21 @@ gst_atomic_queue_push (GstAtomicQueue * queue, gpointer data)
       tail = g_atomic_int_get (&tail_mem->tail_write);
       size = tail_mem->size;
 
+      /* bounded queues never grow */
+      if (queue->capacity) {
+        if G_UNLIKELY
+          ((guint) (tail - head) >= queue->capacity)
+              return 0;
+        avail = queue->capacity - (tail - head);
+        break;
+      }
+
       /* we're not full, continue */
       if G_LIKELY
-        (tail - head <= size)
-            break;
+        (tail - head <= size) {
+        avail = size + 1 - (tail - head);
+        break;
+        }
 
       /* else we need to grow the array, we store a mask so we have to add 1 */
       mem = new_queue_mem ((size << 1) + 1, tail);
@@ -374,18 +478,125 @@ gst_atomic_queue_push (GstAtomicQueue * queue, gpointer data)
        * pointer to the new array */
       g_atomic_pointer_set (&tail_mem->next, mem);
     }
+    avail = MIN (avail, n);
   } while G_UNLIKELY
-  (!g_atomic_int_compare_and_exchange (&tail_mem->tail_write, tail, tail + 1));
+  (!g_atomic_int_compare_and_exchange (&tail_mem->tail_write, tail,
+          tail + avail));
 
-  tail_mem->array[tail & size] = data;
+  *tail_mem_p = tail_mem;
+  *tail_p = tail;
 
+  return avail;
+}
+
+/* make the @n items written at @tail visible to the readers */
+static void
+publish_tail (GstAQueueMem * tail_mem, gint tail, guint n)
+{
   /* now wait until all writers have completed their write before we move the
    * tail_read to this new item. It is possible that other writers are still
    * updating the previous array slots and we don't want to reveal their changes
    * before they are done. FIXME, it would be nice if we didn't have to busy
    * wait here. */
   while G_UNLIKELY
-    (!g_atomic_int_compare_and_exchange (&tail_mem->tail_read, tail, tail + 1));
+    (!g_atomic_int_compare_and_exchange (&tail_mem->tail_read, tail,
+          tail + n));
+}
+
+/**
+ * gst_atomic_queue_push:
+ * @queue: a #GstAtomicQueue
+ * @data: the data
+ *
+ * Append @data to the tail of the queue. When @queue is bounded and full, this
+ * waits until there is room.
+ */
+void
+gst_atomic_queue_push (GstAtomicQueue * queue, gpointer data)
+{
+  GstAQueueMem *tail_mem;
+  gint tail;
+
+  g_return_if_fail (queue != NULL);
+
+  while G_UNLIKELY
+    (!reserve_tail (queue, 1, &tail_mem, &tail))
+        g_thread_yield ();
+
+  tail_mem->array[tail & tail_mem->size] = data;
+
+  publish_tail (tail_mem, tail, 1);
+}
+
+/**
+ * gst_atomic_queue_try_push:
+ * @queue: a #GstAtomicQueue
+ * @data: the data
+ *
+ * Append @data to the tail of the queue if there is room for it. This only
+ * fails for queues created with gst_atomic_queue_new_bounded().
+ *
+ * Returns: %TRUE when @data was added, %FALSE when @queue is full.
+ *
+ * Since: 1.6
+ */
+gboolean
+gst_atomic_queue_try_push (GstAtomicQueue * queue, gpointer data)
+{
+  GstAQueueMem *tail_mem;
+  gint tail;
+
+  g_return_val_if_fail (queue != NULL, FALSE);
+
+  if (!reserve_tail (queue, 1, &tail_mem, &tail))
+    return FALSE;
+
+  tail_mem->array[tail & tail_mem->size] = data;
+
+  publish_tail (tail_mem, tail, 1);
+
+  return TRUE;
+}
+
+/**
+ * gst_atomic_queue_push_many:
+ * @queue: a #GstAtomicQueue
+ * @data: (array length=n): the items
+ * @n: the number of items in @data
+ *
+ * Append the @n items in @data to the tail of the queue. The items are
+ * claimed in as few operations as possible, they are only interleaved with
+ * items of other writers when the queue needs to grow or, for bounded queues,
+ * when it is full. When a bounded queue is full, this waits until there is
+ * room for the remaining items.
+ *
+ * Since: 1.6
+ */
+void
+gst_atomic_queue_push_many (GstAtomicQueue * queue, gpointer * data, guint n)
+{
+  GstAQueueMem *tail_mem;
+  gint tail;
+  guint i, reserved;
+
+  g_return_if_fail (queue != NULL);
+  g_return_if_fail (data != NULL || n == 0);
+
+  while (n > 0) {
+    if G_UNLIKELY
+      (!(reserved = reserve_tail (queue, n, &tail_mem, &tail))) {
+      g_thread_yield ();
+      continue;
+      }
+
+    for (i = 0; i < reserved; i++)
+      tail_mem->array[(tail + i) & tail_mem->size] = data[i];
+
+    publish_tail (tail_mem, tail, reserved);
+
+    data += reserved;
+    n -= reserved;
+  }
 }
 
 /**
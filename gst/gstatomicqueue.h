@@ -42,14 +42,19 @@ typedef struct _GstAtomicQueue GstAtomicQueue;
 GType              gst_atomic_queue_get_type    (void);
 
 GstAtomicQueue *   gst_atomic_queue_new         (guint initial_size) G_GNUC_MALLOC;
+GstAtomicQueue *   gst_atomic_queue_new_bounded (guint capacity) G_GNUC_MALLOC;
 
 void               gst_atomic_queue_ref         (GstAtomicQueue * queue);
 void               gst_atomic_queue_unref       (GstAtomicQueue * queue);
 
 void               gst_atomic_queue_push        (GstAtomicQueue* queue, gpointer data);
+gboolean           gst_atomic_queue_try_push    (GstAtomicQueue* queue, gpointer data);
 gpointer           gst_atomic_queue_pop         (GstAtomicQueue* queue);
 gpointer           gst_atomic_queue_peek        (GstAtomicQueue* queue);
 
+void               gst_atomic_queue_push_many   (GstAtomicQueue* queue, gpointer *data, guint n);
+guint              gst_atomic_queue_pop_many    (GstAtomicQueue* queue, gpointer *data, guint n);
+
 guint              gst_atomic_queue_length      (GstAtomicQueue * queue);
 
 G_END_DECLS
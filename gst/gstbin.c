@@ -199,6 +199,12 @@ struct _GstBinPrivate
   gboolean posted_playing;
 
   GList *contexts;
+
+  /* index of the cached messages, GstObject -> GList of the links of its
+   * messages in bin->messages, and the number of cached messages per type
+   * bit, all protected with the object lock */
+  GHashTable *messages_by_src;
+  guint n_messages[32];
 };
 
 typedef struct
@@ -209,6 +215,7 @@ typedef struct
 } BinContinueData;
 
 static void gst_bin_dispose (GObject * object);
+static void gst_bin_finalize (GObject * object);
 
 static void gst_bin_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
@@ -441,6 +448,7 @@ gst_bin_class_init (GstBinClass * klass)
           DEFAULT_MESSAGE_FORWARD, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   gobject_class->dispose = gst_bin_dispose;
+  gobject_class->finalize = gst_bin_finalize;
 
   gst_element_class_set_static_metadata (gstelement_class, "Generic bin",
       "Generic/Bin",
@@ -503,6 +511,7 @@ gst_bin_init (GstBin * bin)
   bin->priv->asynchandling = DEFAULT_ASYNC_HANDLING;
   bin->priv->structure_cookie = 0;
   bin->priv->message_forward = DEFAULT_MESSAGE_FORWARD;
+  bin->priv->messages_by_src = g_hash_table_new (NULL, NULL);
 }
 
 static void
@@ -535,6 +544,17 @@ gst_bin_dispose (GObject * object)
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
 
+static void
+gst_bin_finalize (GObject * object)
+{
+  GstBin *bin = GST_BIN_CAST (object);
+
+  /* all messages were removed in dispose */
+  g_hash_table_destroy (bin->priv->messages_by_src);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
 /**
  * gst_bin_new:
  * @name: (allow-none): the name of the new bin
@@ -863,17 +883,98 @@ message_check (GstMessage * message, MessageFind * target)
   return (eq ? 0 : 1);
 }
 
+/* with LOCK. Update the per type counters for a message of @type, extended
+ * types count for all their bits so that the counters can be checked with the
+ * same mask semantics as message_check() */
+static void
+count_message (GstBin * bin, GstMessageType type, gint diff)
+{
+  guint i;
+
+  for (i = 0; i < 32; i++)
+    if (type & (1U << i))
+      bin->priv->n_messages[i] += diff;
+}
+
+/* with LOCK. Check if there are cached messages matching @types */
+static gboolean
+have_messages (GstBin * bin, GstMessageType types)
+{
+  guint i;
+
+  for (i = 0; i < 32; i++)
+    if ((types & (1U << i)) && bin->priv->n_messages[i] > 0)
+      return TRUE;
+
+  return FALSE;
+}
+
+/* with LOCK. Add @message to the cached messages, takes ownership */
+static void
+cache_message (GstBin * bin, GstMessage * message)
+{
+  GstObject *src = GST_MESSAGE_SRC (message);
+  GList *links;
+
+  bin->messages = g_list_prepend (bin->messages, message);
+
+  links = g_hash_table_lookup (bin->priv->messages_by_src, src);
+  g_hash_table_insert (bin->priv->messages_by_src, src,
+      g_list_prepend (links, bin->messages));
+  count_message (bin, GST_MESSAGE_TYPE (message), 1);
+}
+
+/* with LOCK. Remove the cached message at @link, returns the message */
+static GstMessage *
+uncache_message (GstBin * bin, GList * link)
+{
+  GstMessage *message = link->data;
+  GstObject *src = GST_MESSAGE_SRC (message);
+  GList *links;
+
+  links = g_hash_table_lookup (bin->priv->messages_by_src, src);
+  links = g_list_remove (links, link);
+  if (links)
+    g_hash_table_insert (bin->priv->messages_by_src, src, links);
+  else
+    g_hash_table_remove (bin->priv->messages_by_src, src);
+  count_message (bin, GST_MESSAGE_TYPE (message), -1);
+
+  bin->messages = g_list_delete_link (bin->messages, link);
+
+  return message;
+}
+
+/* with LOCK. Find the first cached message matching @src and @types. Messages
+ * of a given source are looked up in the index so that this doesn't depend
+ * on the number of children. */
 static GList *
 find_message (GstBin * bin, GstObject * src, GstMessageType types)
 {
-  GList *result;
+  GList *result = NULL;
   MessageFind find;
 
   find.src = src;
   find.types = types;
 
-  result = g_list_find_custom (bin->messages, &find,
-      (GCompareFunc) message_check);
+  if (!have_messages (bin, types)) {
+    /* nothing of these types cached */
+  } else if (src) {
+    GList *walk;
+
+    walk = g_hash_table_lookup (bin->priv->messages_by_src, src);
+    for (; walk; walk = g_list_next (walk)) {
+      GList *link = walk->data;
+
+      if (message_check (link->data, &find) == 0) {
+        result = link;
+        break;
+      }
+    }
+  } else {
+    result = g_list_find_custom (bin->messages, &find,
+        (GCompareFunc) message_check);
+  }
 
   if (result) {
     GST_DEBUG_OBJECT (bin, "we found a message %p from %s matching types %08x",
@@ -916,6 +1017,8 @@ bin_replace_message (GstBin * bin, GstMessage * message, GstMessageType types)
       /* if we found a previous message, replace it */
       previous_msg = previous->data;
       previous->data = message;
+      count_message (bin, GST_MESSAGE_TYPE (previous_msg), -1);
+      count_message (bin, GST_MESSAGE_TYPE (message), 1);
 
       GST_DEBUG_OBJECT (bin, "replace old message %s from %s with %s message",
           GST_MESSAGE_TYPE_NAME (previous_msg), GST_ELEMENT_NAME (src),
@@ -924,7 +1027,7 @@ bin_replace_message (GstBin * bin, GstMessage * message, GstMessageType types)
       gst_message_unref (previous_msg);
     } else {
       /* keep new message */
-      bin->messages = g_list_prepend (bin->messages, message);
+      cache_message (bin, message);
 
       GST_DEBUG_OBJECT (bin, "got new message %p, %s from %s",
           message, GST_MESSAGE_TYPE_NAME (message), GST_ELEMENT_NAME (src));
@@ -943,20 +1046,31 @@ static void
 bin_remove_messages (GstBin * bin, GstObject * src, GstMessageType types)
 {
   MessageFind find;
-  GList *walk, *next;
+  GList *walk, *next, *links = NULL;
+
+  if (!have_messages (bin, types))
+    return;
 
   find.src = src;
   find.types = types;
 
-  for (walk = bin->messages; walk; walk = next) {
-    GstMessage *message = (GstMessage *) walk->data;
+  if (src) {
+    /* only look at the messages of @src, the index is updated while we
+     * remove messages so iterate a copy */
+    links = g_list_copy (g_hash_table_lookup (bin->priv->messages_by_src,
+            src));
+  }
+
+  for (walk = src ? links : bin->messages; walk; walk = next) {
+    GList *link = src ? walk->data : walk;
+    GstMessage *message = (GstMessage *) link->data;
 
     next = g_list_next (walk);
 
     if (message_check (message, &find) == 0) {
       GST_DEBUG_OBJECT (GST_MESSAGE_SRC (message),
           "deleting message %p of types 0x%08x", message, types);
-      bin->messages = g_list_delete_link (bin->messages, walk);
+      uncache_message (bin, link);
       gst_message_unref (message);
     } else {
       GST_DEBUG_OBJECT (GST_MESSAGE_SRC (message),
@@ -964,6 +1078,7 @@ bin_remove_messages (GstBin * bin, GstObject * src, GstMessageType types)
           GST_MESSAGE_TYPE (message));
     }
   }
+  g_list_free (links);
 }
 
 
@@ -978,6 +1093,10 @@ is_eos (GstBin * bin, guint32 * seqnum)
   gint n_eos = 0;
   GList *walk, *msgs;
 
+  /* no sink posted EOS yet */
+  if (!have_messages (bin, GST_MESSAGE_EOS))
+    return FALSE;
+
   result = TRUE;
   for (walk = bin->children; walk; walk = g_list_next (walk)) {
     GstElement *element;
@@ -1445,56 +1564,47 @@ gst_bin_remove_func (GstBin * bin, GstElement * element)
   /* remove messages for the element, if there was a pending ASYNC_START
    * message we must see if removing the element caused the bin to lose its
    * async state. */
-  this_async = FALSE;
-  other_async = FALSE;
-  for (walk = bin->messages; walk; walk = next) {
-    GstMessage *message = (GstMessage *) walk->data;
-    GstElement *src = GST_ELEMENT_CAST (GST_MESSAGE_SRC (message));
-    gboolean remove;
+  /* an element has at most one pending ASYNC_START message */
+  this_async = find_message (bin, GST_OBJECT_CAST (element),
+      GST_MESSAGE_ASYNC_START) != NULL;
+  other_async =
+      bin->priv->n_messages[g_bit_nth_lsf (GST_MESSAGE_ASYNC_START, -1)] >
+      (this_async ? 1 : 0);
 
-    next = g_list_next (walk);
-    remove = FALSE;
+  if (have_messages (bin, GST_MESSAGE_STRUCTURE_CHANGE)) {
+    for (walk = bin->messages; walk; walk = next) {
+      GstMessage *message = (GstMessage *) walk->data;
+      GstElement *owner;
 
-    switch (GST_MESSAGE_TYPE (message)) {
-      case GST_MESSAGE_ASYNC_START:
-        if (src == element)
-          this_async = TRUE;
-        else
-          other_async = TRUE;
+      next = g_list_next (walk);
 
-        GST_DEBUG_OBJECT (src, "looking at message %p", message);
-        break;
-      case GST_MESSAGE_STRUCTURE_CHANGE:
-      {
-        GstElement *owner;
-
-        GST_DEBUG_OBJECT (src, "looking at structure change message %p",
-            message);
-        /* it's unlikely that this message is still in the list of messages
-         * because this would mean that a link/unlink is busy in another thread
-         * while we remove the element. We still have to remove the message
-         * because we might not receive the done message anymore when the element
-         * is removed from the bin. */
-        gst_message_parse_structure_change (message, NULL, &owner, NULL);
-        if (owner == element)
-          remove = TRUE;
-        break;
+      if (GST_MESSAGE_TYPE (message) != GST_MESSAGE_STRUCTURE_CHANGE)
+        continue;
+
+      GST_DEBUG_OBJECT (GST_MESSAGE_SRC (message),
+          "looking at structure change message %p", message);
+      /* it's unlikely that this message is still in the list of messages
+       * because this would mean that a link/unlink is busy in another thread
+       * while we remove the element. We still have to remove the message
+       * because we might not receive the done message anymore when the element
+       * is removed from the bin. */
+      gst_message_parse_structure_change (message, NULL, &owner, NULL);
+      if (owner == element && GST_MESSAGE_SRC (message) !=
+          GST_OBJECT_CAST (element)) {
+        GST_DEBUG_OBJECT (GST_MESSAGE_SRC (message),
+            "deleting message %p owned by element \"%s\"", message,
+            elem_name);
+        uncache_message (bin, walk);
+        gst_message_unref (message);
       }
-      default:
-        break;
-    }
-    if (src == element)
-      remove = TRUE;
-
-    if (remove) {
-      /* delete all message types */
-      GST_DEBUG_OBJECT (src, "deleting message %p of element \"%s\"",
-          message, elem_name);
-      bin->messages = g_list_delete_link (bin->messages, walk);
-      gst_message_unref (message);
     }
   }
 
+  /* delete all message types of the element */
+  GST_DEBUG_OBJECT (element, "deleting messages of element \"%s\"",
+      elem_name);
+  bin_remove_messages (bin, GST_OBJECT_CAST (element), GST_MESSAGE_ANY);
+
   /* get last return */
   ret = GST_STATE_RETURN (bin);
 
@@ -3816,8 +3926,8 @@ bin_query_duration_done (GstBin * bin, QueryFold * fold)
 #if 0
   /* and cache now */
   GST_OBJECT_LOCK (bin);
-  bin->messages = g_list_prepend (bin->messages,
-      gst_message_new_duration (GST_OBJECT_CAST (bin), format, fold->max));
+  cache_message (bin, gst_message_new_duration (GST_OBJECT_CAST (bin),
+          format, fold->max));
   GST_OBJECT_UNLOCK (bin);
 #endif
 }
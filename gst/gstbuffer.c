@@ -131,12 +131,17 @@ struct _GstMetaItem
 };
 #define ITEM_SIZE(info) ((info)->size + sizeof (GstMetaItem))
 
-#define GST_BUFFER_MEM_MAX         16
+/* number of memory blocks that fit in the buffer itself, more blocks are
+ * kept in an array that is allocated separately */
+#define GST_BUFFER_MEM_INLINE      16
 
 #define GST_BUFFER_SLICE_SIZE(b)   (((GstBufferImpl *)(b))->slice_size)
 #define GST_BUFFER_MEM_LEN(b)      (((GstBufferImpl *)(b))->len)
+#define GST_BUFFER_MEM_SIZE(b)     (((GstBufferImpl *)(b))->mem_size)
 #define GST_BUFFER_MEM_ARRAY(b)    (((GstBufferImpl *)(b))->mem)
 #define GST_BUFFER_MEM_PTR(b,i)    (((GstBufferImpl *)(b))->mem[i])
+#define GST_BUFFER_MEM_IS_INLINE(b) \
+    (GST_BUFFER_MEM_ARRAY (b) == ((GstBufferImpl *)(b))->mem_inline)
 #define GST_BUFFER_BUFMEM(b)       (((GstBufferImpl *)(b))->bufmem)
 #define GST_BUFFER_META(b)         (((GstBufferImpl *)(b))->item)
 
@@ -146,9 +151,12 @@ typedef struct
 
   gsize slice_size;
 
-  /* the memory blocks */
+  /* the memory blocks, mem points to mem_inline or to an allocated array
+   * of mem_size entries */
   guint len;
-  GstMemory *mem[GST_BUFFER_MEM_MAX];
+  guint mem_size;
+  GstMemory **mem;
+  GstMemory *mem_inline[GST_BUFFER_MEM_INLINE];
 
   /* memory of the buffer when allocated from 1 chunk */
   GstMemory *bufmem;
@@ -284,33 +292,55 @@ _replace_memory (GstBuffer * buffer, guint len, guint idx, guint length,
   GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_TAG_MEMORY);
 }
 
+/* make room for at least @needed memory blocks */
+static void
+_memory_reserve (GstBuffer * buffer, guint needed)
+{
+  guint size = GST_BUFFER_MEM_SIZE (buffer);
+
+  if (G_LIKELY (needed <= size))
+    return;
+
+  while (size < needed)
+    size *= 2;
+
+  GST_CAT_DEBUG (GST_CAT_PERFORMANCE, "buffer %p grows memory array to %u",
+      buffer, size);
+
+  if (GST_BUFFER_MEM_IS_INLINE (buffer)) {
+    GstMemory **mem = g_new (GstMemory *, size);
+
+    memcpy (mem, GST_BUFFER_MEM_ARRAY (buffer),
+        GST_BUFFER_MEM_LEN (buffer) * sizeof (GstMemory *));
+    GST_BUFFER_MEM_ARRAY (buffer) = mem;
+  } else {
+    GST_BUFFER_MEM_ARRAY (buffer) =
+        g_renew (GstMemory *, GST_BUFFER_MEM_ARRAY (buffer), size);
+  }
+  GST_BUFFER_MEM_SIZE (buffer) = size;
+}
+
 static inline void
 _memory_add (GstBuffer * buffer, gint idx, GstMemory * mem, gboolean lock)
 {
-  guint i, len = GST_BUFFER_MEM_LEN (buffer);
+  guint len = GST_BUFFER_MEM_LEN (buffer);
 
   GST_CAT_LOG (GST_CAT_BUFFER, "buffer %p, idx %d, mem %p, lock %d", buffer,
       idx, mem, lock);
 
-  if (G_UNLIKELY (len >= GST_BUFFER_MEM_MAX)) {
-    /* too many buffer, span them. */
-    /* FIXME, there is room for improvement here: We could only try to merge
-     * 2 buffers to make some room. If we can't efficiently merge 2 buffers we
-     * could try to only merge the two smallest buffers to avoid memcpy, etc. */
-    GST_CAT_DEBUG (GST_CAT_PERFORMANCE, "memory array overflow in buffer %p",
-        buffer);
-    _replace_memory (buffer, len, 0, len, _get_merged_memory (buffer, 0, len));
-    /* we now have 1 single spanned buffer */
-    len = 1;
-  }
+  /* there is no limit on the number of memory blocks, grow the array instead
+   * of merging the memory */
+  if (G_UNLIKELY (len >= GST_BUFFER_MEM_SIZE (buffer)))
+    _memory_reserve (buffer, len + 1);
 
   if (idx == -1)
     idx = len;
 
-  for (i = len; i > idx; i--) {
-    /* move buffers to insert, FIXME, we need to insert first and then merge */
-    GST_BUFFER_MEM_PTR (buffer, i) = GST_BUFFER_MEM_PTR (buffer, i - 1);
-  }
+  /* move memory to insert */
+  if ((guint) idx < len)
+    memmove (&GST_BUFFER_MEM_PTR (buffer, idx + 1),
+        &GST_BUFFER_MEM_PTR (buffer, idx), (len - idx) * sizeof (gpointer));
+
   /* and insert the new buffer */
   if (lock)
     gst_memory_lock (mem, GST_LOCK_FLAG_EXCLUSIVE);
@@ -331,11 +361,11 @@ _priv_gst_buffer_initialize (void)
 /**
  * gst_buffer_get_max_memory:
  *
- * Get the maximum amount of memory blocks that a buffer can hold. This is a
- * compile time constant that can be queried with the function.
+ * Get the maximum amount of memory blocks that a buffer can hold.
  *
- * When more memory blocks are added, existing memory blocks will be merged
- * together to make room for the new block.
+ * Since 1.6 buffers can hold any number of memory blocks and this function
+ * returns %G_MAXINT. Before, memory blocks were merged together when more
+ * than a small, fixed number of blocks was added.
  *
  * Returns: the maximum amount of memory blocks that a buffer can hold.
  *
@@ -344,7 +374,7 @@ _priv_gst_buffer_initialize (void)
 guint
 gst_buffer_get_max_memory (void)
 {
-  return GST_BUFFER_MEM_MAX;
+  return G_MAXINT;
 }
 
 /**
@@ -433,6 +463,9 @@ gst_buffer_copy_into (GstBuffer * dest, GstBuffer * src,
     left = size;
     skip = offset;
 
+    /* at most all memory of src is added, grow the array only once */
+    _memory_reserve (dest, dest_len + len);
+
     /* copy and make regions of the memory */
     for (i = 0; i < len && left > 0; i++) {
       GstMemory *mem = GST_BUFFER_MEM_PTR (src, i);
@@ -569,7 +602,7 @@ _gst_buffer_free (GstBuffer * buffer)
 
     next = walk->next;
     /* and free the slice */
-    g_slice_free1 (ITEM_SIZE (info), walk);
+    priv_gst_mini_object_cache_free (walk, ITEM_SIZE (info));
   }
 
   /* get the size, when unreffing the memory, we could also unref the buffer
@@ -582,13 +615,15 @@ _gst_buffer_free (GstBuffer * buffer)
     gst_memory_unlock (GST_BUFFER_MEM_PTR (buffer, i), GST_LOCK_FLAG_EXCLUSIVE);
     gst_memory_unref (GST_BUFFER_MEM_PTR (buffer, i));
   }
+  if (!GST_BUFFER_MEM_IS_INLINE (buffer))
+    g_free (GST_BUFFER_MEM_ARRAY (buffer));
 
   /* we set msize to 0 when the buffer is part of the memory block */
   if (msize) {
 #ifdef USE_POISONING
     memset (buffer, 0xff, msize);
 #endif
-    g_slice_free1 (msize, buffer);
+    priv_gst_mini_object_cache_free (buffer, msize);
   } else {
     gst_memory_unref (GST_BUFFER_BUFMEM (buffer));
   }
@@ -612,6 +647,8 @@ gst_buffer_init (GstBufferImpl * buffer, gsize size)
   GST_BUFFER_OFFSET_END (buffer) = GST_BUFFER_OFFSET_NONE;
 
   GST_BUFFER_MEM_LEN (buffer) = 0;
+  GST_BUFFER_MEM_SIZE (buffer) = GST_BUFFER_MEM_INLINE;
+  GST_BUFFER_MEM_ARRAY (buffer) = buffer->mem_inline;
   GST_BUFFER_META (buffer) = NULL;
 }
 
@@ -629,7 +666,7 @@ gst_buffer_new (void)
 {
   GstBufferImpl *newbuf;
 
-  newbuf = g_slice_new (GstBufferImpl);
+  newbuf = priv_gst_mini_object_cache_alloc (sizeof (GstBufferImpl));
   GST_CAT_LOG (GST_CAT_BUFFER, "new %p", newbuf);
 
   gst_buffer_init (newbuf, sizeof (GstBufferImpl));
@@ -802,8 +839,7 @@ gst_buffer_new_wrapped (gpointer data, gsize size)
  * gst_buffer_n_memory:
  * @buffer: a #GstBuffer.
  *
- * Get the amount of memory blocks that this buffer has. This amount is never
- * larger than what gst_buffer_get_max_memory() returns.
+ * Get the amount of memory blocks that this buffer has.
  *
  * Returns: (transfer full): the amount of memory block in this buffer.
  */
@@ -858,9 +894,8 @@ gst_buffer_append_memory (GstBuffer * buffer, GstMemory * mem)
  * Insert the memory block @mem to @buffer at @idx. This function takes ownership
  * of @mem and thus doesn't increase its refcount.
  *
- * Only gst_buffer_get_max_memory() can be added to a buffer. If more memory is
- * added, existing memory blocks will automatically be merged to make room for
- * the new memory.
+ * Any number of memory blocks can be added to a buffer, they are never
+ * merged automatically.
  */
 void
 gst_buffer_insert_memory (GstBuffer * buffer, gint idx, GstMemory * mem)
@@ -1915,6 +1950,7 @@ gst_buffer_append_region (GstBuffer * buf1, GstBuffer * buf2, gssize offset,
   gst_buffer_resize (buf2, offset, size);
 
   len = GST_BUFFER_MEM_LEN (buf2);
+  _memory_reserve (buf1, GST_BUFFER_MEM_LEN (buf1) + len);
   for (i = 0; i < len; i++) {
     GstMemory *mem;
 
@@ -1988,7 +2024,7 @@ gst_buffer_add_meta (GstBuffer * buffer, const GstMetaInfo * info,
 
   /* create a new slice */
   size = ITEM_SIZE (info);
-  item = g_slice_alloc (size);
+  item = priv_gst_mini_object_cache_alloc (size);
   result = &item->meta;
   result->info = info;
   result->flags = GST_META_FLAG_NONE;
@@ -2010,7 +2046,7 @@ gst_buffer_add_meta (GstBuffer * buffer, const GstMetaInfo * info,
 
 init_failed:
   {
-    g_slice_free1 (size, item);
+    priv_gst_mini_object_cache_free (item, size);
     return NULL;
   }
 }
@@ -2053,7 +2089,7 @@ gst_buffer_remove_meta (GstBuffer * buffer, GstMeta * meta)
         info->free_func (m, buffer);
 
       /* and free the slice */
-      g_slice_free1 (ITEM_SIZE (info), walk);
+      priv_gst_mini_object_cache_free (walk, ITEM_SIZE (info));
       break;
     }
     prev = walk;
@@ -2151,7 +2187,7 @@ gst_buffer_foreach_meta (GstBuffer * buffer, GstBufferForeachMetaFunc func,
         info->free_func (m, buffer);
 
       /* and free the slice */
-      g_slice_free1 (ITEM_SIZE (info), walk);
+      priv_gst_mini_object_cache_free (walk, ITEM_SIZE (info));
     }
     if (!res)
       break;
@@ -75,6 +75,7 @@
 #include "gstatomicqueue.h"
 #include "gstinfo.h"
 #include "gstpoll.h"
+#include "gstsystemclock.h"
 
 #include "gstbus.h"
 #include "glib-compat-private.h"
@@ -119,11 +120,76 @@ struct _GstBusPrivate
   gboolean enable_async;
   GstPoll *poll;
   GPollFD pollfd;
+
+  /* message coalescing, protected with queue_lock */
+  GstMessageType coalesce_types;
+  GstClockTime coalesce_interval;
+  GHashTable *coalesce_slots;
+  GstClock *coalesce_clock;
+  GstClockID coalesce_timeout;
+
+  /* the group dispatching this bus, the poll is the one of the group then
+   * and the own poll of the bus is kept in own_poll until it leaves the
+   * group. Changed with queue_lock. */
+  GstBusGroup *group;
+  GstPoll *own_poll;
+  GstBusFunc group_func;
+  gpointer group_data;
+  GDestroyNotify group_notify;
+  volatile gint group_scheduled;
 };
 
+/**
+ * GstBusGroup:
+ *
+ * Opaque structure to dispatch the messages of many buses from one #GSource.
+ *
+ * Since: 1.6
+ */
+struct _GstBusGroup
+{
+  volatile gint refcount;
+
+  /* protects buses */
+  GMutex lock;
+  GHashTable *buses;
+
+  /* shared by all buses of the group */
+  GstPoll *poll;
+  GPollFD pollfd;
+
+  /* buses with pending messages, one ref each */
+  GstAtomicQueue *ready;
+};
+
+/* the maximum number of messages dispatched for a bus before moving on to the
+ * next bus of a group */
+#define GROUP_BATCH_SIZE 16
+
+/* the messages of one source, type and structure name that are coalesced.
+ * The slot keeps a ref to the source so that the pointer can't be reused by
+ * another object while the slot exists. */
+typedef struct
+{
+  GstObject *src;
+  GstMessageType type;
+  GQuark name;
+
+  /* the message in the queue, not reffed */
+  GstMessage *queued;
+  /* newer message that will be delivered instead of @queued, or that is
+   * held back until the interval passed when nothing is queued */
+  GstMessage *latest;
+  /* when a message was last queued */
+  GstClockTime last_time;
+} GstBusCoalesceSlot;
+
 #define gst_bus_parent_class parent_class
 G_DEFINE_TYPE (GstBus, gst_bus, GST_TYPE_OBJECT);
 
+G_DEFINE_BOXED_TYPE (GstBusGroup, gst_bus_group,
+    (GBoxedCopyFunc) gst_bus_group_ref, (GBoxedFreeFunc) gst_bus_group_unref);
+
 static void
 gst_bus_set_property (GObject * object,
     guint prop_id, const GValue * value, GParamSpec * pspec)
@@ -242,9 +308,17 @@ gst_bus_dispose (GObject * object)
     } while (message != NULL);
     gst_atomic_queue_unref (bus->priv->queue);
     bus->priv->queue = NULL;
+    /* a pending timeout keeps a ref to the bus so there can't be one now */
+    if (bus->priv->coalesce_slots)
+      g_hash_table_destroy (bus->priv->coalesce_slots);
+    bus->priv->coalesce_slots = NULL;
+    if (bus->priv->coalesce_clock)
+      gst_object_unref (bus->priv->coalesce_clock);
+    bus->priv->coalesce_clock = NULL;
     g_mutex_unlock (&bus->priv->queue_lock);
     g_mutex_clear (&bus->priv->queue_lock);
 
+    /* a bus in a group is kept alive by the group */
     if (bus->priv->poll)
       gst_poll_free (bus->priv->poll);
     bus->priv->poll = NULL;
@@ -282,6 +356,230 @@ gst_bus_new (void)
   return result;
 }
 
+/* with queue_lock. Push @message on the queue of @bus and wake up the poll,
+ * when the bus is part of a group it is also scheduled for dispatching there.
+ * The lock keeps the group and the poll from being swapped or freed while we
+ * use them. */
+static void
+gst_bus_queue_message (GstBus * bus, GstMessage * message)
+{
+  GstBusGroup *group = bus->priv->group;
+
+  gst_atomic_queue_push (bus->priv->queue, message);
+  if (group && g_atomic_int_compare_and_exchange (&bus->priv->group_scheduled,
+          FALSE, TRUE))
+    gst_atomic_queue_push (group->ready, gst_object_ref (bus));
+  gst_poll_write_control (bus->priv->poll);
+}
+
+static guint
+coalesce_slot_hash (const GstBusCoalesceSlot * slot)
+{
+  return g_direct_hash (slot->src) ^ slot->type ^ slot->name;
+}
+
+static gboolean
+coalesce_slot_equal (const GstBusCoalesceSlot * a,
+    const GstBusCoalesceSlot * b)
+{
+  return a->src == b->src && a->type == b->type && a->name == b->name;
+}
+
+static void
+coalesce_slot_free (GstBusCoalesceSlot * slot)
+{
+  if (slot->latest)
+    gst_message_unref (slot->latest);
+  if (slot->src)
+    gst_object_unref (slot->src);
+  g_slice_free (GstBusCoalesceSlot, slot);
+}
+
+static void
+coalesce_slot_init (GstBusCoalesceSlot * slot, GstMessage * message)
+{
+  const GstStructure *s = gst_message_get_structure (message);
+
+  slot->src = GST_MESSAGE_SRC (message);
+  slot->type = GST_MESSAGE_TYPE (message);
+  slot->name = s ? gst_structure_get_name_id (s) : 0;
+  slot->queued = NULL;
+  slot->latest = NULL;
+  slot->last_time = GST_CLOCK_TIME_NONE;
+}
+
+static void gst_bus_schedule_coalesce (GstBus * bus, GstClockTime time);
+
+/* called from the clock thread to queue the messages that were held back */
+static gboolean
+gst_bus_coalesce_timeout (GstClock * clock, GstClockTime time, GstClockID id,
+    gpointer user_data)
+{
+  GstBus *bus = GST_BUS_CAST (user_data);
+  GstBusPrivate *priv = bus->priv;
+  GstBusCoalesceSlot *slot;
+  GstClockTime now, deadline, next = GST_CLOCK_TIME_NONE;
+  GHashTableIter iter;
+
+  g_mutex_lock (&priv->queue_lock);
+  /* unscheduled or replaced while we were called */
+  if (priv->coalesce_timeout != id || priv->coalesce_slots == NULL)
+    goto done;
+
+  gst_clock_id_unref (priv->coalesce_timeout);
+  priv->coalesce_timeout = NULL;
+
+  now = gst_clock_get_time (clock);
+
+  g_hash_table_iter_init (&iter, priv->coalesce_slots);
+  while (g_hash_table_iter_next (&iter, (gpointer *) & slot, NULL)) {
+    if (slot->queued)
+      continue;
+
+    deadline = slot->last_time + priv->coalesce_interval;
+    if (slot->latest && now >= deadline) {
+      GST_DEBUG_OBJECT (bus, "[msg %p] queueing held back message",
+          slot->latest);
+      slot->queued = slot->latest;
+      slot->latest = NULL;
+      slot->last_time = now;
+      gst_bus_queue_message (bus, slot->queued);
+    } else if (now >= deadline) {
+      /* nothing delivered during the last interval, forget about it */
+      g_hash_table_iter_remove (&iter);
+    } else {
+      next = MIN (next, deadline);
+    }
+  }
+
+  if (GST_CLOCK_TIME_IS_VALID (next))
+    gst_bus_schedule_coalesce (bus, next);
+
+done:
+  g_mutex_unlock (&priv->queue_lock);
+
+  return TRUE;
+}
+
+/* with queue_lock */
+static void
+gst_bus_schedule_coalesce (GstBus * bus, GstClockTime time)
+{
+  GstBusPrivate *priv = bus->priv;
+
+  /* the pending timeout reschedules for the messages it can't queue yet */
+  if (priv->coalesce_timeout)
+    return;
+
+  priv->coalesce_timeout =
+      gst_clock_new_single_shot_id (priv->coalesce_clock, time);
+  gst_clock_id_wait_async (priv->coalesce_timeout, gst_bus_coalesce_timeout,
+      gst_object_ref (bus), (GDestroyNotify) gst_object_unref);
+}
+
+/* with queue_lock. Returns %TRUE when @message was merged with a queued
+ * message of the same source, type and structure name or is held back
+ * because such a message was delivered less than the coalesce interval ago.
+ * Otherwise the message must be queued. */
+static gboolean
+gst_bus_coalesce (GstBus * bus, GstMessage * message)
+{
+  GstBusPrivate *priv = bus->priv;
+  GstBusCoalesceSlot key, *slot;
+  GstClockTime now = GST_CLOCK_TIME_NONE;
+
+  coalesce_slot_init (&key, message);
+  slot = g_hash_table_lookup (priv->coalesce_slots, &key);
+
+  if (slot && slot->queued) {
+    GST_DEBUG_OBJECT (bus, "[msg %p] replaces queued message %p", message,
+        slot->latest ? slot->latest : slot->queued);
+    if (slot->latest)
+      gst_message_unref (slot->latest);
+    slot->latest = message;
+    return TRUE;
+  }
+
+  if (priv->coalesce_interval > 0) {
+    now = gst_clock_get_time (priv->coalesce_clock);
+
+    if (slot && now < slot->last_time + priv->coalesce_interval) {
+      GST_DEBUG_OBJECT (bus, "[msg %p] held back", message);
+      if (slot->latest)
+        gst_message_unref (slot->latest);
+      slot->latest = message;
+      gst_bus_schedule_coalesce (bus,
+          slot->last_time + priv->coalesce_interval);
+      return TRUE;
+    }
+  }
+
+  if (slot == NULL) {
+    slot = g_slice_dup (GstBusCoalesceSlot, &key);
+    if (slot->src)
+      gst_object_ref (slot->src);
+    g_hash_table_add (priv->coalesce_slots, slot);
+  } else if (slot->latest) {
+    /* the held back message is older than this one */
+    gst_message_unref (slot->latest);
+    slot->latest = NULL;
+  }
+  slot->queued = message;
+  slot->last_time = now;
+
+  return FALSE;
+}
+
+/* with queue_lock. Returns the coalesce slot of @message if it is the queued
+ * message of the slot. */
+static GstBusCoalesceSlot *
+gst_bus_coalesce_lookup (GstBus * bus, GstMessage * message)
+{
+  GstBusCoalesceSlot key, *slot;
+
+  if (bus->priv->coalesce_slots == NULL
+      || g_hash_table_size (bus->priv->coalesce_slots) == 0)
+    return NULL;
+
+  coalesce_slot_init (&key, message);
+  slot = g_hash_table_lookup (bus->priv->coalesce_slots, &key);
+  if (slot && slot->queued != message)
+    slot = NULL;
+
+  return slot;
+}
+
+/* with queue_lock. Called for each message popped from the queue, returns
+ * the message that should be delivered instead. */
+static GstMessage *
+gst_bus_uncoalesce (GstBus * bus, GstMessage * message)
+{
+  GstBusCoalesceSlot *slot;
+
+  if (!(slot = gst_bus_coalesce_lookup (bus, message)))
+    return message;
+
+  slot->queued = NULL;
+  if (slot->latest) {
+    GST_DEBUG_OBJECT (bus, "[msg %p] delivering newer message %p", message,
+        slot->latest);
+    gst_message_unref (message);
+    message = slot->latest;
+    slot->latest = NULL;
+  }
+
+  /* only needed to remember when the last message was delivered, the
+   * timeout drops the slot when the interval has passed */
+  if (bus->priv->coalesce_interval == 0
+      || !GST_CLOCK_TIME_IS_VALID (slot->last_time))
+    g_hash_table_remove (bus->priv->coalesce_slots, slot);
+  else
+    gst_bus_schedule_coalesce (bus,
+        slot->last_time + bus->priv->coalesce_interval);
+
+  return message;
+}
+
 /**
  * gst_bus_post:
  * @bus: a #GstBus to post on
@@ -340,13 +638,26 @@ gst_bus_post (GstBus * bus, GstMessage * message)
       GST_DEBUG_OBJECT (bus, "[msg %p] dropped", message);
       break;
     case GST_BUS_PASS:
+    {
+      GstMessageType types;
+
+      g_mutex_lock (&bus->priv->queue_lock);
+      types = bus->priv->coalesce_types;
+      if (G_UNLIKELY (types != 0) && (GST_MESSAGE_TYPE (message) & types) != 0
+          && (!GST_MESSAGE_TYPE_IS_EXTENDED (message)
+              || (types & GST_MESSAGE_EXTENDED))
+          && gst_bus_coalesce (bus, message)) {
+        g_mutex_unlock (&bus->priv->queue_lock);
+        break;
+      }
       /* pass the message to the async queue, refcount passed in the queue */
       GST_DEBUG_OBJECT (bus, "[msg %p] pushing on async queue", message);
-      gst_atomic_queue_push (bus->priv->queue, message);
-      gst_poll_write_control (bus->priv->poll);
+      gst_bus_queue_message (bus, message);
+      g_mutex_unlock (&bus->priv->queue_lock);
       GST_DEBUG_OBJECT (bus, "[msg %p] pushed on async queue", message);
 
       break;
+    }
     case GST_BUS_ASYNC:
     {
       /* async delivery, we need a mutex and a cond to block
@@ -364,8 +675,9 @@ gst_bus_post (GstBus * bus, GstMessage * message)
        * the cond will be signalled and we can continue */
       g_mutex_lock (lock);
 
-      gst_atomic_queue_push (bus->priv->queue, message);
-      gst_poll_write_control (bus->priv->poll);
+      g_mutex_lock (&bus->priv->queue_lock);
+      gst_bus_queue_message (bus, message);
+      g_mutex_unlock (&bus->priv->queue_lock);
 
       /* now block till the message is freed */
       g_cond_wait (cond, lock);
@@ -444,6 +756,17 @@ gst_bus_set_flushing (GstBus * bus, gboolean flushing)
 
     while ((message = gst_bus_pop (bus)))
       gst_message_unref (message);
+
+    /* drop the held back messages */
+    g_mutex_lock (&bus->priv->queue_lock);
+    if (bus->priv->coalesce_slots)
+      g_hash_table_remove_all (bus->priv->coalesce_slots);
+    if (bus->priv->coalesce_timeout) {
+      gst_clock_id_unschedule (bus->priv->coalesce_timeout);
+      gst_clock_id_unref (bus->priv->coalesce_timeout);
+      bus->priv->coalesce_timeout = NULL;
+    }
+    g_mutex_unlock (&bus->priv->queue_lock);
   } else {
     GST_DEBUG_OBJECT (bus, "unset bus flushing");
     GST_OBJECT_FLAG_UNSET (bus, GST_BUS_FLUSHING);
@@ -452,6 +775,83 @@ gst_bus_set_flushing (GstBus * bus, gboolean flushing)
   GST_OBJECT_UNLOCK (bus);
 }
 
+/**
+ * gst_bus_set_coalesce:
+ * @bus: a #GstBus
+ * @types: the message types to coalesce
+ * @interval: the minimum time between the delivery of two messages of the
+ *     same source, type and structure name, or 0
+ *
+ * Coalesce the messages of @types that are posted on @bus. A message that is
+ * posted while a message of the same source, type and structure name is still
+ * queued on the bus is delivered in its place, the older message is dropped.
+ * This is useful for messages that only carry the latest state of something,
+ * like buffering, QoS or progress messages, so that frequent posting of them
+ * doesn't flood the application.
+ *
+ * When @interval is not 0, such messages are also delivered at most once per
+ * @interval. Messages posted earlier are held back and the latest one of them
+ * is queued when the interval has passed.
+ *
+ * Messages that are handled by the sync handler are not affected. Setting
+ * @types to 0 disables coalescing.
+ *
+ * MT safe.
+ *
+ * Since: 1.6
+ */
+void
+gst_bus_set_coalesce (GstBus * bus, GstMessageType types,
+    GstClockTime interval)
+{
+  GstBusPrivate *priv;
+
+  g_return_if_fail (GST_IS_BUS (bus));
+  g_return_if_fail (GST_CLOCK_TIME_IS_VALID (interval));
+
+  priv = bus->priv;
+
+  g_mutex_lock (&priv->queue_lock);
+  GST_DEBUG_OBJECT (bus, "coalesce types 0x%08x, interval %" GST_TIME_FORMAT,
+      (guint) types, GST_TIME_ARGS (interval));
+  priv->coalesce_types = types;
+  priv->coalesce_interval = interval;
+  if (types != 0 && priv->coalesce_slots == NULL)
+    priv->coalesce_slots =
+        g_hash_table_new_full ((GHashFunc) coalesce_slot_hash,
+        (GEqualFunc) coalesce_slot_equal, NULL,
+        (GDestroyNotify) coalesce_slot_free);
+  if (interval > 0 && priv->coalesce_clock == NULL)
+    priv->coalesce_clock = gst_system_clock_obtain ();
+  g_mutex_unlock (&priv->queue_lock);
+}
+
+/**
+ * gst_bus_get_coalesce:
+ * @bus: a #GstBus
+ * @types: (out) (allow-none): the message types that are coalesced
+ * @interval: (out) (allow-none): the minimum delivery interval
+ *
+ * Get the message coalescing configured with gst_bus_set_coalesce().
+ *
+ * MT safe.
+ *
+ * Since: 1.6
+ */
+void
+gst_bus_get_coalesce (GstBus * bus, GstMessageType * types,
+    GstClockTime * interval)
+{
+  g_return_if_fail (GST_IS_BUS (bus));
+
+  g_mutex_lock (&bus->priv->queue_lock);
+  if (types)
+    *types = bus->priv->coalesce_types;
+  if (interval)
+    *interval = bus->priv->coalesce_interval;
+  g_mutex_unlock (&bus->priv->queue_lock);
+}
+
 /**
  * gst_bus_timed_pop_filtered:
  * @bus: a #GstBus to pop from
@@ -466,6 +866,9 @@ gst_bus_set_flushing (GstBus * bus, gboolean flushing)
  * @timeout is #GST_CLOCK_TIME_NONE, this function will block forever until a
  * matching message was posted on the bus.
  *
+ * A bus that is part of a #GstBusGroup shares the wakeup file descriptor of
+ * the group and can't wait for its own messages, @timeout must be 0 then.
+ *
  * Returns: (transfer full) (nullable): a #GstMessage matching the
  *     filter in @types, or %NULL if no matching message was found on
  *     the bus until the timeout expired. The message is taken from
@@ -486,10 +889,12 @@ gst_bus_timed_pop_filtered (GstBus * bus, GstClockTime timeout,
   g_return_val_if_fail (GST_IS_BUS (bus), NULL);
   g_return_val_if_fail (types != 0, NULL);
   g_return_val_if_fail (timeout == 0 || bus->priv->poll != NULL, NULL);
+  g_return_val_if_fail (timeout == 0 || bus->priv->group == NULL, NULL);
 
   g_mutex_lock (&bus->priv->queue_lock);
 
   while (TRUE) {
+    GstPoll *poll;
     gint ret;
 
     GST_LOG_OBJECT (bus, "have %d messages",
@@ -499,6 +904,8 @@ gst_bus_timed_pop_filtered (GstBus * bus, GstClockTime timeout,
       if (bus->priv->poll)
         gst_poll_read_control (bus->priv->poll);
 
+      message = gst_bus_uncoalesce (bus, message);
+
       GST_DEBUG_OBJECT (bus, "got message %p, %s from %s, type mask is %u",
           message, GST_MESSAGE_TYPE_NAME (message),
           GST_MESSAGE_SRC_NAME (message), (guint) types);
@@ -536,9 +943,10 @@ gst_bus_timed_pop_filtered (GstBus * bus, GstClockTime timeout,
     }
 
     /* only here in timeout case */
-    g_assert (bus->priv->poll);
+    poll = bus->priv->poll;
+    g_assert (poll);
     g_mutex_unlock (&bus->priv->queue_lock);
-    ret = gst_poll_wait (bus->priv->poll, timeout - elapsed);
+    ret = gst_poll_wait (poll, timeout - elapsed);
     g_mutex_lock (&bus->priv->queue_lock);
 
     if (ret == 0) {
@@ -653,8 +1061,14 @@ gst_bus_peek (GstBus * bus)
 
   g_mutex_lock (&bus->priv->queue_lock);
   message = gst_atomic_queue_peek (bus->priv->queue);
-  if (message)
+  if (message) {
+    GstBusCoalesceSlot *slot;
+
+    /* this is the message that will be popped */
+    if ((slot = gst_bus_coalesce_lookup (bus, message)) && slot->latest)
+      message = slot->latest;
     gst_message_ref (message);
+  }
   g_mutex_unlock (&bus->priv->queue_lock);
 
   GST_DEBUG_OBJECT (bus, "peek on bus, got message %p", message);
@@ -813,6 +1227,23 @@ static GSourceFuncs gst_bus_source_funcs = {
   gst_bus_source_finalize
 };
 
+/* must be called with the bus OBJECT LOCK */
+static GSource *
+gst_bus_create_watch_unlocked (GstBus * bus)
+{
+  GstBusSource *source;
+
+  source = (GstBusSource *) g_source_new (&gst_bus_source_funcs,
+      sizeof (GstBusSource));
+
+  g_source_set_name ((GSource *) source, "GStreamer message bus watch");
+
+  source->bus = gst_object_ref (bus);
+  g_source_add_poll ((GSource *) source, &bus->priv->pollfd);
+
+  return (GSource *) source;
+}
+
 /**
  * gst_bus_create_watch:
  * @bus: a #GstBus to create the watch for
@@ -821,25 +1252,29 @@ static GSourceFuncs gst_bus_source_funcs = {
  * a message is on the bus. After the GSource is dispatched, the
  * message is popped off the bus and unreffed.
  *
- * Returns: (transfer full): a #GSource that can be added to a mainloop.
+ * A bus that is part of a #GstBusGroup can't have a watch of its own.
+ *
+ * Returns: (transfer full) (nullable): a #GSource that can be added to a
+ *     mainloop, or %NULL when @bus is part of a #GstBusGroup.
  */
 GSource *
 gst_bus_create_watch (GstBus * bus)
 {
-  GstBusSource *source;
+  GSource *source;
 
   g_return_val_if_fail (GST_IS_BUS (bus), NULL);
   g_return_val_if_fail (bus->priv->poll != NULL, NULL);
 
-  source = (GstBusSource *) g_source_new (&gst_bus_source_funcs,
-      sizeof (GstBusSource));
-
-  g_source_set_name ((GSource *) source, "GStreamer message bus watch");
-
-  source->bus = gst_object_ref (bus);
-  g_source_add_poll ((GSource *) source, &bus->priv->pollfd);
+  GST_OBJECT_LOCK (bus);
+  if (bus->priv->group) {
+    GST_ERROR_OBJECT (bus, "Tried to create a watch for a bus in a group");
+    source = NULL;
+  } else {
+    source = gst_bus_create_watch_unlocked (bus);
+  }
+  GST_OBJECT_UNLOCK (bus);
 
-  return (GSource *) source;
+  return source;
 }
 
 /* must be called with the bus OBJECT LOCK */
@@ -857,7 +1292,12 @@ gst_bus_add_watch_full_unlocked (GstBus * bus, gint priority,
     return 0;
   }
 
-  source = gst_bus_create_watch (bus);
+  if (bus->priv->group) {
+    GST_ERROR_OBJECT (bus, "Tried to add a watch to a bus in a group");
+    return 0;
+  }
+
+  source = gst_bus_create_watch_unlocked (bus);
 
   if (priority != G_PRIORITY_DEFAULT)
     g_source_set_priority (source, priority);
@@ -1390,3 +1830,390 @@ error:
     return;
   }
 }
+
+/**
+ * gst_bus_group_new:
+ *
+ * Creates a new #GstBusGroup. A bus group dispatches the messages of many
+ * buses from a single #GSource, see gst_bus_group_create_watch(). The buses
+ * in the group share one wakeup file descriptor instead of using one each,
+ * which allows running a large number of pipelines in one process.
+ *
+ * Returns: (transfer full): a new #GstBusGroup
+ *
+ * Since: 1.6
+ */
+GstBusGroup *
+gst_bus_group_new (void)
+{
+  GstBusGroup *group;
+
+  group = g_slice_new (GstBusGroup);
+  group->refcount = 1;
+  g_mutex_init (&group->lock);
+  group->buses = g_hash_table_new (NULL, NULL);
+  group->poll = gst_poll_new_timer ();
+  gst_poll_get_read_gpollfd (group->poll, &group->pollfd);
+  group->ready = gst_atomic_queue_new (32);
+
+  GST_DEBUG ("created bus group %p", group);
+
+  return group;
+}
+
+/**
+ * gst_bus_group_ref:
+ * @group: a #GstBusGroup
+ *
+ * Increase the refcount of @group.
+ *
+ * Returns: (transfer full): @group
+ *
+ * Since: 1.6
+ */
+GstBusGroup *
+gst_bus_group_ref (GstBusGroup * group)
+{
+  g_return_val_if_fail (group != NULL, NULL);
+
+  g_atomic_int_inc (&group->refcount);
+
+  return group;
+}
+
+/* with the group lock, @bus must be in the group. Returns the notify
+ * function and data for the caller to call without the lock. */
+static void
+gst_bus_group_release_bus (GstBusGroup * group, GstBus * bus,
+    GDestroyNotify * notify, gpointer * data)
+{
+  GstBusPrivate *priv = bus->priv;
+  guint i, pending;
+
+  GST_DEBUG_OBJECT (bus, "leaving group %p", group);
+
+  /* give the bus its own poll back, with a wakeup for each queued message */
+  g_mutex_lock (&priv->queue_lock);
+  pending = gst_atomic_queue_length (priv->queue);
+  priv->poll = priv->own_poll;
+  priv->own_poll = NULL;
+  gst_poll_get_read_gpollfd (priv->poll, &priv->pollfd);
+  for (i = 0; i < pending; i++) {
+    gst_poll_read_control (group->poll);
+    gst_poll_write_control (priv->poll);
+  }
+  priv->group = NULL;
+  *notify = priv->group_notify;
+  *data = priv->group_data;
+  priv->group_func = NULL;
+  priv->group_data = NULL;
+  priv->group_notify = NULL;
+  g_mutex_unlock (&priv->queue_lock);
+}
+
+/**
+ * gst_bus_group_unref:
+ * @group: (transfer full): a #GstBusGroup
+ *
+ * Unref @group. When the refcount reaches 0, all buses are removed from the
+ * group and it is freed.
+ *
+ * Since: 1.6
+ */
+void
+gst_bus_group_unref (GstBusGroup * group)
+{
+  GHashTableIter iter;
+  GstBus *bus;
+
+  g_return_if_fail (group != NULL);
+  g_return_if_fail (group->refcount > 0);
+
+  if (!g_atomic_int_dec_and_test (&group->refcount))
+    return;
+
+  GST_DEBUG ("freeing bus group %p", group);
+
+  /* release the buses first, once they have their own poll again no poster
+   * can see the ready queue and the poll of the group anymore */
+  g_hash_table_iter_init (&iter, group->buses);
+  while (g_hash_table_iter_next (&iter, (gpointer *) & bus, NULL)) {
+    GDestroyNotify notify;
+    gpointer data;
+
+    g_hash_table_iter_remove (&iter);
+    gst_bus_group_release_bus (group, bus, &notify, &data);
+    if (notify)
+      notify (data);
+    gst_object_unref (bus);
+  }
+  g_hash_table_destroy (group->buses);
+
+  while ((bus = gst_atomic_queue_pop (group->ready)))
+    gst_object_unref (bus);
+  gst_atomic_queue_unref (group->ready);
+
+  gst_poll_free (group->poll);
+  g_mutex_clear (&group->lock);
+
+  g_slice_free (GstBusGroup, group);
+}
+
+/**
+ * gst_bus_group_add_bus:
+ * @group: a #GstBusGroup
+ * @bus: a #GstBus
+ * @func: the function to call for the messages of @bus
+ * @user_data: user data passed to @func
+ * @notify: the function to call with @user_data when @bus leaves @group
+ *
+ * Adds @bus to @group. The messages posted on @bus are passed to @func from
+ * the watches of @group. Like with a bus watch, @bus is removed from @group
+ * when @func returns %FALSE.
+ *
+ * While @bus is part of @group it uses the wakeup file descriptor of the
+ * group and can not have a watch of its own. Messages can only be popped from
+ * it without waiting, with a timeout of 0, because the wakeups of the other
+ * buses of the group would make a waiting pop spin.
+ *
+ * Returns: %TRUE if @bus was added to @group, %FALSE if it could not be
+ * added because it has a watch, is part of a group already or has no
+ * asynchronous message delivery.
+ *
+ * MT safe.
+ *
+ * Since: 1.6
+ */
+gboolean
+gst_bus_group_add_bus (GstBusGroup * group, GstBus * bus, GstBusFunc func,
+    gpointer user_data, GDestroyNotify notify)
+{
+  GstBusPrivate *priv;
+  guint i, pending;
+
+  g_return_val_if_fail (group != NULL, FALSE);
+  g_return_val_if_fail (GST_IS_BUS (bus), FALSE);
+  g_return_val_if_fail (func != NULL, FALSE);
+
+  priv = bus->priv;
+
+  g_mutex_lock (&group->lock);
+  GST_OBJECT_LOCK (bus);
+  if (priv->signal_watch || priv->group || priv->poll == NULL)
+    goto not_possible;
+
+  GST_DEBUG_OBJECT (bus, "joining group %p", group);
+
+  g_mutex_lock (&priv->queue_lock);
+  /* move the wakeups of the queued messages to the poll of the group. The
+   * own poll is kept and not freed, a thread might still be polling it */
+  pending = gst_atomic_queue_length (priv->queue);
+  for (i = 0; i < pending; i++) {
+    gst_poll_read_control (priv->poll);
+    gst_poll_write_control (group->poll);
+  }
+  priv->own_poll = priv->poll;
+  priv->poll = group->poll;
+  priv->pollfd = group->pollfd;
+
+  priv->group = group;
+  priv->group_func = func;
+  priv->group_data = user_data;
+  priv->group_notify = notify;
+  g_atomic_int_set (&priv->group_scheduled, pending > 0);
+  if (pending > 0)
+    gst_atomic_queue_push (group->ready, gst_object_ref (bus));
+  g_mutex_unlock (&priv->queue_lock);
+  GST_OBJECT_UNLOCK (bus);
+
+  g_hash_table_add (group->buses, gst_object_ref (bus));
+  g_mutex_unlock (&group->lock);
+
+  return TRUE;
+
+  /* ERRORS */
+not_possible:
+  {
+    GST_WARNING_OBJECT (bus, "can't add bus to group %p", group);
+    GST_OBJECT_UNLOCK (bus);
+    g_mutex_unlock (&group->lock);
+    return FALSE;
+  }
+}
+
+/**
+ * gst_bus_group_remove_bus:
+ * @group: a #GstBusGroup
+ * @bus: a #GstBus
+ *
+ * Removes @bus from @group. Messages that are still queued on @bus stay
+ * there and can be popped from @bus or dispatched from a watch of its own
+ * afterwards.
+ *
+ * Returns: %TRUE if @bus was removed, %FALSE if it was not in @group.
+ *
+ * MT safe.
+ *
+ * Since: 1.6
+ */
+gboolean
+gst_bus_group_remove_bus (GstBusGroup * group, GstBus * bus)
+{
+  GDestroyNotify notify;
+  gpointer data;
+
+  g_return_val_if_fail (group != NULL, FALSE);
+  g_return_val_if_fail (GST_IS_BUS (bus), FALSE);
+
+  g_mutex_lock (&group->lock);
+  if (!g_hash_table_remove (group->buses, bus))
+    goto not_in_group;
+
+  gst_bus_group_release_bus (group, bus, &notify, &data);
+  g_mutex_unlock (&group->lock);
+
+  if (notify)
+    notify (data);
+  gst_object_unref (bus);
+
+  return TRUE;
+
+  /* ERRORS */
+not_in_group:
+  {
+    GST_WARNING_OBJECT (bus, "not part of group %p", group);
+    g_mutex_unlock (&group->lock);
+    return FALSE;
+  }
+}
+
+/* GSource for a bus group
+ */
+typedef struct
+{
+  GSource source;
+  GstBusGroup *group;
+} GstBusGroupSource;
+
+static gboolean
+gst_bus_group_source_prepare (GSource * source, gint * timeout)
+{
+  *timeout = -1;
+  return FALSE;
+}
+
+static gboolean
+gst_bus_group_source_check (GSource * source)
+{
+  GstBusGroupSource *gsrc = (GstBusGroupSource *) source;
+
+  return gsrc->group->pollfd.revents & (G_IO_IN | G_IO_HUP | G_IO_ERR);
+}
+
+static gboolean
+gst_bus_group_source_dispatch (GSource * source, GSourceFunc callback,
+    gpointer user_data)
+{
+  GstBusGroupSource *gsource = (GstBusGroupSource *) source;
+  GstBusGroup *group = gsource->group;
+  GstMessage *message;
+  GstBus *bus;
+  guint n_ready;
+
+  /* only dispatch the buses that are ready now, buses that become ready
+   * while dispatching are handled in the next iteration of the main loop */
+  n_ready = gst_atomic_queue_length (group->ready);
+
+  while (n_ready-- > 0 && (bus = gst_atomic_queue_pop (group->ready))) {
+    GstBusPrivate *priv = bus->priv;
+    GstBusFunc func;
+    gpointer data;
+    gboolean keep = TRUE;
+    guint i;
+
+    /* from now on new messages schedule the bus again */
+    g_atomic_int_set (&priv->group_scheduled, FALSE);
+
+    g_mutex_lock (&group->lock);
+    func = priv->group == group ? priv->group_func : NULL;
+    data = priv->group_data;
+    g_mutex_unlock (&group->lock);
+
+    /* removed from the group after it was scheduled */
+    if (func == NULL) {
+      gst_object_unref (bus);
+      continue;
+    }
+
+    for (i = 0; keep && i < GROUP_BATCH_SIZE; i++) {
+      if (!(message = gst_bus_pop (bus)))
+        break;
+
+      GST_DEBUG_OBJECT (bus, "group %p dispatching %" GST_PTR_FORMAT, group,
+          message);
+      keep = func (bus, message, data);
+      gst_message_unref (message);
+    }
+
+    if (!keep) {
+      GST_DEBUG_OBJECT (bus, "handler returned FALSE, leaving group");
+      gst_bus_group_remove_bus (group, bus);
+    } else if (i == GROUP_BATCH_SIZE && gst_bus_have_pending (bus)
+        && g_atomic_int_compare_and_exchange (&priv->group_scheduled, FALSE,
+            TRUE)) {
+      /* more messages, give the other buses a chance first */
+      gst_atomic_queue_push (group->ready, gst_object_ref (bus));
+    }
+    gst_object_unref (bus);
+  }
+
+  return TRUE;
+}
+
+static void
+gst_bus_group_source_finalize (GSource * source)
+{
+  GstBusGroupSource *gsource = (GstBusGroupSource *) source;
+
+  gst_bus_group_unref (gsource->group);
+  gsource->group = NULL;
+}
+
+static GSourceFuncs gst_bus_group_source_funcs = {
+  gst_bus_group_source_prepare,
+  gst_bus_group_source_check,
+  gst_bus_group_source_dispatch,
+  gst_bus_group_source_finalize
+};
+
+/**
+ * gst_bus_group_create_watch:
+ * @group: a #GstBusGroup
+ *
+ * Create a watch for @group. The #GSource is dispatched whenever one of the
+ * buses of @group has messages and passes them to the function given in
+ * gst_bus_group_add_bus() for that bus. A limited number of messages is
+ * dispatched per bus in one go so that a busy bus doesn't starve the
+ * others.
+ *
+ * Returns: (transfer full): a #GSource that can be added to a mainloop.
+ *
+ * Since: 1.6
+ */
+GSource *
+gst_bus_group_create_watch (GstBusGroup * group)
+{
+  GstBusGroupSource *source;
+
+  g_return_val_if_fail (group != NULL, NULL);
+
+  source = (GstBusGroupSource *) g_source_new (&gst_bus_group_source_funcs,
+      sizeof (GstBusGroupSource));
+
+  g_source_set_name ((GSource *) source, "GStreamer message bus group watch");
+
+  source->group = gst_bus_group_ref (group);
+  g_source_add_poll ((GSource *) source, &group->pollfd);
+
+  return (GSource *) source;
+}
@@ -25,6 +25,7 @@
 typedef struct _GstBus GstBus;
 typedef struct _GstBusPrivate GstBusPrivate;
 typedef struct _GstBusClass GstBusClass;
+typedef struct _GstBusGroup GstBusGroup;
 
 #include <gst/gstmessage.h>
 #include <gst/gstclock.h>
@@ -146,6 +147,11 @@ GstMessage *            gst_bus_timed_pop               (GstBus * bus, GstClockT
 GstMessage *            gst_bus_timed_pop_filtered      (GstBus * bus, GstClockTime timeout, GstMessageType types);
 void                    gst_bus_set_flushing            (GstBus * bus, gboolean flushing);
 
+void                    gst_bus_set_coalesce            (GstBus * bus, GstMessageType types,
+                                                         GstClockTime interval);
+void                    gst_bus_get_coalesce            (GstBus * bus, GstMessageType * types,
+                                                         GstClockTime * interval);
+
 /* synchronous dispatching */
 void                    gst_bus_set_sync_handler        (GstBus * bus, GstBusSyncHandler func,
                                                          gpointer user_data, GDestroyNotify notify);
@@ -179,6 +185,21 @@ void                    gst_bus_remove_signal_watch     (GstBus * bus);
 void                    gst_bus_enable_sync_message_emission (GstBus * bus);
 void                    gst_bus_disable_sync_message_emission (GstBus * bus);
 
+/* dispatching the messages of many buses from one source */
+#define GST_TYPE_BUS_GROUP        (gst_bus_group_get_type ())
+
+GType                   gst_bus_group_get_type          (void);
+
+GstBusGroup *           gst_bus_group_new               (void);
+GstBusGroup *           gst_bus_group_ref               (GstBusGroup * group);
+void                    gst_bus_group_unref             (GstBusGroup * group);
+
+gboolean                gst_bus_group_add_bus           (GstBusGroup * group, GstBus * bus,
+                                                         GstBusFunc func, gpointer user_data,
+                                                         GDestroyNotify notify);
+gboolean                gst_bus_group_remove_bus        (GstBusGroup * group, GstBus * bus);
+GSource *               gst_bus_group_create_watch      (GstBusGroup * group);
+
 G_END_DECLS
 
 #endif /* __GST_BUS_H__ */
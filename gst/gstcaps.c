@@ -373,6 +373,40 @@ gst_caps_new_full_valist (GstStructure * structure, va_list var_args)
 
 G_DEFINE_POINTER_TYPE (GstStaticCaps, gst_static_caps);
 
+/* static caps loaded from the registry carry a binary serialization of the
+ * caps in their padding, decoding that is a lot faster than parsing the
+ * string */
+#define STATIC_CAPS_BINARY(sc)      ((sc)->_gst_reserved[0])
+#define STATIC_CAPS_BINARY_SIZE(sc) ((sc)->_gst_reserved[1])
+
+void
+priv_gst_static_caps_set_binary (GstStaticCaps * static_caps, guint8 * data,
+    gsize size)
+{
+  G_LOCK (static_caps_lock);
+  g_free (STATIC_CAPS_BINARY (static_caps));
+  STATIC_CAPS_BINARY (static_caps) = data;
+  STATIC_CAPS_BINARY_SIZE (static_caps) = GSIZE_TO_POINTER (size);
+  G_UNLOCK (static_caps_lock);
+}
+
+static GstCaps *
+gst_static_caps_from_binary (GstStaticCaps * static_caps)
+{
+  GValue value = G_VALUE_INIT;
+  GstCaps *caps = NULL;
+
+  if (!gst_value_deserialize_binary (&value, STATIC_CAPS_BINARY (static_caps),
+          GPOINTER_TO_SIZE (STATIC_CAPS_BINARY_SIZE (static_caps)), NULL))
+    return NULL;
+
+  if (G_VALUE_TYPE (&value) == GST_TYPE_CAPS)
+    caps = g_value_dup_boxed (&value);
+  g_value_unset (&value);
+
+  return caps;
+}
+
 /**
  * gst_static_caps_get:
  * @static_caps: the #GstStaticCaps to convert
@@ -401,6 +435,17 @@ gst_static_caps_get (GstStaticCaps * static_caps)
     if (G_UNLIKELY (*caps != NULL))
       goto done;
 
+    if (STATIC_CAPS_BINARY (static_caps) != NULL) {
+      *caps = gst_static_caps_from_binary (static_caps);
+      if (G_LIKELY (*caps != NULL)) {
+        GST_CAT_TRACE (GST_CAT_CAPS, "created %p from binary caps",
+            static_caps);
+        goto done;
+      }
+      GST_CAT_WARNING (GST_CAT_CAPS, "invalid binary caps for %p",
+          static_caps);
+    }
+
     string = static_caps->string;
 
     if (G_UNLIKELY (string == NULL))
@@ -443,6 +488,9 @@ gst_static_caps_cleanup (GstStaticCaps * static_caps)
 {
   G_LOCK (static_caps_lock);
   gst_caps_replace (&static_caps->caps, NULL);
+  g_free (STATIC_CAPS_BINARY (static_caps));
+  STATIC_CAPS_BINARY (static_caps) = NULL;
+  STATIC_CAPS_BINARY_SIZE (static_caps) = NULL;
   G_UNLOCK (static_caps_lock);
 }
 
@@ -121,6 +121,9 @@ static GstAllocTrace *_gst_clock_entry_trace;
 #define DEFAULT_WINDOW_THRESHOLD        4
 #define DEFAULT_TIMEOUT                 GST_SECOND / 10
 
+/* denominator of the rate found by the regression */
+#define RATE_DENOMINATOR                (G_GUINT64_CONSTANT (1) << 31)
+
 enum
 {
   PROP_0,
@@ -156,6 +159,9 @@ struct _GstClockPrivate
   gint time_index;
   GstClockTime timeout;
   GstClockTime *times;
+  /* running sums over the observations in times, relative to the bases */
+  GstClockTime xbase, ybase;
+  gdouble sum_x, sum_y, sum_xx, sum_yy, sum_xy;
   GstClockID clockid;
 
   gint pre_count;
@@ -719,7 +725,7 @@ gst_clock_init (GstClock * clock)
   priv->filling = TRUE;
   priv->time_index = 0;
   priv->timeout = DEFAULT_TIMEOUT;
-  priv->times = g_new0 (GstClockTime, 4 * priv->window_size);
+  priv->times = g_new0 (GstClockTime, 2 * priv->window_size);
 
   /* clear floating flag */
   gst_object_ref_sink (clock);
@@ -1228,6 +1234,49 @@ gst_clock_get_master (GstClock * clock)
   return result;
 }
 
+/* the observations are kept relative to a base, the sums over the window are
+ * updated for every observation and recomputed whenever the window wraps
+ * around so that rounding errors can't accumulate.
+ * with SLAVE_LOCK
+ */
+static void
+update_sums (GstClockPrivate * priv, GstClockTime x, GstClockTime y,
+    gdouble sign)
+{
+  gdouble dx, dy;
+
+  dx = GST_CLOCK_DIFF (priv->xbase, x);
+  dy = GST_CLOCK_DIFF (priv->ybase, y);
+
+  priv->sum_x += sign * dx;
+  priv->sum_y += sign * dy;
+  priv->sum_xx += sign * dx * dx;
+  priv->sum_yy += sign * dy * dy;
+  priv->sum_xy += sign * dx * dy;
+}
+
+/* with SLAVE_LOCK */
+static void
+reset_sums (GstClockPrivate * priv, gint n)
+{
+  GstClockTime *x, *y;
+  gint i, j;
+
+  x = priv->times;
+  y = priv->times + 1;
+
+  priv->xbase = priv->ybase = G_MAXUINT64;
+  for (i = j = 0; i < n; i++, j += 2) {
+    priv->xbase = MIN (priv->xbase, x[j]);
+    priv->ybase = MIN (priv->ybase, y[j]);
+  }
+
+  priv->sum_x = priv->sum_y = 0.0;
+  priv->sum_xx = priv->sum_yy = priv->sum_xy = 0.0;
+  for (i = j = 0; i < n; i++, j += 2)
+    update_sums (priv, x[j], y[j], 1.0);
+}
+
 /* http://mathworld.wolfram.com/LeastSquaresFitting.html
  * with SLAVE_LOCK
  */
@@ -1236,108 +1285,58 @@ do_linear_regression (GstClock * clock, GstClockTime * m_num,
     GstClockTime * m_denom, GstClockTime * b, GstClockTime * xbase,
     gdouble * r_squared)
 {
-  GstClockTime *newx, *newy;
-  GstClockTime xmin, ymin, xbar, ybar, xbar4, ybar4;
-  GstClockTimeDiff sxx, sxy, syy;
-  GstClockTime *x, *y;
-  gint i, j;
+  gdouble xbar, ybar, sxx, syy, sxy, m;
   guint n;
   GstClockPrivate *priv;
 
-  xbar = ybar = sxx = syy = sxy = 0;
-
   priv = clock->priv;
 
-  x = priv->times;
-  y = priv->times + 2;
   n = priv->filling ? priv->time_index : priv->window_size;
 
 #ifdef DEBUGGING_ENABLED
-  GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "doing regression on:");
-  for (i = j = 0; i < n; i++, j += 4)
-    GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
-        "  %" G_GUINT64_FORMAT "  %" G_GUINT64_FORMAT, x[j], y[j]);
-#endif
-
-  xmin = ymin = G_MAXUINT64;
-  for (i = j = 0; i < n; i++, j += 4) {
-    xmin = MIN (xmin, x[j]);
-    ymin = MIN (ymin, y[j]);
-  }
-
-#ifdef DEBUGGING_ENABLED
-  GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "min x: %" G_GUINT64_FORMAT,
-      xmin);
-  GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "min y: %" G_GUINT64_FORMAT,
-      ymin);
-#endif
-
-  newx = priv->times + 1;
-  newy = priv->times + 3;
+  {
+    gint i, j;
 
-  /* strip off unnecessary bits of precision */
-  for (i = j = 0; i < n; i++, j += 4) {
-    newx[j] = x[j] - xmin;
-    newy[j] = y[j] - ymin;
+    GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "doing regression on:");
+    for (i = j = 0; i < n; i++, j += 2)
+      GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
+          "  %" G_GUINT64_FORMAT "  %" G_GUINT64_FORMAT, priv->times[j],
+          priv->times[j + 1]);
   }
-
-#ifdef DEBUGGING_ENABLED
-  GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "reduced numbers:");
-  for (i = j = 0; i < n; i++, j += 4)
-    GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
-        "  %" G_GUINT64_FORMAT "  %" G_GUINT64_FORMAT, newx[j], newy[j]);
 #endif
 
-  /* have to do this precisely otherwise the results are pretty much useless.
-   * should guarantee that none of these accumulators can overflow */
+  xbar = priv->sum_x / n;
+  ybar = priv->sum_y / n;
 
-  /* quantities on the order of 1e10 -> 30 bits; window size a max of 2^10, so
-     this addition could end up around 2^40 or so -- ample headroom */
-  for (i = j = 0; i < n; i++, j += 4) {
-    xbar += newx[j];
-    ybar += newy[j];
-  }
-  xbar /= n;
-  ybar /= n;
+  /* the observations are relative to the base, which is close to the values
+   * in the window, so there is no loss of precision worth mentioning here */
+  sxx = priv->sum_xx - n * xbar * xbar;
+  syy = priv->sum_yy - n * ybar * ybar;
+  sxy = priv->sum_xy - n * xbar * ybar;
 
 #ifdef DEBUGGING_ENABLED
-  GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "  xbar  = %" G_GUINT64_FORMAT,
-      xbar);
-  GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "  ybar  = %" G_GUINT64_FORMAT,
-      ybar);
+  GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "  xbar  = %g", xbar);
+  GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "  ybar  = %g", ybar);
 #endif
 
-  /* multiplying directly would give quantities on the order of 1e20 -> 60 bits;
-     times the window size that's 70 which is too much. Instead we (1) subtract
-     off the xbar*ybar in the loop instead of after, to avoid accumulation; (2)
-     shift off 4 bits from each multiplicand, giving an expected ceiling of 52
-     bits, which should be enough. Need to check the incoming range and domain
-     to ensure this is an appropriate loss of precision though. */
-  xbar4 = xbar >> 4;
-  ybar4 = ybar >> 4;
-  for (i = j = 0; i < n; i++, j += 4) {
-    GstClockTime newx4, newy4;
-
-    newx4 = newx[j] >> 4;
-    newy4 = newy[j] >> 4;
-
-    sxx += newx4 * newx4 - xbar4 * xbar4;
-    syy += newy4 * newy4 - ybar4 * ybar4;
-    sxy += newx4 * newy4 - xbar4 * ybar4;
-  }
+  if (G_UNLIKELY (sxx <= 0.0))
+    goto invalid;
 
-  if (G_UNLIKELY (sxx == 0))
+  m = sxy / sxx;
+  if (G_UNLIKELY (m <= 0.0))
     goto invalid;
 
-  *m_num = sxy;
-  *m_denom = sxx;
-  *xbase = xmin;
-  *b = (ybar + ymin) - gst_util_uint64_scale (xbar, *m_num, *m_denom);
-  *r_squared = ((double) sxy * (double) sxy) / ((double) sxx * (double) syy);
+  /* express the rate with a fixed power of two denominator, that's precise
+   * enough and keeps the numerator small so that scaling the clock time stays
+   * cheap */
+  *m_denom = RATE_DENOMINATOR;
+  *m_num = (GstClockTime) (m * RATE_DENOMINATOR + 0.5);
+  *xbase = priv->xbase;
+  *b = priv->ybase + (GstClockTimeDiff) (ybar - m * xbar);
+  *r_squared = syy > 0.0 ? (sxy * sxy) / (sxx * syy) : 1.0;
 
 #ifdef DEBUGGING_ENABLED
-  GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "  m      = %g",
-      ((double) *m_num) / *m_denom);
+  GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "  m      = %g", m);
   GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "  b      = %" G_GUINT64_FORMAT,
       *b);
   GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "  xbase  = %" G_GUINT64_FORMAT,
@@ -1349,7 +1348,9 @@ do_linear_regression (GstClock * clock, GstClockTime * m_num,
 
 invalid:
   {
-    GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "sxx == 0, regression failed");
+    GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
+        "sxx %g, sxy %g, regression failed", sxx, sxy);
+    *r_squared = 0.0;
     return FALSE;
   }
 }
@@ -1364,7 +1365,9 @@ invalid:
  * The time @master of the master clock and the time @slave of the slave
  * clock are added to the list of observations. If enough observations
  * are available, a linear regression algorithm is run on the
- * observations and @clock is recalibrated.
+ * observations and @clock is recalibrated. The regression is updated
+ * incrementally, adding an observation takes constant time regardless of
+ * the #GstClock:window-size.
  *
  * If this functions returns %TRUE, @r_squared will contain the 
  * correlation coefficient of the interpolation. A value of 1.0
@@ -1395,13 +1398,27 @@ gst_clock_add_observation (GstClock * clock, GstClockTime slave,
       "adding observation slave %" GST_TIME_FORMAT ", master %" GST_TIME_FORMAT,
       GST_TIME_ARGS (slave), GST_TIME_ARGS (master));
 
-  priv->times[(4 * priv->time_index)] = slave;
-  priv->times[(4 * priv->time_index) + 2] = master;
+  if (G_UNLIKELY (priv->filling && priv->time_index == 0)) {
+    /* (re)starting, the first observation is the base */
+    priv->xbase = slave;
+    priv->ybase = master;
+    priv->sum_x = priv->sum_y = 0.0;
+    priv->sum_xx = priv->sum_yy = priv->sum_xy = 0.0;
+  } else if (!priv->filling) {
+    /* the oldest observation leaves the window */
+    update_sums (priv, priv->times[2 * priv->time_index],
+        priv->times[2 * priv->time_index + 1], -1.0);
+  }
+
+  priv->times[2 * priv->time_index] = slave;
+  priv->times[2 * priv->time_index + 1] = master;
+  update_sums (priv, slave, master, 1.0);
 
   priv->time_index++;
   if (G_UNLIKELY (priv->time_index == priv->window_size)) {
     priv->filling = FALSE;
     priv->time_index = 0;
+    reset_sums (priv, priv->window_size);
   }
 
   if (G_UNLIKELY (priv->filling && priv->time_index < priv->window_threshold))
@@ -1489,7 +1506,7 @@ gst_clock_set_property (GObject * object, guint prop_id,
       GST_CLOCK_SLAVE_LOCK (clock);
       priv->window_size = g_value_get_int (value);
       priv->window_threshold = MIN (priv->window_threshold, priv->window_size);
-      priv->times = g_renew (GstClockTime, priv->times, 4 * priv->window_size);
+      priv->times = g_renew (GstClockTime, priv->times, 2 * priv->window_size);
       /* restart calibration */
       priv->filling = TRUE;
       priv->time_index = 0;
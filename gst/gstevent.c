@@ -89,9 +89,30 @@ typedef struct
 
   GstStructure *structure;
   gint64 running_time_offset;
+
+  /* The frequent event types keep their fields here instead of in a
+   * structure. The structure is only created when someone asks for it, from
+   * then on it is used for all the fields. */
+  gboolean compact;
+  union
+  {
+    gboolean reset_time;        /* FLUSH_STOP */
+    struct
+    {
+      GstClockTime timestamp;
+      GstClockTime duration;
+    } gap;                      /* GAP */
+    GstSegment segment;         /* SEGMENT */
+    GstClockTime latency;       /* LATENCY */
+  } fields;
 } GstEventImpl;
 
 #define GST_EVENT_STRUCTURE(e)  (((GstEventImpl *)(e))->structure)
+#define GST_EVENT_FIELDS(e)     (((GstEventImpl *)(e))->fields)
+
+/* TRUE when the fields of @e are in the fixed layout storage */
+#define GST_EVENT_IS_COMPACT(e) \
+    (((GstEventImpl *)(e))->compact && GST_EVENT_STRUCTURE (e) == NULL)
 
 typedef struct
 {
@@ -224,7 +245,7 @@ _gst_event_free (GstEvent * event)
     gst_structure_free (s);
   }
 
-  g_slice_free1 (sizeof (GstEventImpl), event);
+  priv_gst_mini_object_cache_free (event, sizeof (GstEventImpl));
 }
 
 static void gst_event_init (GstEventImpl * event, GstEventType type);
@@ -235,7 +256,7 @@ _gst_event_copy (GstEvent * event)
   GstEventImpl *copy;
   GstStructure *s;
 
-  copy = g_slice_new0 (GstEventImpl);
+  copy = priv_gst_mini_object_cache_alloc0 (sizeof (GstEventImpl));
 
   gst_event_init (copy, GST_EVENT_TYPE (event));
 
@@ -254,6 +275,10 @@ _gst_event_copy (GstEvent * event)
   ((GstEventImpl *) copy)->running_time_offset =
       ((GstEventImpl *) event)->running_time_offset;
 
+  copy->compact = ((GstEventImpl *) event)->compact;
+  if (copy->compact)
+    copy->fields = GST_EVENT_FIELDS (event);
+
   return GST_EVENT_CAST (copy);
 }
 
@@ -271,6 +296,99 @@ gst_event_init (GstEventImpl * event, GstEventType type)
 }
 
 
+/* create an event of one of the types that keep their fields in the fixed
+ * layout storage, the caller fills in the fields */
+static GstEvent *
+gst_event_new_compact (GstEventType type)
+{
+  GstEventImpl *event;
+
+  event = priv_gst_mini_object_cache_alloc0 (sizeof (GstEventImpl));
+
+  GST_CAT_DEBUG (GST_CAT_EVENT, "creating new event %p %s %d", event,
+      gst_event_type_get_name (type), type);
+
+  gst_event_init (event, type);
+  event->compact = TRUE;
+
+  return GST_EVENT_CAST (event);
+}
+
+/* the name of the structure of the compact event types */
+static GQuark
+gst_event_compact_name (GstEventType type)
+{
+  switch (type) {
+    case GST_EVENT_FLUSH_STOP:
+      return GST_QUARK (EVENT_FLUSH_STOP);
+    case GST_EVENT_GAP:
+      return GST_QUARK (EVENT_GAP);
+    case GST_EVENT_SEGMENT:
+      return GST_QUARK (EVENT_SEGMENT);
+    case GST_EVENT_LATENCY:
+      return GST_QUARK (EVENT_LATENCY);
+    default:
+      g_assert_not_reached ();
+      return 0;
+  }
+}
+
+static GstStructure *
+gst_event_compact_to_structure (GstEvent * event)
+{
+  GQuark name = gst_event_compact_name (GST_EVENT_TYPE (event));
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_FLUSH_STOP:
+      return gst_structure_new_id (name,
+          GST_QUARK (RESET_TIME), G_TYPE_BOOLEAN,
+          GST_EVENT_FIELDS (event).reset_time, NULL);
+    case GST_EVENT_GAP:
+      return gst_structure_new_id (name,
+          GST_QUARK (TIMESTAMP), GST_TYPE_CLOCK_TIME,
+          GST_EVENT_FIELDS (event).gap.timestamp,
+          GST_QUARK (DURATION), GST_TYPE_CLOCK_TIME,
+          GST_EVENT_FIELDS (event).gap.duration, NULL);
+    case GST_EVENT_SEGMENT:
+      return gst_structure_new_id (name,
+          GST_QUARK (SEGMENT), GST_TYPE_SEGMENT,
+          &GST_EVENT_FIELDS (event).segment, NULL);
+    case GST_EVENT_LATENCY:
+      return gst_structure_new_id (name,
+          GST_QUARK (LATENCY), G_TYPE_UINT64,
+          GST_EVENT_FIELDS (event).latency, NULL);
+    default:
+      g_assert_not_reached ();
+      return NULL;
+  }
+}
+
+/* get the structure of @event, creating it from the fixed layout storage
+ * when needed. This can happen on events that are shared between threads so
+ * the structure is installed atomically. */
+static GstStructure *
+gst_event_ensure_structure (GstEvent * event)
+{
+  GstEventImpl *impl = (GstEventImpl *) event;
+  GstStructure *structure;
+
+  structure = g_atomic_pointer_get (&impl->structure);
+  if (structure == NULL && impl->compact) {
+    structure = gst_event_compact_to_structure (event);
+    gst_structure_set_parent_refcount (structure,
+        &event->mini_object.refcount);
+
+    if (!g_atomic_pointer_compare_and_exchange (&impl->structure, NULL,
+            structure)) {
+      /* someone else was faster */
+      gst_structure_set_parent_refcount (structure, NULL);
+      gst_structure_free (structure);
+      structure = g_atomic_pointer_get (&impl->structure);
+    }
+  }
+  return structure;
+}
+
 /**
  * gst_event_new_custom:
  * @type: The type of the new event
@@ -295,7 +413,7 @@ gst_event_new_custom (GstEventType type, GstStructure * structure)
 {
   GstEventImpl *event;
 
-  event = g_slice_new0 (GstEventImpl);
+  event = priv_gst_mini_object_cache_alloc0 (sizeof (GstEventImpl));
 
   GST_CAT_DEBUG (GST_CAT_EVENT, "creating new event %p %s %d", event,
       gst_event_type_get_name (type), type);
@@ -316,7 +434,7 @@ gst_event_new_custom (GstEventType type, GstStructure * structure)
   /* ERRORS */
 had_parent:
   {
-    g_slice_free1 (sizeof (GstEventImpl), event);
+    priv_gst_mini_object_cache_free (event, sizeof (GstEventImpl));
     g_warning ("structure is already owned by another object");
     return NULL;
   }
@@ -339,7 +457,7 @@ gst_event_get_structure (GstEvent * event)
 {
   g_return_val_if_fail (GST_IS_EVENT (event), NULL);
 
-  return GST_EVENT_STRUCTURE (event);
+  return gst_event_ensure_structure (event);
 }
 
 /**
@@ -364,7 +482,7 @@ gst_event_writable_structure (GstEvent * event)
   g_return_val_if_fail (GST_IS_EVENT (event), NULL);
   g_return_val_if_fail (gst_event_is_writable (event), NULL);
 
-  structure = GST_EVENT_STRUCTURE (event);
+  structure = gst_event_ensure_structure (event);
 
   if (structure == NULL) {
     structure =
@@ -391,6 +509,10 @@ gst_event_has_name (GstEvent * event, const gchar * name)
 {
   g_return_val_if_fail (GST_IS_EVENT (event), FALSE);
 
+  if (GST_EVENT_IS_COMPACT (event))
+    return gst_event_compact_name (GST_EVENT_TYPE (event)) ==
+        g_quark_try_string (name);
+
   if (GST_EVENT_STRUCTURE (event) == NULL)
     return FALSE;
 
@@ -545,9 +667,8 @@ gst_event_new_flush_stop (gboolean reset_time)
 
   GST_CAT_INFO (GST_CAT_EVENT, "creating flush stop %d", reset_time);
 
-  event = gst_event_new_custom (GST_EVENT_FLUSH_STOP,
-      gst_structure_new_id (GST_QUARK (EVENT_FLUSH_STOP),
-          GST_QUARK (RESET_TIME), G_TYPE_BOOLEAN, reset_time, NULL));
+  event = gst_event_new_compact (GST_EVENT_FLUSH_STOP);
+  GST_EVENT_FIELDS (event).reset_time = reset_time;
 
   return event;
 }
@@ -567,6 +688,12 @@ gst_event_parse_flush_stop (GstEvent * event, gboolean * reset_time)
   g_return_if_fail (GST_IS_EVENT (event));
   g_return_if_fail (GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_STOP);
 
+  if (GST_EVENT_IS_COMPACT (event)) {
+    if (G_LIKELY (reset_time))
+      *reset_time = GST_EVENT_FIELDS (event).reset_time;
+    return;
+  }
+
   structure = GST_EVENT_STRUCTURE (event);
   if (G_LIKELY (reset_time))
     *reset_time =
@@ -624,10 +751,9 @@ gst_event_new_gap (GstClockTime timestamp, GstClockTime duration)
       GST_TIME_ARGS (timestamp), GST_TIME_ARGS (timestamp + duration),
       GST_TIME_ARGS (duration));
 
-  event = gst_event_new_custom (GST_EVENT_GAP,
-      gst_structure_new_id (GST_QUARK (EVENT_GAP),
-          GST_QUARK (TIMESTAMP), GST_TYPE_CLOCK_TIME, timestamp,
-          GST_QUARK (DURATION), GST_TYPE_CLOCK_TIME, duration, NULL));
+  event = gst_event_new_compact (GST_EVENT_GAP);
+  GST_EVENT_FIELDS (event).gap.timestamp = timestamp;
+  GST_EVENT_FIELDS (event).gap.duration = duration;
 
   return event;
 }
@@ -651,6 +777,14 @@ gst_event_parse_gap (GstEvent * event, GstClockTime * timestamp,
   g_return_if_fail (GST_IS_EVENT (event));
   g_return_if_fail (GST_EVENT_TYPE (event) == GST_EVENT_GAP);
 
+  if (GST_EVENT_IS_COMPACT (event)) {
+    if (timestamp)
+      *timestamp = GST_EVENT_FIELDS (event).gap.timestamp;
+    if (duration)
+      *duration = GST_EVENT_FIELDS (event).gap.duration;
+    return;
+  }
+
   structure = GST_EVENT_STRUCTURE (event);
   gst_structure_id_get (structure,
       GST_QUARK (TIMESTAMP), GST_TYPE_CLOCK_TIME, timestamp,
@@ -758,9 +892,8 @@ gst_event_new_segment (const GstSegment * segment)
   GST_CAT_INFO (GST_CAT_EVENT, "creating segment event %" GST_SEGMENT_FORMAT,
       segment);
 
-  event = gst_event_new_custom (GST_EVENT_SEGMENT,
-      gst_structure_new_id (GST_QUARK (EVENT_SEGMENT),
-          GST_QUARK (SEGMENT), GST_TYPE_SEGMENT, segment, NULL));
+  event = gst_event_new_compact (GST_EVENT_SEGMENT);
+  gst_segment_copy_into (segment, &GST_EVENT_FIELDS (event).segment);
 
   return event;
 }
@@ -783,6 +916,10 @@ gst_event_parse_segment (GstEvent * event, const GstSegment ** segment)
   g_return_if_fail (GST_EVENT_TYPE (event) == GST_EVENT_SEGMENT);
 
   if (segment) {
+    if (GST_EVENT_IS_COMPACT (event)) {
+      *segment = &GST_EVENT_FIELDS (event).segment;
+      return;
+    }
     structure = GST_EVENT_STRUCTURE (event);
     *segment = g_value_get_boxed (gst_structure_id_get_value (structure,
             GST_QUARK (SEGMENT)));
@@ -1238,14 +1375,12 @@ GstEvent *
 gst_event_new_latency (GstClockTime latency)
 {
   GstEvent *event;
-  GstStructure *structure;
 
   GST_CAT_INFO (GST_CAT_EVENT,
       "creating latency event %" GST_TIME_FORMAT, GST_TIME_ARGS (latency));
 
-  structure = gst_structure_new_id (GST_QUARK (EVENT_LATENCY),
-      GST_QUARK (LATENCY), G_TYPE_UINT64, latency, NULL);
-  event = gst_event_new_custom (GST_EVENT_LATENCY, structure);
+  event = gst_event_new_compact (GST_EVENT_LATENCY);
+  GST_EVENT_FIELDS (event).latency = latency;
 
   return event;
 }
@@ -1263,6 +1398,12 @@ gst_event_parse_latency (GstEvent * event, GstClockTime * latency)
   g_return_if_fail (GST_IS_EVENT (event));
   g_return_if_fail (GST_EVENT_TYPE (event) == GST_EVENT_LATENCY);
 
+  if (GST_EVENT_IS_COMPACT (event)) {
+    if (latency)
+      *latency = GST_EVENT_FIELDS (event).latency;
+    return;
+  }
+
   if (latency)
     *latency =
         g_value_get_uint64 (gst_structure_id_get_value (GST_EVENT_STRUCTURE
@@ -193,7 +193,7 @@ _gst_message_free (GstMessage * message)
     gst_structure_free (structure);
   }
 
-  g_slice_free1 (sizeof (GstMessageImpl), message);
+  priv_gst_mini_object_cache_free (message, sizeof (GstMessageImpl));
 }
 
 static void
@@ -210,7 +210,7 @@ _gst_message_copy (GstMessage * message)
       GST_MESSAGE_TYPE_NAME (message),
       GST_OBJECT_NAME (GST_MESSAGE_SRC (message)));
 
-  copy = g_slice_new0 (GstMessageImpl);
+  copy = priv_gst_mini_object_cache_alloc0 (sizeof (GstMessageImpl));
 
   gst_message_init (copy, GST_MESSAGE_TYPE (message),
       GST_MESSAGE_SRC (message));
@@ -268,7 +268,7 @@ gst_message_new_custom (GstMessageType type, GstObject * src,
 {
   GstMessageImpl *message;
 
-  message = g_slice_new0 (GstMessageImpl);
+  message = priv_gst_mini_object_cache_alloc0 (sizeof (GstMessageImpl));
 
   GST_CAT_LOG (GST_CAT_MESSAGE, "source %s: creating new message %p %s",
       (src ? GST_OBJECT_NAME (src) : "NULL"), message,
@@ -289,7 +289,7 @@ gst_message_new_custom (GstMessageType type, GstObject * src,
   /* ERRORS */
 had_parent:
   {
-    g_slice_free1 (sizeof (GstMessageImpl), message);
+    priv_gst_mini_object_cache_free (message, sizeof (GstMessageImpl));
     g_warning ("structure is already owned by another object");
     return NULL;
   }
@@ -89,16 +89,400 @@ typedef struct
 #define QDATA_DATA(o,i)     (QDATA(o,i).data)
 #define QDATA_DESTROY(o,i)  (QDATA(o,i).destroy)
 
+/* Allocation cache for the memory of mini objects and metadata.
+ *
+ * Freed blocks are kept in a per thread cache, sorted in size classes of
+ * CACHE_ALIGN bytes, and handed out again without going through the slice
+ * allocator. Blocks larger than CACHE_MAX_SIZE are not cached.
+ *
+ * Objects are often allocated in one thread and freed in another, when a
+ * thread has more than two magazines of CACHE_MAGAZINE_SIZE blocks of a
+ * class, one magazine is moved to a global depot where threads that run
+ * out of blocks pick it up.
+ *
+ * The number of blocks in all threads and the depot is limited by
+ * cache_limit, threads reserve their share in chunks of CACHE_MAGAZINE_SIZE
+ * blocks so that the global counter is only touched once in a while. */
+#define CACHE_ALIGN          16
+#define CACHE_N_CLASSES      32
+#define CACHE_MAX_SIZE       (CACHE_ALIGN * CACHE_N_CLASSES)
+#define CACHE_CLASS(size)    (((size) - 1) / CACHE_ALIGN)
+#define CACHE_CLASS_SIZE(c)  (((c) + 1) * CACHE_ALIGN)
+#define CACHE_MAGAZINE_SIZE  32
+#define CACHE_DEFAULT_LIMIT  4096
+
+typedef struct _GstCacheBlock GstCacheBlock;
+
+/* fits in the smallest size class */
+struct _GstCacheBlock
+{
+  GstCacheBlock *next;
+  /* links the magazines in the depot */
+  GstCacheBlock *next_magazine;
+};
+
+typedef struct
+{
+  GstCacheBlock *blocks[CACHE_N_CLASSES];
+  guint n_blocks[CACHE_N_CLASSES];
+  guint cached;
+  guint quota;
+
+  guint64 allocs;
+  guint64 hits;
+  guint64 frees;
+} GstMiniObjectCache;
+
+static void gst_mini_object_cache_destroy (gpointer data);
+
+static GPrivate cache_private = G_PRIVATE_INIT (gst_mini_object_cache_destroy);
+static volatile gint cache_limit = CACHE_DEFAULT_LIMIT;
+/* the quota of all threads plus the blocks in the depot */
+static volatile gint cache_reserved = 0;
+
+/* protects the depot, the list of caches and the stats of exited threads */
+static GMutex cache_lock;
+static GstCacheBlock *depot[CACHE_N_CLASSES];
+static GList *caches = NULL;
+static guint64 exited_allocs = 0;
+static guint64 exited_hits = 0;
+static guint64 exited_frees = 0;
+
+static GstMiniObjectCache *
+gst_mini_object_cache_get (void)
+{
+  GstMiniObjectCache *cache;
+
+  cache = g_private_get (&cache_private);
+  if (G_UNLIKELY (cache == NULL)) {
+    cache = g_new0 (GstMiniObjectCache, 1);
+    g_private_set (&cache_private, cache);
+
+    g_mutex_lock (&cache_lock);
+    caches = g_list_prepend (caches, cache);
+    g_mutex_unlock (&cache_lock);
+  }
+  return cache;
+}
+
+static void
+gst_mini_object_cache_free_blocks (GstCacheBlock * block, guint cls)
+{
+  GstCacheBlock *next;
+
+  for (; block; block = next) {
+    next = block->next;
+    g_slice_free1 (CACHE_CLASS_SIZE (cls), block);
+  }
+}
+
+static void
+gst_mini_object_cache_flush (GstMiniObjectCache * cache)
+{
+  guint i;
+
+  for (i = 0; i < CACHE_N_CLASSES; i++) {
+    gst_mini_object_cache_free_blocks (cache->blocks[i], i);
+    cache->blocks[i] = NULL;
+    cache->n_blocks[i] = 0;
+  }
+  cache->cached = 0;
+
+  g_atomic_int_add (&cache_reserved, -(gint) cache->quota);
+  cache->quota = 0;
+}
+
+static void
+gst_mini_object_cache_destroy (gpointer data)
+{
+  GstMiniObjectCache *cache = data;
+
+  gst_mini_object_cache_flush (cache);
+
+  g_mutex_lock (&cache_lock);
+  caches = g_list_remove (caches, cache);
+  exited_allocs += cache->allocs;
+  exited_hits += cache->hits;
+  exited_frees += cache->frees;
+  g_mutex_unlock (&cache_lock);
+
+  g_free (cache);
+}
+
+/* take another chunk of the global limit for this thread */
+static gboolean
+gst_mini_object_cache_reserve (GstMiniObjectCache * cache)
+{
+  gint reserved, limit;
+
+  limit = g_atomic_int_get (&cache_limit);
+  do {
+    reserved = g_atomic_int_get (&cache_reserved);
+    if (reserved + CACHE_MAGAZINE_SIZE > limit)
+      return FALSE;
+  } while (!g_atomic_int_compare_and_exchange (&cache_reserved, reserved,
+          reserved + CACHE_MAGAZINE_SIZE));
+
+  cache->quota += CACHE_MAGAZINE_SIZE;
+  return TRUE;
+}
+
+/* move one magazine of blocks to the depot, the reservation for the blocks
+ * moves along */
+static void
+gst_mini_object_cache_put_magazine (GstMiniObjectCache * cache, guint cls)
+{
+  GstCacheBlock *magazine, *last;
+  guint i;
+
+  magazine = last = cache->blocks[cls];
+  for (i = 1; i < CACHE_MAGAZINE_SIZE; i++)
+    last = last->next;
+  cache->blocks[cls] = last->next;
+  last->next = NULL;
+
+  cache->n_blocks[cls] -= CACHE_MAGAZINE_SIZE;
+  cache->cached -= CACHE_MAGAZINE_SIZE;
+  cache->quota -= CACHE_MAGAZINE_SIZE;
+
+  g_mutex_lock (&cache_lock);
+  magazine->next_magazine = depot[cls];
+  depot[cls] = magazine;
+  g_mutex_unlock (&cache_lock);
+}
+
+static gboolean
+gst_mini_object_cache_get_magazine (GstMiniObjectCache * cache, guint cls)
+{
+  GstCacheBlock *magazine;
+
+  g_mutex_lock (&cache_lock);
+  magazine = depot[cls];
+  if (magazine)
+    depot[cls] = magazine->next_magazine;
+  g_mutex_unlock (&cache_lock);
+
+  if (magazine == NULL)
+    return FALSE;
+
+  cache->blocks[cls] = magazine;
+  cache->n_blocks[cls] = CACHE_MAGAZINE_SIZE;
+  cache->cached += CACHE_MAGAZINE_SIZE;
+  cache->quota += CACHE_MAGAZINE_SIZE;
+
+  return TRUE;
+}
+
+/* Allocates @size bytes for a mini object or metadata, the memory must be
+ * released with priv_gst_mini_object_cache_free() with the same @size. */
+gpointer
+priv_gst_mini_object_cache_alloc (gsize size)
+{
+  GstMiniObjectCache *cache;
+  GstCacheBlock *block;
+  guint cls;
+
+  if (G_UNLIKELY (size > CACHE_MAX_SIZE))
+    return g_slice_alloc (size);
+
+  cls = CACHE_CLASS (size);
+  cache = gst_mini_object_cache_get ();
+  cache->allocs++;
+
+  if (G_UNLIKELY (cache->blocks[cls] == NULL)
+      && (depot[cls] == NULL || !gst_mini_object_cache_get_magazine (cache,
+              cls))) {
+    /* always allocate the full class size so that the block can be reused
+     * for every size in the class */
+    return g_slice_alloc (CACHE_CLASS_SIZE (cls));
+  }
+
+  block = cache->blocks[cls];
+  cache->blocks[cls] = block->next;
+  cache->n_blocks[cls]--;
+  cache->cached--;
+  cache->hits++;
+
+  /* give back what we don't need anymore */
+  if (G_UNLIKELY (cache->quota - cache->cached > 2 * CACHE_MAGAZINE_SIZE)) {
+    cache->quota -= CACHE_MAGAZINE_SIZE;
+    g_atomic_int_add (&cache_reserved, -CACHE_MAGAZINE_SIZE);
+  }
+  return block;
+}
+
+gpointer
+priv_gst_mini_object_cache_alloc0 (gsize size)
+{
+  gpointer mem;
+
+  mem = priv_gst_mini_object_cache_alloc (size);
+  memset (mem, 0, size);
+
+  return mem;
+}
+
+void
+priv_gst_mini_object_cache_free (gpointer mem, gsize size)
+{
+  GstMiniObjectCache *cache;
+  GstCacheBlock *block;
+  guint cls;
+
+  if (G_UNLIKELY (size > CACHE_MAX_SIZE)) {
+    g_slice_free1 (size, mem);
+    return;
+  }
+
+  cls = CACHE_CLASS (size);
+  cache = gst_mini_object_cache_get ();
+  cache->frees++;
+
+  /* this thread frees more than it allocates, let others have some */
+  if (G_UNLIKELY (cache->n_blocks[cls] >= 2 * CACHE_MAGAZINE_SIZE))
+    gst_mini_object_cache_put_magazine (cache, cls);
+
+  if (G_UNLIKELY (cache->cached >= cache->quota)
+      && !gst_mini_object_cache_reserve (cache)) {
+    g_slice_free1 (CACHE_CLASS_SIZE (cls), mem);
+    return;
+  }
+
+  block = mem;
+  block->next = cache->blocks[cls];
+  cache->blocks[cls] = block;
+  cache->n_blocks[cls]++;
+  cache->cached++;
+}
+
+/**
+ * gst_mini_object_get_cache_stats:
+ * @allocations: (out) (allow-none): location for the number of allocations
+ * @hits: (out) (allow-none): location for the number of allocations that
+ *     were served from the cache
+ * @frees: (out) (allow-none): location for the number of frees
+ * @cached: (out) (allow-none): location for the number of blocks that are
+ *     currently cached in all threads and the shared depot
+ *
+ * Gets statistics about the cache that recycles the memory of buffers
+ * without a pool, events, messages and buffer metadata. The counters cover
+ * all threads since the start of the process, the values of running threads
+ * are read without synchronisation and are only approximate.
+ *
+ * Since: 1.6
+ */
+void
+gst_mini_object_get_cache_stats (guint64 * allocations, guint64 * hits,
+    guint64 * frees, guint * cached)
+{
+  guint64 a, h, f;
+  guint c = 0, i;
+  GstCacheBlock *magazine;
+  GList *walk;
+
+  g_mutex_lock (&cache_lock);
+  a = exited_allocs;
+  h = exited_hits;
+  f = exited_frees;
+  for (walk = caches; walk; walk = walk->next) {
+    GstMiniObjectCache *cache = walk->data;
+
+    a += cache->allocs;
+    h += cache->hits;
+    f += cache->frees;
+    c += cache->cached;
+  }
+  for (i = 0; i < CACHE_N_CLASSES; i++) {
+    for (magazine = depot[i]; magazine; magazine = magazine->next_magazine)
+      c += CACHE_MAGAZINE_SIZE;
+  }
+  g_mutex_unlock (&cache_lock);
+
+  if (allocations)
+    *allocations = a;
+  if (hits)
+    *hits = h;
+  if (frees)
+    *frees = f;
+  if (cached)
+    *cached = c;
+}
+
+/**
+ * gst_mini_object_set_cache_limit:
+ * @limit: the maximum number of blocks to cache
+ *
+ * Sets the maximum number of freed buffers, events, messages and metadata
+ * blocks that are kept over all threads for reuse. A @limit of 0 disables
+ * the cache. Lowering the limit does not release the blocks that are
+ * already cached, threads give them back while they allocate.
+ *
+ * The default limit is 4096, it is 0 when the G_SLICE environment variable
+ * contains "always-malloc" so that memory debuggers see every allocation.
+ *
+ * Since: 1.6
+ */
+void
+gst_mini_object_set_cache_limit (guint limit)
+{
+  g_atomic_int_set (&cache_limit, MIN (limit, G_MAXINT));
+}
+
+/**
+ * gst_mini_object_get_cache_limit:
+ *
+ * Gets the limit set with gst_mini_object_set_cache_limit().
+ *
+ * Returns: the maximum number of cached blocks
+ *
+ * Since: 1.6
+ */
+guint
+gst_mini_object_get_cache_limit (void)
+{
+  return g_atomic_int_get (&cache_limit);
+}
+
 void
 _priv_gst_mini_object_initialize (void)
 {
+  const gchar *slice;
+
   weak_ref_quark = g_quark_from_static_string ("GstMiniObjectWeakRefQuark");
 
+  slice = g_getenv ("G_SLICE");
+  if (slice != NULL && strstr (slice, "always-malloc") != NULL)
+    gst_mini_object_set_cache_limit (0);
+
 #ifndef GST_DISABLE_TRACE
   _gst_mini_object_trace = _gst_alloc_trace_register ("GstMiniObject", 0);
 #endif
 }
 
+void
+_priv_gst_mini_object_cleanup (void)
+{
+  GstMiniObjectCache *cache;
+  GstCacheBlock *magazine, *next;
+  guint i;
+
+  /* other threads flush their cache when they exit */
+  cache = g_private_get (&cache_private);
+  if (cache)
+    gst_mini_object_cache_flush (cache);
+
+  g_mutex_lock (&cache_lock);
+  for (i = 0; i < CACHE_N_CLASSES; i++) {
+    for (magazine = depot[i]; magazine; magazine = next) {
+      next = magazine->next_magazine;
+      gst_mini_object_cache_free_blocks (magazine, i);
+      g_atomic_int_add (&cache_reserved, -CACHE_MAGAZINE_SIZE);
+    }
+    depot[i] = NULL;
+  }
+  g_mutex_unlock (&cache_lock);
+}
+
 /**
  * gst_mini_object_init: (skip)
  * @mini_object: a #GstMiniObject
@@ -257,6 +257,12 @@ gboolean        gst_mini_object_replace         (GstMiniObject **olddata, GstMin
 gboolean        gst_mini_object_take            (GstMiniObject **olddata, GstMiniObject *newdata);
 GstMiniObject * gst_mini_object_steal           (GstMiniObject **olddata);
 
+/* allocation cache */
+void            gst_mini_object_get_cache_stats (guint64 *allocations, guint64 *hits,
+                                                 guint64 *frees, guint *cached);
+void            gst_mini_object_set_cache_limit (guint limit);
+guint           gst_mini_object_get_cache_limit (void);
+
 /**
  * GST_DEFINE_MINI_OBJECT_TYPE:
  * @TypeName: name of the new type in CamelCase
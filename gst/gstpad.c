@@ -121,6 +121,9 @@ enum
 #define GST_PAD_GET_PRIVATE(obj)  \
    (G_TYPE_INSTANCE_GET_PRIVATE ((obj), GST_TYPE_PAD, GstPadPrivate))
 
+/* number of sticky event types with their own bit in the event_types mask */
+#define N_STICKY_SLOTS 9
+
 /* we have a pending and an active event on the pad. On source pads only the
  * active event is used. On sinkpads, events are copied to the pending entry and
  * moved to the active event when the eventfunc returned %TRUE. */
@@ -135,6 +138,14 @@ struct _GstPadPrivate
   guint events_cookie;
   GArray *events;
   guint last_cookie;
+  /* sticky_type_bit() of all event types in events */
+  guint32 event_types;
+  /* sticky_type_bit() of the types with an event that was not received
+   * downstream yet. May have stale bits set, never misses one */
+  guint32 pending_types;
+  /* index in events of the single-instance types, valid when the type bit
+   * is set in event_types */
+  guint8 type_slots[N_STICKY_SLOTS];
 
   gint using;
   guint probe_list_cookie;
@@ -392,6 +403,78 @@ gst_pad_init (GstPad * pad)
   pad->ABI.abi.last_flowret = GST_FLOW_FLUSHING;
 }
 
+/* Slot of a sticky event type in the event_types mask of the pad. This lets us
+ * answer whether an event type is on the pad without walking the array. All
+ * unknown types share the last bit and have no slot. */
+static inline guint
+sticky_type_slot (GstEventType type)
+{
+  switch (type) {
+    case GST_EVENT_STREAM_START:
+      return 0;
+    case GST_EVENT_CAPS:
+      return 1;
+    case GST_EVENT_SEGMENT:
+      return 2;
+    case GST_EVENT_TAG:
+      return 3;
+    case GST_EVENT_BUFFERSIZE:
+      return 4;
+    case GST_EVENT_SINK_MESSAGE:
+      return 5;
+    case GST_EVENT_EOS:
+      return 6;
+    case GST_EVENT_TOC:
+      return 7;
+    case GST_EVENT_CUSTOM_DOWNSTREAM_STICKY:
+      return 8;
+    default:
+      return 31;
+  }
+}
+
+static inline guint32
+sticky_type_bit (GstEventType type)
+{
+  return 1U << sticky_type_slot (type);
+}
+
+#define HAS_EVENT_TYPE(pad,type) \
+    (((pad)->priv->event_types & sticky_type_bit (type)) != 0)
+
+/* recalculate the event_types and pending_types masks and the slots of the
+ * single-instance types after events were inserted, removed or replaced.
+ * should be called with object lock */
+static void
+update_event_types (GstPad * pad)
+{
+  guint i, len, slot;
+  GArray *events;
+  guint32 types = 0, pending = 0;
+
+  events = pad->priv->events;
+  len = events->len;
+
+  for (i = 0; i < len; i++) {
+    PadEvent *ev = &g_array_index (events, PadEvent, i);
+    GstEventType type;
+
+    if (ev->event == NULL)
+      continue;
+
+    type = GST_EVENT_TYPE (ev->event);
+    slot = sticky_type_slot (type);
+    types |= 1U << slot;
+    if (!ev->received)
+      pending |= 1U << slot;
+    if (slot < N_STICKY_SLOTS && !(type & GST_EVENT_TYPE_STICKY_MULTI)
+        && i <= G_MAXUINT8)
+      pad->priv->type_slots[slot] = i;
+  }
+  pad->priv->event_types = types;
+  pad->priv->pending_types = pending;
+}
+
 /* called when setting the pad inactive. It removes all sticky events from
  * the pad. must be called with object lock */
 static void
@@ -418,6 +501,8 @@ remove_events (GstPad * pad)
 
   GST_OBJECT_FLAG_UNSET (pad, GST_PAD_FLAG_PENDING_EVENTS);
   g_array_set_size (events, 0);
+  pad->priv->event_types = 0;
+  pad->priv->pending_types = 0;
   pad->priv->events_cookie++;
 
   if (notify) {
@@ -438,7 +523,24 @@ find_event_by_type (GstPad * pad, GstEventType type, guint idx)
   GArray *events;
   PadEvent *ev;
 
+  if (!HAS_EVENT_TYPE (pad, type))
+    return NULL;
+
   events = pad->priv->events;
+
+  /* single-instance types are found through their slot */
+  if (idx == 0 && !(type & GST_EVENT_TYPE_STICKY_MULTI)) {
+    i = sticky_type_slot (type);
+    if (i < N_STICKY_SLOTS) {
+      i = pad->priv->type_slots[i];
+      if (i < events->len) {
+        ev = &g_array_index (events, PadEvent, i);
+        if (ev->event && GST_EVENT_TYPE (ev->event) == type)
+          return ev;
+      }
+    }
+  }
+
   len = events->len;
 
   for (i = 0; i < len; i++) {
@@ -486,6 +588,9 @@ remove_event_by_type (GstPad * pad, GstEventType type)
   GArray *events;
   PadEvent *ev;
 
+  if (!HAS_EVENT_TYPE (pad, type))
+    return;
+
   events = pad->priv->events;
   len = events->len;
 
@@ -507,6 +612,7 @@ remove_event_by_type (GstPad * pad, GstEventType type)
   next:
     i++;
   }
+  update_event_types (pad);
 }
 
 /* check all events on srcpad against those on sinkpad. All events that are not
@@ -531,6 +637,8 @@ schedule_events (GstPad * srcpad, GstPad * sinkpad)
 
     if (sinkpad == NULL || !find_event (sinkpad, ev->event)) {
       ev->received = FALSE;
+      srcpad->priv->pending_types |=
+          sticky_type_bit (GST_EVENT_TYPE (ev->event));
       pending = TRUE;
     }
   }
@@ -549,6 +657,7 @@ events_foreach (GstPad * pad, PadEventFunction func, gpointer user_data)
   GArray *events;
   gboolean ret;
   guint cookie;
+  gboolean changed = FALSE;
 
   events = pad->priv->events;
 
@@ -579,6 +688,8 @@ restart:
 
     /* store the received state */
     ev->received = ev_ret.received;
+    if (!ev->received)
+      pad->priv->pending_types |= sticky_type_bit (GST_EVENT_TYPE (ev->event));
 
     /* if the event changed, we need to do something */
     if (G_UNLIKELY (ev->event != ev_ret.event)) {
@@ -588,10 +699,12 @@ restart:
         g_array_remove_index (events, i);
         len--;
         cookie = ++pad->priv->events_cookie;
+        changed = TRUE;
         continue;
       } else {
         /* function gave a new event for us */
         gst_event_take (&ev->event, ev_ret.event);
+        changed = TRUE;
       }
     } else {
       /* just unref, nothing changed */
@@ -602,6 +715,8 @@ restart:
   next:
     i++;
   }
+  if (changed)
+    update_event_types (pad);
 }
 
 /* should be called with LOCK */
@@ -3372,6 +3487,7 @@ static gboolean
 mark_event_not_received (GstPad * pad, PadEvent * ev, gpointer user_data)
 {
   ev->received = FALSE;
+  pad->priv->pending_types |= sticky_type_bit (GST_EVENT_TYPE (ev->event));
   return TRUE;
 }
 
@@ -3485,6 +3601,61 @@ push_sticky (GstPad * pad, PadEvent * ev, gpointer user_data)
   return data->ret == GST_FLOW_OK;
 }
 
+/* should be called with pad LOCK. Like events_foreach() with push_sticky() but
+ * events that were already received downstream are skipped without taking a
+ * reference or calling out, and nothing is walked when the pending_types mask
+ * says all events were received. */
+static void
+push_pending_events (GstPad * pad, PushStickyData * data)
+{
+  guint i;
+  GArray *events;
+  gboolean ret;
+  guint cookie;
+  guint32 pending;
+
+  if (pad->priv->pending_types == 0)
+    return;
+
+  events = pad->priv->events;
+
+restart:
+  cookie = pad->priv->events_cookie;
+  pending = 0;
+  for (i = 0; i < events->len; i++) {
+    PadEvent *ev, ev_ret;
+
+    ev = &g_array_index (events, PadEvent, i);
+    if (ev->event == NULL || ev->received)
+      continue;
+
+    /* take aditional ref, pushing releases the lock */
+    ev_ret.event = gst_event_ref (ev->event);
+    ev_ret.received = FALSE;
+
+    ret = push_sticky (pad, &ev_ret, data);
+
+    /* recheck the cookie, the list could have changed while unlocked */
+    if (G_UNLIKELY (cookie != pad->priv->events_cookie)) {
+      gst_event_unref (ev_ret.event);
+      goto restart;
+    }
+
+    ev->received = ev_ret.received;
+    gst_event_unref (ev_ret.event);
+
+    if (!ev->received)
+      pending |= sticky_type_bit (GST_EVENT_TYPE (ev->event));
+
+    /* keep the mask as it is, the events after this one were not checked */
+    if (!ret)
+      return;
+  }
+  /* the whole array was walked, only the events that are still not received
+   * are left in the mask */
+  pad->priv->pending_types = pending;
+}
+
 /* check sticky events and push them when needed. should be called
  * with pad LOCK */
 static inline GstFlowReturn
@@ -3496,7 +3667,7 @@ check_sticky (GstPad * pad, GstEvent * event)
     GST_OBJECT_FLAG_UNSET (pad, GST_PAD_FLAG_PENDING_EVENTS);
 
     GST_DEBUG_OBJECT (pad, "pushing all sticky events");
-    events_foreach (pad, push_sticky, &data);
+    push_pending_events (pad, &data);
 
     /* If there's an EOS event we must push it downstream
      * even if sending a previous sticky event failed.
@@ -3791,12 +3962,12 @@ gst_pad_chain_data_unchecked (GstPad * pad, GstPadProbeType type, void *data)
 
 #ifndef G_DISABLE_ASSERT
   if (G_UNLIKELY (pad->priv->last_cookie != pad->priv->events_cookie)) {
-    if (!find_event_by_type (pad, GST_EVENT_STREAM_START, 0)) {
+    if (!HAS_EVENT_TYPE (pad, GST_EVENT_STREAM_START)) {
       g_warning (G_STRLOC
           ":%s:<%s:%s> Got data flow before stream-start event",
           G_STRFUNC, GST_DEBUG_PAD_NAME (pad));
     }
-    if (!find_event_by_type (pad, GST_EVENT_SEGMENT, 0)) {
+    if (!HAS_EVENT_TYPE (pad, GST_EVENT_SEGMENT)) {
       g_warning (G_STRLOC
           ":%s:<%s:%s> Got data flow before segment event",
           G_STRFUNC, GST_DEBUG_PAD_NAME (pad));
@@ -4025,12 +4196,12 @@ gst_pad_push_data (GstPad * pad, GstPadProbeType type, void *data)
 
 #ifndef G_DISABLE_ASSERT
   if (G_UNLIKELY (pad->priv->last_cookie != pad->priv->events_cookie)) {
-    if (!find_event_by_type (pad, GST_EVENT_STREAM_START, 0)) {
+    if (!HAS_EVENT_TYPE (pad, GST_EVENT_STREAM_START)) {
       g_warning (G_STRLOC
           ":%s:<%s:%s> Got data flow before stream-start event",
           G_STRFUNC, GST_DEBUG_PAD_NAME (pad));
     }
-    if (!find_event_by_type (pad, GST_EVENT_SEGMENT, 0)) {
+    if (!HAS_EVENT_TYPE (pad, GST_EVENT_SEGMENT)) {
       g_warning (G_STRLOC
           ":%s:<%s:%s> Got data flow before segment event",
           G_STRFUNC, GST_DEBUG_PAD_NAME (pad));
@@ -4635,8 +4806,10 @@ store_sticky_event (GstPad * pad, GstEvent * event)
         continue;
 
       /* overwrite */
-      if ((res = gst_event_replace (&ev->event, event)))
+      if ((res = gst_event_replace (&ev->event, event))) {
         ev->received = FALSE;
+        pad->priv->pending_types |= sticky_type_bit (type);
+      }
 
       insert = FALSE;
       break;
@@ -4661,6 +4834,8 @@ store_sticky_event (GstPad * pad, GstEvent * event)
     ev.event = gst_event_ref (event);
     ev.received = FALSE;
     g_array_insert_val (events, i, ev);
+    /* the events after i moved, recalculate the slots */
+    update_event_types (pad);
     res = TRUE;
   }
 
@@ -5532,7 +5707,13 @@ gst_pad_start_task (GstPad * pad, GstTaskFunction func, gpointer user_data,
   GST_OBJECT_LOCK (pad);
   task = GST_PAD_TASK (pad);
   if (task == NULL) {
+    gchar *name;
+
     task = gst_task_new (func, user_data, notify);
+    /* the task names its thread after itself */
+    name = g_strdup_printf ("%s:%s", GST_DEBUG_PAD_NAME (pad));
+    gst_object_set_name (GST_OBJECT_CAST (task), name);
+    g_free (name);
     gst_task_set_lock (task, GST_PAD_GET_STREAM_LOCK (pad));
     gst_task_set_enter_callback (task, pad_enter_thread, pad, NULL);
     gst_task_set_leave_callback (task, pad_leave_thread, pad, NULL);
@@ -72,9 +72,33 @@ typedef struct
   GstQuery query;
 
   GstStructure *structure;
+
+  /* The frequent query types keep their fields here instead of in a
+   * structure. The structure is only created when someone asks for it, from
+   * then on it is used for all the fields. */
+  gboolean compact;
+  union
+  {
+    struct
+    {
+      GstFormat format;
+      gint64 value;
+    } position;                 /* POSITION and DURATION */
+    struct
+    {
+      gboolean live;
+      GstClockTime min_latency;
+      GstClockTime max_latency;
+    } latency;                  /* LATENCY */
+  } fields;
 } GstQueryImpl;
 
 #define GST_QUERY_STRUCTURE(q)  (((GstQueryImpl *)(q))->structure)
+#define GST_QUERY_FIELDS(q)     (((GstQueryImpl *)(q))->fields)
+
+/* TRUE when the fields of @q are in the fixed layout storage */
+#define GST_QUERY_IS_COMPACT(q) \
+    (((GstQueryImpl *)(q))->compact && GST_QUERY_STRUCTURE (q) == NULL)
 
 
 typedef struct
@@ -210,9 +234,81 @@ _gst_query_copy (GstQuery * query)
   }
   copy = gst_query_new_custom (query->type, s);
 
+  ((GstQueryImpl *) copy)->compact = ((GstQueryImpl *) query)->compact;
+  if (((GstQueryImpl *) copy)->compact)
+    GST_QUERY_FIELDS (copy) = GST_QUERY_FIELDS (query);
+
   return copy;
 }
 
+/* create a query of one of the types that keep their fields in the fixed
+ * layout storage, the caller fills in the fields */
+static GstQuery *
+gst_query_new_compact (GstQueryType type)
+{
+  GstQuery *query;
+
+  query = gst_query_new_custom (type, NULL);
+  ((GstQueryImpl *) query)->compact = TRUE;
+
+  return query;
+}
+
+static GstStructure *
+gst_query_compact_to_structure (GstQuery * query)
+{
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_POSITION:
+      return gst_structure_new_id (GST_QUARK (QUERY_POSITION),
+          GST_QUARK (FORMAT), GST_TYPE_FORMAT,
+          GST_QUERY_FIELDS (query).position.format,
+          GST_QUARK (CURRENT), G_TYPE_INT64,
+          GST_QUERY_FIELDS (query).position.value, NULL);
+    case GST_QUERY_DURATION:
+      return gst_structure_new_id (GST_QUARK (QUERY_DURATION),
+          GST_QUARK (FORMAT), GST_TYPE_FORMAT,
+          GST_QUERY_FIELDS (query).position.format,
+          GST_QUARK (DURATION), G_TYPE_INT64,
+          GST_QUERY_FIELDS (query).position.value, NULL);
+    case GST_QUERY_LATENCY:
+      return gst_structure_new_id (GST_QUARK (QUERY_LATENCY),
+          GST_QUARK (LIVE), G_TYPE_BOOLEAN,
+          GST_QUERY_FIELDS (query).latency.live,
+          GST_QUARK (MIN_LATENCY), G_TYPE_UINT64,
+          GST_QUERY_FIELDS (query).latency.min_latency,
+          GST_QUARK (MAX_LATENCY), G_TYPE_UINT64,
+          GST_QUERY_FIELDS (query).latency.max_latency, NULL);
+    default:
+      g_assert_not_reached ();
+      return NULL;
+  }
+}
+
+/* get the structure of @query, creating it from the fixed layout storage
+ * when needed */
+static GstStructure *
+gst_query_ensure_structure (GstQuery * query)
+{
+  GstQueryImpl *impl = (GstQueryImpl *) query;
+  GstStructure *structure;
+
+  structure = g_atomic_pointer_get (&impl->structure);
+  if (structure == NULL && impl->compact) {
+    structure = gst_query_compact_to_structure (query);
+    gst_structure_set_parent_refcount (structure,
+        &query->mini_object.refcount);
+
+    if (!g_atomic_pointer_compare_and_exchange (&impl->structure, NULL,
+            structure)) {
+      /* someone else was faster */
+      gst_structure_set_parent_refcount (structure, NULL);
+      gst_structure_free (structure);
+      structure = g_atomic_pointer_get (&impl->structure);
+    }
+  }
+  return structure;
+}
+
 /**
  * gst_query_new_position:
  * @format: the default #GstFormat for the new query
@@ -229,13 +325,10 @@ GstQuery *
 gst_query_new_position (GstFormat format)
 {
   GstQuery *query;
-  GstStructure *structure;
-
-  structure = gst_structure_new_id (GST_QUARK (QUERY_POSITION),
-      GST_QUARK (FORMAT), GST_TYPE_FORMAT, format,
-      GST_QUARK (CURRENT), G_TYPE_INT64, G_GINT64_CONSTANT (-1), NULL);
 
-  query = gst_query_new_custom (GST_QUERY_POSITION, structure);
+  query = gst_query_new_compact (GST_QUERY_POSITION);
+  GST_QUERY_FIELDS (query).position.format = format;
+  GST_QUERY_FIELDS (query).position.value = -1;
 
   return query;
 }
@@ -255,6 +348,12 @@ gst_query_set_position (GstQuery * query, GstFormat format, gint64 cur)
 
   g_return_if_fail (GST_QUERY_TYPE (query) == GST_QUERY_POSITION);
 
+  if (GST_QUERY_IS_COMPACT (query)) {
+    g_return_if_fail (format == GST_QUERY_FIELDS (query).position.format);
+    GST_QUERY_FIELDS (query).position.value = cur;
+    return;
+  }
+
   s = GST_QUERY_STRUCTURE (query);
   g_return_if_fail (format == g_value_get_enum (gst_structure_id_get_value (s,
               GST_QUARK (FORMAT))));
@@ -281,6 +380,14 @@ gst_query_parse_position (GstQuery * query, GstFormat * format, gint64 * cur)
 
   g_return_if_fail (GST_QUERY_TYPE (query) == GST_QUERY_POSITION);
 
+  if (GST_QUERY_IS_COMPACT (query)) {
+    if (format)
+      *format = GST_QUERY_FIELDS (query).position.format;
+    if (cur)
+      *cur = GST_QUERY_FIELDS (query).position.value;
+    return;
+  }
+
   structure = GST_QUERY_STRUCTURE (query);
   if (format)
     *format =
@@ -308,13 +415,10 @@ GstQuery *
 gst_query_new_duration (GstFormat format)
 {
   GstQuery *query;
-  GstStructure *structure;
-
-  structure = gst_structure_new_id (GST_QUARK (QUERY_DURATION),
-      GST_QUARK (FORMAT), GST_TYPE_FORMAT, format,
-      GST_QUARK (DURATION), G_TYPE_INT64, G_GINT64_CONSTANT (-1), NULL);
 
-  query = gst_query_new_custom (GST_QUERY_DURATION, structure);
+  query = gst_query_new_compact (GST_QUERY_DURATION);
+  GST_QUERY_FIELDS (query).position.format = format;
+  GST_QUERY_FIELDS (query).position.value = -1;
 
   return query;
 }
@@ -334,6 +438,12 @@ gst_query_set_duration (GstQuery * query, GstFormat format, gint64 duration)
 
   g_return_if_fail (GST_QUERY_TYPE (query) == GST_QUERY_DURATION);
 
+  if (GST_QUERY_IS_COMPACT (query)) {
+    g_return_if_fail (format == GST_QUERY_FIELDS (query).position.format);
+    GST_QUERY_FIELDS (query).position.value = duration;
+    return;
+  }
+
   s = GST_QUERY_STRUCTURE (query);
   g_return_if_fail (format == g_value_get_enum (gst_structure_id_get_value (s,
               GST_QUARK (FORMAT))));
@@ -359,6 +469,14 @@ gst_query_parse_duration (GstQuery * query, GstFormat * format,
 
   g_return_if_fail (GST_QUERY_TYPE (query) == GST_QUERY_DURATION);
 
+  if (GST_QUERY_IS_COMPACT (query)) {
+    if (format)
+      *format = GST_QUERY_FIELDS (query).position.format;
+    if (duration)
+      *duration = GST_QUERY_FIELDS (query).position.value;
+    return;
+  }
+
   structure = GST_QUERY_STRUCTURE (query);
   if (format)
     *format =
@@ -385,14 +503,11 @@ GstQuery *
 gst_query_new_latency (void)
 {
   GstQuery *query;
-  GstStructure *structure;
 
-  structure = gst_structure_new_id (GST_QUARK (QUERY_LATENCY),
-      GST_QUARK (LIVE), G_TYPE_BOOLEAN, FALSE,
-      GST_QUARK (MIN_LATENCY), G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
-      GST_QUARK (MAX_LATENCY), G_TYPE_UINT64, G_GUINT64_CONSTANT (-1), NULL);
-
-  query = gst_query_new_custom (GST_QUERY_LATENCY, structure);
+  query = gst_query_new_compact (GST_QUERY_LATENCY);
+  GST_QUERY_FIELDS (query).latency.live = FALSE;
+  GST_QUERY_FIELDS (query).latency.min_latency = 0;
+  GST_QUERY_FIELDS (query).latency.max_latency = GST_CLOCK_TIME_NONE;
 
   return query;
 }
@@ -414,6 +529,13 @@ gst_query_set_latency (GstQuery * query, gboolean live,
 
   g_return_if_fail (GST_QUERY_TYPE (query) == GST_QUERY_LATENCY);
 
+  if (GST_QUERY_IS_COMPACT (query)) {
+    GST_QUERY_FIELDS (query).latency.live = live;
+    GST_QUERY_FIELDS (query).latency.min_latency = min_latency;
+    GST_QUERY_FIELDS (query).latency.max_latency = max_latency;
+    return;
+  }
+
   structure = GST_QUERY_STRUCTURE (query);
   gst_structure_id_set (structure,
       GST_QUARK (LIVE), G_TYPE_BOOLEAN, live,
@@ -438,6 +560,16 @@ gst_query_parse_latency (GstQuery * query, gboolean * live,
 
   g_return_if_fail (GST_QUERY_TYPE (query) == GST_QUERY_LATENCY);
 
+  if (GST_QUERY_IS_COMPACT (query)) {
+    if (live)
+      *live = GST_QUERY_FIELDS (query).latency.live;
+    if (min_latency)
+      *min_latency = GST_QUERY_FIELDS (query).latency.min_latency;
+    if (max_latency)
+      *max_latency = GST_QUERY_FIELDS (query).latency.max_latency;
+    return;
+  }
+
   structure = GST_QUERY_STRUCTURE (query);
   if (live)
     *live =
@@ -712,7 +844,7 @@ gst_query_get_structure (GstQuery * query)
 {
   g_return_val_if_fail (GST_IS_QUERY (query), NULL);
 
-  return GST_QUERY_STRUCTURE (query);
+  return gst_query_ensure_structure (query);
 }
 
 /**
@@ -732,7 +864,7 @@ gst_query_writable_structure (GstQuery * query)
   g_return_val_if_fail (GST_IS_QUERY (query), NULL);
   g_return_val_if_fail (gst_query_is_writable (query), NULL);
 
-  return GST_QUERY_STRUCTURE (query);
+  return gst_query_ensure_structure (query);
 }
 
 /**
@@ -168,6 +168,11 @@ struct _GstRegistryPrivate
   guint32 tfl_cookie;
   GList *device_provider_factory_list;
   guint32 dmfl_cookie;
+
+  /* URI protocol to rank sorted element factories, one table for sinks and
+   * one for sources */
+  GHashTable *uri_handlers[2];
+  guint32 uh_cookie;
 };
 
 /* the one instance of the default registry and the mutex protecting the
@@ -323,6 +328,12 @@ gst_registry_finalize (GObject * object)
     gst_plugin_feature_list_free (registry->priv->device_provider_factory_list);
   }
 
+  if (registry->priv->uri_handlers[0]) {
+    GST_DEBUG_OBJECT (registry, "Cleaning up URI handler index");
+    g_hash_table_destroy (registry->priv->uri_handlers[0]);
+    g_hash_table_destroy (registry->priv->uri_handlers[1]);
+  }
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -809,6 +820,179 @@ gst_registry_get_device_provider_factory_list (GstRegistry * registry)
   return list;
 }
 
+/* protocols are case insensitive */
+static guint
+gst_registry_uri_protocol_hash (gconstpointer key)
+{
+  const gchar *p = key;
+  guint h = 5381;
+
+  for (; *p != '\0'; p++)
+    h = (h << 5) + h + g_ascii_tolower (*p);
+
+  return h;
+}
+
+static gboolean
+gst_registry_uri_protocol_equal (gconstpointer a, gconstpointer b)
+{
+  return g_ascii_strcasecmp (a, b) == 0;
+}
+
+static void
+gst_registry_uri_factories_free (GQueue * factories)
+{
+  g_queue_foreach (factories, (GFunc) gst_object_unref, NULL);
+  g_queue_free (factories);
+}
+
+/* The rank of a feature can change without the cookie being updated, so
+ * this is also done on every lookup. The lists are short and almost always
+ * sorted already, an insertion sort that swaps the data in place is cheap
+ * and is stable, factories with equal ranks stay in the order they were
+ * added to the registry. */
+static void
+gst_registry_uri_factories_sort (GList * list)
+{
+  GList *walk, *l;
+
+  for (walk = list ? list->next : NULL; walk; walk = walk->next) {
+    for (l = walk; l->prev && GST_PLUGIN_FEATURE_CAST (l->prev->data)->rank <
+        GST_PLUGIN_FEATURE_CAST (l->data)->rank; l = l->prev) {
+      gpointer tmp = l->data;
+
+      l->data = l->prev->data;
+      l->prev->data = tmp;
+    }
+  }
+}
+
+static void
+gst_registry_uri_factories_sort_foreach (gpointer key, GQueue * factories,
+    gpointer user_data)
+{
+  gst_registry_uri_factories_sort (factories->head);
+}
+
+#define URI_HANDLERS_INDEX(type) ((type) == GST_URI_SINK ? 0 : 1)
+
+/* (re)builds the URI handler index when the features changed
+ *
+ * Must be called with the object lock taken */
+static void
+gst_registry_update_uri_handlers (GstRegistry * registry)
+{
+  GstRegistryPrivate *priv = registry->priv;
+  GList *walk;
+  guint i;
+
+  if (G_LIKELY (priv->uri_handlers[0] && priv->uh_cookie == priv->cookie))
+    return;
+
+  GST_DEBUG_OBJECT (registry, "building URI handler index");
+
+  for (i = 0; i < G_N_ELEMENTS (priv->uri_handlers); i++) {
+    if (priv->uri_handlers[i])
+      g_hash_table_remove_all (priv->uri_handlers[i]);
+    else
+      priv->uri_handlers[i] =
+          g_hash_table_new_full (gst_registry_uri_protocol_hash,
+          gst_registry_uri_protocol_equal, g_free,
+          (GDestroyNotify) gst_registry_uri_factories_free);
+  }
+
+  /* features are prepended to the registry list, walk it from the start so
+   * that prepending puts the factories in the order they were added. This is
+   * the order equal ranks are returned in */
+  for (walk = priv->features; walk; walk = walk->next) {
+    GstElementFactory *factory;
+    GHashTable *table;
+    gchar **protocols;
+
+    if (!GST_IS_ELEMENT_FACTORY (walk->data))
+      continue;
+    factory = GST_ELEMENT_FACTORY_CAST (walk->data);
+
+    if (factory->uri_type != GST_URI_SINK && factory->uri_type != GST_URI_SRC)
+      continue;
+
+    if (factory->uri_protocols == NULL) {
+      g_warning ("Factory '%s' implements GstUriHandler interface but returned "
+          "no supported protocols!", GST_OBJECT_NAME (factory));
+      continue;
+    }
+
+    table = priv->uri_handlers[URI_HANDLERS_INDEX (factory->uri_type)];
+    for (protocols = factory->uri_protocols; *protocols; protocols++) {
+      GQueue *factories = g_hash_table_lookup (table, *protocols);
+
+      if (factories == NULL) {
+        factories = g_queue_new ();
+        g_hash_table_insert (table, g_strdup (*protocols), factories);
+      } else if (factories->head->data == factory) {
+        /* protocol listed twice */
+        continue;
+      }
+      g_queue_push_head (factories, gst_object_ref (factory));
+    }
+  }
+
+  for (i = 0; i < G_N_ELEMENTS (priv->uri_handlers); i++)
+    g_hash_table_foreach (priv->uri_handlers[i],
+        (GHFunc) gst_registry_uri_factories_sort_foreach, NULL);
+
+  priv->uh_cookie = priv->cookie;
+}
+
+/* Returns the element factories that handle @protocol for @type sorted by
+ * rank, free with gst_plugin_feature_list_free() */
+GList *
+priv_gst_registry_get_uri_factories (GstRegistry * registry,
+    GstURIType type, const gchar * protocol)
+{
+  GQueue *factories;
+  GList *list = NULL;
+
+  g_return_val_if_fail (GST_IS_REGISTRY (registry), NULL);
+  g_return_val_if_fail (protocol != NULL, NULL);
+
+  if (type != GST_URI_SINK && type != GST_URI_SRC)
+    return NULL;
+
+  GST_OBJECT_LOCK (registry);
+  gst_registry_update_uri_handlers (registry);
+  factories = g_hash_table_lookup (registry->priv->uri_handlers
+      [URI_HANDLERS_INDEX (type)], protocol);
+  if (factories) {
+    gst_registry_uri_factories_sort (factories->head);
+    list = gst_plugin_feature_list_copy (factories->head);
+  }
+  GST_OBJECT_UNLOCK (registry);
+
+  return list;
+}
+
+gboolean
+priv_gst_registry_has_uri_factory (GstRegistry * registry,
+    GstURIType type, const gchar * protocol)
+{
+  gboolean res;
+
+  g_return_val_if_fail (GST_IS_REGISTRY (registry), FALSE);
+  g_return_val_if_fail (protocol != NULL, FALSE);
+
+  if (type != GST_URI_SINK && type != GST_URI_SRC)
+    return FALSE;
+
+  GST_OBJECT_LOCK (registry);
+  gst_registry_update_uri_handlers (registry);
+  res = g_hash_table_lookup (registry->priv->uri_handlers
+      [URI_HANDLERS_INDEX (type)], protocol) != NULL;
+  GST_OBJECT_UNLOCK (registry);
+
+  return res;
+}
+
 /**
  * gst_registry_feature_filter:
  * @registry: registry to query
@@ -177,6 +177,50 @@ gst_registry_chunks_make_data (gpointer data, gulong size)
 }
 
 
+/*
+ * gst_registry_chunks_save_caps:
+ *
+ * Store caps in their binary serialization, which is a lot faster to load
+ * than the caps string. @size is set to the size of the chunk or to 0 if
+ * there are no caps or they could not be serialized.
+ *
+ * Returns: %TRUE if a chunk was stored
+ */
+static gboolean
+gst_registry_chunks_save_caps (GList ** list, const GstCaps * caps,
+    guint * size)
+{
+  GstRegistryChunk *chunk;
+  GValue value = G_VALUE_INIT;
+  GByteArray *data;
+  gboolean res;
+
+  *size = 0;
+  if (caps == NULL)
+    return FALSE;
+
+  data = g_byte_array_new ();
+  g_value_init (&value, GST_TYPE_CAPS);
+  g_value_set_boxed (&value, caps);
+  res = gst_value_serialize_binary (&value, data);
+  g_value_unset (&value);
+
+  if (G_UNLIKELY (!res)) {
+    GST_WARNING ("could not serialize caps %" GST_PTR_FORMAT, caps);
+    g_byte_array_free (data, TRUE);
+    return FALSE;
+  }
+
+  *size = data->len;
+  chunk = g_slice_new (GstRegistryChunk);
+  chunk->size = data->len;
+  chunk->data = g_byte_array_free (data, FALSE);
+  chunk->flags = GST_REGISTRY_CHUNK_FLAG_MALLOC;
+  chunk->align = FALSE;
+  *list = g_list_prepend (*list, chunk);
+  return TRUE;
+}
+
 /*
  * gst_registry_chunks_save_pad_template:
  *
@@ -190,6 +234,7 @@ gst_registry_chunks_save_pad_template (GList ** list,
 {
   GstRegistryChunkPadTemplate *pt;
   GstRegistryChunk *chk;
+  GstCaps *caps;
 
   pt = g_slice_new (GstRegistryChunkPadTemplate);
   chk =
@@ -198,6 +243,19 @@ gst_registry_chunks_save_pad_template (GList ** list,
   pt->presence = template->presence;
   pt->direction = template->direction;
 
+  /* pack the binary caps, they are decoded instead of the string when the
+   * template caps are needed. Don't use gst_static_caps_get() here, that
+   * would keep the caps of all templates alive. */
+  if (template->static_caps.caps)
+    caps = gst_caps_ref (template->static_caps.caps);
+  else if (template->static_caps.string)
+    caps = gst_caps_from_string (template->static_caps.string);
+  else
+    caps = NULL;
+  gst_registry_chunks_save_caps (list, caps, &pt->caps_size);
+  if (caps)
+    gst_caps_unref (caps);
+
   /* pack pad template strings */
   gst_registry_chunks_save_const_string (list,
       (gchar *) (template->static_caps.string));
@@ -301,7 +359,6 @@ gst_registry_chunks_save_feature (GList ** list, GstPluginFeature * feature)
   } else if (GST_IS_TYPE_FIND_FACTORY (feature)) {
     GstRegistryChunkTypeFindFactory *tff;
     GstTypeFindFactory *factory = GST_TYPE_FIND_FACTORY (feature);
-    gchar *str;
 
     /* Initialize with zeroes because of struct padding and
      * valgrind complaining about copying unitialized memory
@@ -326,12 +383,8 @@ gst_registry_chunks_save_feature (GList ** list, GstPluginFeature * feature)
       /* we simplify the caps before saving. This is a lot faster
        * when loading them later on */
       fcaps = gst_caps_simplify (fcaps);
-      str = gst_caps_to_string (fcaps);
+      gst_registry_chunks_save_caps (list, fcaps, &tff->caps_size);
       gst_caps_unref (fcaps);
-
-      gst_registry_chunks_save_string (list, str);
-    } else {
-      gst_registry_chunks_save_const_string (list, "");
     }
   } else if (GST_IS_DEVICE_PROVIDER_FACTORY (feature)) {
     GstRegistryChunkDeviceProviderFactory *tff;
@@ -508,7 +561,7 @@ gst_registry_chunks_load_pad_template (GstElementFactory * factory, gchar ** in,
       *in);
   unpack_element (*in, pt, GstRegistryChunkPadTemplate, end, fail);
 
-  template = g_slice_new (GstStaticPadTemplate);
+  template = g_slice_new0 (GstStaticPadTemplate);
   template->presence = pt->presence;
   template->direction = (GstPadDirection) pt->direction;
   template->static_caps.caps = NULL;
@@ -517,6 +570,15 @@ gst_registry_chunks_load_pad_template (GstElementFactory * factory, gchar ** in,
   unpack_const_string (*in, template->name_template, end, fail);
   unpack_const_string (*in, template->static_caps.string, end, fail);
 
+  /* the binary caps are only decoded when the caps are needed */
+  if (pt->caps_size) {
+    if (*in + pt->caps_size > end)
+      goto fail;
+    priv_gst_static_caps_set_binary (&template->static_caps,
+        g_memdup (*in, pt->caps_size), pt->caps_size);
+    *in += pt->caps_size;
+  }
+
   __gst_element_factory_add_static_pad_template (factory, template);
   GST_DEBUG ("Added pad_template %s", template->name_template);
 
@@ -651,11 +713,25 @@ gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
     pf = (GstRegistryChunkPluginFeature *) tff;
 
     /* load typefinder caps */
-    unpack_string_nocopy (*in, const_str, end, fail);
-    if (const_str != NULL && *const_str != '\0')
-      factory->caps = gst_caps_from_string (const_str);
-    else
-      factory->caps = NULL;
+    factory->caps = NULL;
+    if (tff->caps_size) {
+      GValue value = G_VALUE_INIT;
+
+      if (*in + tff->caps_size > end)
+        goto fail;
+      /* the caps only help to pick the typefinder, a feature without them is
+       * still usable so don't throw away the whole registry for this */
+      if (gst_value_deserialize_binary (&value, (const guint8 *) *in,
+              tff->caps_size, NULL)) {
+        if (G_VALUE_TYPE (&value) == GST_TYPE_CAPS)
+          factory->caps = g_value_dup_boxed (&value);
+        g_value_unset (&value);
+      }
+      if (factory->caps == NULL)
+        GST_WARNING ("Could not decode the caps of typefinder '%s'",
+            feature_name);
+      *in += tff->caps_size;
+    }
 
     /* load extensions */
     if (tff->nextensions) {
@@ -121,6 +121,8 @@ typedef struct _GstRegistryChunkElementFactory
 /*
  * GstRegistryChunkTypeFindFactory:
  * @nextensions: stores the number of typefind extensions
+ * @caps_size: size of the binary serialized caps following the structure,
+ * 0 if there are no caps
  *
  * A structure containing the type find factory fields
  */
@@ -129,6 +131,7 @@ typedef struct _GstRegistryChunkTypeFindFactory
   GstRegistryChunkPluginFeature plugin_feature;
 
   guint nextensions;
+  guint caps_size;
 } GstRegistryChunkTypeFindFactory;
 
 /*
@@ -144,6 +147,8 @@ typedef struct _GstRegistryChunkDeviceProviderFactory
 
 /*
  * GstRegistryChunkPadTemplate:
+ * @caps_size: size of the binary serialized caps following the caps string,
+ * 0 if the caps could not be serialized
  *
  * A structure containing the static pad templates of a plugin feature
  */
@@ -151,6 +156,7 @@ typedef struct _GstRegistryChunkPadTemplate
 {
   guint direction;	               /* Either 0:"sink" or 1:"src" */
   GstPadPresence presence;
+  guint caps_size;
 } GstRegistryChunkPadTemplate;
 
 G_BEGIN_DECLS
@@ -63,7 +63,15 @@
  * For debugging purposes, the task will configure its object name as the thread
  * name on Linux. Please note that the object name should be configured before the
  * task is started; changing the object name after the task has been started, has
- * no effect on the thread name.
+ * no effect on the thread name. Tasks started with gst_pad_start_task() are named
+ * after their pad, so that tools like top and perf show which pad a streaming
+ * thread belongs to.
+ *
+ * With gst_task_set_collect_stats() a task records how many times it called
+ * the #GstTaskFunction, how long it spent in it and how much CPU time its
+ * thread used. The statistics can be retrieved with gst_task_get_stats(). An
+ * application can enable them for the streaming threads of a pipeline when it
+ * receives the #GST_STREAM_STATUS_TYPE_CREATE stream status message.
  */
 
 #include "gst_private.h"
@@ -73,6 +81,7 @@
 #include "glib-compat-private.h"
 
 #include <stdio.h>
+#include <time.h>
 
 #ifdef HAVE_SYS_PRCTL_H
 #include <sys/prctl.h>
@@ -104,6 +113,13 @@ struct _GstTaskPrivate
   /* remember the pool and id that is currently running. */
   gpointer id;
   GstTaskPool *pool_id;
+
+  /* statistics, with LOCK */
+  gboolean collect_stats;
+  guint64 iterations;
+  GstClockTime busy_time;
+  GstClockTime wait_time;
+  GstClockTime cpu_time;
 };
 
 #ifdef _MSC_VER
@@ -257,12 +273,57 @@ gst_task_configure_name (GstTask * task)
 #endif
 }
 
+/* the CPU time used by the calling thread so far, GST_CLOCK_TIME_NONE when
+ * the platform can't tell */
+static GstClockTime
+gst_task_get_thread_cpu_time (void)
+{
+#if defined (HAVE_CLOCK_GETTIME) && defined (CLOCK_THREAD_CPUTIME_ID)
+  struct timespec ts;
+
+  if (clock_gettime (CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+    return GST_TIMESPEC_TO_TIME (ts);
+#endif
+  return GST_CLOCK_TIME_NONE;
+}
+
+/* call the task function once and account for it. @last_cpu_time is the CPU
+ * time of the thread after the previous iteration, so that only one CPU time
+ * lookup is needed per iteration. */
+static void
+gst_task_func_with_stats (GstTask * task, GstClockTime * last_cpu_time)
+{
+  GstTaskPrivate *priv = task->priv;
+  GstClockTime start, end, cpu_time;
+
+  if (!GST_CLOCK_TIME_IS_VALID (*last_cpu_time))
+    *last_cpu_time = gst_task_get_thread_cpu_time ();
+
+  start = gst_util_get_timestamp ();
+  task->func (task->user_data);
+  end = gst_util_get_timestamp ();
+
+  cpu_time = gst_task_get_thread_cpu_time ();
+
+  GST_OBJECT_LOCK (task);
+  priv->iterations++;
+  priv->busy_time += end - start;
+  if (GST_CLOCK_TIME_IS_VALID (cpu_time)
+      && GST_CLOCK_TIME_IS_VALID (*last_cpu_time))
+    priv->cpu_time += cpu_time - *last_cpu_time;
+  GST_OBJECT_UNLOCK (task);
+
+  *last_cpu_time = cpu_time;
+}
+
 static void
 gst_task_func (GstTask * task)
 {
   GRecMutex *lock;
   GThread *tself;
   GstTaskPrivate *priv;
+  GstClockTime last_cpu_time = GST_CLOCK_TIME_NONE;
+  gboolean collect_stats;
 
   priv = task->priv;
 
@@ -294,12 +355,22 @@ gst_task_func (GstTask * task)
   while (G_LIKELY (GET_TASK_STATE (task) != GST_TASK_STOPPED)) {
     GST_OBJECT_LOCK (task);
     while (G_UNLIKELY (GST_TASK_STATE (task) == GST_TASK_PAUSED)) {
+      GstClockTime wait_start = GST_CLOCK_TIME_NONE;
+
       g_rec_mutex_unlock (lock);
 
+      if (G_UNLIKELY (priv->collect_stats))
+        wait_start = gst_util_get_timestamp ();
+
       GST_TASK_SIGNAL (task);
       GST_INFO_OBJECT (task, "Task going to paused");
       GST_TASK_WAIT (task);
       GST_INFO_OBJECT (task, "Task resume from paused");
+
+      if (G_UNLIKELY (priv->collect_stats)
+          && GST_CLOCK_TIME_IS_VALID (wait_start))
+        priv->wait_time += gst_util_get_timestamp () - wait_start;
+
       GST_OBJECT_UNLOCK (task);
       /* locking order.. */
       g_rec_mutex_lock (lock);
@@ -310,10 +381,16 @@ gst_task_func (GstTask * task)
       GST_OBJECT_UNLOCK (task);
       break;
     } else {
+      collect_stats = priv->collect_stats;
       GST_OBJECT_UNLOCK (task);
     }
 
-    task->func (task->user_data);
+    if (G_UNLIKELY (collect_stats)) {
+      gst_task_func_with_stats (task, &last_cpu_time);
+    } else {
+      task->func (task->user_data);
+      last_cpu_time = GST_CLOCK_TIME_NONE;
+    }
   }
 
   g_rec_mutex_unlock (lock);
@@ -580,6 +657,103 @@ gst_task_set_leave_callback (GstTask * task, GstTaskThreadFunc leave_func,
   GST_OBJECT_UNLOCK (task);
 }
 
+/**
+ * gst_task_set_collect_stats:
+ * @task: a #GstTask
+ * @collect: whether to collect statistics
+ *
+ * Enable or disable the collection of statistics for @task, see
+ * gst_task_get_stats(). Enabling resets the statistics. Collecting costs a
+ * few timestamps per call of the #GstTaskFunction and is disabled by
+ * default.
+ *
+ * MT safe.
+ *
+ * Since: 1.6
+ */
+void
+gst_task_set_collect_stats (GstTask * task, gboolean collect)
+{
+  GstTaskPrivate *priv;
+
+  g_return_if_fail (GST_IS_TASK (task));
+
+  priv = task->priv;
+
+  GST_OBJECT_LOCK (task);
+  if (collect && !priv->collect_stats) {
+    priv->iterations = 0;
+    priv->busy_time = 0;
+    priv->wait_time = 0;
+    priv->cpu_time = 0;
+  }
+  priv->collect_stats = collect;
+  GST_OBJECT_UNLOCK (task);
+}
+
+/**
+ * gst_task_get_stats:
+ * @task: a #GstTask
+ *
+ * Get the statistics of @task collected since gst_task_set_collect_stats()
+ * enabled them. The returned structure has the following fields:
+ *
+ * "iterations" G_TYPE_UINT64: the number of times the #GstTaskFunction
+ * returned.
+ *
+ * "busy-time" G_TYPE_UINT64: the time spent in the #GstTaskFunction, in
+ * nanoseconds.
+ *
+ * "wait-time" G_TYPE_UINT64: the time the task spent paused, in nanoseconds.
+ *
+ * "cpu-time" G_TYPE_UINT64: the CPU time that the thread of the task used
+ * while running the task, in nanoseconds, or #GST_CLOCK_TIME_NONE when the
+ * platform does not provide it.
+ *
+ * The difference between busy-time and cpu-time is the time the
+ * #GstTaskFunction was blocked, for example waiting for data or for the
+ * clock.
+ *
+ * MT safe.
+ *
+ * Returns: (transfer full) (nullable): a #GstStructure with the statistics,
+ * or %NULL when @task does not collect statistics. Free with
+ * gst_structure_free().
+ *
+ * Since: 1.6
+ */
+GstStructure *
+gst_task_get_stats (GstTask * task)
+{
+  GstTaskPrivate *priv;
+  GstStructure *stats;
+  GstClockTime cpu_time;
+
+  g_return_val_if_fail (GST_IS_TASK (task), NULL);
+
+  priv = task->priv;
+
+  /* if it does not work here, it does not work in the task either */
+  cpu_time = gst_task_get_thread_cpu_time ();
+
+  GST_OBJECT_LOCK (task);
+  if (!priv->collect_stats) {
+    GST_OBJECT_UNLOCK (task);
+    return NULL;
+  }
+  if (GST_CLOCK_TIME_IS_VALID (cpu_time))
+    cpu_time = priv->cpu_time;
+
+  stats = gst_structure_new ("GstTaskStats",
+      "iterations", G_TYPE_UINT64, priv->iterations,
+      "busy-time", G_TYPE_UINT64, priv->busy_time,
+      "wait-time", G_TYPE_UINT64, priv->wait_time,
+      "cpu-time", G_TYPE_UINT64, cpu_time, NULL);
+  GST_OBJECT_UNLOCK (task);
+
+  return stats;
+}
+
 /**
  * gst_task_get_state:
  * @task: The #GstTask to query
@@ -24,6 +24,7 @@
 #define __GST_TASK_H__
 
 #include <gst/gstobject.h>
+#include <gst/gststructure.h>
 #include <gst/gsttaskpool.h>
 
 G_BEGIN_DECLS
@@ -185,6 +186,9 @@ void            gst_task_set_leave_callback  (GstTask *task,
                                               gpointer user_data,
                                               GDestroyNotify notify);
 
+void            gst_task_set_collect_stats   (GstTask *task, gboolean collect);
+GstStructure *  gst_task_get_stats           (GstTask *task);
+
 GstTaskState    gst_task_get_state      (GstTask *task);
 gboolean        gst_task_set_state      (GstTask *task, GstTaskState state);
 
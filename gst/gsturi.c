@@ -548,65 +548,16 @@ gst_uri_construct (const gchar * protocol, const gchar * location)
   return retval;
 }
 
-typedef struct
-{
-  GstURIType type;
-  const gchar *protocol;
-}
-SearchEntry;
-
-static gboolean
-search_by_entry (GstPluginFeature * feature, gpointer search_entry)
-{
-  const gchar *const *protocols;
-  GstElementFactory *factory;
-  SearchEntry *entry = (SearchEntry *) search_entry;
-
-  if (!GST_IS_ELEMENT_FACTORY (feature))
-    return FALSE;
-  factory = GST_ELEMENT_FACTORY_CAST (feature);
-
-  if (factory->uri_type != entry->type)
-    return FALSE;
-
-  protocols = gst_element_factory_get_uri_protocols (factory);
-
-  if (protocols == NULL) {
-    g_warning ("Factory '%s' implements GstUriHandler interface but returned "
-        "no supported protocols!", gst_plugin_feature_get_name (feature));
-    return FALSE;
-  }
-
-  while (*protocols != NULL) {
-    if (g_ascii_strcasecmp (*protocols, entry->protocol) == 0)
-      return TRUE;
-    protocols++;
-  }
-  return FALSE;
-}
-
-static gint
-sort_by_rank (GstPluginFeature * first, GstPluginFeature * second)
-{
-  return gst_plugin_feature_get_rank (second) -
-      gst_plugin_feature_get_rank (first);
-}
-
 static GList *
 get_element_factories_from_uri_protocol (const GstURIType type,
     const gchar * protocol)
 {
-  GList *possibilities;
-  SearchEntry entry;
-
   g_return_val_if_fail (protocol, NULL);
 
-  entry.type = type;
-  entry.protocol = protocol;
-  possibilities = gst_registry_feature_filter (gst_registry_get (),
-      search_by_entry, FALSE, &entry);
-
-  return possibilities;
+  /* the registry keeps an index of the factories by protocol, sorted by
+   * rank */
+  return priv_gst_registry_get_uri_factories (gst_registry_get (), type,
+      protocol);
 }
 
 /**
@@ -623,17 +574,10 @@ get_element_factories_from_uri_protocol (const GstURIType type,
 gboolean
 gst_uri_protocol_is_supported (const GstURIType type, const gchar * protocol)
 {
-  GList *possibilities;
-
   g_return_val_if_fail (protocol, FALSE);
 
-  possibilities = get_element_factories_from_uri_protocol (type, protocol);
-
-  if (possibilities) {
-    g_list_free (possibilities);
-    return TRUE;
-  } else
-    return FALSE;
+  return priv_gst_registry_has_uri_factory (gst_registry_get (), type,
+      protocol);
 }
 
 /**
@@ -677,7 +621,6 @@ gst_element_make_from_uri (const GstURIType type, const gchar * uri,
   }
   g_free (protocol);
 
-  possibilities = g_list_sort (possibilities, (GCompareFunc) sort_by_rank);
   walk = possibilities;
   while (walk) {
     GstElementFactory *factory = walk->data;
@@ -132,6 +132,19 @@ static GArray *gst_value_union_funcs;
 static GArray *gst_value_intersect_funcs;
 static GArray *gst_value_subtract_funcs;
 
+/* (type1, type2) -> function lookups, filled when the functions are
+ * registered so that the hot paths don't have to scan the arrays above */
+typedef struct _GstValueTypePair GstValueTypePair;
+struct _GstValueTypePair
+{
+  GType type1;
+  GType type2;
+};
+
+static GHashTable *gst_value_union_hash;
+static GHashTable *gst_value_intersect_hash;
+static GHashTable *gst_value_subtract_hash;
+
 /* Forward declarations */
 static gchar *gst_value_serialize_fraction (const GValue * value);
 
@@ -167,6 +180,50 @@ gst_value_hash_add_type (GType type, const GstValueTable * table)
   g_hash_table_insert (gst_value_hash, (gpointer) type, (gpointer) table);
 }
 
+static guint
+gst_value_type_pair_hash (gconstpointer key)
+{
+  const GstValueTypePair *pair = key;
+
+  /* non-fundamental types are pointers, drop the alignment bits */
+  return (guint) ((pair->type1 >> 2) * 31 + (pair->type2 >> 2));
+}
+
+static gboolean
+gst_value_type_pair_equal (gconstpointer a, gconstpointer b)
+{
+  const GstValueTypePair *pa = a, *pb = b;
+
+  return pa->type1 == pb->type1 && pa->type2 == pb->type2;
+}
+
+static inline gpointer
+gst_value_type_pair_lookup (GHashTable * hash, GType type1, GType type2)
+{
+  GstValueTypePair pair;
+
+  pair.type1 = type1;
+  pair.type2 = type2;
+
+  return g_hash_table_lookup (hash, &pair);
+}
+
+static void
+gst_value_type_pair_add (GHashTable * hash, GType type1, GType type2,
+    gpointer func)
+{
+  GstValueTypePair *pair;
+
+  /* like the linear scan this replaces, the first registration wins */
+  if (gst_value_type_pair_lookup (hash, type1, type2))
+    return;
+
+  pair = g_slice_new (GstValueTypePair);
+  pair->type1 = type1;
+  pair->type2 = type2;
+  g_hash_table_insert (hash, pair, func);
+}
+
 /********
  * list *
  ********/
@@ -4647,25 +4704,16 @@ gst_value_compare_with_func (const GValue * value1, const GValue * value2,
 gboolean
 gst_value_can_union (const GValue * value1, const GValue * value2)
 {
-  GstValueUnionInfo *union_info;
-  guint i, len;
+  GType type1, type2;
 
   g_return_val_if_fail (G_IS_VALUE (value1), FALSE);
   g_return_val_if_fail (G_IS_VALUE (value2), FALSE);
 
-  len = gst_value_union_funcs->len;
-
-  for (i = 0; i < len; i++) {
-    union_info = &g_array_index (gst_value_union_funcs, GstValueUnionInfo, i);
-    if (union_info->type1 == G_VALUE_TYPE (value1) &&
-        union_info->type2 == G_VALUE_TYPE (value2))
-      return TRUE;
-    if (union_info->type1 == G_VALUE_TYPE (value2) &&
-        union_info->type2 == G_VALUE_TYPE (value1))
-      return TRUE;
-  }
+  type1 = G_VALUE_TYPE (value1);
+  type2 = G_VALUE_TYPE (value2);
 
-  return FALSE;
+  return gst_value_type_pair_lookup (gst_value_union_hash, type1, type2) ||
+      gst_value_type_pair_lookup (gst_value_union_hash, type2, type1);
 }
 
 /**
@@ -4681,8 +4729,7 @@ gst_value_can_union (const GValue * value1, const GValue * value2)
 gboolean
 gst_value_union (GValue * dest, const GValue * value1, const GValue * value2)
 {
-  const GstValueUnionInfo *union_info;
-  guint i, len;
+  GstValueUnionFunc func;
   GType type1, type2;
 
   g_return_val_if_fail (dest != NULL, FALSE);
@@ -4691,19 +4738,17 @@ gst_value_union (GValue * dest, const GValue * value1, const GValue * value2)
   g_return_val_if_fail (gst_value_list_or_array_are_compatible (value1, value2),
       FALSE);
 
-  len = gst_value_union_funcs->len;
   type1 = G_VALUE_TYPE (value1);
   type2 = G_VALUE_TYPE (value2);
 
-  for (i = 0; i < len; i++) {
-    union_info = &g_array_index (gst_value_union_funcs, GstValueUnionInfo, i);
-    if (union_info->type1 == type1 && union_info->type2 == type2) {
-      return union_info->func (dest, value1, value2);
-    }
-    if (union_info->type1 == type2 && union_info->type2 == type1) {
-      return union_info->func (dest, value2, value1);
-    }
-  }
+  func = (GstValueUnionFunc) gst_value_type_pair_lookup (gst_value_union_hash,
+      type1, type2);
+  if (func)
+    return func (dest, value1, value2);
+  func = (GstValueUnionFunc) gst_value_type_pair_lookup (gst_value_union_hash,
+      type2, type1);
+  if (func)
+    return func (dest, value2, value1);
 
   gst_value_list_concat (dest, value1, value2);
   return TRUE;
@@ -4731,6 +4776,8 @@ gst_value_register_union_func (GType type1, GType type2, GstValueUnionFunc func)
   union_info.func = func;
 
   g_array_append_val (gst_value_union_funcs, union_info);
+  gst_value_type_pair_add (gst_value_union_hash, type1, type2,
+      (gpointer) func);
 }
 
 /* intersection */
@@ -4749,8 +4796,6 @@ gst_value_register_union_func (GType type1, GType type2, GstValueUnionFunc func)
 gboolean
 gst_value_can_intersect (const GValue * value1, const GValue * value2)
 {
-  GstValueIntersectInfo *intersect_info;
-  guint i, len;
   GType type1, type2;
 
   g_return_val_if_fail (G_IS_VALUE (value1), FALSE);
@@ -4769,14 +4814,9 @@ gst_value_can_intersect (const GValue * value1, const GValue * value2)
     return TRUE;
 
   /* check registered intersect functions */
-  len = gst_value_intersect_funcs->len;
-  for (i = 0; i < len; i++) {
-    intersect_info = &g_array_index (gst_value_intersect_funcs,
-        GstValueIntersectInfo, i);
-    if ((intersect_info->type1 == type1 && intersect_info->type2 == type2) ||
-        (intersect_info->type1 == type2 && intersect_info->type2 == type1))
-      return TRUE;
-  }
+  if (gst_value_type_pair_lookup (gst_value_intersect_hash, type1, type2) ||
+      gst_value_type_pair_lookup (gst_value_intersect_hash, type2, type1))
+    return TRUE;
 
   return gst_value_can_compare_unchecked (value1, value2);
 }
@@ -4801,8 +4841,7 @@ gboolean
 gst_value_intersect (GValue * dest, const GValue * value1,
     const GValue * value2)
 {
-  GstValueIntersectInfo *intersect_info;
-  guint i, len;
+  GstValueIntersectFunc func;
   GType type1, type2;
 
   g_return_val_if_fail (G_IS_VALUE (value1), FALSE);
@@ -4817,23 +4856,24 @@ gst_value_intersect (GValue * dest, const GValue * value1,
   if (type2 == GST_TYPE_LIST)
     return gst_value_intersect_list (dest, value2, value1);
 
-  if (_gst_value_compare_nolist (value1, value2) == GST_VALUE_EQUAL) {
+  /* values of different types are never equal, go straight to the registered
+   * functions for the common fixed value against range cases */
+  if (type1 == type2
+      && _gst_value_compare_nolist (value1, value2) == GST_VALUE_EQUAL) {
     if (dest)
       gst_value_init_and_copy (dest, value1);
     return TRUE;
   }
 
-  len = gst_value_intersect_funcs->len;
-  for (i = 0; i < len; i++) {
-    intersect_info = &g_array_index (gst_value_intersect_funcs,
-        GstValueIntersectInfo, i);
-    if (intersect_info->type1 == type1 && intersect_info->type2 == type2) {
-      return intersect_info->func (dest, value1, value2);
-    }
-    if (intersect_info->type1 == type2 && intersect_info->type2 == type1) {
-      return intersect_info->func (dest, value2, value1);
-    }
-  }
+  func = (GstValueIntersectFunc)
+      gst_value_type_pair_lookup (gst_value_intersect_hash, type1, type2);
+  if (func)
+    return func (dest, value1, value2);
+  func = (GstValueIntersectFunc)
+      gst_value_type_pair_lookup (gst_value_intersect_hash, type2, type1);
+  if (func)
+    return func (dest, value2, value1);
+
   return FALSE;
 }
 
@@ -4863,6 +4903,8 @@ gst_value_register_intersect_func (GType type1, GType type2,
   intersect_info.func = func;
 
   g_array_append_val (gst_value_intersect_funcs, intersect_info);
+  gst_value_type_pair_add (gst_value_intersect_hash, type1, type2,
+      (gpointer) func);
 }
 
 
@@ -4886,8 +4928,7 @@ gboolean
 gst_value_subtract (GValue * dest, const GValue * minuend,
     const GValue * subtrahend)
 {
-  GstValueSubtractInfo *info;
-  guint i, len;
+  GstValueSubtractFunc func;
   GType mtype, stype;
 
   g_return_val_if_fail (G_IS_VALUE (minuend), FALSE);
@@ -4902,13 +4943,10 @@ gst_value_subtract (GValue * dest, const GValue * minuend,
   if (stype == GST_TYPE_LIST)
     return gst_value_subtract_list (dest, minuend, subtrahend);
 
-  len = gst_value_subtract_funcs->len;
-  for (i = 0; i < len; i++) {
-    info = &g_array_index (gst_value_subtract_funcs, GstValueSubtractInfo, i);
-    if (info->minuend == mtype && info->subtrahend == stype) {
-      return info->func (dest, minuend, subtrahend);
-    }
-  }
+  func = (GstValueSubtractFunc)
+      gst_value_type_pair_lookup (gst_value_subtract_hash, mtype, stype);
+  if (func)
+    return func (dest, minuend, subtrahend);
 
   if (_gst_value_compare_nolist (minuend, subtrahend) != GST_VALUE_EQUAL) {
     if (dest)
@@ -4945,8 +4983,6 @@ gst_value_subtract (GValue * dest, const GValue * minuend,
 gboolean
 gst_value_can_subtract (const GValue * minuend, const GValue * subtrahend)
 {
-  GstValueSubtractInfo *info;
-  guint i, len;
   GType mtype, stype;
 
   g_return_val_if_fail (G_IS_VALUE (minuend), FALSE);
@@ -4959,12 +4995,8 @@ gst_value_can_subtract (const GValue * minuend, const GValue * subtrahend)
   if (mtype == GST_TYPE_LIST || stype == GST_TYPE_LIST)
     return TRUE;
 
-  len = gst_value_subtract_funcs->len;
-  for (i = 0; i < len; i++) {
-    info = &g_array_index (gst_value_subtract_funcs, GstValueSubtractInfo, i);
-    if (info->minuend == mtype && info->subtrahend == stype)
-      return TRUE;
-  }
+  if (gst_value_type_pair_lookup (gst_value_subtract_hash, mtype, stype))
+    return TRUE;
 
   return gst_value_can_compare_unchecked (minuend, subtrahend);
 }
@@ -4995,6 +5027,8 @@ gst_value_register_subtract_func (GType minuend_type, GType subtrahend_type,
   info.func = func;
 
   g_array_append_val (gst_value_subtract_funcs, info);
+  gst_value_type_pair_add (gst_value_subtract_hash, minuend_type,
+      subtrahend_type, (gpointer) func);
 }
 
 /**
@@ -5144,6 +5178,1132 @@ gst_value_deserialize (GValue * dest, const gchar * src)
   return FALSE;
 }
 
+/* binary serialisation */
+
+/* the version byte written in front of every top-level value, bump this when
+ * the encoding changes in an incompatible way */
+#define GST_VALUE_BINARY_VERSION 1
+
+/* limit the nesting of lists, arrays, structures and caps when decoding so
+ * that corrupt input can't make us run out of stack */
+#define GST_VALUE_BINARY_MAX_DEPTH 64
+
+typedef enum
+{
+  GST_VALUE_BINARY_BOOLEAN = 1,
+  GST_VALUE_BINARY_INT,
+  GST_VALUE_BINARY_UINT,
+  GST_VALUE_BINARY_INT64,
+  GST_VALUE_BINARY_UINT64,
+  GST_VALUE_BINARY_FLOAT,
+  GST_VALUE_BINARY_DOUBLE,
+  GST_VALUE_BINARY_STRING,
+  GST_VALUE_BINARY_FRACTION,
+  GST_VALUE_BINARY_INT_RANGE,
+  GST_VALUE_BINARY_INT64_RANGE,
+  GST_VALUE_BINARY_DOUBLE_RANGE,
+  GST_VALUE_BINARY_FRACTION_RANGE,
+  GST_VALUE_BINARY_LIST,
+  GST_VALUE_BINARY_ARRAY,
+  GST_VALUE_BINARY_BITMASK,
+  GST_VALUE_BINARY_ENUM,
+  GST_VALUE_BINARY_FLAGS,
+  GST_VALUE_BINARY_STRUCTURE,
+  GST_VALUE_BINARY_CAPS,
+  GST_VALUE_BINARY_CAPS_FEATURES,
+  GST_VALUE_BINARY_TAG_LIST,
+  /* any other type, stored as type name and gst_value_serialize() string */
+  GST_VALUE_BINARY_OTHER
+} GstValueBinaryTag;
+
+/* caps features encoding */
+enum
+{
+  GST_VALUE_BINARY_FEATURES_NONE = 0,   /* NULL or system memory */
+  GST_VALUE_BINARY_FEATURES_ANY,
+  GST_VALUE_BINARY_FEATURES_LIST
+};
+
+/* caps encoding */
+enum
+{
+  GST_VALUE_BINARY_CAPS_STRUCTURES = 0,
+  GST_VALUE_BINARY_CAPS_ANY,
+  GST_VALUE_BINARY_CAPS_NULL
+};
+
+static gboolean gst_value_binary_put_value (GByteArray * dest,
+    const GValue * value);
+
+static inline void
+gst_value_binary_put_byte (GByteArray * dest, guint8 byte)
+{
+  g_byte_array_append (dest, &byte, 1);
+}
+
+/* unsigned LEB128 */
+static void
+gst_value_binary_put_varint (GByteArray * dest, guint64 v)
+{
+  guint8 buf[10];
+  guint n = 0;
+
+  do {
+    buf[n] = v & 0x7f;
+    v >>= 7;
+    if (v)
+      buf[n] |= 0x80;
+    n++;
+  } while (v);
+
+  g_byte_array_append (dest, buf, n);
+}
+
+/* zigzag encoding so that small negative numbers stay small */
+static inline void
+gst_value_binary_put_svarint (GByteArray * dest, gint64 v)
+{
+  gst_value_binary_put_varint (dest,
+      (((guint64) v) << 1) ^ (guint64) (v >> 63));
+}
+
+static inline void
+gst_value_binary_put_uint32 (GByteArray * dest, guint32 v)
+{
+  v = GUINT32_TO_LE (v);
+  g_byte_array_append (dest, (const guint8 *) &v, 4);
+}
+
+static inline void
+gst_value_binary_put_uint64 (GByteArray * dest, guint64 v)
+{
+  v = GUINT64_TO_LE (v);
+  g_byte_array_append (dest, (const guint8 *) &v, 8);
+}
+
+static inline void
+gst_value_binary_put_double (GByteArray * dest, gdouble d)
+{
+  union
+  {
+    gdouble d;
+    guint64 u;
+  } u;
+
+  u.d = d;
+  gst_value_binary_put_uint64 (dest, u.u);
+}
+
+/* strings are stored as length + 1 followed by the bytes without the
+ * terminator, a length of 0 means NULL */
+static void
+gst_value_binary_put_string (GByteArray * dest, const gchar * str)
+{
+  gsize len;
+
+  if (str == NULL) {
+    gst_value_binary_put_varint (dest, 0);
+    return;
+  }
+  len = strlen (str);
+  gst_value_binary_put_varint (dest, len + 1);
+  g_byte_array_append (dest, (const guint8 *) str, len);
+}
+
+static gboolean
+gst_value_binary_put_field (GQuark field_id, const GValue * value,
+    gpointer user_data)
+{
+  GByteArray *dest = user_data;
+
+  gst_value_binary_put_string (dest, g_quark_to_string (field_id));
+  return gst_value_binary_put_value (dest, value);
+}
+
+static gboolean
+gst_value_binary_put_structure (GByteArray * dest,
+    const GstStructure * structure)
+{
+  /* a NULL name marks a NULL structure, real structures always have one */
+  if (structure == NULL) {
+    gst_value_binary_put_string (dest, NULL);
+    return TRUE;
+  }
+  gst_value_binary_put_string (dest, gst_structure_get_name (structure));
+  gst_value_binary_put_varint (dest, gst_structure_n_fields (structure));
+
+  return gst_structure_foreach (structure, gst_value_binary_put_field, dest);
+}
+
+static void
+gst_value_binary_put_features (GByteArray * dest,
+    const GstCapsFeatures * features)
+{
+  guint i, n;
+
+  if (features == NULL
+      || gst_caps_features_is_equal (features,
+          GST_CAPS_FEATURES_MEMORY_SYSTEM_MEMORY)) {
+    gst_value_binary_put_byte (dest, GST_VALUE_BINARY_FEATURES_NONE);
+  } else if (gst_caps_features_is_any (features)) {
+    gst_value_binary_put_byte (dest, GST_VALUE_BINARY_FEATURES_ANY);
+  } else {
+    gst_value_binary_put_byte (dest, GST_VALUE_BINARY_FEATURES_LIST);
+    n = gst_caps_features_get_size (features);
+    gst_value_binary_put_varint (dest, n);
+    for (i = 0; i < n; i++)
+      gst_value_binary_put_string (dest,
+          gst_caps_features_get_nth (features, i));
+  }
+}
+
+static gboolean
+gst_value_binary_put_caps (GByteArray * dest, const GstCaps * caps)
+{
+  guint i, n;
+
+  if (caps == NULL) {
+    gst_value_binary_put_byte (dest, GST_VALUE_BINARY_CAPS_NULL);
+    return TRUE;
+  }
+  if (gst_caps_is_any (caps)) {
+    gst_value_binary_put_byte (dest, GST_VALUE_BINARY_CAPS_ANY);
+    return TRUE;
+  }
+
+  gst_value_binary_put_byte (dest, GST_VALUE_BINARY_CAPS_STRUCTURES);
+  n = gst_caps_get_size (caps);
+  gst_value_binary_put_varint (dest, n);
+  for (i = 0; i < n; i++) {
+    gst_value_binary_put_features (dest, gst_caps_get_features (caps, i));
+    if (!gst_value_binary_put_structure (dest, gst_caps_get_structure (caps,
+                i)))
+      return FALSE;
+  }
+  return TRUE;
+}
+
+static gboolean
+gst_value_binary_put_tag_list (GByteArray * dest, const GstTagList * list)
+{
+  guint i, j, n, size;
+
+  /* the scope is stored + 1 so that 0 can mark a NULL taglist */
+  if (list == NULL) {
+    gst_value_binary_put_byte (dest, 0);
+    return TRUE;
+  }
+  gst_value_binary_put_byte (dest, gst_tag_list_get_scope (list) + 1);
+
+  n = gst_tag_list_n_tags (list);
+  gst_value_binary_put_varint (dest, n);
+  for (i = 0; i < n; i++) {
+    const gchar *tag = gst_tag_list_nth_tag_name (list, i);
+
+    size = gst_tag_list_get_tag_size (list, tag);
+    gst_value_binary_put_string (dest, tag);
+    gst_value_binary_put_varint (dest, size);
+    for (j = 0; j < size; j++) {
+      if (!gst_value_binary_put_value (dest,
+              gst_tag_list_get_value_index (list, tag, j)))
+        return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+static gboolean
+gst_value_binary_put_value (GByteArray * dest, const GValue * value)
+{
+  GType type = G_VALUE_TYPE (value);
+
+  switch (G_TYPE_FUNDAMENTAL (type)) {
+    case G_TYPE_BOOLEAN:
+      gst_value_binary_put_byte (dest, GST_VALUE_BINARY_BOOLEAN);
+      gst_value_binary_put_byte (dest, g_value_get_boolean (value) ? 1 : 0);
+      return TRUE;
+    case G_TYPE_INT:
+      gst_value_binary_put_byte (dest, GST_VALUE_BINARY_INT);
+      gst_value_binary_put_svarint (dest, g_value_get_int (value));
+      return TRUE;
+    case G_TYPE_UINT:
+      gst_value_binary_put_byte (dest, GST_VALUE_BINARY_UINT);
+      gst_value_binary_put_varint (dest, g_value_get_uint (value));
+      return TRUE;
+    case G_TYPE_INT64:
+      gst_value_binary_put_byte (dest, GST_VALUE_BINARY_INT64);
+      gst_value_binary_put_svarint (dest, g_value_get_int64 (value));
+      return TRUE;
+    case G_TYPE_UINT64:
+      gst_value_binary_put_byte (dest, GST_VALUE_BINARY_UINT64);
+      gst_value_binary_put_varint (dest, g_value_get_uint64 (value));
+      return TRUE;
+    case G_TYPE_FLOAT:
+    {
+      union
+      {
+        gfloat f;
+        guint32 u;
+      } u;
+
+      u.f = g_value_get_float (value);
+      gst_value_binary_put_byte (dest, GST_VALUE_BINARY_FLOAT);
+      gst_value_binary_put_uint32 (dest, u.u);
+      return TRUE;
+    }
+    case G_TYPE_DOUBLE:
+      gst_value_binary_put_byte (dest, GST_VALUE_BINARY_DOUBLE);
+      gst_value_binary_put_double (dest, g_value_get_double (value));
+      return TRUE;
+    case G_TYPE_STRING:
+      if (type != G_TYPE_STRING)
+        break;
+      gst_value_binary_put_byte (dest, GST_VALUE_BINARY_STRING);
+      gst_value_binary_put_string (dest, g_value_get_string (value));
+      return TRUE;
+    case G_TYPE_ENUM:
+      gst_value_binary_put_byte (dest, GST_VALUE_BINARY_ENUM);
+      gst_value_binary_put_string (dest, g_type_name (type));
+      gst_value_binary_put_svarint (dest, g_value_get_enum (value));
+      return TRUE;
+    case G_TYPE_FLAGS:
+      gst_value_binary_put_byte (dest, GST_VALUE_BINARY_FLAGS);
+      gst_value_binary_put_string (dest, g_type_name (type));
+      gst_value_binary_put_varint (dest, g_value_get_flags (value));
+      return TRUE;
+    default:
+      break;
+  }
+
+  if (type == GST_TYPE_FRACTION) {
+    gst_value_binary_put_byte (dest, GST_VALUE_BINARY_FRACTION);
+    gst_value_binary_put_svarint (dest, value->data[0].v_int);
+    gst_value_binary_put_svarint (dest, value->data[1].v_int);
+  } else if (type == GST_TYPE_INT_RANGE) {
+    gst_value_binary_put_byte (dest, GST_VALUE_BINARY_INT_RANGE);
+    gst_value_binary_put_svarint (dest, INT_RANGE_MIN (value));
+    gst_value_binary_put_svarint (dest, INT_RANGE_MAX (value));
+    gst_value_binary_put_svarint (dest, INT_RANGE_STEP (value));
+  } else if (type == GST_TYPE_INT64_RANGE) {
+    gst_value_binary_put_byte (dest, GST_VALUE_BINARY_INT64_RANGE);
+    gst_value_binary_put_svarint (dest, INT64_RANGE_MIN (value));
+    gst_value_binary_put_svarint (dest, INT64_RANGE_MAX (value));
+    gst_value_binary_put_svarint (dest, INT64_RANGE_STEP (value));
+  } else if (type == GST_TYPE_DOUBLE_RANGE) {
+    gst_value_binary_put_byte (dest, GST_VALUE_BINARY_DOUBLE_RANGE);
+    gst_value_binary_put_double (dest, value->data[0].v_double);
+    gst_value_binary_put_double (dest, value->data[1].v_double);
+  } else if (type == GST_TYPE_FRACTION_RANGE) {
+    const GValue *vals = (const GValue *) value->data[0].v_pointer;
+
+    gst_value_binary_put_byte (dest, GST_VALUE_BINARY_FRACTION_RANGE);
+    gst_value_binary_put_svarint (dest, vals[0].data[0].v_int);
+    gst_value_binary_put_svarint (dest, vals[0].data[1].v_int);
+    gst_value_binary_put_svarint (dest, vals[1].data[0].v_int);
+    gst_value_binary_put_svarint (dest, vals[1].data[1].v_int);
+  } else if (type == GST_TYPE_LIST || type == GST_TYPE_ARRAY) {
+    GArray *array = (GArray *) value->data[0].v_pointer;
+    guint i;
+
+    gst_value_binary_put_byte (dest, type == GST_TYPE_LIST ?
+        GST_VALUE_BINARY_LIST : GST_VALUE_BINARY_ARRAY);
+    gst_value_binary_put_varint (dest, array->len);
+    for (i = 0; i < array->len; i++) {
+      if (!gst_value_binary_put_value (dest,
+              &g_array_index (array, GValue, i)))
+        return FALSE;
+    }
+  } else if (type == GST_TYPE_BITMASK) {
+    gst_value_binary_put_byte (dest, GST_VALUE_BINARY_BITMASK);
+    gst_value_binary_put_uint64 (dest, value->data[0].v_uint64);
+  } else if (type == GST_TYPE_STRUCTURE) {
+    gst_value_binary_put_byte (dest, GST_VALUE_BINARY_STRUCTURE);
+    return gst_value_binary_put_structure (dest,
+        gst_value_get_structure (value));
+  } else if (type == GST_TYPE_CAPS) {
+    gst_value_binary_put_byte (dest, GST_VALUE_BINARY_CAPS);
+    return gst_value_binary_put_caps (dest, gst_value_get_caps (value));
+  } else if (type == GST_TYPE_CAPS_FEATURES) {
+    const GstCapsFeatures *features = gst_value_get_caps_features (value);
+
+    /* the NONE encoding can't tell NULL from system memory features */
+    if (features == NULL)
+      return FALSE;
+    gst_value_binary_put_byte (dest, GST_VALUE_BINARY_CAPS_FEATURES);
+    gst_value_binary_put_features (dest, features);
+  } else if (type == GST_TYPE_TAG_LIST) {
+    gst_value_binary_put_byte (dest, GST_VALUE_BINARY_TAG_LIST);
+    return gst_value_binary_put_tag_list (dest, g_value_get_boxed (value));
+  } else {
+    gchar *str;
+
+    /* everything else goes through the text serialisation */
+    str = gst_value_serialize (value);
+    if (str == NULL)
+      return FALSE;
+    gst_value_binary_put_byte (dest, GST_VALUE_BINARY_OTHER);
+    gst_value_binary_put_string (dest, g_type_name (type));
+    gst_value_binary_put_string (dest, str);
+    g_free (str);
+  }
+  return TRUE;
+}
+
+/**
+ * gst_value_serialize_binary:
+ * @value: a #GValue to serialize
+ * @dest: a #GByteArray to append the serialization to
+ *
+ * Appends a compact binary representation of @value to @dest that can be
+ * read back with gst_value_deserialize_binary(). Unlike gst_value_serialize()
+ * this is not meant to be human readable but is a lot faster to encode and
+ * to decode, which makes it useful for caches and for passing caps,
+ * structures and taglists between processes.
+ *
+ * Fundamental types, ranges, lists, arrays, fractions, bitmasks, enums,
+ * flags, structures, caps (including their features) and taglists are
+ * encoded natively. Other types are stored with their string serialization.
+ *
+ * The encoding is versioned and independent of the host byte order. If
+ * @value can't be serialized, %FALSE is returned and @dest is left
+ * untouched.
+ *
+ * Returns: %TRUE on success
+ *
+ * Since: 1.6
+ */
+gboolean
+gst_value_serialize_binary (const GValue * value, GByteArray * dest)
+{
+  guint len;
+
+  g_return_val_if_fail (G_IS_VALUE (value), FALSE);
+  g_return_val_if_fail (dest != NULL, FALSE);
+
+  len = dest->len;
+  gst_value_binary_put_byte (dest, GST_VALUE_BINARY_VERSION);
+  if (!gst_value_binary_put_value (dest, value)) {
+    g_byte_array_set_size (dest, len);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+typedef struct
+{
+  const guint8 *data;
+  const guint8 *end;
+} GstValueBinaryReader;
+
+static gboolean gst_value_binary_get_value (GstValueBinaryReader * reader,
+    GValue * dest, guint depth);
+
+static inline gboolean
+gst_value_binary_get_byte (GstValueBinaryReader * reader, guint8 * byte)
+{
+  if (G_UNLIKELY (reader->data >= reader->end))
+    return FALSE;
+  *byte = *reader->data++;
+  return TRUE;
+}
+
+static gboolean
+gst_value_binary_get_varint (GstValueBinaryReader * reader, guint64 * v)
+{
+  guint64 res = 0;
+  guint shift = 0;
+  guint8 byte;
+
+  do {
+    if (G_UNLIKELY (shift > 63 || reader->data >= reader->end))
+      return FALSE;
+    byte = *reader->data++;
+    res |= ((guint64) (byte & 0x7f)) << shift;
+    shift += 7;
+  } while (byte & 0x80);
+
+  *v = res;
+  return TRUE;
+}
+
+static inline gboolean
+gst_value_binary_get_svarint (GstValueBinaryReader * reader, gint64 * v)
+{
+  guint64 u;
+
+  if (!gst_value_binary_get_varint (reader, &u))
+    return FALSE;
+  *v = (gint64) (u >> 1) ^ -(gint64) (u & 1);
+  return TRUE;
+}
+
+static inline gboolean
+gst_value_binary_get_int (GstValueBinaryReader * reader, gint * v)
+{
+  gint64 v64;
+
+  if (!gst_value_binary_get_svarint (reader, &v64)
+      || v64 < G_MININT || v64 > G_MAXINT)
+    return FALSE;
+  *v = (gint) v64;
+  return TRUE;
+}
+
+static inline gboolean
+gst_value_binary_get_uint (GstValueBinaryReader * reader, guint * v)
+{
+  guint64 v64;
+
+  if (!gst_value_binary_get_varint (reader, &v64) || v64 > G_MAXUINT)
+    return FALSE;
+  *v = (guint) v64;
+  return TRUE;
+}
+
+/* reads an element count and sanity checks it against the remaining data,
+ * every element takes at least one byte */
+static inline gboolean
+gst_value_binary_get_count (GstValueBinaryReader * reader, guint * n)
+{
+  if (!gst_value_binary_get_uint (reader, n))
+    return FALSE;
+  return *n <= (gsize) (reader->end - reader->data);
+}
+
+static inline gboolean
+gst_value_binary_get_uint32 (GstValueBinaryReader * reader, guint32 * v)
+{
+  if (G_UNLIKELY (reader->end - reader->data < 4))
+    return FALSE;
+  *v = GST_READ_UINT32_LE (reader->data);
+  reader->data += 4;
+  return TRUE;
+}
+
+static inline gboolean
+gst_value_binary_get_uint64 (GstValueBinaryReader * reader, guint64 * v)
+{
+  if (G_UNLIKELY (reader->end - reader->data < 8))
+    return FALSE;
+  *v = GST_READ_UINT64_LE (reader->data);
+  reader->data += 8;
+  return TRUE;
+}
+
+static inline gboolean
+gst_value_binary_get_double (GstValueBinaryReader * reader, gdouble * d)
+{
+  union
+  {
+    gdouble d;
+    guint64 u;
+  } u;
+
+  if (!gst_value_binary_get_uint64 (reader, &u.u))
+    return FALSE;
+  *d = u.d;
+  return TRUE;
+}
+
+/* points @str at the string bytes in the input, @len is -1 for NULL */
+static gboolean
+gst_value_binary_peek_string (GstValueBinaryReader * reader,
+    const gchar ** str, gssize * len)
+{
+  guint64 l;
+
+  if (!gst_value_binary_get_varint (reader, &l))
+    return FALSE;
+  if (l == 0) {
+    *str = NULL;
+    *len = -1;
+    return TRUE;
+  }
+  l--;
+  if (G_UNLIKELY (l > (guint64) (reader->end - reader->data)))
+    return FALSE;
+  /* embedded NUL bytes can't come from the encoder */
+  if (G_UNLIKELY (memchr (reader->data, '\0', l) != NULL))
+    return FALSE;
+
+  *str = (const gchar *) reader->data;
+  *len = l;
+  reader->data += l;
+  return TRUE;
+}
+
+static gboolean
+gst_value_binary_get_string (GstValueBinaryReader * reader, gchar ** str)
+{
+  const gchar *s;
+  gssize len;
+
+  if (!gst_value_binary_peek_string (reader, &s, &len))
+    return FALSE;
+  *str = s ? g_strndup (s, len) : NULL;
+  return TRUE;
+}
+
+/* structure names, field names and types are mostly short and already known,
+ * avoid allocating a copy to look them up */
+static gboolean
+gst_value_binary_get_quark (GstValueBinaryReader * reader, GQuark * quark)
+{
+  gchar buf[128];
+  const gchar *s;
+  gssize len;
+
+  if (!gst_value_binary_peek_string (reader, &s, &len))
+    return FALSE;
+  if (s == NULL) {
+    *quark = 0;
+  } else if ((gsize) len < sizeof (buf)) {
+    memcpy (buf, s, len);
+    buf[len] = '\0';
+    *quark = g_quark_from_string (buf);
+  } else {
+    gchar *tmp = g_strndup (s, len);
+
+    *quark = g_quark_from_string (tmp);
+    g_free (tmp);
+  }
+  return TRUE;
+}
+
+static GType
+gst_value_binary_get_type (GstValueBinaryReader * reader)
+{
+  GQuark quark;
+
+  if (!gst_value_binary_get_quark (reader, &quark) || quark == 0)
+    return G_TYPE_INVALID;
+  return g_type_from_name (g_quark_to_string (quark));
+}
+
+/* returns FALSE on errors, @structure is NULL for a NULL structure */
+static gboolean
+gst_value_binary_get_structure (GstValueBinaryReader * reader,
+    GstStructure ** structure, guint depth)
+{
+  GstStructure *s;
+  GQuark name, field;
+  guint i, n;
+
+  if (!gst_value_binary_get_quark (reader, &name))
+    return FALSE;
+  if (name == 0) {
+    *structure = NULL;
+    return TRUE;
+  }
+  if (!gst_value_binary_get_count (reader, &n))
+    return FALSE;
+
+  s = gst_structure_new_id_empty (name);
+  for (i = 0; i < n; i++) {
+    GValue value = G_VALUE_INIT;
+
+    if (!gst_value_binary_get_quark (reader, &field) || field == 0)
+      goto fail;
+    if (!gst_value_binary_get_value (reader, &value, depth + 1))
+      goto fail;
+    gst_structure_id_take_value (s, field, &value);
+  }
+  *structure = s;
+  return TRUE;
+
+fail:
+  gst_structure_free (s);
+  return FALSE;
+}
+
+static GstCapsFeatures *
+gst_value_binary_get_features (GstValueBinaryReader * reader,
+    gboolean * res)
+{
+  GstCapsFeatures *features;
+  guint8 kind;
+  guint i, n;
+
+  *res = FALSE;
+  if (!gst_value_binary_get_byte (reader, &kind))
+    return NULL;
+
+  switch (kind) {
+    case GST_VALUE_BINARY_FEATURES_NONE:
+      *res = TRUE;
+      return NULL;
+    case GST_VALUE_BINARY_FEATURES_ANY:
+      *res = TRUE;
+      return gst_caps_features_new_any ();
+    case GST_VALUE_BINARY_FEATURES_LIST:
+      if (!gst_value_binary_get_count (reader, &n))
+        return NULL;
+      features = gst_caps_features_new_empty ();
+      for (i = 0; i < n; i++) {
+        GQuark feature;
+
+        if (!gst_value_binary_get_quark (reader, &feature) || feature == 0) {
+          gst_caps_features_free (features);
+          return NULL;
+        }
+        gst_caps_features_add_id (features, feature);
+      }
+      *res = TRUE;
+      return features;
+    default:
+      return NULL;
+  }
+}
+
+static gboolean
+gst_value_binary_get_caps (GstValueBinaryReader * reader, GstCaps ** caps,
+    guint depth)
+{
+  GstCapsFeatures *features;
+  GstStructure *s;
+  GstCaps *res;
+  gboolean ok;
+  guint8 kind;
+  guint i, n;
+
+  if (!gst_value_binary_get_byte (reader, &kind))
+    return FALSE;
+
+  switch (kind) {
+    case GST_VALUE_BINARY_CAPS_NULL:
+      *caps = NULL;
+      return TRUE;
+    case GST_VALUE_BINARY_CAPS_ANY:
+      *caps = gst_caps_new_any ();
+      return TRUE;
+    case GST_VALUE_BINARY_CAPS_STRUCTURES:
+      break;
+    default:
+      return FALSE;
+  }
+
+  if (!gst_value_binary_get_count (reader, &n))
+    return FALSE;
+
+  res = gst_caps_new_empty ();
+  for (i = 0; i < n; i++) {
+    features = gst_value_binary_get_features (reader, &ok);
+    if (!ok)
+      goto fail;
+    if (!gst_value_binary_get_structure (reader, &s, depth + 1) || s == NULL) {
+      if (features)
+        gst_caps_features_free (features);
+      goto fail;
+    }
+    gst_caps_append_structure_full (res, s, features);
+  }
+  *caps = res;
+  return TRUE;
+
+fail:
+  gst_caps_unref (res);
+  return FALSE;
+}
+
+static gboolean
+gst_value_binary_get_tag_list (GstValueBinaryReader * reader,
+    GstTagList ** taglist, guint depth)
+{
+  GstTagList *list;
+  guint8 scope;
+  guint i, j, n, size;
+
+  if (!gst_value_binary_get_byte (reader, &scope))
+    return FALSE;
+  if (scope == 0) {
+    *taglist = NULL;
+    return TRUE;
+  }
+  if (scope - 1 > GST_TAG_SCOPE_GLOBAL)
+    return FALSE;
+  if (!gst_value_binary_get_count (reader, &n))
+    return FALSE;
+
+  list = gst_tag_list_new_empty ();
+  gst_tag_list_set_scope (list, (GstTagScope) (scope - 1));
+  for (i = 0; i < n; i++) {
+    gchar *tag;
+
+    if (!gst_value_binary_get_string (reader, &tag) || tag == NULL)
+      goto fail;
+    /* only accept tags that are registered with the right type, the
+     * taglist API would warn about anything else */
+    if (!gst_tag_exists (tag) || !gst_value_binary_get_count (reader, &size)) {
+      g_free (tag);
+      goto fail;
+    }
+    for (j = 0; j < size; j++) {
+      GValue value = G_VALUE_INIT;
+
+      if (!gst_value_binary_get_value (reader, &value, depth + 1)) {
+        g_free (tag);
+        goto fail;
+      }
+      if (G_VALUE_TYPE (&value) != gst_tag_get_type (tag)) {
+        g_value_unset (&value);
+        g_free (tag);
+        goto fail;
+      }
+      gst_tag_list_add_value (list, GST_TAG_MERGE_APPEND, tag, &value);
+      g_value_unset (&value);
+    }
+    g_free (tag);
+  }
+  *taglist = list;
+  return TRUE;
+
+fail:
+  gst_tag_list_unref (list);
+  return FALSE;
+}
+
+static gboolean
+gst_value_binary_get_value (GstValueBinaryReader * reader, GValue * dest,
+    guint depth)
+{
+  guint8 tag;
+
+  if (G_UNLIKELY (depth > GST_VALUE_BINARY_MAX_DEPTH))
+    return FALSE;
+  if (!gst_value_binary_get_byte (reader, &tag))
+    return FALSE;
+
+  switch (tag) {
+    case GST_VALUE_BINARY_BOOLEAN:
+    {
+      guint8 b;
+
+      if (!gst_value_binary_get_byte (reader, &b) || b > 1)
+        return FALSE;
+      g_value_init (dest, G_TYPE_BOOLEAN);
+      g_value_set_boolean (dest, b);
+      return TRUE;
+    }
+    case GST_VALUE_BINARY_INT:
+    {
+      gint v;
+
+      if (!gst_value_binary_get_int (reader, &v))
+        return FALSE;
+      g_value_init (dest, G_TYPE_INT);
+      g_value_set_int (dest, v);
+      return TRUE;
+    }
+    case GST_VALUE_BINARY_UINT:
+    {
+      guint v;
+
+      if (!gst_value_binary_get_uint (reader, &v))
+        return FALSE;
+      g_value_init (dest, G_TYPE_UINT);
+      g_value_set_uint (dest, v);
+      return TRUE;
+    }
+    case GST_VALUE_BINARY_INT64:
+    {
+      gint64 v;
+
+      if (!gst_value_binary_get_svarint (reader, &v))
+        return FALSE;
+      g_value_init (dest, G_TYPE_INT64);
+      g_value_set_int64 (dest, v);
+      return TRUE;
+    }
+    case GST_VALUE_BINARY_UINT64:
+    {
+      guint64 v;
+
+      if (!gst_value_binary_get_varint (reader, &v))
+        return FALSE;
+      g_value_init (dest, G_TYPE_UINT64);
+      g_value_set_uint64 (dest, v);
+      return TRUE;
+    }
+    case GST_VALUE_BINARY_FLOAT:
+    {
+      union
+      {
+        gfloat f;
+        guint32 u;
+      } u;
+
+      if (!gst_value_binary_get_uint32 (reader, &u.u))
+        return FALSE;
+      g_value_init (dest, G_TYPE_FLOAT);
+      g_value_set_float (dest, u.f);
+      return TRUE;
+    }
+    case GST_VALUE_BINARY_DOUBLE:
+    {
+      gdouble v;
+
+      if (!gst_value_binary_get_double (reader, &v))
+        return FALSE;
+      g_value_init (dest, G_TYPE_DOUBLE);
+      g_value_set_double (dest, v);
+      return TRUE;
+    }
+    case GST_VALUE_BINARY_STRING:
+    {
+      gchar *str;
+
+      if (!gst_value_binary_get_string (reader, &str))
+        return FALSE;
+      g_value_init (dest, G_TYPE_STRING);
+      g_value_take_string (dest, str);
+      return TRUE;
+    }
+    case GST_VALUE_BINARY_FRACTION:
+    {
+      gint n, d;
+
+      if (!gst_value_binary_get_int (reader, &n)
+          || !gst_value_binary_get_int (reader, &d) || d == 0)
+        return FALSE;
+      g_value_init (dest, GST_TYPE_FRACTION);
+      gst_value_set_fraction (dest, n, d);
+      return TRUE;
+    }
+    case GST_VALUE_BINARY_INT_RANGE:
+    {
+      /* ranges are stored as min / step, max / step and step like in the
+       * GValue itself */
+      gint min, max, step;
+
+      if (!gst_value_binary_get_int (reader, &min)
+          || !gst_value_binary_get_int (reader, &max)
+          || !gst_value_binary_get_int (reader, &step))
+        return FALSE;
+      if (step <= 0 || min >= max)
+        return FALSE;
+      g_value_init (dest, GST_TYPE_INT_RANGE);
+      dest->data[0].v_uint64 = (((guint64) (guint) min) << 32) | (guint) max;
+      INT_RANGE_STEP (dest) = step;
+      return TRUE;
+    }
+    case GST_VALUE_BINARY_INT64_RANGE:
+    {
+      gint64 min, max, step;
+
+      if (!gst_value_binary_get_svarint (reader, &min)
+          || !gst_value_binary_get_svarint (reader, &max)
+          || !gst_value_binary_get_svarint (reader, &step))
+        return FALSE;
+      if (step <= 0 || min >= max)
+        return FALSE;
+      g_value_init (dest, GST_TYPE_INT64_RANGE);
+      INT64_RANGE_MIN (dest) = min;
+      INT64_RANGE_MAX (dest) = max;
+      INT64_RANGE_STEP (dest) = step;
+      return TRUE;
+    }
+    case GST_VALUE_BINARY_DOUBLE_RANGE:
+    {
+      gdouble min, max;
+
+      if (!gst_value_binary_get_double (reader, &min)
+          || !gst_value_binary_get_double (reader, &max) || !(min < max))
+        return FALSE;
+      g_value_init (dest, GST_TYPE_DOUBLE_RANGE);
+      gst_value_set_double_range (dest, min, max);
+      return TRUE;
+    }
+    case GST_VALUE_BINARY_FRACTION_RANGE:
+    {
+      gint n1, d1, n2, d2;
+
+      if (!gst_value_binary_get_int (reader, &n1)
+          || !gst_value_binary_get_int (reader, &d1)
+          || !gst_value_binary_get_int (reader, &n2)
+          || !gst_value_binary_get_int (reader, &d2) || d1 == 0 || d2 == 0)
+        return FALSE;
+      if (gst_util_fraction_compare (n1, d1, n2, d2) >= 0)
+        return FALSE;
+      g_value_init (dest, GST_TYPE_FRACTION_RANGE);
+      gst_value_set_fraction_range_full (dest, n1, d1, n2, d2);
+      return TRUE;
+    }
+    case GST_VALUE_BINARY_LIST:
+    case GST_VALUE_BINARY_ARRAY:
+    {
+      GArray *array;
+      guint i, n;
+
+      if (!gst_value_binary_get_count (reader, &n))
+        return FALSE;
+      g_value_init (dest, tag == GST_VALUE_BINARY_LIST ?
+          GST_TYPE_LIST : GST_TYPE_ARRAY);
+      array = (GArray *) dest->data[0].v_pointer;
+      g_array_set_size (array, n);
+      for (i = 0; i < n; i++) {
+        if (!gst_value_binary_get_value (reader,
+                &g_array_index (array, GValue, i), depth + 1)) {
+          /* only unset the values that were read */
+          g_array_set_size (array, i);
+          g_value_unset (dest);
+          return FALSE;
+        }
+      }
+      return TRUE;
+    }
+    case GST_VALUE_BINARY_BITMASK:
+    {
+      guint64 v;
+
+      if (!gst_value_binary_get_uint64 (reader, &v))
+        return FALSE;
+      g_value_init (dest, GST_TYPE_BITMASK);
+      gst_value_set_bitmask (dest, v);
+      return TRUE;
+    }
+    case GST_VALUE_BINARY_ENUM:
+    {
+      GType type;
+      gint v;
+
+      type = gst_value_binary_get_type (reader);
+      if (!G_TYPE_IS_ENUM (type) || G_TYPE_IS_ABSTRACT (type)
+          || !gst_value_binary_get_int (reader, &v))
+        return FALSE;
+      g_value_init (dest, type);
+      g_value_set_enum (dest, v);
+      return TRUE;
+    }
+    case GST_VALUE_BINARY_FLAGS:
+    {
+      GType type;
+      guint v;
+
+      type = gst_value_binary_get_type (reader);
+      if (!G_TYPE_IS_FLAGS (type) || G_TYPE_IS_ABSTRACT (type)
+          || !gst_value_binary_get_uint (reader, &v))
+        return FALSE;
+      g_value_init (dest, type);
+      g_value_set_flags (dest, v);
+      return TRUE;
+    }
+    case GST_VALUE_BINARY_STRUCTURE:
+    {
+      GstStructure *s;
+
+      if (!gst_value_binary_get_structure (reader, &s, depth))
+        return FALSE;
+      g_value_init (dest, GST_TYPE_STRUCTURE);
+      g_value_take_boxed (dest, s);
+      return TRUE;
+    }
+    case GST_VALUE_BINARY_CAPS:
+    {
+      GstCaps *caps;
+
+      if (!gst_value_binary_get_caps (reader, &caps, depth))
+        return FALSE;
+      g_value_init (dest, GST_TYPE_CAPS);
+      g_value_take_boxed (dest, caps);
+      return TRUE;
+    }
+    case GST_VALUE_BINARY_CAPS_FEATURES:
+    {
+      GstCapsFeatures *features;
+      gboolean ok;
+
+      features = gst_value_binary_get_features (reader, &ok);
+      if (!ok)
+        return FALSE;
+      if (features == NULL)
+        features =
+            gst_caps_features_copy (GST_CAPS_FEATURES_MEMORY_SYSTEM_MEMORY);
+      g_value_init (dest, GST_TYPE_CAPS_FEATURES);
+      g_value_take_boxed (dest, features);
+      return TRUE;
+    }
+    case GST_VALUE_BINARY_TAG_LIST:
+    {
+      GstTagList *list;
+
+      if (!gst_value_binary_get_tag_list (reader, &list, depth))
+        return FALSE;
+      g_value_init (dest, GST_TYPE_TAG_LIST);
+      g_value_take_boxed (dest, list);
+      return TRUE;
+    }
+    case GST_VALUE_BINARY_OTHER:
+    {
+      const gchar *s;
+      gchar *str;
+      gssize len;
+      GType type;
+
+      type = gst_value_binary_get_type (reader);
+      if (!G_TYPE_IS_VALUE_TYPE (type) || G_TYPE_IS_ABSTRACT (type)
+          || !gst_value_binary_peek_string (reader, &s, &len) || s == NULL)
+        return FALSE;
+      str = g_strndup (s, len);
+      g_value_init (dest, type);
+      if (!gst_value_deserialize (dest, str)) {
+        g_value_unset (dest);
+        g_free (str);
+        return FALSE;
+      }
+      g_free (str);
+      return TRUE;
+    }
+    default:
+      return FALSE;
+  }
+}
+
+/**
+ * gst_value_deserialize_binary:
+ * @dest: (out caller-allocates): an uninitialized #GValue to fill with the
+ *     contents of the deserialization
+ * @data: (array length=size): data created with gst_value_serialize_binary()
+ * @size: the size of @data
+ * @consumed: (out) (allow-none): location for the number of bytes read
+ *     from @data, or %NULL
+ *
+ * Reads back a value that was written with gst_value_serialize_binary().
+ * The type of @dest is taken from the data, so @dest must be zero-filled
+ * and will be initialized by this function on success.
+ *
+ * Several values can be stored after each other, @consumed can be used to
+ * find the start of the next one.
+ *
+ * Returns: %TRUE on success, %FALSE if @data is not a valid serialization
+ *
+ * Since: 1.6
+ */
+gboolean
+gst_value_deserialize_binary (GValue * dest, const guint8 * data, gsize size,
+    gsize * consumed)
+{
+  GstValueBinaryReader reader;
+  guint8 version;
+
+  g_return_val_if_fail (dest != NULL, FALSE);
+  g_return_val_if_fail (G_VALUE_TYPE (dest) == G_TYPE_INVALID, FALSE);
+  g_return_val_if_fail (data != NULL || size == 0, FALSE);
+
+  reader.data = data;
+  reader.end = data + size;
+
+  if (!gst_value_binary_get_byte (&reader, &version)
+      || version != GST_VALUE_BINARY_VERSION)
+    return FALSE;
+  if (!gst_value_binary_get_value (&reader, dest, 0))
+    return FALSE;
+
+  if (consumed)
+    *consumed = reader.data - data;
+
+  return TRUE;
+}
+
 /**
  * gst_value_is_fixed:
  * @value: the #GValue to check
@@ -6172,6 +7332,12 @@ _priv_gst_value_initialize (void)
       sizeof (GstValueIntersectInfo), GST_VALUE_INTERSECT_TABLE_DEFAULT_SIZE);
   gst_value_subtract_funcs = g_array_sized_new (FALSE, FALSE,
       sizeof (GstValueSubtractInfo), GST_VALUE_SUBTRACT_TABLE_DEFAULT_SIZE);
+  gst_value_union_hash = g_hash_table_new (gst_value_type_pair_hash,
+      gst_value_type_pair_equal);
+  gst_value_intersect_hash = g_hash_table_new (gst_value_type_pair_hash,
+      gst_value_type_pair_equal);
+  gst_value_subtract_hash = g_hash_table_new (gst_value_type_pair_hash,
+      gst_value_type_pair_equal);
 
   REGISTER_SERIALIZATION (gst_int_range_get_type (), int_range);
   REGISTER_SERIALIZATION (gst_int64_range_get_type (), int64_range);
@@ -418,6 +418,12 @@ void            gst_value_init_and_copy         (GValue                *dest,
 gchar *         gst_value_serialize             (const GValue          *value) G_GNUC_MALLOC;
 gboolean        gst_value_deserialize           (GValue                *dest,
                                                  const gchar           *src);
+gboolean        gst_value_serialize_binary      (const GValue          *value,
+                                                 GByteArray            *dest);
+gboolean        gst_value_deserialize_binary    (GValue                *dest,
+                                                 const guint8          *data,
+                                                 gsize                  size,
+                                                 gsize                 *consumed);
 
 /* list */
 void            gst_value_list_append_value     (GValue         *value,
@@ -269,6 +269,11 @@ struct _GstBaseSinkPrivate
   GstClockTime rc_time;
   GstClockTime rc_next;
   gsize rc_accumulated;
+
+  /* max running time span of buffers rendered after one clock wait */
+  gint64 render_window;
+  /* chaining a run of a windowed list, with STREAM_LOCK */
+  gboolean window_run;
 };
 
 #define DO_RUNNING_AVG(avg,val,size) (((val) + ((size)-1) * (avg)) / (size))
@@ -297,6 +302,7 @@ struct _GstBaseSinkPrivate
 #define DEFAULT_ENABLE_LAST_SAMPLE  TRUE
 #define DEFAULT_THROTTLE_TIME       0
 #define DEFAULT_MAX_BITRATE         0
+#define DEFAULT_RENDER_WINDOW       -1
 
 enum
 {
@@ -312,6 +318,7 @@ enum
   PROP_RENDER_DELAY,
   PROP_THROTTLE_TIME,
   PROP_MAX_BITRATE,
+  PROP_RENDER_WINDOW,
   PROP_LAST
 };
 
@@ -534,6 +541,23 @@ gst_base_sink_class_init (GstBaseSinkClass * klass)
           "The maximum bits per second to render (0 = disabled)", 0,
           G_MAXUINT64, DEFAULT_MAX_BITRATE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstBaseSink:render-window:
+   *
+   * The maximum running time span of the buffers of a #GstBufferList that
+   * are rendered after a single clock wait. A list is split into runs of
+   * buffers that are due within render-window of the first buffer of the
+   * run, the sink waits on the clock once per run. Late buffers are still
+   * dropped and QoS is done one buffer at a time. -1 renders the complete
+   * list after waiting for its first buffer.
+   *
+   * Since: 1.6
+   */
+  g_object_class_install_property (gobject_class, PROP_RENDER_WINDOW,
+      g_param_spec_int64 ("render-window", "Render Window",
+          "Maximum running time span in nanoseconds of list buffers rendered "
+          "after one clock wait (-1 = whole list)", -1, G_MAXINT64,
+          DEFAULT_RENDER_WINDOW, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_base_sink_change_state);
@@ -665,6 +689,7 @@ gst_base_sink_init (GstBaseSink * basesink, gpointer g_class)
   g_atomic_int_set (&priv->enable_last_sample, DEFAULT_ENABLE_LAST_SAMPLE);
   priv->throttle_time = DEFAULT_THROTTLE_TIME;
   priv->max_bitrate = DEFAULT_MAX_BITRATE;
+  priv->render_window = DEFAULT_RENDER_WINDOW;
 
   GST_OBJECT_FLAG_SET (basesink, GST_ELEMENT_FLAG_SINK);
 }
@@ -1315,6 +1340,55 @@ gst_base_sink_get_max_bitrate (GstBaseSink * sink)
   return res;
 }
 
+/**
+ * gst_base_sink_set_render_window:
+ * @sink: a #GstBaseSink
+ * @window: the render window in nanoseconds, or -1
+ *
+ * Set the maximum running time span of the buffers of a #GstBufferList that
+ * will be rendered after a single clock wait. Lists are split into runs of
+ * buffers due within @window of the first buffer of the run. A value of -1
+ * renders complete lists after waiting for their first buffer.
+ *
+ * Since: 1.6
+ */
+void
+gst_base_sink_set_render_window (GstBaseSink * sink, gint64 window)
+{
+  g_return_if_fail (GST_IS_BASE_SINK (sink));
+
+  GST_OBJECT_LOCK (sink);
+  sink->priv->render_window = window;
+  GST_LOG_OBJECT (sink, "set render_window to %" G_GINT64_FORMAT, window);
+  GST_OBJECT_UNLOCK (sink);
+}
+
+/**
+ * gst_base_sink_get_render_window:
+ * @sink: a #GstBaseSink
+ *
+ * Get the maximum running time span of list buffers rendered after a single
+ * clock wait.
+ *
+ * Returns: the render window of @sink in nanoseconds, -1 when complete lists
+ * are rendered after one wait.
+ *
+ * Since: 1.6
+ */
+gint64
+gst_base_sink_get_render_window (GstBaseSink * sink)
+{
+  gint64 res;
+
+  g_return_val_if_fail (GST_IS_BASE_SINK (sink), -1);
+
+  GST_OBJECT_LOCK (sink);
+  res = sink->priv->render_window;
+  GST_OBJECT_UNLOCK (sink);
+
+  return res;
+}
+
 static void
 gst_base_sink_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
@@ -1352,6 +1426,9 @@ gst_base_sink_set_property (GObject * object, guint prop_id,
     case PROP_MAX_BITRATE:
       gst_base_sink_set_max_bitrate (sink, g_value_get_uint64 (value));
       break;
+    case PROP_RENDER_WINDOW:
+      gst_base_sink_set_render_window (sink, g_value_get_int64 (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1398,6 +1475,9 @@ gst_base_sink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_MAX_BITRATE:
       g_value_set_uint64 (value, gst_base_sink_get_max_bitrate (sink));
       break;
+    case PROP_RENDER_WINDOW:
+      g_value_set_int64 (value, gst_base_sink_get_render_window (sink));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3269,6 +3349,261 @@ count_list_bytes (GstBuffer ** buffer, guint idx, GstBaseSinkPrivate * priv)
   return TRUE;
 }
 
+/* call @func on each buffer of @list, for subclasses that don't handle
+ * buffer lists themselves */
+static GstFlowReturn
+gst_base_sink_render_each (GstBaseSink * basesink, GstBufferList * list,
+    GstFlowReturn (*func) (GstBaseSink * sink, GstBuffer * buffer))
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint i, len;
+
+  len = gst_buffer_list_length (list);
+  for (i = 0; i < len && ret == GST_FLOW_OK; i++)
+    ret = func (basesink, gst_buffer_list_get (list, i));
+
+  return ret;
+}
+
+/* a buffer list is synchronised on its first buffer. After rendering it,
+ * make the position, QoS and EOS timing follow its last buffer. */
+static void
+gst_base_sink_update_list_times (GstBaseSink * basesink, GstBufferList * list)
+{
+  GstBaseSinkClass *bclass;
+  GstBaseSinkPrivate *priv = basesink->priv;
+  GstSegment *segment = &basesink->segment;
+  GstClockTime start = GST_CLOCK_TIME_NONE, stop = GST_CLOCK_TIME_NONE;
+  GstClockTime sstart, sstop, rstop;
+  GstBuffer *last;
+  guint len;
+
+  len = gst_buffer_list_length (list);
+  if (len < 2 || segment->format != GST_FORMAT_TIME || segment->rate < 0.0)
+    return;
+
+  bclass = GST_BASE_SINK_GET_CLASS (basesink);
+  last = gst_buffer_list_get (list, len - 1);
+
+  if (bclass->get_times)
+    bclass->get_times (basesink, last, &start, &stop);
+  if (!GST_CLOCK_TIME_IS_VALID (start))
+    gst_base_sink_default_get_times (basesink, last, &start, &stop);
+  if (!GST_CLOCK_TIME_IS_VALID (start))
+    return;
+  if (!GST_CLOCK_TIME_IS_VALID (stop))
+    stop = start;
+
+  sstart = gst_segment_to_stream_time (segment, GST_FORMAT_TIME, start);
+  sstop = gst_segment_to_stream_time (segment, GST_FORMAT_TIME, stop);
+  rstop = gst_segment_to_running_time (segment, GST_FORMAT_TIME, stop);
+
+  GST_OBJECT_LOCK (basesink);
+  if (GST_CLOCK_TIME_IS_VALID (sstart))
+    priv->current_sstart = sstart;
+  if (GST_CLOCK_TIME_IS_VALID (sstop))
+    priv->current_sstop = sstop;
+  GST_OBJECT_UNLOCK (basesink);
+
+  if (GST_CLOCK_TIME_IS_VALID (rstop)) {
+    priv->current_rstop = rstop;
+    if (GST_CLOCK_TIME_IS_VALID (priv->eos_rtime))
+      priv->eos_rtime = rstop;
+  }
+}
+
+/* running time of the start of @buffer or -1. @rstop and @sstart, when not
+ * NULL, are set to the running time of its end and the stream time of its
+ * start. */
+static GstClockTime
+gst_base_sink_get_running_time (GstBaseSink * basesink, GstBuffer * buffer,
+    GstClockTime * rstop, GstClockTime * sstart)
+{
+  GstBaseSinkClass *bclass;
+  GstSegment *segment = &basesink->segment;
+  GstClockTime start = GST_CLOCK_TIME_NONE, stop = GST_CLOCK_TIME_NONE;
+
+  if (rstop)
+    *rstop = GST_CLOCK_TIME_NONE;
+  if (sstart)
+    *sstart = GST_CLOCK_TIME_NONE;
+
+  if (segment->format != GST_FORMAT_TIME)
+    return GST_CLOCK_TIME_NONE;
+
+  bclass = GST_BASE_SINK_GET_CLASS (basesink);
+  if (bclass->get_times)
+    bclass->get_times (basesink, buffer, &start, &stop);
+  if (!GST_CLOCK_TIME_IS_VALID (start))
+    gst_base_sink_default_get_times (basesink, buffer, &start, &stop);
+  if (!GST_CLOCK_TIME_IS_VALID (start))
+    return GST_CLOCK_TIME_NONE;
+
+  if (rstop && GST_CLOCK_TIME_IS_VALID (stop))
+    *rstop = gst_segment_to_running_time (segment, GST_FORMAT_TIME, stop);
+  if (sstart)
+    *sstart = gst_segment_to_stream_time (segment, GST_FORMAT_TIME, start);
+
+  return gst_segment_to_running_time (segment, GST_FORMAT_TIME, start);
+}
+
+static void
+gst_base_sink_post_qos_dropped (GstBaseSink * basesink, GstBuffer * buffer,
+    GstClockTime rstart, GstClockTime sstart, GstClockTimeDiff jitter)
+{
+  GstBaseSinkPrivate *priv = basesink->priv;
+  GstMessage *qos_msg;
+  GstClockTime timestamp, duration;
+
+  timestamp = GST_BUFFER_TIMESTAMP (buffer);
+  duration = GST_BUFFER_DURATION (buffer);
+
+  GST_CAT_DEBUG_OBJECT (GST_CAT_QOS, basesink,
+      "qos: dropped buffer rt %" GST_TIME_FORMAT ", st %" GST_TIME_FORMAT
+      ", ts %" GST_TIME_FORMAT ", dur %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (rstart), GST_TIME_ARGS (sstart), GST_TIME_ARGS (timestamp),
+      GST_TIME_ARGS (duration));
+  GST_CAT_DEBUG_OBJECT (GST_CAT_QOS, basesink,
+      "qos: rendered %" G_GUINT64_FORMAT ", dropped %" G_GUINT64_FORMAT,
+      priv->rendered, priv->dropped);
+
+  qos_msg =
+      gst_message_new_qos (GST_OBJECT_CAST (basesink), basesink->sync,
+      rstart, sstart, timestamp, duration);
+  gst_message_set_qos_values (qos_msg, jitter, priv->avg_rate, 1000000);
+  gst_message_set_qos_stats (qos_msg, GST_FORMAT_BUFFERS, priv->rendered,
+      priv->dropped);
+  gst_element_post_message (GST_ELEMENT_CAST (basesink), qos_msg);
+}
+
+typedef struct
+{
+  GstClockTime rstart;
+  GstClockTime rstop;
+  GstClockTime sstart;
+  GstClockTimeDiff jitter;
+  gboolean late;
+} GstBaseSinkRunBuffer;
+
+/* with STREAM_LOCK, PREROLL_LOCK
+ *
+ * Render a run of a windowed buffer list. Only the first buffer of the run
+ * waited for the clock, @first_late tells if it was too late. The other
+ * buffers are checked against the clock time after that wait: the late ones
+ * are dropped and the QoS is done for every buffer, like when they would have
+ * been chained one by one. */
+static GstFlowReturn
+gst_base_sink_render_run (GstBaseSink * basesink, GstBufferList * run,
+    gboolean first_late)
+{
+  GstBaseSinkClass *bclass = GST_BASE_SINK_GET_CLASS (basesink);
+  GstBaseSinkPrivate *priv = basesink->priv;
+  GstBaseSinkRunBuffer *bufs;
+  GstBufferList *render;
+  GstClock *clock;
+  GstClockTime now = GST_CLOCK_TIME_NONE, base_time = 0;
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint i, len;
+
+  GST_OBJECT_LOCK (basesink);
+  if ((clock = GST_ELEMENT_CLOCK (basesink))) {
+    gst_object_ref (clock);
+    base_time = GST_ELEMENT_CAST (basesink)->base_time;
+  }
+  GST_OBJECT_UNLOCK (basesink);
+  if (clock) {
+    now = gst_clock_get_time (clock);
+    gst_object_unref (clock);
+  }
+
+  len = gst_buffer_list_length (run);
+  bufs = g_new (GstBaseSinkRunBuffer, len);
+  render = gst_buffer_list_new_sized (len);
+
+  for (i = 0; i < len; i++) {
+    GstBuffer *buffer = gst_buffer_list_get (run, i);
+    GstBaseSinkRunBuffer *b = &bufs[i];
+    GstClockTime stime;
+
+    b->rstart = gst_base_sink_get_running_time (basesink, buffer, &b->rstop,
+        &b->sstart);
+
+    stime = gst_base_sink_adjust_time (basesink, b->rstart);
+    if (GST_CLOCK_TIME_IS_VALID (now) && GST_CLOCK_TIME_IS_VALID (stime))
+      b->jitter = GST_CLOCK_DIFF (stime + base_time, now);
+    else
+      b->jitter = 0;
+
+    if (i == 0) {
+      b->late = first_late;
+    } else if (G_UNLIKELY (priv->earliest_in_time != -1
+            && b->rstart < priv->earliest_in_time)) {
+      b->late = TRUE;
+    } else {
+      b->late = gst_base_sink_is_too_late (basesink,
+          GST_MINI_OBJECT_CAST (buffer), b->rstart, b->rstop,
+          b->jitter > 0 ? GST_CLOCK_EARLY : GST_CLOCK_OK, b->jitter, TRUE);
+    }
+
+    if (G_UNLIKELY (b->late)) {
+      priv->dropped++;
+      GST_DEBUG_OBJECT (basesink, "buffer %u of run late, dropping", i);
+      if (g_atomic_int_get (&priv->qos_enabled))
+        gst_base_sink_post_qos_dropped (basesink, buffer, b->rstart,
+            b->sstart, b->jitter);
+    } else {
+      gst_buffer_list_add (render, gst_buffer_ref (buffer));
+    }
+  }
+
+  if (gst_buffer_list_length (render) > 0) {
+    gint do_qos;
+
+    if (priv->max_bitrate) {
+      gst_buffer_list_foreach (render, (GstBufferListFunc) count_list_bytes,
+          priv);
+      priv->rc_next = priv->rc_time +
+          gst_util_uint64_scale (priv->rc_accumulated, 8 * GST_SECOND,
+          priv->max_bitrate);
+    }
+
+    do_qos = g_atomic_int_get (&priv->qos_enabled);
+    if (do_qos)
+      gst_base_sink_do_render_stats (basesink, TRUE);
+
+    gst_base_sink_set_last_buffer (basesink,
+        gst_buffer_list_get (render, gst_buffer_list_length (render) - 1));
+
+    GST_LOG_OBJECT (basesink, "rendering %u of %u buffers of run",
+        gst_buffer_list_length (render), len);
+    if (bclass->render_list)
+      ret = bclass->render_list (basesink, render);
+    else if (bclass->render)
+      ret = gst_base_sink_render_each (basesink, render, bclass->render);
+
+    if (do_qos)
+      gst_base_sink_do_render_stats (basesink, FALSE);
+  }
+
+  if (ret != GST_FLOW_STEP && !basesink->flushing) {
+    priv->rendered += gst_buffer_list_length (render);
+
+    for (i = 0; i < len; i++) {
+      priv->current_rstart = bufs[i].rstart;
+      priv->current_rstop = GST_CLOCK_TIME_IS_VALID (bufs[i].rstop) ?
+          bufs[i].rstop : bufs[i].rstart;
+      priv->current_jitter = bufs[i].jitter;
+      gst_base_sink_perform_qos (basesink, bufs[i].late);
+    }
+    gst_base_sink_update_list_times (basesink, run);
+  }
+
+  gst_buffer_list_unref (render);
+  g_free (bufs);
+
+  return ret;
+}
+
 /* with STREAM_LOCK, PREROLL_LOCK
  *
  * Takes a buffer and compare the timestamps with the last segment.
@@ -3288,7 +3623,7 @@ gst_base_sink_chain_unlocked (GstBaseSink * basesink, GstPad * pad,
   GstSegment *segment;
   GstBuffer *sync_buf;
   gint do_qos;
-  gboolean late, step_end, prepared = FALSE;
+  gboolean late, step_end, prepared = FALSE, qos_done = FALSE;
 
   if (G_UNLIKELY (basesink->flushing))
     goto flushing;
@@ -3384,6 +3719,12 @@ gst_base_sink_chain_unlocked (GstBaseSink * basesink, GstPad * pad,
         ret = bclass->prepare_list (basesink, GST_BUFFER_LIST_CAST (obj));
         if (G_UNLIKELY (ret != GST_FLOW_OK))
           goto prepare_failed;
+      } else if (bclass->prepare && !bclass->render_list) {
+        /* the buffers will be rendered one by one */
+        ret = gst_base_sink_render_each (basesink, GST_BUFFER_LIST_CAST (obj),
+            bclass->prepare);
+        if (G_UNLIKELY (ret != GST_FLOW_OK))
+          goto prepare_failed;
       }
     }
 
@@ -3404,6 +3745,17 @@ again:
   /* Don't skip if prepare() was called on time */
   late = late && !prepared;
 
+  if (is_list && priv->window_run) {
+    ret = gst_base_sink_render_run (basesink, GST_BUFFER_LIST_CAST (obj), late);
+    if (ret == GST_FLOW_STEP)
+      goto again;
+    if (G_UNLIKELY (basesink->flushing))
+      goto flushing;
+    late = FALSE;
+    qos_done = TRUE;
+    goto done;
+  }
+
   /* drop late buffers unconditionally, let's hope it's unlikely */
   if (G_UNLIKELY (late))
     goto dropped;
@@ -3429,14 +3781,22 @@ again:
     gst_base_sink_do_render_stats (basesink, TRUE);
 
   if (!is_list) {
-    /* For buffer lists do not set last buffer for now. */
     gst_base_sink_set_last_buffer (basesink, GST_BUFFER_CAST (obj));
 
     if (bclass->render)
       ret = bclass->render (basesink, GST_BUFFER_CAST (obj));
   } else {
+    GstBufferList *buffer_list = GST_BUFFER_LIST_CAST (obj);
+
+    /* the last buffer of the list is the last one rendered */
+    gst_base_sink_set_last_buffer (basesink,
+        gst_buffer_list_get (buffer_list,
+            gst_buffer_list_length (buffer_list) - 1));
+
     if (bclass->render_list)
-      ret = bclass->render_list (basesink, GST_BUFFER_LIST_CAST (obj));
+      ret = bclass->render_list (basesink, buffer_list);
+    else if (bclass->render)
+      ret = gst_base_sink_render_each (basesink, buffer_list, bclass->render);
   }
 
   if (do_qos)
@@ -3448,7 +3808,12 @@ again:
   if (G_UNLIKELY (basesink->flushing))
     goto flushing;
 
-  priv->rendered++;
+  if (is_list) {
+    priv->rendered += gst_buffer_list_length (GST_BUFFER_LIST_CAST (obj));
+    gst_base_sink_update_list_times (basesink, GST_BUFFER_LIST_CAST (obj));
+  } else {
+    priv->rendered++;
+  }
 
 done:
   if (step_end) {
@@ -3459,7 +3824,8 @@ done:
     goto again;
   }
 
-  gst_base_sink_perform_qos (basesink, late);
+  if (!qos_done)
+    gst_base_sink_perform_qos (basesink, late);
 
   GST_DEBUG_OBJECT (basesink, "object unref after render %p", obj);
   gst_mini_object_unref (GST_MINI_OBJECT_CAST (obj));
@@ -3499,35 +3865,15 @@ sync_failed:
   }
 dropped:
   {
-    priv->dropped++;
+    if (is_list)
+      priv->dropped += gst_buffer_list_length (GST_BUFFER_LIST_CAST (obj));
+    else
+      priv->dropped++;
     GST_DEBUG_OBJECT (basesink, "buffer late, dropping");
 
-    if (g_atomic_int_get (&priv->qos_enabled)) {
-      GstMessage *qos_msg;
-      GstClockTime timestamp, duration;
-
-      timestamp = GST_BUFFER_TIMESTAMP (GST_BUFFER_CAST (sync_buf));
-      duration = GST_BUFFER_DURATION (GST_BUFFER_CAST (sync_buf));
-
-      GST_CAT_DEBUG_OBJECT (GST_CAT_QOS, basesink,
-          "qos: dropped buffer rt %" GST_TIME_FORMAT ", st %" GST_TIME_FORMAT
-          ", ts %" GST_TIME_FORMAT ", dur %" GST_TIME_FORMAT,
-          GST_TIME_ARGS (priv->current_rstart),
-          GST_TIME_ARGS (priv->current_sstart), GST_TIME_ARGS (timestamp),
-          GST_TIME_ARGS (duration));
-      GST_CAT_DEBUG_OBJECT (GST_CAT_QOS, basesink,
-          "qos: rendered %" G_GUINT64_FORMAT ", dropped %" G_GUINT64_FORMAT,
-          priv->rendered, priv->dropped);
-
-      qos_msg =
-          gst_message_new_qos (GST_OBJECT_CAST (basesink), basesink->sync,
-          priv->current_rstart, priv->current_sstart, timestamp, duration);
-      gst_message_set_qos_values (qos_msg, priv->current_jitter, priv->avg_rate,
-          1000000);
-      gst_message_set_qos_stats (qos_msg, GST_FORMAT_BUFFERS, priv->rendered,
-          priv->dropped);
-      gst_element_post_message (GST_ELEMENT_CAST (basesink), qos_msg);
-    }
+    if (g_atomic_int_get (&priv->qos_enabled))
+      gst_base_sink_post_qos_dropped (basesink, sync_buf,
+          priv->current_rstart, priv->current_sstart, priv->current_jitter);
     goto done;
   }
 }
@@ -3576,6 +3922,58 @@ gst_base_sink_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   return gst_base_sink_chain_main (basesink, pad, buf, FALSE);
 }
 
+/* split @list in runs of buffers that are due within @window of the first
+ * buffer of the run and chain each run as a list so that we only wait once
+ * for the clock per run. */
+static GstFlowReturn
+gst_base_sink_chain_list_windowed (GstBaseSink * basesink, GstPad * pad,
+    GstBufferList * list, GstClockTime window)
+{
+  GstFlowReturn result = GST_FLOW_OK;
+  GstBufferList *run;
+  GstClockTime first, rt;
+  guint i, j, len;
+
+  len = gst_buffer_list_length (list);
+
+  for (i = 0; i < len && result == GST_FLOW_OK; i = j) {
+    first = gst_base_sink_get_running_time (basesink,
+        gst_buffer_list_get (list, i), NULL, NULL);
+
+    for (j = i + 1; j < len; j++) {
+      rt = gst_base_sink_get_running_time (basesink,
+          gst_buffer_list_get (list, j), NULL, NULL);
+
+      if (!GST_CLOCK_TIME_IS_VALID (first))
+        first = rt;
+      else if (GST_CLOCK_TIME_IS_VALID (rt) && rt > first + window)
+        break;
+    }
+
+    if (i == 0 && j == len) {
+      /* everything is due within the window */
+      run = gst_buffer_list_ref (list);
+    } else {
+      guint k;
+
+      GST_LOG_OBJECT (basesink, "rendering buffers %u-%u of %u", i, j - 1,
+          len);
+      run = gst_buffer_list_new_sized (j - i);
+      for (k = i; k < j; k++)
+        gst_buffer_list_add (run, gst_buffer_ref (gst_buffer_list_get (list,
+                    k)));
+    }
+    /* the lateness and QoS of the buffers of the run are checked one by one
+     * after waiting for the first one */
+    basesink->priv->window_run = TRUE;
+    result = gst_base_sink_chain_main (basesink, pad, run, TRUE);
+    basesink->priv->window_run = FALSE;
+  }
+  gst_buffer_list_unref (list);
+
+  return result;
+}
+
 static GstFlowReturn
 gst_base_sink_chain_list (GstPad * pad, GstObject * parent,
     GstBufferList * list)
@@ -3583,11 +3981,20 @@ gst_base_sink_chain_list (GstPad * pad, GstObject * parent,
   GstBaseSink *basesink;
   GstBaseSinkClass *bclass;
   GstFlowReturn result;
+  gint64 window;
+  gboolean sync;
 
   basesink = GST_BASE_SINK (parent);
   bclass = GST_BASE_SINK_GET_CLASS (basesink);
 
-  if (G_LIKELY (bclass->render_list)) {
+  GST_OBJECT_LOCK (basesink);
+  window = basesink->priv->render_window;
+  sync = basesink->sync;
+  GST_OBJECT_UNLOCK (basesink);
+
+  if (sync && window >= 0 && gst_buffer_list_length (list) > 0) {
+    result = gst_base_sink_chain_list_windowed (basesink, pad, list, window);
+  } else if (G_LIKELY (bclass->render_list)) {
     result = gst_base_sink_chain_main (basesink, pad, list, TRUE);
   } else {
     guint i, len;
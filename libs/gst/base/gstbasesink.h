@@ -249,6 +249,10 @@ guint64         gst_base_sink_get_throttle_time (GstBaseSink *sink);
 void            gst_base_sink_set_max_bitrate   (GstBaseSink *sink, guint64 max_bitrate);
 guint64         gst_base_sink_get_max_bitrate   (GstBaseSink *sink);
 
+/* render-window */
+void            gst_base_sink_set_render_window (GstBaseSink *sink, gint64 window);
+gint64          gst_base_sink_get_render_window (GstBaseSink *sink);
+
 GstClockReturn  gst_base_sink_wait_clock        (GstBaseSink *sink, GstClockTime time,
                                                  GstClockTimeDiff * jitter);
 GstFlowReturn   gst_base_sink_wait              (GstBaseSink *sink, GstClockTime time,
@@ -2393,16 +2393,70 @@ unexpected_length:
   }
 }
 
-/* must be called with LIVE_LOCK */
+/* must be called with LIVE_LOCK and STREAM_LOCK and a writable @list.
+ * Timestamps and syncs each buffer of @list like a buffer from create(). */
+static GstFlowReturn
+gst_base_src_sync_list (GstBaseSrc * src, guint64 offset, GstBufferList * list)
+{
+  GstClockReturn status;
+  GstBuffer *buf;
+  guint i, len;
+
+  len = gst_buffer_list_length (list);
+  for (i = 0; i < len; i++) {
+    buf = gst_buffer_list_get (list, i);
+
+    /* no timestamp set and we are at offset 0, we can timestamp with 0 */
+    if (i == 0 && offset == 0 && src->segment.time == 0
+        && GST_BUFFER_DTS (buf) == -1 && !src->is_live) {
+      GST_DEBUG_OBJECT (src, "setting first timestamp to 0");
+      if (!gst_buffer_is_writable (buf)) {
+        buf = gst_buffer_copy (buf);
+        gst_buffer_list_remove (list, i, 1);
+        gst_buffer_list_insert (list, i, buf);
+      }
+      GST_BUFFER_DTS (buf) = 0;
+    }
+
+    status = gst_base_src_do_sync (src, buf);
+
+    /* waiting for the clock could have made us flushing */
+    if (G_UNLIKELY (src->priv->flushing))
+      return GST_FLOW_FLUSHING;
+
+    switch (status) {
+      case GST_CLOCK_EARLY:
+        GST_DEBUG_OBJECT (src, "buffer %u too late!, returning anyway", i);
+        break;
+      case GST_CLOCK_OK:
+        break;
+      case GST_CLOCK_UNSCHEDULED:
+        /* the caller decides between flushing and retrying */
+        GST_DEBUG_OBJECT (src, "clock was unscheduled (%d)", status);
+        return GST_FLOW_CUSTOM_SUCCESS;
+      default:
+        GST_ELEMENT_ERROR (src, CORE, CLOCK,
+            (_("Internal clock error.")),
+            ("clock returned unexpected return value %d", status));
+        return GST_FLOW_ERROR;
+    }
+  }
+  return GST_FLOW_OK;
+}
+
+/* must be called with LIVE_LOCK. When @list is not %NULL, the subclass is
+ * asked to create a list of buffers first, which is returned in @list, and
+ * @buf is only used when it doesn't support that. */
 static GstFlowReturn
 gst_base_src_get_range (GstBaseSrc * src, guint64 offset, guint length,
-    GstBuffer ** buf)
+    GstBuffer ** buf, GstBufferList ** list)
 {
   GstFlowReturn ret;
   GstBaseSrcClass *bclass;
   GstClockReturn status;
   GstBuffer *res_buf;
   GstBuffer *in_buf;
+  GstBufferList *res_list;
 
   bclass = GST_BASE_SRC_GET_CLASS (src);
 
@@ -2451,6 +2505,15 @@ again:
       G_GINT64_FORMAT, offset, length, src->segment.time);
 
   res_buf = in_buf = *buf;
+  res_list = NULL;
+
+  if (list != NULL && bclass->create_list != NULL) {
+    ret = bclass->create_list (src, offset, length, &res_list);
+    if (ret == GST_FLOW_OK && res_list != NULL)
+      goto have_list;
+    if (ret != GST_FLOW_NOT_SUPPORTED)
+      goto list_not_ok;
+  }
 
   ret = bclass->create (src, offset, length, &res_buf);
 
@@ -2550,7 +2613,63 @@ again:
 
   return ret;
 
+have_list:
+  {
+    guint len;
+
+    if (G_UNLIKELY (g_atomic_int_get (&src->priv->has_pending_eos))) {
+      gst_buffer_list_unref (res_list);
+      src->priv->forced_eos = TRUE;
+      goto eos;
+    }
+
+    res_list = gst_buffer_list_make_writable (res_list);
+    len = gst_buffer_list_length (res_list);
+
+    /* one buffer was already counted above, drop the ones after the last
+     * buffer we are allowed to produce */
+    if (G_UNLIKELY (src->num_buffers_left >= 0) && len > 0) {
+      if (len - 1 > (guint) src->num_buffers_left) {
+        gst_buffer_list_remove (res_list, src->num_buffers_left + 1,
+            len - 1 - src->num_buffers_left);
+        len = src->num_buffers_left + 1;
+      }
+      src->num_buffers_left -= len - 1;
+    }
+
+    ret = gst_base_src_sync_list (src, offset, res_list);
+    if (G_LIKELY (ret == GST_FLOW_OK)) {
+      *list = res_list;
+      return ret;
+    }
+    gst_buffer_list_unref (res_list);
+
+    /* the clock was unscheduled, just like for a single buffer */
+    if (ret == GST_FLOW_CUSTOM_SUCCESS) {
+      if (!src->live_running) {
+        GST_DEBUG_OBJECT (src, "clock was unscheduled, returning FLUSHING");
+        ret = GST_FLOW_FLUSHING;
+      } else {
+        GST_DEBUG_OBJECT (src, "clock was unscheduled, but we are running");
+        goto again;
+      }
+    }
+    return ret;
+  }
+
   /* ERROR */
+list_not_ok:
+  {
+    GST_DEBUG_OBJECT (src, "create_list returned %d (%s)", ret,
+        gst_flow_get_name (ret));
+    if (res_list)
+      gst_buffer_list_unref (res_list);
+    if (G_UNLIKELY (g_atomic_int_get (&src->priv->has_pending_eos))) {
+      src->priv->forced_eos = TRUE;
+      goto eos;
+    }
+    return ret;
+  }
 stopped:
   {
     GST_DEBUG_OBJECT (src, "wait_playing returned %d (%s)", ret,
@@ -2620,7 +2739,7 @@ gst_base_src_getrange (GstPad * pad, GstObject * parent, guint64 offset,
   if (G_UNLIKELY (src->priv->flushing))
     goto flushing;
 
-  res = gst_base_src_get_range (src, offset, length, buf);
+  res = gst_base_src_get_range (src, offset, length, buf, NULL);
 
 done:
   GST_LIVE_UNLOCK (src);
@@ -2659,11 +2778,90 @@ start_failed:
   }
 }
 
+/* figure out the new position after @buf and store it in the segment.
+ * Returns %TRUE when the end of the segment was reached.
+ * with LIVE_LOCK and STREAM_LOCK */
+static gboolean
+gst_base_src_update_position (GstBaseSrc * src, GstBuffer * buf,
+    gint64 * position)
+{
+  gboolean eos = FALSE;
+
+  switch (src->segment.format) {
+    case GST_FORMAT_BYTES:
+    {
+      guint bufsize = gst_buffer_get_size (buf);
+
+      /* the loop subtracted the blocksize for negative rates */
+      if (src->segment.rate >= 0.0)
+        *position += bufsize;
+      break;
+    }
+    case GST_FORMAT_TIME:
+    {
+      GstClockTime start, duration;
+
+      start = GST_BUFFER_TIMESTAMP (buf);
+      duration = GST_BUFFER_DURATION (buf);
+
+      if (GST_CLOCK_TIME_IS_VALID (start))
+        *position = start;
+      else
+        *position = src->segment.position;
+
+      if (GST_CLOCK_TIME_IS_VALID (duration)) {
+        if (src->segment.rate >= 0.0)
+          *position += duration;
+        else if (*position > duration)
+          *position -= duration;
+        else
+          *position = 0;
+      }
+      break;
+    }
+    case GST_FORMAT_DEFAULT:
+      if (src->segment.rate >= 0.0)
+        *position = GST_BUFFER_OFFSET_END (buf);
+      else
+        *position = GST_BUFFER_OFFSET (buf);
+      break;
+    default:
+      *position = -1;
+      break;
+  }
+  if (*position != -1) {
+    if (src->segment.rate >= 0.0) {
+      /* positive rate, check if we reached the stop */
+      if (src->segment.stop != -1) {
+        if (*position >= src->segment.stop) {
+          eos = TRUE;
+          *position = src->segment.stop;
+        }
+      }
+    } else {
+      /* negative rate, check if we reached the start. start is always set to
+       * something different from -1 */
+      if (*position <= src->segment.start) {
+        eos = TRUE;
+        *position = src->segment.start;
+      }
+      /* when going reverse, all buffers are DISCONT */
+      src->priv->discont = TRUE;
+    }
+    GST_OBJECT_LOCK (src);
+    src->segment.position = *position;
+    GST_OBJECT_UNLOCK (src);
+  }
+
+  return eos;
+}
+
 static void
 gst_base_src_loop (GstPad * pad)
 {
   GstBaseSrc *src;
   GstBuffer *buf = NULL;
+  GstBufferList *list = NULL;
   GstFlowReturn ret;
   gint64 position;
   gboolean eos;
@@ -2728,7 +2926,10 @@ gst_base_src_loop (GstPad * pad)
   GST_LOG_OBJECT (src, "next_ts %" GST_TIME_FORMAT " size %u",
       GST_TIME_ARGS (position), blocksize);
 
-  ret = gst_base_src_get_range (src, position, blocksize, &buf);
+  /* lists are only created for forward playback, reverse playback needs to
+   * go over the data one block at a time */
+  ret = gst_base_src_get_range (src, position, blocksize, &buf,
+      src->segment.rate >= 0.0 ? &list : NULL);
   if (G_UNLIKELY (ret != GST_FLOW_OK)) {
     GST_INFO_OBJECT (src, "pausing after gst_base_src_get_range() = %s",
         gst_flow_get_name (ret));
@@ -2736,7 +2937,8 @@ gst_base_src_loop (GstPad * pad)
     goto pause;
   }
   /* this should not happen */
-  if (G_UNLIKELY (buf == NULL))
+  if (G_UNLIKELY (buf == NULL && (list == NULL
+              || gst_buffer_list_length (list) == 0)))
     goto null_buffer;
 
   /* push events to close/start our segment before we push the buffer. */
@@ -2768,81 +2970,43 @@ gst_base_src_loop (GstPad * pad)
   }
 
   /* figure out the new position */
-  switch (src->segment.format) {
-    case GST_FORMAT_BYTES:
-    {
-      guint bufsize = gst_buffer_get_size (buf);
-
-      /* we subtracted above for negative rates */
-      if (src->segment.rate >= 0.0)
-        position += bufsize;
-      break;
-    }
-    case GST_FORMAT_TIME:
-    {
-      GstClockTime start, duration;
-
-      start = GST_BUFFER_TIMESTAMP (buf);
-      duration = GST_BUFFER_DURATION (buf);
+  if (list == NULL) {
+    eos = gst_base_src_update_position (src, buf, &position);
+  } else {
+    guint i, len;
 
-      if (GST_CLOCK_TIME_IS_VALID (start))
-        position = start;
-      else
-        position = src->segment.position;
+    len = gst_buffer_list_length (list);
+    for (i = 0; i < len && !eos; i++)
+      eos = gst_base_src_update_position (src, gst_buffer_list_get (list, i),
+          &position);
 
-      if (GST_CLOCK_TIME_IS_VALID (duration)) {
-        if (src->segment.rate >= 0.0)
-          position += duration;
-        else if (position > duration)
-          position -= duration;
-        else
-          position = 0;
-      }
-      break;
+    /* drop the buffers after the end of the segment */
+    if (G_UNLIKELY (i < len)) {
+      GST_DEBUG_OBJECT (src, "dropping %u buffers after segment end", len - i);
+      gst_buffer_list_remove (list, i, len - i);
     }
-    case GST_FORMAT_DEFAULT:
-      if (src->segment.rate >= 0.0)
-        position = GST_BUFFER_OFFSET_END (buf);
-      else
-        position = GST_BUFFER_OFFSET (buf);
-      break;
-    default:
-      position = -1;
-      break;
   }
-  if (position != -1) {
-    if (src->segment.rate >= 0.0) {
-      /* positive rate, check if we reached the stop */
-      if (src->segment.stop != -1) {
-        if (position >= src->segment.stop) {
-          eos = TRUE;
-          position = src->segment.stop;
-        }
-      }
+  if (G_UNLIKELY (src->priv->discont)) {
+    GST_INFO_OBJECT (src, "marking pending DISCONT");
+    if (list == NULL) {
+      buf = gst_buffer_make_writable (buf);
     } else {
-      /* negative rate, check if we reached the start. start is always set to
-       * something different from -1 */
-      if (position <= src->segment.start) {
-        eos = TRUE;
-        position = src->segment.start;
+      buf = gst_buffer_list_get (list, 0);
+      if (!gst_buffer_is_writable (buf)) {
+        buf = gst_buffer_copy (buf);
+        gst_buffer_list_remove (list, 0, 1);
+        gst_buffer_list_insert (list, 0, buf);
       }
-      /* when going reverse, all buffers are DISCONT */
-      src->priv->discont = TRUE;
     }
-    GST_OBJECT_LOCK (src);
-    src->segment.position = position;
-    GST_OBJECT_UNLOCK (src);
-  }
-
-  if (G_UNLIKELY (src->priv->discont)) {
-    GST_INFO_OBJECT (src, "marking pending DISCONT");
-    buf = gst_buffer_make_writable (buf);
     GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DISCONT);
     src->priv->discont = FALSE;
   }
   GST_LIVE_UNLOCK (src);
 
-  ret = gst_pad_push (pad, buf);
+  if (list == NULL)
+    ret = gst_pad_push (pad, buf);
+  else
+    ret = gst_pad_push_list (pad, list);
   if (G_UNLIKELY (ret != GST_FLOW_OK)) {
     if (ret == GST_FLOW_NOT_NEGOTIATED) {
       goto not_negotiated;
@@ -2949,6 +3113,8 @@ null_buffer:
   {
     GST_ELEMENT_ERROR (src, STREAM, FAILED,
         (_("Internal data flow error.")), ("element returned NULL buffer"));
+    if (list)
+      gst_buffer_list_unref (list);
     GST_LIVE_UNLOCK (src);
     goto done;
   }
@@ -159,6 +159,13 @@ struct _GstBaseSrc {
  *   default implementation will create a new buffer from the negotiated allocator.
  * @fill: Ask the subclass to fill the buffer with data for offset and size. The
  *   passed buffer is guaranteed to hold the requested amount of bytes.
+ * @create_list: Ask the subclass to create a list of buffers in one go, size
+ *   is the requested size of each buffer. Used instead of @create in push
+ *   mode during forward playback. The buffers in the list are timestamped,
+ *   synchronised and counted for #GstBaseSrc:num-buffers one by one and the
+ *   list is pushed with gst_pad_push_list(). Returning GST_FLOW_NOT_SUPPORTED
+ *   makes the base class call @create instead for this iteration.
+ *   Since: 1.6
  *
  * Subclasses can override any of the available virtual methods or not, as
  * needed. At the minimum, the @create method should be overridden to produce
@@ -229,8 +236,12 @@ struct _GstBaseSrcClass {
   GstFlowReturn (*fill)         (GstBaseSrc *src, guint64 offset, guint size,
                                  GstBuffer *buf);
 
+  /* ask the subclass to create several buffers at once */
+  GstFlowReturn (*create_list)  (GstBaseSrc *src, guint64 offset, guint size,
+                                 GstBufferList **list);
+
   /*< private >*/
-  gpointer       _gst_reserved[GST_PADDING_LARGE];
+  gpointer       _gst_reserved[GST_PADDING_LARGE - 1];
 };
 
 GType gst_base_src_get_type (void);
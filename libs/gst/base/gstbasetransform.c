@@ -220,11 +220,16 @@ enum
 };
 
 #define DEFAULT_PROP_QOS	FALSE
+#define DEFAULT_PROP_STATS_INTERVAL	0
+#define DEFAULT_PROP_PREFER_POOL	FALSE
 
 enum
 {
   PROP_0,
-  PROP_QOS
+  PROP_QOS,
+  PROP_STATS,
+  PROP_STATS_INTERVAL,
+  PROP_PREFER_POOL
 };
 
 #define GST_BASE_TRANSFORM_GET_PRIVATE(obj)  \
@@ -267,6 +272,23 @@ struct _GstBaseTransformPrivate
   GstAllocator *allocator;
   GstAllocationParams params;
   GstQuery *query;
+
+  /* buffer handling stats, with LOCK */
+  guint64 n_passthrough;
+  guint64 n_in_place;
+  guint64 n_copied;
+  guint64 n_allocated;
+  guint64 bytes_copied;
+  guint stats_interval;
+
+  /* pool for making in-place buffers writable, streaming thread only */
+  gboolean prefer_pool;
+  GstBufferPool *copy_pool;
+  gsize copy_pool_size;
+  /* size of the last input that did not match the copy pool and how many
+   * buffers in a row had it */
+  gsize copy_miss_size;
+  guint copy_misses;
 };
 
 
@@ -392,6 +414,58 @@ gst_base_transform_class_init (GstBaseTransformClass * klass)
       g_param_spec_boolean ("qos", "QoS", "Handle Quality-of-Service events",
           DEFAULT_PROP_QOS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstBaseTransform:stats:
+   *
+   * Various #GstBaseTransform statistics. This property returns a
+   * #GstStructure with name "GstBaseTransformStats" with the following
+   * fields:
+   *
+   * - "passthrough"  G_TYPE_UINT64  buffers pushed through unmodified
+   * - "in-place"     G_TYPE_UINT64  buffers processed in place
+   * - "copied"       G_TYPE_UINT64  buffers copied to make them writable
+   * - "allocated"    G_TYPE_UINT64  output buffers newly allocated
+   * - "bytes-copied" G_TYPE_UINT64  bytes copied to make buffers writable
+   *
+   * The counters are reset when the element is activated.
+   *
+   * Since: 1.6
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Buffer handling statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstBaseTransform:stats-interval:
+   *
+   * Post an element message with the #GstBaseTransform:stats structure
+   * every stats-interval buffers. 0 disables posting.
+   *
+   * Since: 1.6
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS_INTERVAL,
+      g_param_spec_uint ("stats-interval", "Stats interval",
+          "Post the stats as element message every this many buffers "
+          "(0 = never)", 0, G_MAXUINT, DEFAULT_PROP_STATS_INTERVAL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstBaseTransform:prefer-pool:
+   *
+   * When processing in place and the input buffer is not writable, copy
+   * it into a buffer from an internal #GstBufferPool instead of allocating
+   * a new copy for every buffer. This works best for streams with a fixed
+   * buffer size, such as raw video.
+   *
+   * Since: 1.6
+   */
+  g_object_class_install_property (gobject_class, PROP_PREFER_POOL,
+      g_param_spec_boolean ("prefer-pool", "Prefer pool",
+          "Copy non-writable buffers into pooled buffers for in-place "
+          "processing", DEFAULT_PROP_PREFER_POOL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gobject_class->finalize = gst_base_transform_finalize;
 
   klass->passthrough_on_same_caps = FALSE;
@@ -465,6 +539,8 @@ gst_base_transform_init (GstBaseTransform * trans,
   priv->pad_mode = GST_PAD_MODE_NONE;
   priv->gap_aware = FALSE;
   priv->prefer_passthrough = TRUE;
+  priv->stats_interval = DEFAULT_PROP_STATS_INTERVAL;
+  priv->prefer_pool = DEFAULT_PROP_PREFER_POOL;
 
   priv->passthrough = FALSE;
   if (bclass->transform == NULL) {
@@ -1572,6 +1648,89 @@ gst_base_transform_query (GstPad * pad, GstObject * parent, GstQuery * query)
   return ret;
 }
 
+static void
+gst_base_transform_clear_copy_pool (GstBaseTransform * trans)
+{
+  GstBaseTransformPrivate *priv = trans->priv;
+
+  if (priv->copy_pool) {
+    gst_buffer_pool_set_active (priv->copy_pool, FALSE);
+    gst_object_unref (priv->copy_pool);
+    priv->copy_pool = NULL;
+  }
+  priv->copy_misses = 0;
+}
+
+/* number of buffers in a row with the same new size after which the copy pool
+ * is made again for that size */
+#define COPY_POOL_RESIZE_AFTER 16
+
+/* copy @inbuf into a buffer of the copy pool. The default pool only recycles
+ * buffers of the configured size. Inputs of another size are not copied from
+ * the pool, the pool is only made again for a new size once enough buffers in
+ * a row had it, so that streams with varying sizes don't recreate it all the
+ * time. Returns NULL when no pooled copy could be made. */
+static GstBuffer *
+gst_base_transform_copy_from_pool (GstBaseTransform * trans, GstBuffer * inbuf)
+{
+  GstBaseTransformPrivate *priv = trans->priv;
+  GstBuffer *outbuf = NULL;
+  GstMapInfo map;
+  gsize size;
+
+  size = gst_buffer_get_size (inbuf);
+  if (size == 0 || size > G_MAXUINT)
+    return NULL;
+
+  if (priv->copy_pool && priv->copy_pool_size != size) {
+    if (priv->copy_miss_size != size) {
+      priv->copy_miss_size = size;
+      priv->copy_misses = 0;
+    }
+    if (++priv->copy_misses < COPY_POOL_RESIZE_AFTER)
+      return NULL;
+
+    GST_DEBUG_OBJECT (trans, "input size changed from %" G_GSIZE_FORMAT
+        " to %" G_GSIZE_FORMAT, priv->copy_pool_size, size);
+    gst_base_transform_clear_copy_pool (trans);
+  }
+  priv->copy_misses = 0;
+
+  if (priv->copy_pool == NULL) {
+    GstBufferPool *pool;
+    GstStructure *config;
+
+    GST_DEBUG_OBJECT (trans, "making copy pool for size %" G_GSIZE_FORMAT,
+        size);
+    pool = gst_buffer_pool_new ();
+    config = gst_buffer_pool_get_config (pool);
+    gst_buffer_pool_config_set_params (config, NULL, size, 0, 0);
+    if (!gst_buffer_pool_set_config (pool, config) ||
+        !gst_buffer_pool_set_active (pool, TRUE)) {
+      GST_WARNING_OBJECT (trans, "failed to set up copy pool");
+      gst_object_unref (pool);
+      return NULL;
+    }
+    priv->copy_pool = pool;
+    priv->copy_pool_size = size;
+  }
+
+  if (gst_buffer_pool_acquire_buffer (priv->copy_pool, &outbuf,
+          NULL) != GST_FLOW_OK)
+    return NULL;
+
+  if (!gst_buffer_map (inbuf, &map, GST_MAP_READ)) {
+    gst_buffer_unref (outbuf);
+    return NULL;
+  }
+  gst_buffer_fill (outbuf, 0, map.data, map.size);
+  gst_buffer_unmap (inbuf, &map);
+
+  gst_buffer_copy_into (outbuf, inbuf, GST_BUFFER_COPY_METADATA, 0, -1);
+
+  return outbuf;
+}
+
 /* this function either returns the input buffer without incrementing the
  * refcount or it allocates a new (writable) buffer */
 static GstFlowReturn
@@ -1620,9 +1779,22 @@ default_prepare_output_buffer (GstBaseTransform * trans,
       GST_DEBUG_OBJECT (trans, "inplace reuse writable input buffer");
       *outbuf = inbuf;
     } else {
-      GST_DEBUG_OBJECT (trans, "making writable buffer copy");
-      /* we make a copy of the input buffer */
-      *outbuf = gst_buffer_copy (inbuf);
+      gboolean prefer_pool;
+
+      GST_OBJECT_LOCK (trans);
+      prefer_pool = priv->prefer_pool;
+      GST_OBJECT_UNLOCK (trans);
+
+      *outbuf = NULL;
+      if (prefer_pool) {
+        GST_DEBUG_OBJECT (trans, "making writable buffer copy from pool");
+        *outbuf = gst_base_transform_copy_from_pool (trans, inbuf);
+      }
+      if (*outbuf == NULL) {
+        GST_DEBUG_OBJECT (trans, "making writable buffer copy");
+        /* we make a copy of the input buffer */
+        *outbuf = gst_buffer_copy (inbuf);
+      }
     }
     goto done;
   }
@@ -1965,6 +2137,54 @@ gst_base_transform_src_eventfunc (GstBaseTransform * trans, GstEvent * event)
   return ret;
 }
 
+/* with LOCK */
+static GstStructure *
+gst_base_transform_get_stats (GstBaseTransform * trans)
+{
+  GstBaseTransformPrivate *priv = trans->priv;
+
+  return gst_structure_new ("GstBaseTransformStats",
+      "passthrough", G_TYPE_UINT64, priv->n_passthrough,
+      "in-place", G_TYPE_UINT64, priv->n_in_place,
+      "copied", G_TYPE_UINT64, priv->n_copied,
+      "allocated", G_TYPE_UINT64, priv->n_allocated,
+      "bytes-copied", G_TYPE_UINT64, priv->bytes_copied, NULL);
+}
+
+/* account for how the output buffer for @inbuf was obtained and post the
+ * stats when the interval is reached */
+static void
+gst_base_transform_update_stats (GstBaseTransform * trans, GstBuffer * inbuf,
+    GstBuffer * outbuf, gboolean want_in_place)
+{
+  GstBaseTransformPrivate *priv = trans->priv;
+  GstStructure *stats = NULL;
+  guint64 total;
+
+  GST_OBJECT_LOCK (trans);
+  if (priv->passthrough) {
+    priv->n_passthrough++;
+  } else if (outbuf == inbuf) {
+    priv->n_in_place++;
+  } else if (want_in_place) {
+    priv->n_copied++;
+    priv->bytes_copied += gst_buffer_get_size (inbuf);
+  } else {
+    priv->n_allocated++;
+  }
+  if (priv->stats_interval > 0) {
+    total = priv->n_passthrough + priv->n_in_place + priv->n_copied +
+        priv->n_allocated;
+    if (total % priv->stats_interval == 0)
+      stats = gst_base_transform_get_stats (trans);
+  }
+  GST_OBJECT_UNLOCK (trans);
+
+  if (stats)
+    gst_element_post_message (GST_ELEMENT_CAST (trans),
+        gst_message_new_element (GST_OBJECT_CAST (trans), stats));
+}
+
 /* perform a transform on @inbuf and put the result in @outbuf.
  *
  * This function is common to the push and pull-based operations.
@@ -2102,6 +2322,9 @@ no_qos:
   GST_DEBUG_OBJECT (trans, "using allocated buffer in %p, out %p", inbuf,
       *outbuf);
 
+  want_in_place = (bclass->transform_ip != NULL) && priv->always_in_place;
+  gst_base_transform_update_stats (trans, inbuf, *outbuf, want_in_place);
+
   /* now perform the needed transform */
   if (priv->passthrough) {
     /* In passthrough mode, give transform_ip a look at the
@@ -2114,8 +2337,6 @@ no_qos:
       GST_DEBUG_OBJECT (trans, "element is in passthrough");
     }
   } else {
-    want_in_place = (bclass->transform_ip != NULL) && priv->always_in_place;
-
     if (want_in_place) {
       GST_DEBUG_OBJECT (trans, "doing inplace transform");
       ret = bclass->transform_ip (trans, *outbuf);
@@ -2295,6 +2516,16 @@ gst_base_transform_set_property (GObject * object, guint prop_id,
     case PROP_QOS:
       gst_base_transform_set_qos_enabled (trans, g_value_get_boolean (value));
       break;
+    case PROP_STATS_INTERVAL:
+      GST_OBJECT_LOCK (trans);
+      trans->priv->stats_interval = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (trans);
+      break;
+    case PROP_PREFER_POOL:
+      GST_OBJECT_LOCK (trans);
+      trans->priv->prefer_pool = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (trans);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2313,6 +2544,21 @@ gst_base_transform_get_property (GObject * object, guint prop_id,
     case PROP_QOS:
       g_value_set_boolean (value, gst_base_transform_is_qos_enabled (trans));
       break;
+    case PROP_STATS:
+      GST_OBJECT_LOCK (trans);
+      g_value_take_boxed (value, gst_base_transform_get_stats (trans));
+      GST_OBJECT_UNLOCK (trans);
+      break;
+    case PROP_STATS_INTERVAL:
+      GST_OBJECT_LOCK (trans);
+      g_value_set_uint (value, trans->priv->stats_interval);
+      GST_OBJECT_UNLOCK (trans);
+      break;
+    case PROP_PREFER_POOL:
+      GST_OBJECT_LOCK (trans);
+      g_value_set_boolean (value, trans->priv->prefer_pool);
+      GST_OBJECT_UNLOCK (trans);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2354,6 +2600,11 @@ gst_base_transform_activate (GstBaseTransform * trans, gboolean active)
     priv->discont = FALSE;
     priv->processed = 0;
     priv->dropped = 0;
+    priv->n_passthrough = 0;
+    priv->n_in_place = 0;
+    priv->n_copied = 0;
+    priv->n_allocated = 0;
+    priv->bytes_copied = 0;
     GST_OBJECT_UNLOCK (trans);
 
     if (incaps)
@@ -2379,6 +2630,7 @@ gst_base_transform_activate (GstBaseTransform * trans, gboolean active)
       result &= bclass->stop (trans);
 
     gst_base_transform_set_allocation (trans, NULL, NULL, NULL, NULL);
+    gst_base_transform_clear_copy_pool (trans);
   }
 
   return result;
@@ -73,6 +73,8 @@ static GstFlowReturn gst_push_src_alloc (GstBaseSrc * bsrc, guint64 offset,
     guint length, GstBuffer ** ret);
 static GstFlowReturn gst_push_src_fill (GstBaseSrc * bsrc, guint64 offset,
     guint length, GstBuffer * ret);
+static GstFlowReturn gst_push_src_create_list (GstBaseSrc * bsrc,
+    guint64 offset, guint length, GstBufferList ** ret);
 
 static void
 gst_push_src_class_init (GstPushSrcClass * klass)
@@ -82,6 +84,8 @@ gst_push_src_class_init (GstPushSrcClass * klass)
   gstbasesrc_class->create = GST_DEBUG_FUNCPTR (gst_push_src_create);
   gstbasesrc_class->alloc = GST_DEBUG_FUNCPTR (gst_push_src_alloc);
   gstbasesrc_class->fill = GST_DEBUG_FUNCPTR (gst_push_src_fill);
+  gstbasesrc_class->create_list =
+      GST_DEBUG_FUNCPTR (gst_push_src_create_list);
   gstbasesrc_class->query = GST_DEBUG_FUNCPTR (gst_push_src_query);
 }
 
@@ -170,3 +174,21 @@ gst_push_src_fill (GstBaseSrc * bsrc, guint64 offset, guint length,
 
   return fret;
 }
+
+static GstFlowReturn
+gst_push_src_create_list (GstBaseSrc * bsrc, guint64 offset, guint length,
+    GstBufferList ** ret)
+{
+  GstFlowReturn fret;
+  GstPushSrc *src;
+  GstPushSrcClass *pclass;
+
+  src = GST_PUSH_SRC (bsrc);
+  pclass = GST_PUSH_SRC_GET_CLASS (src);
+  if (pclass->create_list)
+    fret = pclass->create_list (src, ret);
+  else
+    fret = GST_FLOW_NOT_SUPPORTED;
+
+  return fret;
+}
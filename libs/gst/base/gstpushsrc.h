@@ -62,8 +62,11 @@ struct _GstPushSrcClass {
   /* ask the subclass to fill a buffer */
   GstFlowReturn (*fill)   (GstPushSrc *src, GstBuffer *buf);
 
+  /* ask the subclass to create several buffers at once */
+  GstFlowReturn (*create_list) (GstPushSrc *src, GstBufferList **list);
+
   /*< private >*/
-  gpointer _gst_reserved[GST_PADDING];
+  gpointer _gst_reserved[GST_PADDING - 1];
 };
 
 GType gst_push_src_get_type(void);
@@ -0,0 +1,1141 @@
+/* GStreamer
+ *
+ * unit testing helper lib
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:gstharness
+ * @short_description: Drive an element or a bin and collect its output
+ * @see_also: #GstTestClock
+ *
+ * A #GstHarness wraps an element, or a bin described by a gst-launch line,
+ * and links its always sink and src pads to pads of its own. Buffers, events
+ * and queries can then be pushed into the element from the test thread,
+ * while all buffers and events that come out of the element are collected in
+ * queues that can be read with gst_harness_pull() and
+ * gst_harness_pull_event(). Collecting never blocks the streaming thread of
+ * the element.
+ *
+ * The element runs in the PLAYING state with a #GstTestClock, so
+ * clock waits of the element can be released one by one with
+ * gst_harness_crank_single_clock_wait().
+ *
+ * The harness also keeps statistics about the buffers that passed through
+ * the element: the throughput, the latency percentiles and the number of
+ * memory allocations from the allocator it proposes in the ALLOCATION query.
+ * This makes it possible to write performance regression tests that do not
+ * need any devices. With gst_harness_set_drop_buffers() the received buffers
+ * are not queued but released right away, so that the element can be run at
+ * full speed.
+ *
+ * <example>
+ * <title>Measuring the throughput of an element</title>
+ *   <programlisting language="c">
+ *   GstHarness *h;
+ *   GstHarnessStats stats;
+ *   gint i;
+ *
+ *   h = gst_harness_new ("identity");
+ *   gst_harness_set_src_caps_str (h, "application/x-test");
+ *   gst_harness_set_drop_buffers (h, TRUE);
+ *
+ *   for (i = 0; i &lt; 100000; i++)
+ *     gst_harness_push (h, gst_buffer_new_allocate (NULL, 1024, NULL));
+ *
+ *   gst_harness_get_stats (h, &amp;stats);
+ *   g_print ("%.0f buffers/s, median latency %" GST_TIME_FORMAT "\n",
+ *       stats.buffers_per_second, GST_TIME_ARGS (stats.latency_50));
+ *
+ *   gst_harness_teardown (h);
+ *   </programlisting>
+ * </example>
+ *
+ * Since: 1.6
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstharness.h"
+
+#include <string.h>
+
+/* how long gst_harness_pull() and gst_harness_pull_event() wait */
+#define HARNESS_PULL_TIMEOUT (60 * G_USEC_PER_SEC)
+
+static GstStaticPadTemplate hsrctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+static GstStaticPadTemplate hsinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+/* allocator that counts the allocations and lets the default allocator do
+ * the actual work */
+#define GST_TYPE_HARNESS_ALLOCATOR (gst_harness_allocator_get_type ())
+
+typedef struct
+{
+  GstAllocator parent;
+
+  GstAllocator *sysmem;
+  volatile gint allocations;
+} GstHarnessAllocator;
+
+typedef struct
+{
+  GstAllocatorClass parent_class;
+} GstHarnessAllocatorClass;
+
+static GType gst_harness_allocator_get_type (void);
+
+G_DEFINE_TYPE (GstHarnessAllocator, gst_harness_allocator, GST_TYPE_ALLOCATOR);
+
+static GstMemory *
+gst_harness_allocator_alloc (GstAllocator * allocator, gsize size,
+    GstAllocationParams * params)
+{
+  GstHarnessAllocator *self = (GstHarnessAllocator *) allocator;
+
+  g_atomic_int_inc (&self->allocations);
+
+  return gst_allocator_alloc (self->sysmem, size, params);
+}
+
+static void
+gst_harness_allocator_free (GstAllocator * allocator, GstMemory * memory)
+{
+  /* never called, the memory belongs to the default allocator */
+  gst_allocator_free (memory->allocator, memory);
+}
+
+static void
+gst_harness_allocator_finalize (GObject * object)
+{
+  GstHarnessAllocator *self = (GstHarnessAllocator *) object;
+
+  gst_object_unref (self->sysmem);
+
+  G_OBJECT_CLASS (gst_harness_allocator_parent_class)->finalize (object);
+}
+
+static void
+gst_harness_allocator_class_init (GstHarnessAllocatorClass * klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+  GstAllocatorClass *allocator_class = (GstAllocatorClass *) klass;
+
+  gobject_class->finalize = gst_harness_allocator_finalize;
+
+  allocator_class->alloc = gst_harness_allocator_alloc;
+  allocator_class->free = gst_harness_allocator_free;
+}
+
+static void
+gst_harness_allocator_init (GstHarnessAllocator * self)
+{
+  self->sysmem = gst_allocator_find (NULL);
+
+  GST_OBJECT_FLAG_SET (self, GST_ALLOCATOR_FLAG_CUSTOM_ALLOC);
+}
+
+/* the push times of the last PUSH_RING_SIZE buffers are kept to match them
+ * with the received buffers */
+#define PUSH_RING_SIZE 4096
+
+/* latencies are counted in buckets with 8 sub-buckets for every power of two
+ * nanoseconds, which keeps the percentiles within 12.5% */
+#define LATENCY_SUB_BITS 3
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BITS)
+#define LATENCY_BUCKETS ((64 - LATENCY_SUB_BITS + 1) * LATENCY_SUB_BUCKETS)
+
+/* statistics of the received buffers, only written by the streaming thread */
+typedef struct
+{
+  guint64 received;
+  guint64 bytes;
+  GstClockTime last_receive;
+  guint64 n_latencies;
+  GstClockTime latency_min;
+  GstClockTime latency_max;
+  guint latency_buckets[LATENCY_BUCKETS];
+} GstHarnessRecvStats;
+
+struct _GstHarnessPrivate
+{
+  GstTestClock *testclock;
+  GstHarnessAllocator *allocator;
+
+  GAsyncQueue *buffer_queue;
+  GAsyncQueue *event_queue;
+  volatile gint drop_buffers;
+  volatile gint buffers_received;
+  volatile gint events_received;
+  gboolean have_segment;
+
+  /* written by the pushing thread. A push time is stored before pushed is
+   * incremented */
+  volatile gint pushed;
+  GstClockTime first_push;
+  GstClockTime push_ring[PUSH_RING_SIZE];
+
+  /* written by the streaming thread. stats_seq is odd while recv_stats is
+   * being updated, readers retry when it changed while they copied */
+  volatile gint stats_seq;
+  GstHarnessRecvStats recv_stats;
+
+  gint allocations_base;
+};
+
+static guint
+latency_bucket (GstClockTime latency)
+{
+  guint exp;
+
+  if (latency < LATENCY_SUB_BUCKETS)
+    return latency;
+
+  if (latency >> 32)
+    exp = 32 + g_bit_storage ((gulong) (latency >> 32)) - 1;
+  else
+    exp = g_bit_storage ((gulong) latency) - 1;
+
+  return (exp - LATENCY_SUB_BITS + 1) * LATENCY_SUB_BUCKETS +
+      ((latency >> (exp - LATENCY_SUB_BITS)) & (LATENCY_SUB_BUCKETS - 1));
+}
+
+/* the largest latency that is counted in @bucket */
+static GstClockTime
+latency_bucket_max (guint bucket)
+{
+  guint exp, sub;
+
+  if (bucket < LATENCY_SUB_BUCKETS)
+    return bucket;
+
+  exp = bucket / LATENCY_SUB_BUCKETS + LATENCY_SUB_BITS - 1;
+  sub = bucket % LATENCY_SUB_BUCKETS;
+
+  return (((GstClockTime) LATENCY_SUB_BUCKETS + sub + 1) << (exp -
+          LATENCY_SUB_BITS)) - 1;
+}
+
+/* the push time of the @index-th buffer pushed, or GST_CLOCK_TIME_NONE when
+ * that buffer was not pushed or its time was overwritten already */
+static GstClockTime
+gst_harness_get_push_time (GstHarnessPrivate * priv, guint index)
+{
+  GstClockTime time;
+
+  if ((guint) g_atomic_int_get (&priv->pushed) - index - 1 >=
+      PUSH_RING_SIZE - 1)
+    return GST_CLOCK_TIME_NONE;
+
+  time = priv->push_ring[index % PUSH_RING_SIZE];
+
+  /* the slot is only reused after pushed went past index + PUSH_RING_SIZE - 1,
+   * check that this did not happen while reading it */
+  if ((guint) g_atomic_int_get (&priv->pushed) - index >= PUSH_RING_SIZE)
+    return GST_CLOCK_TIME_NONE;
+
+  return time;
+}
+
+static GstFlowReturn
+gst_harness_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  GstHarness *h = gst_pad_get_element_private (pad);
+  GstHarnessPrivate *priv = h->priv;
+  GstHarnessRecvStats *recv = &priv->recv_stats;
+  GstClockTime now = gst_util_get_timestamp ();
+  GstClockTime pushed;
+
+  /* the N-th buffer that comes out belongs to the N-th buffer pushed */
+  pushed = gst_harness_get_push_time (priv, (guint) recv->received);
+
+  g_atomic_int_inc (&priv->stats_seq);
+  if (GST_CLOCK_TIME_IS_VALID (pushed) && now >= pushed) {
+    GstClockTime latency = now - pushed;
+
+    if (recv->n_latencies == 0 || latency < recv->latency_min)
+      recv->latency_min = latency;
+    if (recv->n_latencies == 0 || latency > recv->latency_max)
+      recv->latency_max = latency;
+    recv->latency_buckets[latency_bucket (latency)]++;
+    recv->n_latencies++;
+  }
+  recv->received++;
+  recv->bytes += gst_buffer_get_size (buffer);
+  recv->last_receive = now;
+  g_atomic_int_inc (&priv->stats_seq);
+
+  g_atomic_int_inc (&priv->buffers_received);
+
+  if (g_atomic_int_get (&priv->drop_buffers))
+    gst_buffer_unref (buffer);
+  else
+    g_async_queue_push (priv->buffer_queue, buffer);
+
+  return GST_FLOW_OK;
+}
+
+static gboolean
+gst_harness_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
+{
+  GstHarness *h = gst_pad_get_element_private (pad);
+  GstHarnessPrivate *priv = h->priv;
+
+  g_atomic_int_inc (&priv->events_received);
+  g_async_queue_push (priv->event_queue, event);
+
+  return TRUE;
+}
+
+static gboolean
+gst_harness_sink_query (GstPad * pad, GstObject * parent, GstQuery * query)
+{
+  GstHarness *h = gst_pad_get_element_private (pad);
+
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_ALLOCATION:
+      gst_query_add_allocation_param (query,
+          GST_ALLOCATOR_CAST (h->priv->allocator), NULL);
+      return TRUE;
+    default:
+      return gst_pad_query_default (pad, parent, query);
+  }
+}
+
+static gboolean
+gst_harness_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
+{
+  /* upstream events from the element, like QoS, end here */
+  gst_event_unref (event);
+
+  return TRUE;
+}
+
+static gboolean
+gst_harness_setup_src_pad (GstHarness * h, const gchar * element_sinkpad_name)
+{
+  GstPad *element_sinkpad;
+  GstPadLinkReturn ret;
+
+  element_sinkpad = gst_element_get_static_pad (h->element,
+      element_sinkpad_name);
+  if (element_sinkpad == NULL)
+    return FALSE;
+
+  h->srcpad = gst_pad_new_from_static_template (&hsrctemplate, "src");
+  gst_pad_set_element_private (h->srcpad, h);
+  gst_pad_set_event_function (h->srcpad, gst_harness_src_event);
+
+  ret = gst_pad_link (h->srcpad, element_sinkpad);
+  gst_object_unref (element_sinkpad);
+  if (ret != GST_PAD_LINK_OK)
+    return FALSE;
+
+  gst_pad_set_active (h->srcpad, TRUE);
+
+  return TRUE;
+}
+
+static gboolean
+gst_harness_setup_sink_pad (GstHarness * h, const gchar * element_srcpad_name)
+{
+  GstPad *element_srcpad;
+  GstPadLinkReturn ret;
+
+  element_srcpad = gst_element_get_static_pad (h->element,
+      element_srcpad_name);
+  if (element_srcpad == NULL)
+    return FALSE;
+
+  h->sinkpad = gst_pad_new_from_static_template (&hsinktemplate, "sink");
+  gst_pad_set_element_private (h->sinkpad, h);
+  gst_pad_set_chain_function (h->sinkpad, gst_harness_chain);
+  gst_pad_set_event_function (h->sinkpad, gst_harness_sink_event);
+  gst_pad_set_query_function (h->sinkpad, gst_harness_sink_query);
+
+  ret = gst_pad_link (element_srcpad, h->sinkpad);
+  gst_object_unref (element_srcpad);
+  if (ret != GST_PAD_LINK_OK)
+    return FALSE;
+
+  gst_pad_set_active (h->sinkpad, TRUE);
+
+  return TRUE;
+}
+
+static void
+gst_harness_teardown_pad (GstPad * pad)
+{
+  GstPad *peer;
+
+  gst_pad_set_active (pad, FALSE);
+
+  peer = gst_pad_get_peer (pad);
+  if (peer) {
+    if (GST_PAD_IS_SRC (pad))
+      gst_pad_unlink (pad, peer);
+    else
+      gst_pad_unlink (peer, pad);
+    gst_object_unref (peer);
+  }
+
+  gst_object_unref (pad);
+}
+
+/**
+ * gst_harness_new_with_element:
+ * @element: (transfer floating): the element to drive
+ * @element_sinkpad_name: (allow-none): the name of the sink pad of @element
+ *     to push into, or %NULL when @element has no sink pad
+ * @element_srcpad_name: (allow-none): the name of the src pad of @element
+ *     to collect from, or %NULL when @element has no src pad
+ *
+ * Creates a harness around @element, sets the #GstTestClock of the harness
+ * on it and brings it to the PLAYING state.
+ *
+ * MT safe.
+ *
+ * Returns: (transfer full): a new #GstHarness, free with
+ * gst_harness_teardown(). %NULL when the pads of @element could not be
+ * linked or @element failed to start.
+ *
+ * Since: 1.6
+ */
+GstHarness *
+gst_harness_new_with_element (GstElement * element,
+    const gchar * element_sinkpad_name, const gchar * element_srcpad_name)
+{
+  GstHarness *h;
+  GstHarnessPrivate *priv;
+
+  g_return_val_if_fail (GST_IS_ELEMENT (element), NULL);
+
+  h = g_new0 (GstHarness, 1);
+  priv = h->priv = g_new0 (GstHarnessPrivate, 1);
+
+  h->element = gst_object_ref_sink (element);
+
+  priv->testclock = GST_TEST_CLOCK (gst_test_clock_new ());
+  priv->allocator = g_object_new (GST_TYPE_HARNESS_ALLOCATOR, NULL);
+  gst_object_ref_sink (priv->allocator);
+
+  priv->buffer_queue =
+      g_async_queue_new_full ((GDestroyNotify) gst_mini_object_unref);
+  priv->event_queue =
+      g_async_queue_new_full ((GDestroyNotify) gst_mini_object_unref);
+
+  priv->first_push = GST_CLOCK_TIME_NONE;
+  priv->recv_stats.last_receive = GST_CLOCK_TIME_NONE;
+
+  if (element_sinkpad_name && !gst_harness_setup_src_pad (h,
+          element_sinkpad_name))
+    goto link_failed;
+  if (element_srcpad_name && !gst_harness_setup_sink_pad (h,
+          element_srcpad_name))
+    goto link_failed;
+
+  gst_element_set_clock (element, GST_CLOCK_CAST (priv->testclock));
+
+  if (gst_element_set_state (element,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE)
+    goto start_failed;
+
+  if (h->srcpad) {
+    gchar *stream_id = g_strdup_printf ("%s-%p",
+        GST_OBJECT_NAME (element), h);
+
+    gst_pad_push_event (h->srcpad, gst_event_new_stream_start (stream_id));
+    g_free (stream_id);
+  }
+
+  return h;
+
+  /* ERRORS */
+link_failed:
+  {
+    g_warning ("could not link the pads of %s", GST_OBJECT_NAME (element));
+    gst_harness_teardown (h);
+    return NULL;
+  }
+start_failed:
+  {
+    g_warning ("could not start %s", GST_OBJECT_NAME (element));
+    gst_harness_teardown (h);
+    return NULL;
+  }
+}
+
+static const gchar *
+gst_harness_pad_name (GstElement * element, const gchar * name)
+{
+  GstPad *pad;
+
+  pad = gst_element_get_static_pad (element, name);
+  if (pad == NULL)
+    return NULL;
+  gst_object_unref (pad);
+
+  return name;
+}
+
+/**
+ * gst_harness_new:
+ * @element_name: the name of the element factory
+ *
+ * Creates a new element from the factory @element_name and wraps it in a
+ * harness with gst_harness_new_with_element(), using the pads named "sink"
+ * and "src" of the element if it has them.
+ *
+ * MT safe.
+ *
+ * Returns: (transfer full): a new #GstHarness, free with
+ * gst_harness_teardown(). %NULL when the element could not be created.
+ *
+ * Since: 1.6
+ */
+GstHarness *
+gst_harness_new (const gchar * element_name)
+{
+  GstElement *element;
+
+  g_return_val_if_fail (element_name != NULL, NULL);
+
+  element = gst_element_factory_make (element_name, NULL);
+  if (element == NULL)
+    return NULL;
+
+  return gst_harness_new_with_element (element,
+      gst_harness_pad_name (element, "sink"),
+      gst_harness_pad_name (element, "src"));
+}
+
+/**
+ * gst_harness_new_parse:
+ * @launchline: a gst-launch style description of a bin
+ *
+ * Creates a bin from @launchline with gst_parse_bin_from_description() and
+ * wraps it in a harness. The unlinked sink and src pads of the bin are
+ * used, so "identity ! queue" is driven through the sink pad of identity and
+ * collected from the src pad of queue.
+ *
+ * MT safe.
+ *
+ * Returns: (transfer full): a new #GstHarness, free with
+ * gst_harness_teardown(). %NULL when @launchline could not be parsed.
+ *
+ * Since: 1.6
+ */
+GstHarness *
+gst_harness_new_parse (const gchar * launchline)
+{
+  GstElement *bin;
+  GError *err = NULL;
+
+  g_return_val_if_fail (launchline != NULL, NULL);
+
+  bin = gst_parse_bin_from_description (launchline, TRUE, &err);
+  if (bin == NULL) {
+    g_warning ("could not parse '%s': %s", launchline,
+        err ? err->message : "unknown error");
+    g_clear_error (&err);
+    return NULL;
+  }
+  g_clear_error (&err);
+
+  return gst_harness_new_with_element (bin,
+      gst_harness_pad_name (bin, "sink"), gst_harness_pad_name (bin, "src"));
+}
+
+/**
+ * gst_harness_teardown:
+ * @h: a #GstHarness
+ *
+ * Stops the element of @h and frees @h together with all buffers and events
+ * that were not pulled.
+ *
+ * Since: 1.6
+ */
+void
+gst_harness_teardown (GstHarness * h)
+{
+  GstHarnessPrivate *priv;
+
+  g_return_if_fail (h != NULL);
+
+  priv = h->priv;
+
+  gst_element_set_state (h->element, GST_STATE_NULL);
+
+  if (h->srcpad)
+    gst_harness_teardown_pad (h->srcpad);
+  if (h->sinkpad)
+    gst_harness_teardown_pad (h->sinkpad);
+
+  gst_object_unref (h->element);
+
+  g_async_queue_unref (priv->buffer_queue);
+  g_async_queue_unref (priv->event_queue);
+
+  gst_object_unref (priv->testclock);
+  gst_object_unref (priv->allocator);
+
+  g_free (priv);
+  g_free (h);
+}
+
+/**
+ * gst_harness_set_src_caps:
+ * @h: a #GstHarness
+ * @caps: (transfer full): the caps of the buffers that will be pushed
+ *
+ * Pushes a CAPS event with @caps and, if none was pushed yet, a SEGMENT event
+ * in the TIME format into the element of @h.
+ *
+ * Since: 1.6
+ */
+void
+gst_harness_set_src_caps (GstHarness * h, GstCaps * caps)
+{
+  g_return_if_fail (h != NULL);
+  g_return_if_fail (h->srcpad != NULL);
+  g_return_if_fail (GST_IS_CAPS (caps));
+
+  gst_pad_push_event (h->srcpad, gst_event_new_caps (caps));
+  gst_caps_unref (caps);
+
+  if (!h->priv->have_segment) {
+    GstSegment segment;
+
+    gst_segment_init (&segment, GST_FORMAT_TIME);
+    gst_harness_push_event (h, gst_event_new_segment (&segment));
+  }
+}
+
+/**
+ * gst_harness_set_src_caps_str:
+ * @h: a #GstHarness
+ * @str: a string representation of the caps
+ *
+ * Like gst_harness_set_src_caps() but with the caps parsed from @str.
+ *
+ * Since: 1.6
+ */
+void
+gst_harness_set_src_caps_str (GstHarness * h, const gchar * str)
+{
+  GstCaps *caps;
+
+  g_return_if_fail (str != NULL);
+
+  caps = gst_caps_from_string (str);
+  g_return_if_fail (caps != NULL);
+
+  gst_harness_set_src_caps (h, caps);
+}
+
+/**
+ * gst_harness_set_drop_buffers:
+ * @h: a #GstHarness
+ * @drop_buffers: whether to drop the received buffers
+ *
+ * When @drop_buffers is %TRUE, the buffers that come out of the element are
+ * counted in the statistics and released right away instead of being queued
+ * for gst_harness_pull(). Use this to run an element at full speed without
+ * collecting its output.
+ *
+ * MT safe.
+ *
+ * Since: 1.6
+ */
+void
+gst_harness_set_drop_buffers (GstHarness * h, gboolean drop_buffers)
+{
+  g_return_if_fail (h != NULL);
+
+  g_atomic_int_set (&h->priv->drop_buffers, drop_buffers);
+}
+
+/**
+ * gst_harness_push:
+ * @h: a #GstHarness
+ * @buffer: (transfer full): the buffer to push
+ *
+ * Pushes @buffer into the element of @h. A SEGMENT event in the TIME format
+ * is pushed first when none was pushed yet.
+ *
+ * Returns: the #GstFlowReturn of the push
+ *
+ * Since: 1.6
+ */
+GstFlowReturn
+gst_harness_push (GstHarness * h, GstBuffer * buffer)
+{
+  GstHarnessPrivate *priv;
+  GstClockTime now;
+  gint pushed;
+
+  g_return_val_if_fail (h != NULL, GST_FLOW_ERROR);
+  g_return_val_if_fail (h->srcpad != NULL, GST_FLOW_NOT_LINKED);
+  g_return_val_if_fail (GST_IS_BUFFER (buffer), GST_FLOW_ERROR);
+
+  priv = h->priv;
+
+  if (!priv->have_segment) {
+    GstSegment segment;
+
+    gst_segment_init (&segment, GST_FORMAT_TIME);
+    gst_harness_push_event (h, gst_event_new_segment (&segment));
+  }
+
+  now = gst_util_get_timestamp ();
+
+  /* store the time before pushed is incremented, the streaming thread can
+   * match it as soon as it sees the new count */
+  pushed = g_atomic_int_get (&priv->pushed);
+  if (pushed == 0)
+    priv->first_push = now;
+  priv->push_ring[(guint) pushed % PUSH_RING_SIZE] = now;
+  g_atomic_int_inc (&priv->pushed);
+
+  return gst_pad_push (h->srcpad, buffer);
+}
+
+/**
+ * gst_harness_pull:
+ * @h: a #GstHarness
+ *
+ * Takes the oldest buffer that came out of the element of @h, waiting up to
+ * 60 seconds for one to arrive.
+ *
+ * MT safe.
+ *
+ * Returns: (transfer full): a #GstBuffer or %NULL on timeout
+ *
+ * Since: 1.6
+ */
+GstBuffer *
+gst_harness_pull (GstHarness * h)
+{
+  g_return_val_if_fail (h != NULL, NULL);
+
+  return g_async_queue_timeout_pop (h->priv->buffer_queue,
+      HARNESS_PULL_TIMEOUT);
+}
+
+/**
+ * gst_harness_try_pull:
+ * @h: a #GstHarness
+ *
+ * Takes the oldest buffer that came out of the element of @h without
+ * waiting.
+ *
+ * MT safe.
+ *
+ * Returns: (transfer full): a #GstBuffer or %NULL when no buffer is queued
+ *
+ * Since: 1.6
+ */
+GstBuffer *
+gst_harness_try_pull (GstHarness * h)
+{
+  g_return_val_if_fail (h != NULL, NULL);
+
+  return g_async_queue_try_pop (h->priv->buffer_queue);
+}
+
+/**
+ * gst_harness_buffers_received:
+ * @h: a #GstHarness
+ *
+ * MT safe.
+ *
+ * Returns: the number of buffers that came out of the element of @h since
+ * the harness was created, including the dropped ones
+ *
+ * Since: 1.6
+ */
+guint
+gst_harness_buffers_received (GstHarness * h)
+{
+  g_return_val_if_fail (h != NULL, 0);
+
+  return g_atomic_int_get (&h->priv->buffers_received);
+}
+
+/**
+ * gst_harness_buffers_in_queue:
+ * @h: a #GstHarness
+ *
+ * MT safe.
+ *
+ * Returns: the number of buffers that can be pulled from @h
+ *
+ * Since: 1.6
+ */
+guint
+gst_harness_buffers_in_queue (GstHarness * h)
+{
+  gint len;
+
+  g_return_val_if_fail (h != NULL, 0);
+
+  len = g_async_queue_length (h->priv->buffer_queue);
+
+  return MAX (len, 0);
+}
+
+/**
+ * gst_harness_push_event:
+ * @h: a #GstHarness
+ * @event: (transfer full): the event to push
+ *
+ * Pushes @event downstream into the element of @h.
+ *
+ * Returns: the result of gst_pad_push_event()
+ *
+ * Since: 1.6
+ */
+gboolean
+gst_harness_push_event (GstHarness * h, GstEvent * event)
+{
+  g_return_val_if_fail (h != NULL, FALSE);
+  g_return_val_if_fail (h->srcpad != NULL, FALSE);
+  g_return_val_if_fail (GST_IS_EVENT (event), FALSE);
+
+  if (GST_EVENT_TYPE (event) == GST_EVENT_SEGMENT)
+    h->priv->have_segment = TRUE;
+
+  return gst_pad_push_event (h->srcpad, event);
+}
+
+/**
+ * gst_harness_pull_event:
+ * @h: a #GstHarness
+ *
+ * Takes the oldest event that came out of the element of @h, waiting up to
+ * 60 seconds for one to arrive.
+ *
+ * MT safe.
+ *
+ * Returns: (transfer full): a #GstEvent or %NULL on timeout
+ *
+ * Since: 1.6
+ */
+GstEvent *
+gst_harness_pull_event (GstHarness * h)
+{
+  g_return_val_if_fail (h != NULL, NULL);
+
+  return g_async_queue_timeout_pop (h->priv->event_queue,
+      HARNESS_PULL_TIMEOUT);
+}
+
+/**
+ * gst_harness_try_pull_event:
+ * @h: a #GstHarness
+ *
+ * Takes the oldest event that came out of the element of @h without
+ * waiting.
+ *
+ * MT safe.
+ *
+ * Returns: (transfer full): a #GstEvent or %NULL when no event is queued
+ *
+ * Since: 1.6
+ */
+GstEvent *
+gst_harness_try_pull_event (GstHarness * h)
+{
+  g_return_val_if_fail (h != NULL, NULL);
+
+  return g_async_queue_try_pop (h->priv->event_queue);
+}
+
+/**
+ * gst_harness_events_received:
+ * @h: a #GstHarness
+ *
+ * MT safe.
+ *
+ * Returns: the number of events that came out of the element of @h since
+ * the harness was created
+ *
+ * Since: 1.6
+ */
+guint
+gst_harness_events_received (GstHarness * h)
+{
+  g_return_val_if_fail (h != NULL, 0);
+
+  return g_atomic_int_get (&h->priv->events_received);
+}
+
+/**
+ * gst_harness_push_upstream_event:
+ * @h: a #GstHarness
+ * @event: (transfer full): the event to push
+ *
+ * Pushes @event upstream into the src pad of the element of @h.
+ *
+ * Returns: the result of gst_pad_push_event()
+ *
+ * Since: 1.6
+ */
+gboolean
+gst_harness_push_upstream_event (GstHarness * h, GstEvent * event)
+{
+  g_return_val_if_fail (h != NULL, FALSE);
+  g_return_val_if_fail (h->sinkpad != NULL, FALSE);
+  g_return_val_if_fail (GST_IS_EVENT (event), FALSE);
+
+  return gst_pad_push_event (h->sinkpad, event);
+}
+
+/**
+ * gst_harness_push_query:
+ * @h: a #GstHarness
+ * @query: (transfer none): the query to perform
+ *
+ * Performs @query on the sink pad of the element of @h.
+ *
+ * Returns: the result of gst_pad_peer_query()
+ *
+ * Since: 1.6
+ */
+gboolean
+gst_harness_push_query (GstHarness * h, GstQuery * query)
+{
+  g_return_val_if_fail (h != NULL, FALSE);
+  g_return_val_if_fail (h->srcpad != NULL, FALSE);
+  g_return_val_if_fail (GST_IS_QUERY (query), FALSE);
+
+  return gst_pad_peer_query (h->srcpad, query);
+}
+
+/**
+ * gst_harness_get_testclock:
+ * @h: a #GstHarness
+ *
+ * MT safe.
+ *
+ * Returns: (transfer full): the #GstTestClock of the element of @h
+ *
+ * Since: 1.6
+ */
+GstTestClock *
+gst_harness_get_testclock (GstHarness * h)
+{
+  g_return_val_if_fail (h != NULL, NULL);
+
+  return gst_object_ref (h->priv->testclock);
+}
+
+/**
+ * gst_harness_set_time:
+ * @h: a #GstHarness
+ * @time: the new time of the clock
+ *
+ * Sets the time of the #GstTestClock of @h, see gst_test_clock_set_time().
+ *
+ * MT safe.
+ *
+ * Since: 1.6
+ */
+void
+gst_harness_set_time (GstHarness * h, GstClockTime time)
+{
+  g_return_if_fail (h != NULL);
+
+  gst_test_clock_set_time (h->priv->testclock, time);
+}
+
+/**
+ * gst_harness_crank_single_clock_wait:
+ * @h: a #GstHarness
+ *
+ * Waits until the element of @h waits on the #GstTestClock, advances the
+ * clock to the time of that wait and releases it.
+ *
+ * MT safe.
+ *
+ * Returns: %TRUE if the pending clock wait was released
+ *
+ * Since: 1.6
+ */
+gboolean
+gst_harness_crank_single_clock_wait (GstHarness * h)
+{
+  GstTestClock *testclock;
+  GstClockID pending, processed;
+  gboolean ret;
+
+  g_return_val_if_fail (h != NULL, FALSE);
+
+  testclock = h->priv->testclock;
+
+  gst_test_clock_wait_for_next_pending_id (testclock, &pending);
+  gst_test_clock_set_time (testclock, gst_clock_id_get_time (pending));
+
+  processed = gst_test_clock_process_next_clock_id (testclock);
+  ret = (processed == pending);
+
+  if (processed)
+    gst_clock_id_unref (processed);
+  gst_clock_id_unref (pending);
+
+  return ret;
+}
+
+/* the latency that @percent percent of the latencies in @recv did not
+ * exceed, as the upper bound of its bucket */
+static GstClockTime
+latency_percentile (const GstHarnessRecvStats * recv, guint percent)
+{
+  guint64 rank, count = 0;
+  GstClockTime latency = recv->latency_max;
+  guint i;
+
+  rank = (recv->n_latencies - 1) * percent / 100;
+  for (i = 0; i < LATENCY_BUCKETS; i++) {
+    count += recv->latency_buckets[i];
+    if (count > rank) {
+      latency = latency_bucket_max (i);
+      break;
+    }
+  }
+
+  return CLAMP (latency, recv->latency_min, recv->latency_max);
+}
+
+/**
+ * gst_harness_get_stats:
+ * @h: a #GstHarness
+ * @stats: (out caller-allocates): the #GstHarnessStats to fill
+ *
+ * Fills @stats with the statistics collected since @h was created or since
+ * the last gst_harness_reset_stats().
+ *
+ * MT safe.
+ *
+ * Since: 1.6
+ */
+void
+gst_harness_get_stats (GstHarness * h, GstHarnessStats * stats)
+{
+  GstHarnessPrivate *priv;
+  GstHarnessRecvStats recv;
+  GstClockTime first_push = GST_CLOCK_TIME_NONE;
+  gint seq;
+
+  g_return_if_fail (h != NULL);
+  g_return_if_fail (stats != NULL);
+
+  priv = h->priv;
+
+  stats->buffers_pushed = (guint) g_atomic_int_get (&priv->pushed);
+  if (stats->buffers_pushed > 0)
+    first_push = priv->first_push;
+  stats->allocations = g_atomic_int_get (&priv->allocator->allocations) -
+      priv->allocations_base;
+
+  /* copy the statistics of the streaming thread, again when it updated them
+   * while copying */
+  for (;;) {
+    seq = g_atomic_int_get (&priv->stats_seq);
+    if (seq & 1) {
+      g_thread_yield ();
+      continue;
+    }
+    memcpy (&recv, &priv->recv_stats, sizeof (GstHarnessRecvStats));
+    if (g_atomic_int_get (&priv->stats_seq) == seq)
+      break;
+  }
+
+  stats->buffers_received = recv.received;
+  stats->bytes_received = recv.bytes;
+
+  if (GST_CLOCK_TIME_IS_VALID (first_push) &&
+      GST_CLOCK_TIME_IS_VALID (recv.last_receive) &&
+      recv.last_receive > first_push)
+    stats->elapsed = recv.last_receive - first_push;
+  else
+    stats->elapsed = 0;
+
+  if (stats->elapsed > 0) {
+    stats->buffers_per_second =
+        (gdouble) stats->buffers_received * GST_SECOND / stats->elapsed;
+    stats->bytes_per_second =
+        (gdouble) stats->bytes_received * GST_SECOND / stats->elapsed;
+  } else {
+    stats->buffers_per_second = 0.0;
+    stats->bytes_per_second = 0.0;
+  }
+
+  if (recv.n_latencies > 0) {
+    stats->latency_min = recv.latency_min;
+    stats->latency_50 = latency_percentile (&recv, 50);
+    stats->latency_90 = latency_percentile (&recv, 90);
+    stats->latency_99 = latency_percentile (&recv, 99);
+    stats->latency_max = recv.latency_max;
+  } else {
+    stats->latency_min = GST_CLOCK_TIME_NONE;
+    stats->latency_50 = GST_CLOCK_TIME_NONE;
+    stats->latency_90 = GST_CLOCK_TIME_NONE;
+    stats->latency_99 = GST_CLOCK_TIME_NONE;
+    stats->latency_max = GST_CLOCK_TIME_NONE;
+  }
+}
+
+/**
+ * gst_harness_reset_stats:
+ * @h: a #GstHarness
+ *
+ * Clears the statistics of @h, for example to leave out the buffers of a
+ * warm-up phase. The latencies are matched by the order of the buffers, so
+ * this should only be called while no buffers are pushed or inside the
+ * element.
+ *
+ * Since: 1.6
+ */
+void
+gst_harness_reset_stats (GstHarness * h)
+{
+  GstHarnessPrivate *priv;
+
+  g_return_if_fail (h != NULL);
+
+  priv = h->priv;
+
+  /* make concurrent readers of the statistics copy them again */
+  g_atomic_int_inc (&priv->stats_seq);
+  memset (&priv->recv_stats, 0, sizeof (GstHarnessRecvStats));
+  priv->recv_stats.last_receive = GST_CLOCK_TIME_NONE;
+  g_atomic_int_inc (&priv->stats_seq);
+
+  priv->allocations_base = g_atomic_int_get (&priv->allocator->allocations);
+  priv->first_push = GST_CLOCK_TIME_NONE;
+  g_atomic_int_set (&priv->pushed, 0);
+}
@@ -0,0 +1,141 @@
+/* GStreamer
+ *
+ * unit testing helper lib
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_HARNESS_H__
+#define __GST_HARNESS_H__
+
+#include <gst/gst.h>
+#include <gst/check/gsttestclock.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GstHarness GstHarness;
+typedef struct _GstHarnessPrivate GstHarnessPrivate;
+
+/**
+ * GstHarness:
+ * @element: the element inside the harness
+ * @srcpad: the pad that feeds the sink pad of @element
+ * @sinkpad: the pad that collects the output of the src pad of @element
+ *
+ * A harness around an element or a bin. @srcpad and @sinkpad are %NULL when
+ * @element has no sink or src pad respectively.
+ *
+ * Since: 1.6
+ */
+struct _GstHarness {
+  GstElement *element;
+
+  GstPad *srcpad;
+  GstPad *sinkpad;
+
+  /*< private >*/
+  GstHarnessPrivate *priv;
+};
+
+/**
+ * GstHarnessStats:
+ * @buffers_pushed: the number of buffers pushed into the element
+ * @buffers_received: the number of buffers that came out of the element
+ * @bytes_received: the size of all received buffers
+ * @allocations: the number of memory allocations from the allocator that the
+ *     harness proposes in the ALLOCATION query
+ * @elapsed: the time between the first buffer pushed and the last buffer
+ *     received
+ * @buffers_per_second: @buffers_received per second of @elapsed
+ * @bytes_per_second: @bytes_received per second of @elapsed
+ * @latency_min: the shortest latency of a buffer
+ * @latency_50: the median latency
+ * @latency_90: the latency that 90% of the buffers did not exceed
+ * @latency_99: the latency that 99% of the buffers did not exceed
+ * @latency_max: the longest latency of a buffer
+ *
+ * Statistics collected by a #GstHarness, see gst_harness_get_stats().
+ *
+ * The latency of a buffer is the time from the moment the N-th buffer was
+ * pushed until the N-th buffer was received, so the latencies are only
+ * meaningful for elements that produce one buffer for each input buffer
+ * and when the buffers are pushed from one thread. Buffers that come out
+ * more than 4095 buffers after they were pushed are not counted. The
+ * percentiles are taken from a histogram and are accurate to 12.5%, the
+ * minimum and maximum are exact. The latencies are #GST_CLOCK_TIME_NONE when
+ * no buffer was received.
+ *
+ * All times are measured with the monotonic system time, not with the
+ * clock of the harness.
+ *
+ * Since: 1.6
+ */
+typedef struct {
+  guint64 buffers_pushed;
+  guint64 buffers_received;
+  guint64 bytes_received;
+  guint64 allocations;
+
+  GstClockTime elapsed;
+  gdouble buffers_per_second;
+  gdouble bytes_per_second;
+
+  GstClockTime latency_min;
+  GstClockTime latency_50;
+  GstClockTime latency_90;
+  GstClockTime latency_99;
+  GstClockTime latency_max;
+} GstHarnessStats;
+
+/* setup and teardown */
+GstHarness *    gst_harness_new                 (const gchar * element_name);
+GstHarness *    gst_harness_new_with_element    (GstElement * element,
+                                                 const gchar * element_sinkpad_name,
+                                                 const gchar * element_srcpad_name);
+GstHarness *    gst_harness_new_parse           (const gchar * launchline);
+void            gst_harness_teardown            (GstHarness * h);
+
+void            gst_harness_set_src_caps        (GstHarness * h, GstCaps * caps);
+void            gst_harness_set_src_caps_str    (GstHarness * h, const gchar * str);
+void            gst_harness_set_drop_buffers    (GstHarness * h, gboolean drop_buffers);
+
+/* buffers */
+GstFlowReturn   gst_harness_push                (GstHarness * h, GstBuffer * buffer);
+GstBuffer *     gst_harness_pull                (GstHarness * h);
+GstBuffer *     gst_harness_try_pull            (GstHarness * h);
+guint           gst_harness_buffers_received    (GstHarness * h);
+guint           gst_harness_buffers_in_queue    (GstHarness * h);
+
+/* events and queries */
+gboolean        gst_harness_push_event          (GstHarness * h, GstEvent * event);
+GstEvent *      gst_harness_pull_event          (GstHarness * h);
+GstEvent *      gst_harness_try_pull_event      (GstHarness * h);
+guint           gst_harness_events_received     (GstHarness * h);
+gboolean        gst_harness_push_upstream_event (GstHarness * h, GstEvent * event);
+gboolean        gst_harness_push_query          (GstHarness * h, GstQuery * query);
+
+/* time */
+GstTestClock *  gst_harness_get_testclock       (GstHarness * h);
+void            gst_harness_set_time            (GstHarness * h, GstClockTime time);
+gboolean        gst_harness_crank_single_clock_wait (GstHarness * h);
+
+/* statistics */
+void            gst_harness_get_stats           (GstHarness * h, GstHarnessStats * stats);
+void            gst_harness_reset_stats         (GstHarness * h);
+
+G_END_DECLS
+
+#endif /* __GST_HARNESS_H__ */
@@ -100,6 +100,26 @@ convert_value_to_##type (GstDirectControlBinding *self, gdouble s, gpointer d_)
 }
 
 
+/* array variants of the mapping functions, these convert a whole block of
+ * control-values at once and leave the target untouched for NAN values */
+#define DEFINE_CONVERT_ARRAY(type,Type,TYPE,ROUNDING_OP) \
+static void \
+convert_value_array_to_##type (GstDirectControlBinding *self, const gdouble *s, gpointer d_, guint n) \
+{ \
+  GParamSpec##Type *pspec = G_PARAM_SPEC_##TYPE (((GstControlBinding *)self)->pspec); \
+  g##type *d = (g##type *)d_; \
+  g##type min = pspec->minimum, max = pspec->maximum; \
+  gdouble v; \
+  guint i; \
+  \
+  for (i = 0; i < n; i++) { \
+    if (G_UNLIKELY (isnan (s[i]))) \
+      continue; \
+    v = CLAMP (s[i], 0.0, 1.0); \
+    d[i] = (g##type) ROUNDING_OP (min * (1-v)) + (g##type) ROUNDING_OP (max * v); \
+  } \
+}
+
 DEFINE_CONVERT (int, Int, INT, rint);
 DEFINE_CONVERT (uint, UInt, UINT, rint);
 DEFINE_CONVERT (long, Long, LONG, rint);
@@ -109,6 +129,15 @@ DEFINE_CONVERT (uint64, UInt64, UINT64, rint);
 DEFINE_CONVERT (float, Float, FLOAT, /*NOOP*/);
 DEFINE_CONVERT (double, Double, DOUBLE, /*NOOP*/);
 
+DEFINE_CONVERT_ARRAY (int, Int, INT, rint);
+DEFINE_CONVERT_ARRAY (uint, UInt, UINT, rint);
+DEFINE_CONVERT_ARRAY (long, Long, LONG, rint);
+DEFINE_CONVERT_ARRAY (ulong, ULong, ULONG, rint);
+DEFINE_CONVERT_ARRAY (int64, Int64, INT64, rint);
+DEFINE_CONVERT_ARRAY (uint64, UInt64, UINT64, rint);
+DEFINE_CONVERT_ARRAY (float, Float, FLOAT, /*NOOP*/);
+DEFINE_CONVERT_ARRAY (double, Double, DOUBLE, /*NOOP*/);
+
 static void
 convert_g_value_to_boolean (GstDirectControlBinding * self, gdouble s,
     GValue * d)
@@ -152,6 +181,70 @@ convert_value_to_enum (GstDirectControlBinding * self, gdouble s, gpointer d_)
   *d = e->values[(gint) (s * (e->n_values - 1))].value;
 }
 
+static void
+convert_value_array_to_boolean (GstDirectControlBinding * self,
+    const gdouble * s, gpointer d_, guint n)
+{
+  gboolean *d = (gboolean *) d_;
+  guint i;
+
+  for (i = 0; i < n; i++) {
+    if (G_UNLIKELY (isnan (s[i])))
+      continue;
+    d[i] = (gboolean) (CLAMP (s[i], 0.0, 1.0) + 0.5);
+  }
+}
+
+static void
+convert_value_array_to_enum (GstDirectControlBinding * self,
+    const gdouble * s, gpointer d_, guint n)
+{
+  GParamSpecEnum *pspec =
+      G_PARAM_SPEC_ENUM (((GstControlBinding *) self)->pspec);
+  GEnumClass *e = pspec->enum_class;
+  gint *d = (gint *) d_;
+  guint i;
+
+  for (i = 0; i < n; i++) {
+    if (G_UNLIKELY (isnan (s[i])))
+      continue;
+    d[i] = e->values[(gint) (CLAMP (s[i], 0.0, 1.0) * (e->n_values - 1))].value;
+  }
+}
+
+typedef void (*GstDirectControlBindingConvertValueArray) (GstDirectControlBinding
+    * self, const gdouble * src_values, gpointer dest_values, guint n_values);
+
+static GstDirectControlBindingConvertValueArray
+get_convert_value_array (GstDirectControlBinding * self)
+{
+  switch (G_TYPE_FUNDAMENTAL (G_PARAM_SPEC_VALUE_TYPE
+          (GST_CONTROL_BINDING_PSPEC (self)))) {
+    case G_TYPE_INT:
+      return convert_value_array_to_int;
+    case G_TYPE_UINT:
+      return convert_value_array_to_uint;
+    case G_TYPE_LONG:
+      return convert_value_array_to_long;
+    case G_TYPE_ULONG:
+      return convert_value_array_to_ulong;
+    case G_TYPE_INT64:
+      return convert_value_array_to_int64;
+    case G_TYPE_UINT64:
+      return convert_value_array_to_uint64;
+    case G_TYPE_FLOAT:
+      return convert_value_array_to_float;
+    case G_TYPE_DOUBLE:
+      return convert_value_array_to_double;
+    case G_TYPE_BOOLEAN:
+      return convert_value_array_to_boolean;
+    case G_TYPE_ENUM:
+      return convert_value_array_to_enum;
+    default:
+      return NULL;
+  }
+}
+
 /* vmethods */
 
 static void
@@ -388,18 +481,22 @@ gst_direct_control_binding_get_value (GstControlBinding * _self,
   return dst_val;
 }
 
+/* number of control-values fetched from the control source per iteration */
+#define CONVERT_BLOCK_SIZE 256
+
 static gboolean
 gst_direct_control_binding_get_value_array (GstControlBinding * _self,
     GstClockTime timestamp, GstClockTime interval, guint n_values,
     gpointer values_)
 {
   GstDirectControlBinding *self = GST_DIRECT_CONTROL_BINDING (_self);
-  gint i;
-  gdouble *src_val;
+  gdouble src_val[CONVERT_BLOCK_SIZE];
   gboolean res = FALSE;
-  GstDirectControlBindingConvertValue convert;
+  GstDirectControlBindingConvertValueArray convert;
   gint byte_size;
   guint8 *values = (guint8 *) values_;
+  GstClockTime ts = timestamp;
+  guint n;
 
   g_return_val_if_fail (GST_IS_DIRECT_CONTROL_BINDING (self), FALSE);
   g_return_val_if_fail (GST_CLOCK_TIME_IS_VALID (timestamp), FALSE);
@@ -407,27 +504,27 @@ gst_direct_control_binding_get_value_array (GstControlBinding * _self,
   g_return_val_if_fail (values, FALSE);
   g_return_val_if_fail (GST_CONTROL_BINDING_PSPEC (self), FALSE);
 
-  convert = self->convert_value;
+  convert = get_convert_value_array (self);
   byte_size = self->byte_size;
 
-  src_val = g_new0 (gdouble, n_values);
-  if ((res = gst_control_source_get_value_array (self->cs, timestamp,
-              interval, n_values, src_val))) {
-    for (i = 0; i < n_values; i++) {
-      /* we will only get NAN for sparse control sources, such as triggers */
-      if (!isnan (src_val[i])) {
-        convert (self, src_val[i], (gpointer) values);
-      } else {
-        GST_LOG ("no control value for property %s at index %d", _self->name,
-            i);
-      }
-      values += byte_size;
+  /* fetch and convert the control-values block-wise, so that we neither need
+   * to allocate a temporary array nor call the mapping function per value */
+  while (n_values > 0) {
+    n = MIN (n_values, CONVERT_BLOCK_SIZE);
+    if (gst_control_source_get_value_array (self->cs, ts, interval, n,
+            src_val)) {
+      convert (self, src_val, values, n);
+      res = TRUE;
     }
-  } else {
+    ts += n * interval;
+    values += n * byte_size;
+    n_values -= n;
+  }
+
+  if (!res) {
     GST_LOG ("failed to get control value for property %s at ts %"
         GST_TIME_FORMAT, _self->name, GST_TIME_ARGS (timestamp));
   }
-  g_free (src_val);
   return res;
 }
 
@@ -437,11 +534,12 @@ gst_direct_control_binding_get_g_value_array (GstControlBinding * _self,
     GValue * values)
 {
   GstDirectControlBinding *self = GST_DIRECT_CONTROL_BINDING (_self);
-  gint i;
-  gdouble *src_val;
+  gdouble src_val[CONVERT_BLOCK_SIZE];
   gboolean res = FALSE;
   GType type;
   GstDirectControlBindingConvertGValue convert;
+  GstClockTime ts = timestamp;
+  guint i, n;
 
   g_return_val_if_fail (GST_IS_DIRECT_CONTROL_BINDING (self), FALSE);
   g_return_val_if_fail (GST_CLOCK_TIME_IS_VALID (timestamp), FALSE);
@@ -452,24 +550,31 @@ gst_direct_control_binding_get_g_value_array (GstControlBinding * _self,
   convert = self->convert_g_value;
   type = G_PARAM_SPEC_VALUE_TYPE (_self->pspec);
 
-  src_val = g_new0 (gdouble, n_values);
-  if ((res = gst_control_source_get_value_array (self->cs, timestamp,
-              interval, n_values, src_val))) {
-    for (i = 0; i < n_values; i++) {
-      /* we will only get NAN for sparse control sources, such as triggers */
-      if (!isnan (src_val[i])) {
-        g_value_init (&values[i], type);
-        convert (self, src_val[i], &values[i]);
-      } else {
-        GST_LOG ("no control value for property %s at index %d", _self->name,
-            i);
+  while (n_values > 0) {
+    n = MIN (n_values, CONVERT_BLOCK_SIZE);
+    if (gst_control_source_get_value_array (self->cs, ts, interval, n,
+            src_val)) {
+      for (i = 0; i < n; i++) {
+        /* we will only get NAN for sparse control sources, such as triggers */
+        if (!isnan (src_val[i])) {
+          g_value_init (&values[i], type);
+          convert (self, src_val[i], &values[i]);
+        } else {
+          GST_LOG ("no control value for property %s at ts %" GST_TIME_FORMAT,
+              _self->name, GST_TIME_ARGS (ts + i * interval));
+        }
       }
+      res = TRUE;
     }
-  } else {
+    ts += n * interval;
+    values += n;
+    n_values -= n;
+  }
+
+  if (!res) {
     GST_LOG ("failed to get control value for property %s at ts %"
         GST_TIME_FORMAT, _self->name, GST_TIME_ARGS (timestamp));
   }
-  g_free (src_val);
   return res;
 }
 
@@ -46,194 +46,30 @@
 #define GST_CAT_DEFAULT controller_debug
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
 
-/*  steps-like (no-)interpolation, default */
-/*  just returns the value for the most recent key-frame */
-static inline gdouble
-_interpolate_none (GstTimedValueControlSource * self, GSequenceIter * iter)
-{
-  GstControlPoint *cp = g_sequence_get (iter);
-
-  return cp->value;
-}
-
-static gboolean
-interpolate_none_get (GstTimedValueControlSource * self, GstClockTime timestamp,
-    gdouble * value)
-{
-  gboolean ret = FALSE;
-  GSequenceIter *iter;
-
-  g_mutex_lock (&self->lock);
-
-  iter =
-      gst_timed_value_control_source_find_control_point_iter (self, timestamp);
-  if (iter) {
-    *value = _interpolate_none (self, iter);
-    ret = TRUE;
-  }
-  g_mutex_unlock (&self->lock);
-  return ret;
-}
-
-static gboolean
-interpolate_none_get_value_array (GstTimedValueControlSource * self,
-    GstClockTime timestamp, GstClockTime interval, guint n_values,
-    gdouble * values)
-{
-  gboolean ret = FALSE;
-  guint i;
-  GstClockTime ts = timestamp;
-  GstClockTime next_ts = 0;
-  gdouble val;
-  GSequenceIter *iter1 = NULL, *iter2 = NULL;
-
-  g_mutex_lock (&self->lock);
-
-  for (i = 0; i < n_values; i++) {
-    GST_LOG ("values[%3d] : ts=%" GST_TIME_FORMAT ", next_ts=%" GST_TIME_FORMAT,
-        i, GST_TIME_ARGS (ts), GST_TIME_ARGS (next_ts));
-    val = NAN;
-    if (ts >= next_ts) {
-      iter1 = gst_timed_value_control_source_find_control_point_iter (self, ts);
-      if (!iter1) {
-        if (G_LIKELY (self->values))
-          iter2 = g_sequence_get_begin_iter (self->values);
-        else
-          iter2 = NULL;
-      } else {
-        iter2 = g_sequence_iter_next (iter1);
-      }
-
-      if (iter2 && !g_sequence_iter_is_end (iter2)) {
-        GstControlPoint *cp;
-
-        cp = g_sequence_get (iter2);
-        next_ts = cp->timestamp;
-      } else {
-        next_ts = GST_CLOCK_TIME_NONE;
-      }
-    }
-    if (iter1) {
-      val = _interpolate_none (self, iter1);
-      ret = TRUE;
-      GST_LOG ("values[%3d]=%lf", i, val);
-    } else {
-      GST_LOG ("values[%3d]=-", i);
-    }
-    *values = val;
-    ts += interval;
-    values++;
-  }
-  g_mutex_unlock (&self->lock);
-  return ret;
-}
-
-
-
-/*  linear interpolation */
-/*  smoothes inbetween values */
-static inline gdouble
-_interpolate_linear (GstClockTime timestamp1, gdouble value1,
-    GstClockTime timestamp2, gdouble value2, GstClockTime timestamp)
-{
-  if (GST_CLOCK_TIME_IS_VALID (timestamp2)) {
-    gdouble slope;
-
-    slope =
-        (value2 - value1) / gst_guint64_to_gdouble (timestamp2 - timestamp1);
-    return value1 + (gst_guint64_to_gdouble (timestamp - timestamp1) * slope);
-  } else {
-    return value1;
-  }
-}
-
-static gboolean
-interpolate_linear_get (GstTimedValueControlSource * self,
-    GstClockTime timestamp, gdouble * value)
-{
-  gboolean ret = FALSE;
-  GSequenceIter *iter;
-  GstControlPoint *cp1, *cp2;
-
-  g_mutex_lock (&self->lock);
-
-  iter =
-      gst_timed_value_control_source_find_control_point_iter (self, timestamp);
-  if (iter) {
-    cp1 = g_sequence_get (iter);
-    iter = g_sequence_iter_next (iter);
-    if (iter && !g_sequence_iter_is_end (iter)) {
-      cp2 = g_sequence_get (iter);
-    } else {
-      cp2 = NULL;
-    }
-
-    *value = _interpolate_linear (cp1->timestamp, cp1->value,
-        (cp2 ? cp2->timestamp : GST_CLOCK_TIME_NONE),
-        (cp2 ? cp2->value : 0.0), timestamp);
-    ret = TRUE;
-  }
-  g_mutex_unlock (&self->lock);
-  return ret;
-}
-
-static gboolean
-interpolate_linear_get_value_array (GstTimedValueControlSource * self,
-    GstClockTime timestamp, GstClockTime interval, guint n_values,
-    gdouble * values)
+struct _GstInterpolationControlSourcePrivate
 {
-  gboolean ret = FALSE;
-  guint i;
-  GstClockTime ts = timestamp;
-  GstClockTime next_ts = 0;
-  gdouble val;
-  GSequenceIter *iter1, *iter2 = NULL;
-  GstControlPoint *cp1 = NULL, *cp2 = NULL;
-
-  g_mutex_lock (&self->lock);
+  GstInterpolationMode interpolation_mode;
 
-  for (i = 0; i < n_values; i++) {
-    GST_LOG ("values[%3d] : ts=%" GST_TIME_FORMAT ", next_ts=%" GST_TIME_FORMAT,
-        i, GST_TIME_ARGS (ts), GST_TIME_ARGS (next_ts));
-    val = NAN;
-    if (ts >= next_ts) {
-      cp1 = cp2 = NULL;
-      iter1 = gst_timed_value_control_source_find_control_point_iter (self, ts);
-      if (!iter1) {
-        if (G_LIKELY (self->values))
-          iter2 = g_sequence_get_begin_iter (self->values);
-        else
-          iter2 = NULL;
-      } else {
-        cp1 = g_sequence_get (iter1);
-        iter2 = g_sequence_iter_next (iter1);
-      }
-
-      if (iter2 && !g_sequence_iter_is_end (iter2)) {
-        cp2 = g_sequence_get (iter2);
-        next_ts = cp2->timestamp;
-      } else {
-        next_ts = GST_CLOCK_TIME_NONE;
-      }
-    }
-    if (cp1) {
-      val = _interpolate_linear (cp1->timestamp, cp1->value,
-          (cp2 ? cp2->timestamp : GST_CLOCK_TIME_NONE),
-          (cp2 ? cp2->value : 0.0), ts);
-      ret = TRUE;
-      GST_LOG ("values[%3d]=%lf", i, val);
-    } else {
-      GST_LOG ("values[%3d]=-", i);
-    }
-    *values = val;
-    ts += interval;
-    values++;
-  }
-  g_mutex_unlock (&self->lock);
-  return ret;
-}
+  /* Flat copy of the control points, rebuilt from the GSequence whenever the
+   * base class cache is invalidated, so that lookups are a binary search and
+   * whole segments between two control points can be computed in one loop */
+  guint n_points;
+  guint alloc_points;
+  GstClockTime *timestamps;
+  gdouble *values;
+
+  /* spline coefficients, only valid in cubic mode */
+  gdouble *h;
+  gdouble *z;
+};
 
+#define GET_PRIV(self) (((GstInterpolationControlSource *) (self))->priv)
 
+/* Fills @n_values values starting at @timestamp, all of which lie between
+ * control point @idx and the next one */
+typedef void (*InterpolateSegmentFunc) (GstInterpolationControlSourcePrivate *
+    priv, guint idx, GstClockTime timestamp, GstClockTime interval,
+    guint n_values, gdouble * values);
 
 /*  cubic interpolation */
 
@@ -251,53 +87,32 @@ interpolate_linear_get_value_array (GstTimedValueControlSource * self,
  */
 
 static void
-_interpolate_cubic_update_cache (GstTimedValueControlSource * self)
+_interpolate_cubic_update_cache (GstInterpolationControlSourcePrivate * priv)
 {
-  gint i, n = self->nvalues;
+  gint i, n = priv->n_points;
   gdouble *o = g_new0 (gdouble, n);
   gdouble *p = g_new0 (gdouble, n);
   gdouble *q = g_new0 (gdouble, n);
-
-  gdouble *h = g_new0 (gdouble, n);
   gdouble *b = g_new0 (gdouble, n);
-  gdouble *z = g_new0 (gdouble, n);
 
-  GSequenceIter *iter;
-  GstControlPoint *cp;
-  GstClockTime x, x_next;
-  gdouble y_prev, y, y_next;
+  const GstClockTime *x = priv->timestamps;
+  const gdouble *y = priv->values;
+  gdouble *h = priv->h;
+  gdouble *z = priv->z;
 
   /* Fill linear system of equations */
-  iter = g_sequence_get_begin_iter (self->values);
-  cp = g_sequence_get (iter);
-  x = cp->timestamp;
-  y = cp->value;
-
   p[0] = 1.0;
-
-  iter = g_sequence_iter_next (iter);
-  cp = g_sequence_get (iter);
-  x_next = cp->timestamp;
-  y_next = cp->value;
-  h[0] = gst_guint64_to_gdouble (x_next - x);
+  h[0] = gst_guint64_to_gdouble (x[1] - x[0]);
 
   for (i = 1; i < n - 1; i++) {
-    /* Shuffle x and y values */
-    y_prev = y;
-    x = x_next;
-    y = y_next;
-    iter = g_sequence_iter_next (iter);
-    cp = g_sequence_get (iter);
-    x_next = cp->timestamp;
-    y_next = cp->value;
-
-    h[i] = gst_guint64_to_gdouble (x_next - x);
+    h[i] = gst_guint64_to_gdouble (x[i + 1] - x[i]);
     o[i] = h[i - 1];
     p[i] = 2.0 * (h[i - 1] + h[i]);
     q[i] = h[i];
-    b[i] = (y_next - y) / h[i] - (y - y_prev) / h[i - 1];
+    b[i] = (y[i + 1] - y[i]) / h[i] - (y[i] - y[i - 1]) / h[i - 1];
   }
   p[n - 1] = 1.0;
+  h[n - 1] = 0.0;
 
   /* Use Gauss elimination to set everything below the diagonal to zero */
   for (i = 1; i < n - 1; i++) {
@@ -307,85 +122,103 @@ _interpolate_cubic_update_cache (GstTimedValueControlSource * self)
   }
 
   /* Solve everything else from bottom to top */
+  z[0] = z[n - 1] = 0.0;
   for (i = n - 2; i > 0; i--)
     z[i] = (b[i] - q[i] * z[i + 1]) / p[i];
 
-  /* Save cache next in the GstControlPoint */
-
-  iter = g_sequence_get_begin_iter (self->values);
-  for (i = 0; i < n; i++) {
-    cp = g_sequence_get (iter);
-    cp->cache.cubic.h = h[i];
-    cp->cache.cubic.z = z[i];
-    iter = g_sequence_iter_next (iter);
-  }
-
   /* Free our temporary arrays */
   g_free (o);
   g_free (p);
   g_free (q);
-  g_free (h);
   g_free (b);
-  g_free (z);
 }
 
-static inline gdouble
-_interpolate_cubic (GstTimedValueControlSource * self, GstControlPoint * cp1,
-    gdouble value1, GstControlPoint * cp2, gdouble value2,
-    GstClockTime timestamp)
+/* must be called with the lock */
+static void
+_update_cache (GstTimedValueControlSource * self)
 {
-  if (!self->valid_cache) {
-    _interpolate_cubic_update_cache (self);
-    self->valid_cache = TRUE;
+  GstInterpolationControlSourcePrivate *priv = GET_PRIV (self);
+  GSequenceIter *iter;
+  GstControlPoint *cp;
+  guint i, n;
+
+  if (G_LIKELY (self->valid_cache))
+    return;
+
+  n = self->values ? g_sequence_get_length (self->values) : 0;
+  if (n > priv->alloc_points) {
+    priv->timestamps = g_renew (GstClockTime, priv->timestamps, n);
+    priv->values = g_renew (gdouble, priv->values, n);
+    priv->h = g_renew (gdouble, priv->h, n);
+    priv->z = g_renew (gdouble, priv->z, n);
+    priv->alloc_points = n;
   }
 
-  if (cp2) {
-    gdouble diff1, diff2;
-    gdouble out;
-
-    diff1 = gst_guint64_to_gdouble (timestamp - cp1->timestamp);
-    diff2 = gst_guint64_to_gdouble (cp2->timestamp - timestamp);
-
-    out =
-        (cp2->cache.cubic.z * diff1 * diff1 * diff1 +
-        cp1->cache.cubic.z * diff2 * diff2 * diff2) / cp1->cache.cubic.h;
-    out +=
-        (value2 / cp1->cache.cubic.h -
-        cp1->cache.cubic.h * cp2->cache.cubic.z) * diff1;
-    out +=
-        (value1 / cp1->cache.cubic.h -
-        cp1->cache.cubic.h * cp1->cache.cubic.z) * diff2;
-    return out;
-  } else {
-    return value1;
+  if (n > 0) {
+    iter = g_sequence_get_begin_iter (self->values);
+    for (i = 0; i < n; i++) {
+      cp = g_sequence_get (iter);
+      priv->timestamps[i] = cp->timestamp;
+      priv->values[i] = cp->value;
+      iter = g_sequence_iter_next (iter);
+    }
   }
+  priv->n_points = n;
+
+  if (priv->interpolation_mode == GST_INTERPOLATION_MODE_CUBIC && n > 2)
+    _interpolate_cubic_update_cache (priv);
+
+  GST_DEBUG_OBJECT (self, "updated cache with %u control points", n);
+  self->valid_cache = TRUE;
+}
+
+/* Find last control point at or before @timestamp, returns -1 if all
+ * control points come after @timestamp or there are none */
+static inline gint
+_find_control_point (GstInterpolationControlSourcePrivate * priv,
+    GstClockTime timestamp)
+{
+  guint lo = 0, hi = priv->n_points, mid;
+
+  while (lo < hi) {
+    mid = lo + (hi - lo) / 2;
+    if (priv->timestamps[mid] <= timestamp)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return (gint) lo - 1;
+}
+
+/* number of values, at most @max, starting at @timestamp that are before
+ * @end. @timestamp must be smaller than @end */
+static inline guint
+_n_values_before (GstClockTime timestamp, GstClockTime interval,
+    GstClockTime end, guint max)
+{
+  guint64 n;
+
+  if (!GST_CLOCK_TIME_IS_VALID (end) || interval == 0)
+    return max;
+
+  n = (end - timestamp - 1) / interval + 1;
+  return (guint) MIN (n, max);
 }
 
 static gboolean
-interpolate_cubic_get (GstTimedValueControlSource * self,
-    GstClockTime timestamp, gdouble * value)
+_interpolate_get (GstTimedValueControlSource * self, GstClockTime timestamp,
+    gdouble * value, InterpolateSegmentFunc interpolate)
 {
+  GstInterpolationControlSourcePrivate *priv = GET_PRIV (self);
   gboolean ret = FALSE;
-  GSequenceIter *iter;
-  GstControlPoint *cp1, *cp2 = NULL;
-
-  if (self->nvalues <= 2)
-    return interpolate_linear_get (self, timestamp, value);
+  gint idx;
 
   g_mutex_lock (&self->lock);
+  _update_cache (self);
 
-  iter =
-      gst_timed_value_control_source_find_control_point_iter (self, timestamp);
-  if (iter) {
-    cp1 = g_sequence_get (iter);
-    iter = g_sequence_iter_next (iter);
-    if (iter && !g_sequence_iter_is_end (iter)) {
-      cp2 = g_sequence_get (iter);
-    } else {
-      cp2 = NULL;
-    }
-    *value = _interpolate_cubic (self, cp1, cp1->value, cp2,
-        (cp2 ? cp2->value : 0.0), timestamp);
+  idx = _find_control_point (priv, timestamp);
+  if (idx >= 0) {
+    interpolate (priv, idx, timestamp, 0, 1, value);
     ret = TRUE;
   }
   g_mutex_unlock (&self->lock);
@@ -393,64 +226,184 @@ interpolate_cubic_get (GstTimedValueControlSource * self,
 }
 
 static gboolean
-interpolate_cubic_get_value_array (GstTimedValueControlSource * self,
+_interpolate_get_value_array (GstTimedValueControlSource * self,
     GstClockTime timestamp, GstClockTime interval, guint n_values,
-    gdouble * values)
+    gdouble * values, InterpolateSegmentFunc interpolate)
 {
+  GstInterpolationControlSourcePrivate *priv = GET_PRIV (self);
   gboolean ret = FALSE;
-  guint i;
   GstClockTime ts = timestamp;
-  GstClockTime next_ts = 0;
-  gdouble val;
-  GSequenceIter *iter1, *iter2 = NULL;
-  GstControlPoint *cp1 = NULL, *cp2 = NULL;
-
-  if (self->nvalues <= 2)
-    return interpolate_linear_get_value_array (self, timestamp, interval,
-        n_values, values);
+  GstClockTime next_ts;
+  guint i, n;
+  gint idx;
 
   g_mutex_lock (&self->lock);
+  _update_cache (self);
 
-  for (i = 0; i < n_values; i++) {
-    GST_LOG ("values[%3d] : ts=%" GST_TIME_FORMAT ", next_ts=%" GST_TIME_FORMAT,
-        i, GST_TIME_ARGS (ts), GST_TIME_ARGS (next_ts));
-    val = NAN;
-    if (ts >= next_ts) {
-      cp1 = cp2 = NULL;
-      iter1 = gst_timed_value_control_source_find_control_point_iter (self, ts);
-      if (!iter1) {
-        if (G_LIKELY (self->values))
-          iter2 = g_sequence_get_begin_iter (self->values);
-        else
-          iter2 = NULL;
-      } else {
-        cp1 = g_sequence_get (iter1);
-        iter2 = g_sequence_iter_next (iter1);
-      }
-
-      if (iter2 && !g_sequence_iter_is_end (iter2)) {
-        cp2 = g_sequence_get (iter2);
-        next_ts = cp2->timestamp;
-      } else {
-        next_ts = GST_CLOCK_TIME_NONE;
-      }
-    }
-    if (cp1) {
-      val = _interpolate_cubic (self, cp1, cp1->value, cp2,
-          (cp2 ? cp2->value : 0.0), ts);
+  /* Instead of looking up the control points for every value, fill all
+   * values between two control points in one go */
+  while (n_values > 0) {
+    idx = _find_control_point (priv, ts);
+    if (idx + 1 < (gint) priv->n_points)
+      next_ts = priv->timestamps[idx + 1];
+    else
+      next_ts = GST_CLOCK_TIME_NONE;
+
+    n = _n_values_before (ts, interval, next_ts, n_values);
+
+    GST_LOG ("%u values : ts=%" GST_TIME_FORMAT ", next_ts=%" GST_TIME_FORMAT,
+        n, GST_TIME_ARGS (ts), GST_TIME_ARGS (next_ts));
+
+    if (idx >= 0) {
+      interpolate (priv, idx, ts, interval, n, values);
       ret = TRUE;
-      GST_LOG ("values[%3d]=%lf", i, val);
     } else {
-      GST_LOG ("values[%3d]=-", i);
+      for (i = 0; i < n; i++)
+        values[i] = NAN;
     }
-    *values = val;
-    ts += interval;
-    values++;
+    values += n;
+    n_values -= n;
+    ts += n * interval;
   }
   g_mutex_unlock (&self->lock);
   return ret;
 }
 
+/*  steps-like (no-)interpolation, default */
+/*  just returns the value for the most recent key-frame */
+static void
+_interpolate_none (GstInterpolationControlSourcePrivate * priv, guint idx,
+    GstClockTime timestamp, GstClockTime interval, guint n_values,
+    gdouble * values)
+{
+  gdouble value = priv->values[idx];
+  guint i;
+
+  for (i = 0; i < n_values; i++)
+    values[i] = value;
+}
+
+static gboolean
+interpolate_none_get (GstTimedValueControlSource * self, GstClockTime timestamp,
+    gdouble * value)
+{
+  return _interpolate_get (self, timestamp, value, _interpolate_none);
+}
+
+static gboolean
+interpolate_none_get_value_array (GstTimedValueControlSource * self,
+    GstClockTime timestamp, GstClockTime interval, guint n_values,
+    gdouble * values)
+{
+  return _interpolate_get_value_array (self, timestamp, interval, n_values,
+      values, _interpolate_none);
+}
+
+
+
+/*  linear interpolation */
+/*  smoothes inbetween values */
+static void
+_interpolate_linear (GstInterpolationControlSourcePrivate * priv, guint idx,
+    GstClockTime timestamp, GstClockTime interval, guint n_values,
+    gdouble * values)
+{
+  gdouble value1 = priv->values[idx];
+  gdouble slope, diff, step;
+  guint i;
+
+  if (idx + 1 == priv->n_points) {
+    _interpolate_none (priv, idx, timestamp, interval, n_values, values);
+    return;
+  }
+
+  slope = (priv->values[idx + 1] - value1) /
+      gst_guint64_to_gdouble (priv->timestamps[idx + 1] -
+      priv->timestamps[idx]);
+  diff = gst_guint64_to_gdouble (timestamp - priv->timestamps[idx]);
+  step = gst_guint64_to_gdouble (interval);
+
+  for (i = 0; i < n_values; i++)
+    values[i] = value1 + ((diff + i * step) * slope);
+}
+
+static gboolean
+interpolate_linear_get (GstTimedValueControlSource * self,
+    GstClockTime timestamp, gdouble * value)
+{
+  return _interpolate_get (self, timestamp, value, _interpolate_linear);
+}
+
+static gboolean
+interpolate_linear_get_value_array (GstTimedValueControlSource * self,
+    GstClockTime timestamp, GstClockTime interval, guint n_values,
+    gdouble * values)
+{
+  return _interpolate_get_value_array (self, timestamp, interval, n_values,
+      values, _interpolate_linear);
+}
+
+
+
+/*  cubic interpolation */
+static void
+_interpolate_cubic (GstInterpolationControlSourcePrivate * priv, guint idx,
+    GstClockTime timestamp, GstClockTime interval, guint n_values,
+    gdouble * values)
+{
+  gdouble h, z1, z2, a, b, diff, step, diff1, diff2;
+  guint i;
+
+  if (idx + 1 == priv->n_points) {
+    _interpolate_none (priv, idx, timestamp, interval, n_values, values);
+    return;
+  }
+  /* no spline with less than three control points */
+  if (priv->n_points <= 2) {
+    _interpolate_linear (priv, idx, timestamp, interval, n_values, values);
+    return;
+  }
+
+  h = priv->h[idx];
+  z1 = priv->z[idx];
+  z2 = priv->z[idx + 1];
+  a = priv->values[idx + 1] / h - h * z2;
+  b = priv->values[idx] / h - h * z1;
+  diff = gst_guint64_to_gdouble (timestamp - priv->timestamps[idx]);
+  step = gst_guint64_to_gdouble (interval);
+
+  for (i = 0; i < n_values; i++) {
+    diff1 = diff + i * step;
+    diff2 = h - diff1;
+    values[i] = (z2 * diff1 * diff1 * diff1 + z1 * diff2 * diff2 * diff2) / h;
+    values[i] += a * diff1;
+    values[i] += b * diff2;
+  }
+}
+
+static gboolean
+interpolate_cubic_get (GstTimedValueControlSource * self,
+    GstClockTime timestamp, gdouble * value)
+{
+  if (self->nvalues <= 2)
+    return interpolate_linear_get (self, timestamp, value);
+
+  return _interpolate_get (self, timestamp, value, _interpolate_cubic);
+}
+
+static gboolean
+interpolate_cubic_get_value_array (GstTimedValueControlSource * self,
+    GstClockTime timestamp, GstClockTime interval, guint n_values,
+    gdouble * values)
+{
+  if (self->nvalues <= 2)
+    return interpolate_linear_get_value_array (self, timestamp, interval,
+        n_values, values);
+
+  return _interpolate_get_value_array (self, timestamp, interval, n_values,
+      values, _interpolate_cubic);
+}
+
 static struct
 {
   GstControlSourceGetValue get;
@@ -500,11 +453,6 @@ G_DEFINE_TYPE_WITH_CODE (GstInterpolationControlSource,
     gst_interpolation_control_source, GST_TYPE_TIMED_VALUE_CONTROL_SOURCE,
     _do_init);
 
-struct _GstInterpolationControlSourcePrivate
-{
-  GstInterpolationMode interpolation_mode;
-};
-
 /**
  * gst_interpolation_control_source_new:
  *
@@ -552,6 +500,20 @@ gst_interpolation_control_source_init (GstInterpolationControlSource * self)
       GST_INTERPOLATION_MODE_NONE);
 }
 
+static void
+gst_interpolation_control_source_finalize (GObject * obj)
+{
+  GstInterpolationControlSourcePrivate *priv = GET_PRIV (obj);
+
+  g_free (priv->timestamps);
+  g_free (priv->values);
+  g_free (priv->h);
+  g_free (priv->z);
+
+  G_OBJECT_CLASS (gst_interpolation_control_source_parent_class)->finalize
+      (obj);
+}
+
 static void
 gst_interpolation_control_source_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
@@ -599,6 +561,7 @@ gst_interpolation_control_source_class_init (GstInterpolationControlSourceClass
 
   gobject_class->set_property = gst_interpolation_control_source_set_property;
   gobject_class->get_property = gst_interpolation_control_source_get_property;
+  gobject_class->finalize = gst_interpolation_control_source_finalize;
 
   g_object_class_install_property (gobject_class, PROP_MODE,
       g_param_spec_enum ("mode", "Mode", "Interpolation mode",
@@ -191,12 +191,13 @@ gst_timed_value_control_source_set_internal (GstTimedValueControlSource *
 
         /* update control point */
         cp->value = value;
+        self->valid_cache = FALSE;
         g_mutex_unlock (&self->lock);
 
         g_signal_emit (self,
             gst_timed_value_control_source_signals[VALUE_CHANGED_SIGNAL], 0,
             cp);
-        goto done;
+        return;
       }
     }
   } else {
@@ -209,13 +210,11 @@ gst_timed_value_control_source_set_internal (GstTimedValueControlSource *
   g_sequence_insert_sorted (self->values, cp,
       (GCompareDataFunc) gst_control_point_compare, NULL);
   self->nvalues++;
+  self->valid_cache = FALSE;
   g_mutex_unlock (&self->lock);
 
   g_signal_emit (self,
       gst_timed_value_control_source_signals[VALUE_ADDED_SIGNAL], 0, cp);
-
-done:
-  self->valid_cache = FALSE;
 }
 
 /**
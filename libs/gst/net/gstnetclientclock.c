@@ -41,7 +41,17 @@
  * The "round-trip" property limits the maximum round trip packets can take.
  *
  * Various parameters of the clock can be configured with the parent #GstClock
- * "timeout", "window-size" and "window-threshold" object properties.
+ * "timeout", "window-size" and "window-threshold" object properties. They
+ * must be set with g_object_set(), gst_clock_set_timeout() only changes the
+ * value of this instance and not the one used for polling.
+ *
+ * All #GstNetClientClock instances in a process that use the same remote
+ * address and port share one internal clock that polls the time provider and
+ * keeps the calibration state. A new instance for an already known time
+ * provider is synchronized right away, and the number of threads and packets
+ * does not grow with the number of instances. Changing the above parameters
+ * on one instance changes them for all instances that share the internal
+ * clock.
  *
  * A #GstNetClientClock is typically set on a #GstPipeline with 
  * gst_pipeline_use_clock().
@@ -56,6 +66,8 @@
 
 #include <gio/gio.h>
 
+#include <string.h>
+
 GST_DEBUG_CATEGORY_STATIC (ncc_debug);
 #define GST_CAT_DEFAULT (ncc_debug)
 
@@ -63,20 +75,23 @@ GST_DEBUG_CATEGORY_STATIC (ncc_debug);
 #define DEFAULT_PORT            5637
 #define DEFAULT_TIMEOUT         GST_SECOND
 #define DEFAULT_ROUNDTRIP_LIMIT GST_SECOND
+#define DEFAULT_WINDOW_SIZE     32
+#define DEFAULT_WINDOW_THRESHOLD 4
 
-enum
-{
-  PROP_0,
-  PROP_ADDRESS,
-  PROP_PORT,
-  PROP_ROUNDTRIP_LIMIT
-};
+/* the clock that polls the time provider, it is shared by all
+ * GstNetClientClock instances for the same remote address and port */
+#define GST_TYPE_NET_CLIENT_INTERNAL_CLOCK \
+  (gst_net_client_internal_clock_get_type())
+#define GST_NET_CLIENT_INTERNAL_CLOCK(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_NET_CLIENT_INTERNAL_CLOCK,GstNetClientInternalClock))
 
-#define GST_NET_CLIENT_CLOCK_GET_PRIVATE(obj)  \
-  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), GST_TYPE_NET_CLIENT_CLOCK, GstNetClientClockPrivate))
+typedef struct _GstNetClientInternalClock GstNetClientInternalClock;
+typedef struct _GstNetClientInternalClockClass GstNetClientInternalClockClass;
 
-struct _GstNetClientClockPrivate
+struct _GstNetClientInternalClock
 {
+  GstSystemClock clock;
+
   GThread *thread;
 
   GSocket *socket;
@@ -89,163 +104,83 @@ struct _GstNetClientClockPrivate
 
   gchar *address;
   gint port;
+
+  /* number of GstNetClientClock using this clock, protected by clocks_lock */
+  gint users;
 };
 
-#define _do_init \
-  GST_DEBUG_CATEGORY_INIT (ncc_debug, "netclock", 0, "Network client clock");
-#define gst_net_client_clock_parent_class parent_class
-G_DEFINE_TYPE_WITH_CODE (GstNetClientClock, gst_net_client_clock,
-    GST_TYPE_SYSTEM_CLOCK, _do_init);
+struct _GstNetClientInternalClockClass
+{
+  GstSystemClockClass parent_class;
+};
 
-static void gst_net_client_clock_finalize (GObject * object);
-static void gst_net_client_clock_set_property (GObject * object, guint prop_id,
-    const GValue * value, GParamSpec * pspec);
-static void gst_net_client_clock_get_property (GObject * object, guint prop_id,
-    GValue * value, GParamSpec * pspec);
+static GType gst_net_client_internal_clock_get_type (void);
 
-static void gst_net_client_clock_stop (GstNetClientClock * self);
+G_DEFINE_TYPE (GstNetClientInternalClock, gst_net_client_internal_clock,
+    GST_TYPE_SYSTEM_CLOCK);
+
+static void gst_net_client_internal_clock_finalize (GObject * object);
+static void gst_net_client_internal_clock_stop (GstNetClientInternalClock *
+    self);
+
+/* all running internal clocks */
+G_LOCK_DEFINE_STATIC (clocks_lock);
+static GList *clocks = NULL;
 
 static void
-gst_net_client_clock_class_init (GstNetClientClockClass * klass)
+gst_net_client_internal_clock_class_init (GstNetClientInternalClockClass *
+    klass)
 {
   GObjectClass *gobject_class;
 
   gobject_class = G_OBJECT_CLASS (klass);
 
-  g_type_class_add_private (klass, sizeof (GstNetClientClockPrivate));
-
-  gobject_class->finalize = gst_net_client_clock_finalize;
-  gobject_class->get_property = gst_net_client_clock_get_property;
-  gobject_class->set_property = gst_net_client_clock_set_property;
-
-  g_object_class_install_property (gobject_class, PROP_ADDRESS,
-      g_param_spec_string ("address", "address",
-          "The IP address of the machine providing a time server",
-          DEFAULT_ADDRESS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
-  g_object_class_install_property (gobject_class, PROP_PORT,
-      g_param_spec_int ("port", "port",
-          "The port on which the remote server is listening", 0, G_MAXUINT16,
-          DEFAULT_PORT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
-
-  /**
-   * GstNetClientClock::round-trip-limit:
-   *
-   * Maximum allowed round-trip for packets. If this property is set to a nonzero
-   * value, all packets with a round-trip interval larger than this limit will be
-   * ignored. This is useful for networks with severe and fluctuating transport
-   * delays. Filtering out these packets increases stability of the synchronization.
-   * On the other hand, the lower the limit, the higher the amount of filtered
-   * packets. Empirical tests are typically necessary to estimate a good value
-   * for the limit.
-   * If the property is set to zero, the limit is disabled.
-   *
-   * Since: 1.4
-   */
-  g_object_class_install_property (gobject_class, PROP_ROUNDTRIP_LIMIT,
-      g_param_spec_uint64 ("round-trip-limit", "round-trip limit",
-          "Maximum tolerable round-trip interval for packets, in nanoseconds "
-          "(0 = no limit)", 0, G_MAXUINT64, DEFAULT_ROUNDTRIP_LIMIT,
-          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  gobject_class->finalize = gst_net_client_internal_clock_finalize;
 }
 
 static void
-gst_net_client_clock_init (GstNetClientClock * self)
+gst_net_client_internal_clock_init (GstNetClientInternalClock * self)
 {
-  GstClock *clock = GST_CLOCK_CAST (self);
-  GstNetClientClockPrivate *priv;
+  gst_clock_set_timeout (GST_CLOCK_CAST (self), DEFAULT_TIMEOUT);
 
-  self->priv = priv = GST_NET_CLIENT_CLOCK_GET_PRIVATE (self);
-
-  priv->port = DEFAULT_PORT;
-  priv->address = g_strdup (DEFAULT_ADDRESS);
-
-  gst_clock_set_timeout (clock, DEFAULT_TIMEOUT);
+  self->thread = NULL;
 
-  priv->thread = NULL;
-
-  priv->servaddr = NULL;
-  priv->rtt_avg = GST_CLOCK_TIME_NONE;
-  priv->roundtrip_limit = DEFAULT_ROUNDTRIP_LIMIT;
+  self->servaddr = NULL;
+  self->rtt_avg = GST_CLOCK_TIME_NONE;
+  self->roundtrip_limit = DEFAULT_ROUNDTRIP_LIMIT;
 }
 
 static void
-gst_net_client_clock_finalize (GObject * object)
+gst_net_client_internal_clock_finalize (GObject * object)
 {
-  GstNetClientClock *self = GST_NET_CLIENT_CLOCK (object);
+  GstNetClientInternalClock *self = GST_NET_CLIENT_INTERNAL_CLOCK (object);
 
-  if (self->priv->thread) {
-    gst_net_client_clock_stop (self);
+  if (self->thread) {
+    gst_net_client_internal_clock_stop (self);
   }
 
-  g_free (self->priv->address);
-  self->priv->address = NULL;
+  g_free (self->address);
+  self->address = NULL;
 
-  if (self->priv->servaddr != NULL) {
-    g_object_unref (self->priv->servaddr);
-    self->priv->servaddr = NULL;
+  if (self->servaddr != NULL) {
+    g_object_unref (self->servaddr);
+    self->servaddr = NULL;
   }
 
-  if (self->priv->socket != NULL) {
-    g_socket_close (self->priv->socket, NULL);
-    g_object_unref (self->priv->socket);
-    self->priv->socket = NULL;
+  if (self->socket != NULL) {
+    g_socket_close (self->socket, NULL);
+    g_object_unref (self->socket);
+    self->socket = NULL;
   }
 
-  G_OBJECT_CLASS (parent_class)->finalize (object);
+  G_OBJECT_CLASS (gst_net_client_internal_clock_parent_class)->finalize
+      (object);
 }
 
 static void
-gst_net_client_clock_set_property (GObject * object, guint prop_id,
-    const GValue * value, GParamSpec * pspec)
-{
-  GstNetClientClock *self = GST_NET_CLIENT_CLOCK (object);
-
-  switch (prop_id) {
-    case PROP_ADDRESS:
-      g_free (self->priv->address);
-      self->priv->address = g_value_dup_string (value);
-      if (self->priv->address == NULL)
-        self->priv->address = g_strdup (DEFAULT_ADDRESS);
-      break;
-    case PROP_PORT:
-      self->priv->port = g_value_get_int (value);
-      break;
-    case PROP_ROUNDTRIP_LIMIT:
-      self->priv->roundtrip_limit = g_value_get_uint64 (value);
-      break;
-    default:
-      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
-      break;
-  }
-}
-
-static void
-gst_net_client_clock_get_property (GObject * object, guint prop_id,
-    GValue * value, GParamSpec * pspec)
-{
-  GstNetClientClock *self = GST_NET_CLIENT_CLOCK (object);
-
-  switch (prop_id) {
-    case PROP_ADDRESS:
-      g_value_set_string (value, self->priv->address);
-      break;
-    case PROP_PORT:
-      g_value_set_int (value, self->priv->port);
-      break;
-    case PROP_ROUNDTRIP_LIMIT:
-      g_value_set_uint64 (value, self->priv->roundtrip_limit);
-      break;
-    default:
-      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
-      break;
-  }
-}
-
-static void
-gst_net_client_clock_observe_times (GstNetClientClock * self,
+gst_net_client_internal_clock_observe_times (GstNetClientInternalClock * self,
     GstClockTime local_1, GstClockTime remote, GstClockTime local_2)
 {
-  GstNetClientClockPrivate *priv = self->priv;
   GstClockTime current_timeout;
   GstClockTime local_avg;
   gdouble r_squared;
@@ -261,28 +196,28 @@ gst_net_client_clock_observe_times (GstNetClientClock * self,
 
   rtt = GST_CLOCK_DIFF (local_1, local_2);
 
-  if ((self->priv->roundtrip_limit > 0) && (rtt > self->priv->roundtrip_limit)) {
+  if ((self->roundtrip_limit > 0) && (rtt > self->roundtrip_limit)) {
     GST_LOG_OBJECT (self,
         "Dropping observation: RTT %" GST_TIME_FORMAT " > limit %"
         GST_TIME_FORMAT, GST_TIME_ARGS (rtt),
-        GST_TIME_ARGS (self->priv->roundtrip_limit));
+        GST_TIME_ARGS (self->roundtrip_limit));
     goto bogus_observation;
   }
 
   /* Track an average round trip time, for a bit of smoothing */
   /* Always update before discarding a sample, so genuine changes in
    * the network get picked up, eventually */
-  if (priv->rtt_avg == GST_CLOCK_TIME_NONE)
-    priv->rtt_avg = rtt;
-  else if (rtt < priv->rtt_avg) /* Shorter RTTs carry more weight than longer */
-    priv->rtt_avg = (3 * priv->rtt_avg + rtt) / 4;
+  if (self->rtt_avg == GST_CLOCK_TIME_NONE)
+    self->rtt_avg = rtt;
+  else if (rtt < self->rtt_avg) /* Shorter RTTs carry more weight than longer */
+    self->rtt_avg = (3 * self->rtt_avg + rtt) / 4;
   else
-    priv->rtt_avg = (7 * priv->rtt_avg + rtt) / 8;
+    self->rtt_avg = (7 * self->rtt_avg + rtt) / 8;
 
-  if (rtt > 2 * priv->rtt_avg) {
+  if (rtt > 2 * self->rtt_avg) {
     GST_LOG_OBJECT (self,
         "Dropping observation, long RTT %" GST_TIME_FORMAT " > 2 * avg %"
-        GST_TIME_FORMAT, GST_TIME_ARGS (rtt), GST_TIME_ARGS (priv->rtt_avg));
+        GST_TIME_FORMAT, GST_TIME_ARGS (rtt), GST_TIME_ARGS (self->rtt_avg));
     goto bogus_observation;
   }
 
@@ -304,22 +239,22 @@ gst_net_client_clock_observe_times (GstNetClientClock * self,
   }
 
   GST_INFO ("next timeout: %" GST_TIME_FORMAT, GST_TIME_ARGS (current_timeout));
-  self->priv->timeout_expiration = gst_util_get_timestamp () + current_timeout;
+  self->timeout_expiration = gst_util_get_timestamp () + current_timeout;
 
   return;
 
 bogus_observation:
   /* Schedule a new packet again soon */
-  self->priv->timeout_expiration = gst_util_get_timestamp () + (GST_SECOND / 4);
+  self->timeout_expiration = gst_util_get_timestamp () + (GST_SECOND / 4);
   return;
 }
 
 static gpointer
-gst_net_client_clock_thread (gpointer data)
+gst_net_client_internal_clock_thread (gpointer data)
 {
-  GstNetClientClock *self = data;
+  GstNetClientInternalClock *self = data;
   GstNetTimePacket *packet;
-  GSocket *socket = self->priv->socket;
+  GSocket *socket = self->socket;
   GError *err = NULL;
   GstClock *clock = data;
 
@@ -328,8 +263,8 @@ gst_net_client_clock_thread (gpointer data)
   g_socket_set_blocking (socket, TRUE);
   g_socket_set_timeout (socket, 0);
 
-  while (!g_cancellable_is_cancelled (self->priv->cancel)) {
-    GstClockTime expiration_time = self->priv->timeout_expiration;
+  while (!g_cancellable_is_cancelled (self->cancel)) {
+    GstClockTime expiration_time = self->timeout_expiration;
     GstClockTime now = gst_util_get_timestamp ();
     gint64 socket_timeout;
 
@@ -342,7 +277,7 @@ gst_net_client_clock_thread (gpointer data)
     GST_TRACE_OBJECT (self, "timeout: %" G_GINT64_FORMAT "us", socket_timeout);
 
     if (!g_socket_condition_timed_wait (socket, G_IO_IN, socket_timeout,
-            self->priv->cancel, &err)) {
+            self->cancel, &err)) {
       /* cancelled, timeout or error */
       if (err->code == G_IO_ERROR_CANCELLED) {
         GST_INFO_OBJECT (self, "cancelled");
@@ -360,13 +295,13 @@ gst_net_client_clock_thread (gpointer data)
             "sending packet, local time = %" GST_TIME_FORMAT,
             GST_TIME_ARGS (packet->local_time));
 
-        gst_net_time_packet_send (packet, self->priv->socket,
-            self->priv->servaddr, NULL);
+        gst_net_time_packet_send (packet, self->socket,
+            self->servaddr, NULL);
 
         g_free (packet);
 
         /* reset timeout (but are expecting a response sooner anyway) */
-        self->priv->timeout_expiration =
+        self->timeout_expiration =
             gst_util_get_timestamp () + gst_clock_get_timeout (clock);
       } else {
         GST_DEBUG_OBJECT (self, "socket error: %s", err->message);
@@ -392,7 +327,7 @@ gst_net_client_clock_thread (gpointer data)
             GST_TIME_ARGS (new_local));
 
         /* observe_times will reset the timeout */
-        gst_net_client_clock_observe_times (self, packet->local_time,
+        gst_net_client_internal_clock_observe_times (self, packet->local_time,
             packet->remote_time, new_local);
 
         g_free (packet);
@@ -408,7 +343,7 @@ gst_net_client_clock_thread (gpointer data)
 }
 
 static gboolean
-gst_net_client_clock_start (GstNetClientClock * self)
+gst_net_client_internal_clock_start (GstNetClientInternalClock * self)
 {
   GSocketAddress *servaddr;
   GSocketAddress *myaddr;
@@ -418,23 +353,23 @@ gst_net_client_clock_start (GstNetClientClock * self)
   GError *error = NULL;
   GSocketFamily family;
 
-  g_return_val_if_fail (self->priv->address != NULL, FALSE);
-  g_return_val_if_fail (self->priv->servaddr == NULL, FALSE);
+  g_return_val_if_fail (self->address != NULL, FALSE);
+  g_return_val_if_fail (self->servaddr == NULL, FALSE);
 
   /* create target address */
-  inetaddr = g_inet_address_new_from_string (self->priv->address);
+  inetaddr = g_inet_address_new_from_string (self->address);
   if (inetaddr == NULL)
     goto bad_address;
 
   family = g_inet_address_get_family (inetaddr);
 
-  servaddr = g_inet_socket_address_new (inetaddr, self->priv->port);
+  servaddr = g_inet_socket_address_new (inetaddr, self->port);
   g_object_unref (inetaddr);
 
   g_assert (servaddr != NULL);
 
-  GST_DEBUG_OBJECT (self, "will communicate with %s:%d", self->priv->address,
-      self->priv->port);
+  GST_DEBUG_OBJECT (self, "will communicate with %s:%d", self->address,
+      self->port);
 
   socket = g_socket_new (family, G_SOCKET_TYPE_DATAGRAM,
       G_SOCKET_PROTOCOL_UDP, &error);
@@ -463,12 +398,12 @@ gst_net_client_clock_start (GstNetClientClock * self)
 
   g_object_unref (myaddr);
 
-  self->priv->cancel = g_cancellable_new ();
-  self->priv->socket = socket;
-  self->priv->servaddr = G_SOCKET_ADDRESS (servaddr);
+  self->cancel = g_cancellable_new ();
+  self->socket = socket;
+  self->servaddr = G_SOCKET_ADDRESS (servaddr);
 
-  self->priv->thread = g_thread_try_new ("GstNetClientClock",
-      gst_net_client_clock_thread, self, &error);
+  self->thread = g_thread_try_new ("GstNetClientClock",
+      gst_net_client_internal_clock_thread, self, &error);
 
   if (error != NULL)
     goto no_thread;
@@ -499,45 +434,386 @@ getsockname_error:
 bad_address:
   {
     GST_ERROR_OBJECT (self, "inet_address_new_from_string('%s') failed",
-        self->priv->address);
+        self->address);
     return FALSE;
   }
 no_thread:
   {
     GST_ERROR_OBJECT (self, "could not create thread: %s", error->message);
-    g_object_unref (self->priv->servaddr);
-    self->priv->servaddr = NULL;
-    g_object_unref (self->priv->socket);
-    self->priv->socket = NULL;
+    g_object_unref (self->servaddr);
+    self->servaddr = NULL;
+    g_object_unref (self->socket);
+    self->socket = NULL;
     g_error_free (error);
     return FALSE;
   }
 }
 
 static void
-gst_net_client_clock_stop (GstNetClientClock * self)
+gst_net_client_internal_clock_stop (GstNetClientInternalClock * self)
 {
-  if (self->priv->thread == NULL)
+  if (self->thread == NULL)
     return;
 
   GST_INFO_OBJECT (self, "stopping...");
-  g_cancellable_cancel (self->priv->cancel);
+  g_cancellable_cancel (self->cancel);
 
-  g_thread_join (self->priv->thread);
-  self->priv->thread = NULL;
+  g_thread_join (self->thread);
+  self->thread = NULL;
 
-  g_object_unref (self->priv->cancel);
-  self->priv->cancel = NULL;
+  g_object_unref (self->cancel);
+  self->cancel = NULL;
 
-  g_object_unref (self->priv->servaddr);
-  self->priv->servaddr = NULL;
+  g_object_unref (self->servaddr);
+  self->servaddr = NULL;
 
-  g_object_unref (self->priv->socket);
-  self->priv->socket = NULL;
+  g_object_unref (self->socket);
+  self->socket = NULL;
 
   GST_INFO_OBJECT (self, "stopped");
 }
 
+
+enum
+{
+  PROP_0,
+  PROP_ADDRESS,
+  PROP_PORT,
+  PROP_ROUNDTRIP_LIMIT,
+  PROP_TIMEOUT,
+  PROP_WINDOW_SIZE,
+  PROP_WINDOW_THRESHOLD
+};
+
+#define GST_NET_CLIENT_CLOCK_GET_PRIVATE(obj)  \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), GST_TYPE_NET_CLIENT_CLOCK, GstNetClientClockPrivate))
+
+struct _GstNetClientClockPrivate
+{
+  /* the shared clock doing the actual work, NULL until started */
+  GstNetClientInternalClock *internal_clock;
+
+  GstClockTime roundtrip_limit;
+  GstClockTime timeout;
+  gint window_size;
+  gint window_threshold;
+
+  gchar *address;
+  gint port;
+};
+
+#define _do_init \
+  GST_DEBUG_CATEGORY_INIT (ncc_debug, "netclock", 0, "Network client clock");
+#define gst_net_client_clock_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (GstNetClientClock, gst_net_client_clock,
+    GST_TYPE_SYSTEM_CLOCK, _do_init);
+
+static void gst_net_client_clock_finalize (GObject * object);
+static void gst_net_client_clock_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_net_client_clock_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
+
+static GstClockTime gst_net_client_clock_get_internal_time (GstClock * clock);
+
+static void gst_net_client_clock_stop (GstNetClientClock * self);
+
+static void
+gst_net_client_clock_class_init (GstNetClientClockClass * klass)
+{
+  GObjectClass *gobject_class;
+  GstClockClass *clock_class;
+
+  gobject_class = G_OBJECT_CLASS (klass);
+  clock_class = GST_CLOCK_CLASS (klass);
+
+  g_type_class_add_private (klass, sizeof (GstNetClientClockPrivate));
+
+  gobject_class->finalize = gst_net_client_clock_finalize;
+  gobject_class->get_property = gst_net_client_clock_get_property;
+  gobject_class->set_property = gst_net_client_clock_set_property;
+
+  clock_class->get_internal_time = gst_net_client_clock_get_internal_time;
+  g_object_class_install_property (gobject_class, PROP_ADDRESS,
+      g_param_spec_string ("address", "address",
+          "The IP address of the machine providing a time server",
+          DEFAULT_ADDRESS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_PORT,
+      g_param_spec_int ("port", "port",
+          "The port on which the remote server is listening", 0, G_MAXUINT16,
+          DEFAULT_PORT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstNetClientClock::round-trip-limit:
+   *
+   * Maximum allowed round-trip for packets. If this property is set to a nonzero
+   * value, all packets with a round-trip interval larger than this limit will be
+   * ignored. This is useful for networks with severe and fluctuating transport
+   * delays. Filtering out these packets increases stability of the synchronization.
+   * On the other hand, the lower the limit, the higher the amount of filtered
+   * packets. Empirical tests are typically necessary to estimate a good value
+   * for the limit.
+   * If the property is set to zero, the limit is disabled.
+   *
+   * Since: 1.4
+   */
+  g_object_class_install_property (gobject_class, PROP_ROUNDTRIP_LIMIT,
+      g_param_spec_uint64 ("round-trip-limit", "round-trip limit",
+          "Maximum tolerable round-trip interval for packets, in nanoseconds "
+          "(0 = no limit)", 0, G_MAXUINT64, DEFAULT_ROUNDTRIP_LIMIT,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /* these are applied to and read from the shared clock */
+  g_object_class_override_property (gobject_class, PROP_TIMEOUT, "timeout");
+  g_object_class_override_property (gobject_class, PROP_WINDOW_SIZE,
+      "window-size");
+  g_object_class_override_property (gobject_class, PROP_WINDOW_THRESHOLD,
+      "window-threshold");
+}
+
+static void
+gst_net_client_clock_init (GstNetClientClock * self)
+{
+  GstClock *clock = GST_CLOCK_CAST (self);
+  GstNetClientClockPrivate *priv;
+
+  self->priv = priv = GST_NET_CLIENT_CLOCK_GET_PRIVATE (self);
+
+  priv->port = DEFAULT_PORT;
+  priv->address = g_strdup (DEFAULT_ADDRESS);
+
+  gst_clock_set_timeout (clock, DEFAULT_TIMEOUT);
+
+  priv->internal_clock = NULL;
+  priv->roundtrip_limit = DEFAULT_ROUNDTRIP_LIMIT;
+  priv->timeout = DEFAULT_TIMEOUT;
+  priv->window_size = DEFAULT_WINDOW_SIZE;
+  priv->window_threshold = DEFAULT_WINDOW_THRESHOLD;
+}
+
+static void
+gst_net_client_clock_finalize (GObject * object)
+{
+  GstNetClientClock *self = GST_NET_CLIENT_CLOCK (object);
+
+  if (self->priv->internal_clock) {
+    gst_net_client_clock_stop (self);
+  }
+
+  g_free (self->priv->address);
+  self->priv->address = NULL;
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_net_client_clock_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstNetClientClock *self = GST_NET_CLIENT_CLOCK (object);
+
+  switch (prop_id) {
+    case PROP_ADDRESS:
+      g_free (self->priv->address);
+      self->priv->address = g_value_dup_string (value);
+      if (self->priv->address == NULL)
+        self->priv->address = g_strdup (DEFAULT_ADDRESS);
+      break;
+    case PROP_PORT:
+      self->priv->port = g_value_get_int (value);
+      break;
+    case PROP_ROUNDTRIP_LIMIT:
+      self->priv->roundtrip_limit = g_value_get_uint64 (value);
+      if (self->priv->internal_clock)
+        self->priv->internal_clock->roundtrip_limit =
+            self->priv->roundtrip_limit;
+      break;
+    case PROP_TIMEOUT:
+      self->priv->timeout = g_value_get_uint64 (value);
+      gst_clock_set_timeout (GST_CLOCK_CAST (self), self->priv->timeout);
+      if (self->priv->internal_clock)
+        gst_clock_set_timeout (GST_CLOCK_CAST (self->priv->internal_clock),
+            self->priv->timeout);
+      break;
+    case PROP_WINDOW_SIZE:
+      self->priv->window_size = g_value_get_int (value);
+      if (self->priv->internal_clock)
+        g_object_set (self->priv->internal_clock, "window-size",
+            self->priv->window_size, NULL);
+      break;
+    case PROP_WINDOW_THRESHOLD:
+      self->priv->window_threshold = g_value_get_int (value);
+      if (self->priv->internal_clock)
+        g_object_set (self->priv->internal_clock, "window-threshold",
+            self->priv->window_threshold, NULL);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_net_client_clock_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstNetClientClock *self = GST_NET_CLIENT_CLOCK (object);
+
+  switch (prop_id) {
+    case PROP_ADDRESS:
+      g_value_set_string (value, self->priv->address);
+      break;
+    case PROP_PORT:
+      g_value_set_int (value, self->priv->port);
+      break;
+    case PROP_ROUNDTRIP_LIMIT:
+      if (self->priv->internal_clock)
+        g_value_set_uint64 (value, self->priv->internal_clock->roundtrip_limit);
+      else
+        g_value_set_uint64 (value, self->priv->roundtrip_limit);
+      break;
+    case PROP_TIMEOUT:
+      if (self->priv->internal_clock) {
+        GstClock *clock = GST_CLOCK_CAST (self->priv->internal_clock);
+
+        g_value_set_uint64 (value, gst_clock_get_timeout (clock));
+      } else {
+        g_value_set_uint64 (value, self->priv->timeout);
+      }
+      break;
+    case PROP_WINDOW_SIZE:
+    case PROP_WINDOW_THRESHOLD:
+      if (self->priv->internal_clock)
+        g_object_get_property (G_OBJECT (self->priv->internal_clock),
+            g_param_spec_get_name (pspec), value);
+      else if (prop_id == PROP_WINDOW_SIZE)
+        g_value_set_int (value, self->priv->window_size);
+      else
+        g_value_set_int (value, self->priv->window_threshold);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static GstClockTime
+gst_net_client_clock_get_internal_time (GstClock * clock)
+{
+  GstNetClientClock *self = GST_NET_CLIENT_CLOCK (clock);
+
+  /* the shared clock is calibrated against the remote time already */
+  if (self->priv->internal_clock)
+    return gst_clock_get_time (GST_CLOCK_CAST (self->priv->internal_clock));
+
+  return GST_CLOCK_CLASS (parent_class)->get_internal_time (clock);
+}
+
+static GstNetClientInternalClock *
+gst_net_client_clock_find_internal_clock (const gchar * address, gint port)
+{
+  GList *walk;
+
+  for (walk = clocks; walk; walk = g_list_next (walk)) {
+    GstNetClientInternalClock *internal_clock = walk->data;
+
+    if (internal_clock->port == port
+        && strcmp (internal_clock->address, address) == 0)
+      return internal_clock;
+  }
+  return NULL;
+}
+
+static gboolean
+gst_net_client_clock_start (GstNetClientClock * self, GstClockTime base_time)
+{
+  GstNetClientInternalClock *internal_clock;
+  GstClock *clock;
+
+  g_return_val_if_fail (self->priv->internal_clock == NULL, FALSE);
+
+  G_LOCK (clocks_lock);
+  internal_clock =
+      gst_net_client_clock_find_internal_clock (self->priv->address,
+      self->priv->port);
+
+  if (internal_clock == NULL) {
+    GstClockTime internal;
+
+    internal_clock = g_object_new (GST_TYPE_NET_CLIENT_INTERNAL_CLOCK, NULL);
+    internal_clock->address = g_strdup (self->priv->address);
+    internal_clock->port = self->priv->port;
+    internal_clock->roundtrip_limit = self->priv->roundtrip_limit;
+    g_object_set (internal_clock, "timeout", self->priv->timeout,
+        "window-size", self->priv->window_size,
+        "window-threshold", self->priv->window_threshold, NULL);
+
+    clock = GST_CLOCK_CAST (internal_clock);
+
+    /* gst_clock_get_time() values are guaranteed to be increasing. because no
+     * one has called get_time on this clock yet we are free to adjust to any
+     * value without worrying about worrying about MAX() issues with the
+     * clock's internal time.
+     */
+
+    /* update our internal time so get_time() give something around base_time.
+       assume that the rate is 1 in the beginning. */
+    internal = gst_clock_get_internal_time (clock);
+    gst_clock_set_calibration (clock, internal, base_time, 1, 1);
+
+    {
+      GstClockTime now = gst_clock_get_time (clock);
+
+      if (GST_CLOCK_DIFF (now, base_time) > 0 ||
+          GST_CLOCK_DIFF (now, base_time + GST_SECOND) < 0) {
+        g_warning ("unable to set the base time, expect sync problems!");
+      }
+    }
+
+    if (!gst_net_client_internal_clock_start (internal_clock))
+      goto failed_start;
+
+    clocks = g_list_prepend (clocks, internal_clock);
+  } else {
+    GST_DEBUG_OBJECT (self, "sharing clock %" GST_PTR_FORMAT
+        " for %s:%d", internal_clock, self->priv->address, self->priv->port);
+    gst_object_ref (internal_clock);
+  }
+  internal_clock->users++;
+  G_UNLOCK (clocks_lock);
+
+  self->priv->internal_clock = internal_clock;
+
+  return TRUE;
+
+  /* ERRORS */
+failed_start:
+  {
+    /* already printed a nice error */
+    G_UNLOCK (clocks_lock);
+    gst_object_unref (internal_clock);
+    return FALSE;
+  }
+}
+
+static void
+gst_net_client_clock_stop (GstNetClientClock * self)
+{
+  GstNetClientInternalClock *internal_clock = self->priv->internal_clock;
+
+  if (internal_clock == NULL)
+    return;
+
+  G_LOCK (clocks_lock);
+  /* the last user stops the polling */
+  if (--internal_clock->users == 0)
+    clocks = g_list_remove (clocks, internal_clock);
+  G_UNLOCK (clocks_lock);
+
+  self->priv->internal_clock = NULL;
+  gst_object_unref (internal_clock);
+}
+
 /**
  * gst_net_client_clock_new:
  * @name: a name for the clock
@@ -549,6 +825,9 @@ gst_net_client_clock_stop (GstNetClientClock * self)
  * provided by the #GstNetTimeProvider on @remote_address and 
  * @remote_port.
  *
+ * When another #GstNetClientClock for the same time provider exists already,
+ * the new clock shares its synchronization and @base_time is not used.
+ *
  * Returns: a new #GstClock that receives a time from the remote
  * clock.
  */
@@ -558,7 +837,6 @@ gst_net_client_clock_new (const gchar * name, const gchar * remote_address,
 {
   /* FIXME: gst_net_client_clock_new() should be a thin wrapper for g_object_new() */
   GstNetClientClock *ret;
-  GstClockTime internal;
 
   g_return_val_if_fail (remote_address != NULL, NULL);
   g_return_val_if_fail (remote_port > 0, NULL);
@@ -568,27 +846,7 @@ gst_net_client_clock_new (const gchar * name, const gchar * remote_address,
   ret = g_object_new (GST_TYPE_NET_CLIENT_CLOCK, "address", remote_address,
       "port", remote_port, NULL);
 
-  /* gst_clock_get_time() values are guaranteed to be increasing. because no one
-   * has called get_time on this clock yet we are free to adjust to any value
-   * without worrying about worrying about MAX() issues with the clock's
-   * internal time.
-   */
-
-  /* update our internal time so get_time() give something around base_time.
-     assume that the rate is 1 in the beginning. */
-  internal = gst_clock_get_internal_time (GST_CLOCK (ret));
-  gst_clock_set_calibration (GST_CLOCK (ret), internal, base_time, 1, 1);
-
-  {
-    GstClockTime now = gst_clock_get_time (GST_CLOCK (ret));
-
-    if (GST_CLOCK_DIFF (now, base_time) > 0 ||
-        GST_CLOCK_DIFF (now, base_time + GST_SECOND) < 0) {
-      g_warning ("unable to set the base time, expect sync problems!");
-    }
-  }
-
-  if (!gst_net_client_clock_start (ret))
+  if (!gst_net_client_clock_start (ret, base_time))
     goto failed_start;
 
   /* all systems go, cap'n */
@@ -31,20 +31,46 @@
  * query the exposed clock over the network for its values.
  *
  * The #GstNetTimeProvider typically wraps the clock used by a #GstPipeline.
+ *
+ * Pending requests are received and answered in batches of up to
+ * #GstNetTimeProvider:batch-size packets, using recvmmsg() and sendmmsg()
+ * where available. A provider that serves many clients can additionally
+ * spread the load over several threads with the
+ * #GstNetTimeProvider:threads property. Both properties can only be set
+ * when the provider is constructed, for example with
+ * |[
+ * provider = g_initable_new (GST_TYPE_NET_TIME_PROVIDER, NULL, &amp;error,
+ *     "clock", clock, "port", 5637, "threads", 4, NULL);
+ * ]|
  */
 
 #ifdef HAVE_CONFIG_H
 #include "config.h"
 #endif
 
+#if defined (HAVE_RECVMMSG) && defined (HAVE_SENDMMSG)
+#define HAVE_MMSG 1
+#define _GNU_SOURCE 1
+#endif
+
 #include "gstnettimeprovider.h"
 #include "gstnettimepacket.h"
 
+#ifdef HAVE_MMSG
+#include <sys/socket.h>
+#include <errno.h>
+#endif
+
 GST_DEBUG_CATEGORY_STATIC (ntp_debug);
 #define GST_CAT_DEFAULT (ntp_debug)
 
 #define DEFAULT_ADDRESS         "0.0.0.0"
 #define DEFAULT_PORT            5637
+#define DEFAULT_THREADS         1
+#define DEFAULT_BATCH_SIZE      32
+
+#define MAX_THREADS             64
+#define MAX_BATCH_SIZE          1024
 
 #define IS_ACTIVE(self) (g_atomic_int_get (&((self)->priv->active)))
 
@@ -54,7 +80,9 @@ enum
   PROP_PORT,
   PROP_ADDRESS,
   PROP_CLOCK,
-  PROP_ACTIVE
+  PROP_ACTIVE,
+  PROP_THREADS,
+  PROP_BATCH_SIZE
 };
 
 #define GST_NET_TIME_PROVIDER_GET_PRIVATE(obj)  \
@@ -65,7 +93,9 @@ struct _GstNetTimeProviderPrivate
   gchar *address;
   int port;
 
-  GThread *thread;
+  guint n_threads;
+  guint batch_size;
+  GThread **threads;
 
   GstClock *clock;
 
@@ -75,7 +105,23 @@ struct _GstNetTimeProviderPrivate
   GCancellable *cancel;
 };
 
-static gboolean gst_net_time_provider_start (GstNetTimeProvider * bself);
+/* the storage for one batch of requests, every serving thread has its own
+ * and reuses it for all the batches it handles */
+typedef struct
+{
+  gint size;
+  guint8 *buffers;
+#ifdef HAVE_MMSG
+  struct mmsghdr *msgs;
+  struct iovec *iovs;
+  struct sockaddr_storage *addrs;
+#else
+  GSocketAddress **addrs;
+#endif
+} GstNetTimeProviderBatch;
+
+static gboolean gst_net_time_provider_start (GstNetTimeProvider * bself,
+    GError ** error);
 static void gst_net_time_provider_stop (GstNetTimeProvider * bself);
 
 static gpointer gst_net_time_provider_thread (gpointer data);
@@ -86,8 +132,11 @@ static void gst_net_time_provider_set_property (GObject * object, guint prop_id,
 static void gst_net_time_provider_get_property (GObject * object, guint prop_id,
     GValue * value, GParamSpec * pspec);
 
+static void gst_net_time_provider_initable_iface_init (gpointer g_iface);
+
 #define _do_init \
-  GST_DEBUG_CATEGORY_INIT (ntp_debug, "nettime", 0, "Network time provider");
+  GST_DEBUG_CATEGORY_INIT (ntp_debug, "nettime", 0, "Network time provider"); \
+  G_IMPLEMENT_INTERFACE (G_TYPE_INITABLE, gst_net_time_provider_initable_iface_init);
 
 #define gst_net_time_provider_parent_class parent_class
 G_DEFINE_TYPE_WITH_CODE (GstNetTimeProvider, gst_net_time_provider,
@@ -124,6 +173,33 @@ gst_net_time_provider_class_init (GstNetTimeProviderClass * klass)
       g_param_spec_boolean ("active", "Active",
           "TRUE if the clock will respond to queries over the network", TRUE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstNetTimeProvider:threads:
+   *
+   * The number of threads that serve the requests. All threads share the
+   * same socket, more than one thread is only useful when a lot of clients
+   * query the provider.
+   *
+   * Since: 1.6
+   */
+  g_object_class_install_property (gobject_class, PROP_THREADS,
+      g_param_spec_uint ("threads", "Threads",
+          "The number of threads serving requests", 1, MAX_THREADS,
+          DEFAULT_THREADS, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+          G_PARAM_STATIC_STRINGS));
+  /**
+   * GstNetTimeProvider:batch-size:
+   *
+   * The maximum number of requests that a thread receives and answers in
+   * one go.
+   *
+   * Since: 1.6
+   */
+  g_object_class_install_property (gobject_class, PROP_BATCH_SIZE,
+      g_param_spec_uint ("batch-size", "Batch size",
+          "The maximum number of requests handled at once", 1, MAX_BATCH_SIZE,
+          DEFAULT_BATCH_SIZE, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+          G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -133,7 +209,9 @@ gst_net_time_provider_init (GstNetTimeProvider * self)
 
   self->priv->port = DEFAULT_PORT;
   self->priv->address = g_strdup (DEFAULT_ADDRESS);
-  self->priv->thread = NULL;
+  self->priv->n_threads = DEFAULT_THREADS;
+  self->priv->batch_size = DEFAULT_BATCH_SIZE;
+  self->priv->threads = NULL;
   self->priv->active = TRUE;
 }
 
@@ -142,9 +220,9 @@ gst_net_time_provider_finalize (GObject * object)
 {
   GstNetTimeProvider *self = GST_NET_TIME_PROVIDER (object);
 
-  if (self->priv->thread) {
+  if (self->priv->threads) {
     gst_net_time_provider_stop (self);
-    g_assert (self->priv->thread == NULL);
+    g_assert (self->priv->threads == NULL);
   }
 
   g_free (self->priv->address);
@@ -157,20 +235,185 @@ gst_net_time_provider_finalize (GObject * object)
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
+static GstNetTimeProviderBatch *
+gst_net_time_provider_batch_new (guint size)
+{
+  GstNetTimeProviderBatch *batch;
+#ifdef HAVE_MMSG
+  guint i;
+#endif
+
+  batch = g_new0 (GstNetTimeProviderBatch, 1);
+  batch->size = size;
+  batch->buffers = g_new0 (guint8, size * GST_NET_TIME_PACKET_SIZE);
+#ifdef HAVE_MMSG
+  batch->msgs = g_new0 (struct mmsghdr, size);
+  batch->iovs = g_new0 (struct iovec, size);
+  batch->addrs = g_new0 (struct sockaddr_storage, size);
+
+  /* the replies are sent from the storage the requests were received in and
+   * back to the address they came from */
+  for (i = 0; i < size; i++) {
+    batch->iovs[i].iov_base = batch->buffers + i * GST_NET_TIME_PACKET_SIZE;
+    batch->iovs[i].iov_len = GST_NET_TIME_PACKET_SIZE;
+    batch->msgs[i].msg_hdr.msg_iov = &batch->iovs[i];
+    batch->msgs[i].msg_hdr.msg_iovlen = 1;
+    batch->msgs[i].msg_hdr.msg_name = &batch->addrs[i];
+  }
+#else
+  batch->addrs = g_new0 (GSocketAddress *, size);
+#endif
+
+  return batch;
+}
+
+static void
+gst_net_time_provider_batch_free (GstNetTimeProviderBatch * batch)
+{
+#ifdef HAVE_MMSG
+  g_free (batch->msgs);
+  g_free (batch->iovs);
+#endif
+  g_free (batch->addrs);
+  g_free (batch->buffers);
+  g_free (batch);
+}
+
+#ifdef HAVE_MMSG
+static void
+gst_net_time_provider_send_many (gint fd, struct mmsghdr *msgs, guint n)
+{
+  gint ret;
+
+  while (n > 0) {
+    ret = sendmmsg (fd, msgs, n, 0);
+    if (ret <= 0) {
+      /* ignore errors, the clients will ask again */
+      GST_DEBUG ("send error: %s", g_strerror (errno));
+      break;
+    }
+    msgs += ret;
+    n -= ret;
+  }
+}
+
+/* receives and answers up to one batch of pending requests. Returns the
+ * number of packets received or -1 on error. */
+static gint
+gst_net_time_provider_serve (GstNetTimeProvider * self, GSocket * socket,
+    GstNetTimeProviderBatch * batch)
+{
+  gint fd = g_socket_get_fd (socket);
+  GstClockTime now;
+  guint8 *buffer;
+  gint i, n, first;
+
+  for (i = 0; i < batch->size; i++)
+    batch->msgs[i].msg_hdr.msg_namelen = sizeof (struct sockaddr_storage);
+
+  n = recvmmsg (fd, batch->msgs, batch->size, MSG_DONTWAIT, NULL);
+  if (n < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+      return 0;
+
+    GST_DEBUG_OBJECT (self, "receive error: %s", g_strerror (errno));
+    return -1;
+  }
+
+  /* take the time right after receiving, all packets of the batch arrived
+   * by now */
+  now = gst_clock_get_time (self->priv->clock);
+
+  if (!IS_ACTIVE (self))
+    return n;
+
+  /* answer the runs of complete packets, skipping short ones */
+  for (i = 0, first = 0; i <= n; i++) {
+    if (i < n && batch->msgs[i].msg_len >= GST_NET_TIME_PACKET_SIZE) {
+      buffer = batch->buffers + i * GST_NET_TIME_PACKET_SIZE;
+      GST_WRITE_UINT64_BE (buffer + sizeof (GstClockTime), now);
+      continue;
+    }
+    if (i < n)
+      GST_DEBUG_OBJECT (self, "someone sent us a short packet (%u < %d)",
+          batch->msgs[i].msg_len, GST_NET_TIME_PACKET_SIZE);
+
+    gst_net_time_provider_send_many (fd, &batch->msgs[first], i - first);
+    first = i + 1;
+  }
+
+  return n;
+}
+#else
+static gint
+gst_net_time_provider_serve (GstNetTimeProvider * self, GSocket * socket,
+    GstNetTimeProviderBatch * batch)
+{
+  GError *err = NULL;
+  guint8 *buffer;
+  gssize ret;
+  gint i, n, received;
+
+  for (n = 0, received = 0; n < batch->size; received++) {
+    buffer = batch->buffers + n * GST_NET_TIME_PACKET_SIZE;
+
+    ret = g_socket_receive_from (socket, &batch->addrs[n], (gchar *) buffer,
+        GST_NET_TIME_PACKET_SIZE, NULL, &err);
+
+    if (ret < 0) {
+      if (err->code != G_IO_ERROR_WOULD_BLOCK) {
+        GST_DEBUG_OBJECT (self, "receive error: %s", err->message);
+        if (received == 0)
+          received = -1;
+      }
+      g_error_free (err);
+      break;
+    }
+
+    /* take the time as close to the reception of each packet as possible */
+    GST_WRITE_UINT64_BE (buffer + sizeof (GstClockTime),
+        gst_clock_get_time (self->priv->clock));
+
+    if (ret < GST_NET_TIME_PACKET_SIZE) {
+      GST_DEBUG_OBJECT (self, "someone sent us a short packet (%"
+          G_GSSIZE_FORMAT " < %d)", ret, GST_NET_TIME_PACKET_SIZE);
+      g_object_unref (batch->addrs[n]);
+      batch->addrs[n] = NULL;
+      continue;
+    }
+    n++;
+  }
+
+  for (i = 0; i < n; i++) {
+    if (IS_ACTIVE (self)) {
+      buffer = batch->buffers + i * GST_NET_TIME_PACKET_SIZE;
+      /* ignore errors */
+      g_socket_send_to (socket, batch->addrs[i], (const gchar *) buffer,
+          GST_NET_TIME_PACKET_SIZE, NULL, NULL);
+    }
+    g_object_unref (batch->addrs[i]);
+    batch->addrs[i] = NULL;
+  }
+
+  return received;
+}
+#endif
+
 static gpointer
 gst_net_time_provider_thread (gpointer data)
 {
   GstNetTimeProvider *self = data;
   GCancellable *cancel = self->priv->cancel;
   GSocket *socket = self->priv->socket;
-  GstNetTimePacket *packet;
+  GstNetTimeProviderBatch *batch;
   GError *err = NULL;
+  gint n;
 
   GST_INFO_OBJECT (self, "time provider thread is running");
 
-  while (TRUE) {
-    GSocketAddress *sender_addr = NULL;
+  batch = gst_net_time_provider_batch_new (self->priv->batch_size);
 
+  while (TRUE) {
     GST_LOG_OBJECT (self, "waiting on socket");
     if (!g_socket_condition_wait (socket, G_IO_IN, cancel, &err)) {
       GST_INFO_OBJECT (self, "socket error: %s", err->message);
@@ -185,29 +428,18 @@ gst_net_time_provider_thread (gpointer data)
       continue;
     }
 
-    /* got data in */
-    packet = gst_net_time_packet_receive (socket, &sender_addr, &err);
+    /* got data in, keep serving while full batches are pending. Other
+     * threads might have taken the data already, then nothing is received */
+    do {
+      n = gst_net_time_provider_serve (self, socket, batch);
+    } while (n == batch->size);
 
-    if (err != NULL) {
-      GST_DEBUG_OBJECT (self, "receive error: %s", err->message);
+    if (n < 0)
       g_usleep (G_USEC_PER_SEC / 10);
-      g_error_free (err);
-      err = NULL;
-      continue;
-    }
-
-    if (IS_ACTIVE (self)) {
-      /* do what we were asked to and send the packet back */
-      packet->remote_time = gst_clock_get_time (self->priv->clock);
-
-      /* ignore errors */
-      gst_net_time_packet_send (packet, socket, sender_addr, NULL);
-      g_object_unref (sender_addr);
-      g_free (packet);
-    }
   }
 
   g_error_free (err);
+  gst_net_time_provider_batch_free (batch);
 
   GST_INFO_OBJECT (self, "time provider thread is stopping");
   return NULL;
@@ -238,6 +470,12 @@ gst_net_time_provider_set_property (GObject * object, guint prop_id,
     case PROP_ACTIVE:
       g_atomic_int_set (&self->priv->active, g_value_get_boolean (value));
       break;
+    case PROP_THREADS:
+      self->priv->n_threads = g_value_get_uint (value);
+      break;
+    case PROP_BATCH_SIZE:
+      self->priv->batch_size = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -263,6 +501,12 @@ gst_net_time_provider_get_property (GObject * object, guint prop_id,
     case PROP_ACTIVE:
       g_value_set_boolean (value, IS_ACTIVE (self));
       break;
+    case PROP_THREADS:
+      g_value_set_uint (value, self->priv->n_threads);
+      break;
+    case PROP_BATCH_SIZE:
+      g_value_set_uint (value, self->priv->batch_size);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -270,7 +514,7 @@ gst_net_time_provider_get_property (GObject * object, guint prop_id,
 }
 
 static gboolean
-gst_net_time_provider_start (GstNetTimeProvider * self)
+gst_net_time_provider_start (GstNetTimeProvider * self, GError ** error)
 {
   GSocketAddress *socket_addr, *bound_addr;
   GInetAddress *inet_addr;
@@ -278,6 +522,7 @@ gst_net_time_provider_start (GstNetTimeProvider * self)
   GError *err = NULL;
   int port;
   gchar *address;
+  guint i;
 
   if (self->priv->address) {
     inet_addr = g_inet_address_new_from_string (self->priv->address);
@@ -326,14 +571,23 @@ gst_net_time_provider_start (GstNetTimeProvider * self)
       self->priv->address, port);
   g_object_unref (bound_addr);
 
+  /* the threads drain the socket until nothing is pending anymore */
+  g_socket_set_blocking (socket, FALSE);
+
   self->priv->socket = socket;
   self->priv->cancel = g_cancellable_new ();
+  self->priv->threads = g_new0 (GThread *, self->priv->n_threads);
 
-  self->priv->thread = g_thread_try_new ("GstNetTimeProvider",
-      gst_net_time_provider_thread, self, &err);
+  GST_DEBUG_OBJECT (self, "starting %u threads, batch size %u",
+      self->priv->n_threads, self->priv->batch_size);
 
-  if (err != NULL)
-    goto no_thread;
+  for (i = 0; i < self->priv->n_threads; i++) {
+    self->priv->threads[i] = g_thread_try_new ("GstNetTimeProvider",
+        gst_net_time_provider_thread, self, &err);
+
+    if (err != NULL)
+      goto no_thread;
+  }
 
   return TRUE;
 
@@ -341,30 +595,30 @@ gst_net_time_provider_start (GstNetTimeProvider * self)
 invalid_address:
   {
     GST_ERROR_OBJECT (self, "invalid address: %s", self->priv->address);
+    g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+        "Invalid address: %s", self->priv->address);
     return FALSE;
   }
 no_socket:
   {
     GST_ERROR_OBJECT (self, "could not create socket: %s", err->message);
-    g_error_free (err);
+    g_propagate_error (error, err);
     g_object_unref (inet_addr);
     return FALSE;
   }
 bind_error:
   {
     GST_ERROR_OBJECT (self, "bind failed: %s", err->message);
-    g_error_free (err);
+    g_propagate_error (error, err);
     g_object_unref (socket);
     return FALSE;
   }
 no_thread:
   {
     GST_ERROR_OBJECT (self, "could not create thread: %s", err->message);
-    g_error_free (err);
-    g_object_unref (self->priv->socket);
-    self->priv->socket = NULL;
-    g_object_unref (self->priv->cancel);
-    self->priv->cancel = NULL;
+    g_propagate_error (error, err);
+    /* stops the threads that were started already */
+    gst_net_time_provider_stop (self);
     return FALSE;
   }
 }
@@ -372,13 +626,17 @@ no_thread:
 static void
 gst_net_time_provider_stop (GstNetTimeProvider * self)
 {
-  g_return_if_fail (self->priv->thread != NULL);
+  guint i;
+
+  g_return_if_fail (self->priv->threads != NULL);
 
   GST_INFO_OBJECT (self, "stopping..");
   g_cancellable_cancel (self->priv->cancel);
 
-  g_thread_join (self->priv->thread);
-  self->priv->thread = NULL;
+  for (i = 0; i < self->priv->n_threads && self->priv->threads[i]; i++)
+    g_thread_join (self->priv->threads[i]);
+  g_free (self->priv->threads);
+  self->priv->threads = NULL;
 
   g_object_unref (self->priv->cancel);
   self->priv->cancel = NULL;
@@ -408,19 +666,36 @@ gst_net_time_provider_new (GstClock * clock, const gchar * address, gint port)
   g_return_val_if_fail (clock && GST_IS_CLOCK (clock), NULL);
   g_return_val_if_fail (port >= 0 && port <= G_MAXUINT16, NULL);
 
-  ret = g_object_new (GST_TYPE_NET_TIME_PROVIDER, "clock", clock, "address",
-      address, "port", port, NULL);
-
-  if (!gst_net_time_provider_start (ret))
-    goto failed_start;
+  ret = g_initable_new (GST_TYPE_NET_TIME_PROVIDER, NULL, NULL, "clock", clock,
+      "address", address, "port", port, NULL);
 
-  /* all systems go, cap'n */
+  /* on errors, the object is gone and a nice error was printed already */
   return ret;
+}
 
-failed_start:
-  {
-    /* already printed a nice error */
-    gst_object_unref (ret);
-    return NULL;
+static gboolean
+gst_net_time_provider_initable_init (GInitable * initable,
+    GCancellable * cancellable, GError ** error)
+{
+  GstNetTimeProvider *self = GST_NET_TIME_PROVIDER (initable);
+
+  if (self->priv->threads != NULL)
+    return TRUE;
+
+  if (self->priv->clock == NULL) {
+    g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+        "No clock to provide");
+    return FALSE;
   }
+
+  /* all systems go, cap'n */
+  return gst_net_time_provider_start (self, error);
+}
+
+static void
+gst_net_time_provider_initable_iface_init (gpointer g_iface)
+{
+  GInitableIface *iface = g_iface;
+
+  iface->init = gst_net_time_provider_initable_init;
 }
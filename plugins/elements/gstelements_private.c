@@ -65,3 +65,95 @@ gst_buffer_get_flags_string (GstBuffer * buffer)
 
   return flag_str;
 }
+
+void
+gst_queue_stats_reset (GstQueueStats * stats)
+{
+  memset (stats, 0, sizeof (GstQueueStats));
+}
+
+/* bin 0 counts times below 1 microsecond, bin n the times from 2^(n-1) up to
+ * 2^n microseconds and the last bin everything longer than that */
+void
+gst_queue_stats_add_time (GstQueueStats * stats, GstClockTime time)
+{
+  guint64 usecs = time / GST_USECOND;
+  guint bin;
+
+  if (usecs == 0)
+    bin = 0;
+  else if (usecs >= (G_GUINT64_CONSTANT (1) << (GST_QUEUE_STATS_TIME_BINS - 2)))
+    bin = GST_QUEUE_STATS_TIME_BINS - 1;
+  else
+    bin = g_bit_storage ((gulong) usecs);
+
+  stats->buffers++;
+  stats->total_time += time;
+  stats->max_time = MAX (stats->max_time, time);
+  stats->time_bins[bin]++;
+}
+
+/* levels go in 10% steps, the last bin counts a full queue */
+void
+gst_queue_stats_add_level (GstQueueStats * stats, guint percent)
+{
+  percent = MIN (percent, 100);
+
+  stats->level_samples++;
+  stats->total_level += percent;
+  stats->level_bins[percent / 10]++;
+}
+
+/* Returns @cur as percentage of @max, for a limit that is not disabled */
+guint
+gst_queue_stats_percent (guint64 cur, guint64 max)
+{
+  if (max == 0)
+    return 0;
+  if (cur >= max)
+    return 100;
+  return (guint) (cur * 100 / max);
+}
+
+static void
+append_bins (GstStructure * s, const gchar * field, const guint64 * bins,
+    guint n_bins)
+{
+  GValue array = G_VALUE_INIT;
+  GValue val = G_VALUE_INIT;
+  guint i;
+
+  g_value_init (&array, GST_TYPE_ARRAY);
+  g_value_init (&val, G_TYPE_UINT64);
+  for (i = 0; i < n_bins; i++) {
+    g_value_set_uint64 (&val, bins[i]);
+    gst_value_array_append_value (&array, &val);
+  }
+  g_value_unset (&val);
+
+  gst_structure_take_value (s, field, &array);
+}
+
+/* Returns a new structure called @name with the statistics, see the stats
+ * property of the queue elements */
+GstStructure *
+gst_queue_stats_to_structure (const GstQueueStats * stats, const gchar * name)
+{
+  GstStructure *s;
+
+  s = gst_structure_new (name,
+      "buffers", G_TYPE_UINT64, stats->buffers,
+      "mean-time", G_TYPE_UINT64, stats->buffers ?
+      stats->total_time / stats->buffers : G_GUINT64_CONSTANT (0),
+      "max-time", G_TYPE_UINT64, stats->max_time,
+      "level-samples", G_TYPE_UINT64, stats->level_samples,
+      "mean-level", G_TYPE_UINT, stats->level_samples ?
+      (guint) (stats->total_level / stats->level_samples) : 0, NULL);
+
+  append_bins (s, "time-histogram", stats->time_bins,
+      GST_QUEUE_STATS_TIME_BINS);
+  append_bins (s, "level-histogram", stats->level_bins,
+      GST_QUEUE_STATS_LEVEL_BINS);
+
+  return s;
+}
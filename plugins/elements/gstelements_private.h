@@ -30,6 +30,40 @@ G_BEGIN_DECLS
 G_GNUC_INTERNAL
 char *    gst_buffer_get_flags_string                   (GstBuffer *buffer);
 
+/* residence time and fill level statistics of the queue elements */
+#define GST_QUEUE_STATS_TIME_BINS  24
+#define GST_QUEUE_STATS_LEVEL_BINS 11
+
+typedef struct {
+  guint64      buffers;
+  GstClockTime total_time;
+  GstClockTime max_time;
+  guint64      time_bins[GST_QUEUE_STATS_TIME_BINS];
+
+  guint64      level_samples;
+  guint64      total_level;
+  guint64      level_bins[GST_QUEUE_STATS_LEVEL_BINS];
+} GstQueueStats;
+
+G_GNUC_INTERNAL
+void      gst_queue_stats_reset                         (GstQueueStats *stats);
+
+G_GNUC_INTERNAL
+void      gst_queue_stats_add_time                      (GstQueueStats *stats,
+                                                         GstClockTime time);
+
+G_GNUC_INTERNAL
+void      gst_queue_stats_add_level                     (GstQueueStats *stats,
+                                                         guint percent);
+
+G_GNUC_INTERNAL
+guint     gst_queue_stats_percent                       (guint64 cur,
+                                                         guint64 max);
+
+G_GNUC_INTERNAL
+GstStructure * gst_queue_stats_to_structure             (const GstQueueStats *stats,
+                                                         const gchar *name);
+
 G_END_DECLS
 
 #endif /* __GST_ELEMENTS_PRIVATE_H__ */
@@ -72,6 +72,9 @@
 #ifdef HAVE_SYS_SOCKET_H
 #include <sys/socket.h>
 #endif
+#ifdef HAVE_SYS_UIO_H
+#include <sys/uio.h>
+#endif
 #include <fcntl.h>
 #include <stdio.h>
 #ifdef HAVE_UNISTD_H
@@ -98,6 +101,8 @@ GST_DEBUG_CATEGORY_STATIC (gst_fd_src_debug);
 
 #define DEFAULT_FD              0
 #define DEFAULT_TIMEOUT         0
+#define DEFAULT_BATCH_SIZE      1
+#define MAX_BATCH_SIZE          1024
 
 enum
 {
@@ -105,6 +110,7 @@ enum
 
   PROP_FD,
   PROP_TIMEOUT,
+  PROP_BATCH_SIZE,
 
   PROP_LAST
 };
@@ -133,6 +139,8 @@ static gboolean gst_fd_src_do_seek (GstBaseSrc * src, GstSegment * segment);
 static gboolean gst_fd_src_query (GstBaseSrc * src, GstQuery * query);
 
 static GstFlowReturn gst_fd_src_create (GstPushSrc * psrc, GstBuffer ** outbuf);
+static GstFlowReturn gst_fd_src_create_list (GstPushSrc * psrc,
+    GstBufferList ** outlist);
 
 static void
 gst_fd_src_class_init (GstFdSrcClass * klass)
@@ -164,6 +172,19 @@ gst_fd_src_class_init (GstFdSrcClass * klass)
           "Post a message after timeout microseconds (0 = disabled)", 0,
           G_MAXUINT64, DEFAULT_TIMEOUT,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstFdSrc:batch-size
+   *
+   * Read up to this many blocks of blocksize bytes with a single readv()
+   * call and push them downstream as one buffer list. 1 reads one block at
+   * a time.
+   *
+   * Since: 1.6
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_BATCH_SIZE,
+      g_param_spec_uint ("batch-size", "Batch size",
+          "Number of blocks to read with one system call", 1, MAX_BATCH_SIZE,
+          DEFAULT_BATCH_SIZE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   gst_element_class_set_static_metadata (gstelement_class,
       "Filedescriptor Source",
@@ -182,6 +203,7 @@ gst_fd_src_class_init (GstFdSrcClass * klass)
   gstbasesrc_class->query = GST_DEBUG_FUNCPTR (gst_fd_src_query);
 
   gstpush_src_class->create = GST_DEBUG_FUNCPTR (gst_fd_src_create);
+  gstpush_src_class->create_list = GST_DEBUG_FUNCPTR (gst_fd_src_create_list);
 }
 
 static void
@@ -192,6 +214,7 @@ gst_fd_src_init (GstFdSrc * fdsrc)
   fdsrc->fd = -1;
   fdsrc->size = -1;
   fdsrc->timeout = DEFAULT_TIMEOUT;
+  fdsrc->batch_size = DEFAULT_BATCH_SIZE;
   fdsrc->uri = g_strdup_printf ("fd://0");
   fdsrc->curoffset = 0;
 }
@@ -356,6 +379,9 @@ gst_fd_src_set_property (GObject * object, guint prop_id, const GValue * value,
       GST_DEBUG_OBJECT (src, "poll timeout set to %" GST_TIME_FORMAT,
           GST_TIME_ARGS (src->timeout));
       break;
+    case PROP_BATCH_SIZE:
+      src->batch_size = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -375,30 +401,24 @@ gst_fd_src_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_TIMEOUT:
       g_value_set_uint64 (value, src->timeout);
       break;
+    case PROP_BATCH_SIZE:
+      g_value_set_uint (value, src->batch_size);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
   }
 }
 
+/* wait until the fd becomes readable */
 static GstFlowReturn
-gst_fd_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
+gst_fd_src_wait (GstFdSrc * src)
 {
-  GstFdSrc *src;
-  GstBuffer *buf;
-  gssize readbytes;
-  guint blocksize;
-  GstMapInfo info;
-
 #ifndef HAVE_WIN32
   GstClockTime timeout;
   gboolean try_again;
   gint retval;
-#endif
 
-  src = GST_FD_SRC (psrc);
-
-#ifndef HAVE_WIN32
   if (src->timeout > 0) {
     timeout = src->timeout * GST_USECOND;
   } else {
@@ -434,6 +454,41 @@ gst_fd_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
   } while (G_UNLIKELY (try_again));     /* retry if interrupted or timeout */
 #endif
 
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+#ifndef HAVE_WIN32
+poll_error:
+  {
+    GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL),
+        ("poll on file descriptor: %s.", g_strerror (errno)));
+    GST_DEBUG_OBJECT (src, "Error during poll");
+    return GST_FLOW_ERROR;
+  }
+stopped:
+  {
+    GST_DEBUG_OBJECT (src, "Poll stopped");
+    return GST_FLOW_FLUSHING;
+  }
+#endif
+}
+
+static GstFlowReturn
+gst_fd_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
+{
+  GstFdSrc *src;
+  GstBuffer *buf;
+  gssize readbytes;
+  guint blocksize;
+  GstMapInfo info;
+  GstFlowReturn ret;
+
+  src = GST_FD_SRC (psrc);
+
+  ret = gst_fd_src_wait (src);
+  if (G_UNLIKELY (ret != GST_FLOW_OK))
+    return ret;
+
   blocksize = GST_BASE_SRC (src)->blocksize;
 
   /* create the buffer */
@@ -469,20 +524,6 @@ gst_fd_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
   return GST_FLOW_OK;
 
   /* ERRORS */
-#ifndef HAVE_WIN32
-poll_error:
-  {
-    GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL),
-        ("poll on file descriptor: %s.", g_strerror (errno)));
-    GST_DEBUG_OBJECT (psrc, "Error during poll");
-    return GST_FLOW_ERROR;
-  }
-stopped:
-  {
-    GST_DEBUG_OBJECT (psrc, "Poll stopped");
-    return GST_FLOW_FLUSHING;
-  }
-#endif
 alloc_failed:
   {
     GST_ERROR_OBJECT (src, "Failed to allocate %u bytes", blocksize);
@@ -505,6 +546,148 @@ read_error:
   }
 }
 
+/* read batch-size blocks with one readv() call and return the ones that got
+ * data as a buffer list. With a batch-size of 1, or without readv(), the
+ * base class falls back to create(). */
+static GstFlowReturn
+gst_fd_src_create_list (GstPushSrc * psrc, GstBufferList ** outlist)
+{
+#ifdef HAVE_SYS_UIO_H
+  GstFdSrc *src;
+  GstBufferList *list;
+  GstBuffer **bufs;
+  GstMapInfo *maps;
+  struct iovec *iov;
+  gssize readbytes;
+  guint blocksize, n_blocks, i;
+  GstFlowReturn ret;
+
+  src = GST_FD_SRC (psrc);
+
+  n_blocks = src->batch_size;
+  if (n_blocks <= 1)
+    return GST_FLOW_NOT_SUPPORTED;
+
+  ret = gst_fd_src_wait (src);
+  if (G_UNLIKELY (ret != GST_FLOW_OK))
+    return ret;
+
+  blocksize = GST_BASE_SRC (src)->blocksize;
+
+  bufs = g_new (GstBuffer *, n_blocks);
+  maps = g_new (GstMapInfo, n_blocks);
+  iov = g_new (struct iovec, n_blocks);
+
+  for (i = 0; i < n_blocks; i++) {
+    bufs[i] = gst_buffer_new_allocate (NULL, blocksize, NULL);
+    if (G_UNLIKELY (bufs[i] == NULL))
+      goto alloc_failed;
+
+    if (G_UNLIKELY (!gst_buffer_map (bufs[i], &maps[i], GST_MAP_WRITE)))
+      goto map_failed;
+    iov[i].iov_base = maps[i].data;
+    iov[i].iov_len = blocksize;
+  }
+
+  do {
+    readbytes = readv (src->fd, iov, n_blocks);
+    GST_LOG_OBJECT (src, "readv %" G_GSSIZE_FORMAT, readbytes);
+  } while (readbytes == -1 && errno == EINTR);  /* retry if interrupted */
+
+  for (i = 0; i < n_blocks; i++)
+    gst_buffer_unmap (bufs[i], &maps[i]);
+
+  if (readbytes < 0)
+    goto read_error;
+
+  if (readbytes == 0)
+    goto eos;
+
+  /* the blocks are filled in order, keep the ones that got data */
+  list = gst_buffer_list_new_sized (n_blocks);
+  for (i = 0; i < n_blocks; i++) {
+    gsize size = MIN ((gsize) readbytes, blocksize);
+
+    if (size == 0) {
+      gst_buffer_unref (bufs[i]);
+      continue;
+    }
+    if (size < blocksize)
+      gst_buffer_resize (bufs[i], 0, size);
+
+    GST_BUFFER_OFFSET (bufs[i]) = src->curoffset;
+    GST_BUFFER_TIMESTAMP (bufs[i]) = GST_CLOCK_TIME_NONE;
+    src->curoffset += size;
+    readbytes -= size;
+
+    gst_buffer_list_add (list, bufs[i]);
+  }
+
+  GST_LOG_OBJECT (psrc, "Read %u buffers", gst_buffer_list_length (list));
+
+  g_free (bufs);
+  g_free (maps);
+  g_free (iov);
+
+  *outlist = list;
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+alloc_failed:
+  {
+    GST_ERROR_OBJECT (src, "Failed to allocate %u bytes", blocksize);
+    while (i-- > 0) {
+      gst_buffer_unmap (bufs[i], &maps[i]);
+      gst_buffer_unref (bufs[i]);
+    }
+    ret = GST_FLOW_ERROR;
+    goto done;
+  }
+map_failed:
+  {
+    GST_ELEMENT_ERROR (src, RESOURCE, BUSY, (NULL),
+        ("failed to map buffer %u in WRITE mode", i));
+    gst_buffer_unref (bufs[i]);
+    while (i-- > 0) {
+      gst_buffer_unmap (bufs[i], &maps[i]);
+      gst_buffer_unref (bufs[i]);
+    }
+    ret = GST_FLOW_ERROR;
+    goto done;
+  }
+eos:
+  {
+    GST_DEBUG_OBJECT (psrc, "Read 0 bytes. EOS.");
+    ret = GST_FLOW_EOS;
+    goto free_buffers;
+  }
+read_error:
+  {
+    GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL),
+        ("readv on file descriptor: %s.", g_strerror (errno)));
+    GST_DEBUG_OBJECT (psrc, "Error reading from fd");
+    ret = GST_FLOW_ERROR;
+    goto free_buffers;
+  }
+free_buffers:
+  {
+    for (i = 0; i < n_blocks; i++)
+      gst_buffer_unref (bufs[i]);
+    goto done;
+  }
+done:
+  {
+    g_free (bufs);
+    g_free (maps);
+    g_free (iov);
+    return ret;
+  }
+#else
+  return GST_FLOW_NOT_SUPPORTED;
+#endif
+}
+
 static gboolean
 gst_fd_src_query (GstBaseSrc * basesrc, GstQuery * query)
 {
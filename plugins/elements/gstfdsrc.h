@@ -66,6 +66,9 @@ struct _GstFdSrc {
   /* poll timeout */
   guint64 timeout;
 
+  /* blocks to read with one readv() call */
+  guint batch_size;
+
   gchar *uri;
 
   GstPoll *fdset;
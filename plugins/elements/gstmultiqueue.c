@@ -110,6 +110,7 @@
 #include <gst/gst.h>
 #include <stdio.h>
 #include "gstmultiqueue.h"
+#include "gstelements_private.h"
 #include <gst/glib-compat-private.h>
 
 /**
@@ -172,6 +173,9 @@ struct _GstSingleQueue
   GCond query_handled;
   gboolean last_query;
   GstQuery *last_handled_query;
+
+  /* residence time and fill level statistics, protected by global lock */
+  GstQueueStats stats;
 };
 
 
@@ -189,6 +193,8 @@ struct _GstMultiQueueItem
   guint32 posid;
 
   gboolean is_query;
+
+  GstClockTime in_time;         /* when the buffer entered, for the stats */
 };
 
 static GstSingleQueue *gst_single_queue_new (GstMultiQueue * mqueue, guint id);
@@ -248,6 +254,8 @@ enum
 #define DEFAULT_LOW_PERCENT   10
 #define DEFAULT_HIGH_PERCENT  99
 #define DEFAULT_SYNC_BY_RUNNING_TIME FALSE
+#define DEFAULT_COLLECT_STATS FALSE
+#define DEFAULT_STATS_INTERVAL 0
 
 enum
 {
@@ -262,6 +270,9 @@ enum
   PROP_LOW_PERCENT,
   PROP_HIGH_PERCENT,
   PROP_SYNC_BY_RUNNING_TIME,
+  PROP_COLLECT_STATS,
+  PROP_STATS,
+  PROP_STATS_INTERVAL,
   PROP_LAST
 };
 
@@ -428,6 +439,60 @@ gst_multi_queue_class_init (GstMultiQueueClass * klass)
           DEFAULT_SYNC_BY_RUNNING_TIME,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMultiQueue:collect-stats
+   *
+   * Record for each queue how long buffers stay in it and how full it is
+   * when a buffer enters it. The results are available in the
+   * #GstMultiQueue:stats property. Collecting costs two timestamps per
+   * buffer, so it is disabled by default.
+   *
+   * Since: 1.6
+   */
+  g_object_class_install_property (gobject_class, PROP_COLLECT_STATS,
+      g_param_spec_boolean ("collect-stats", "Collect stats",
+          "Collect residence time and fill level statistics",
+          DEFAULT_COLLECT_STATS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMultiQueue:stats
+   *
+   * Statistics collected when #GstMultiQueue:collect-stats is enabled. This
+   * property returns a #GstStructure with name "GstMultiQueueStats" with a
+   * "queues" field of type GST_TYPE_ARRAY. It holds a "GstSingleQueueStats"
+   * structure for each queue, with the same fields as the #GstQueue:stats
+   * structure of queue plus an "id" field of type G_TYPE_UINT with the
+   * number of the sink pad of the queue.
+   *
+   * The fill level of a queue is relative to its own limits, which grow
+   * when the other queues run empty.
+   *
+   * Unlike with queue, the residence time starts when a buffer arrives on
+   * the sink pad and not when the queue accepted it, so it includes the
+   * time upstream waited for the queue to have space for the buffer.
+   *
+   * Since: 1.6
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Residence time and fill level statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMultiQueue:stats-interval
+   *
+   * Post an element message with the "GstSingleQueueStats" structure of a
+   * queue every stats-interval buffers that left that queue. 0 disables
+   * posting.
+   *
+   * Since: 1.6
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS_INTERVAL,
+      g_param_spec_uint ("stats-interval", "Stats interval",
+          "Post the stats of a queue as element message every this many "
+          "buffers (0 = never)", 0, G_MAXUINT, DEFAULT_STATS_INTERVAL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gobject_class->finalize = gst_multi_queue_finalize;
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -466,6 +531,9 @@ gst_multi_queue_init (GstMultiQueue * mqueue)
 
   mqueue->sync_by_running_time = DEFAULT_SYNC_BY_RUNNING_TIME;
 
+  mqueue->collect_stats = DEFAULT_COLLECT_STATS;
+  mqueue->stats_interval = DEFAULT_STATS_INTERVAL;
+
   mqueue->counter = 1;
   mqueue->highid = -1;
   mqueue->high_time = GST_CLOCK_TIME_NONE;
@@ -491,6 +559,42 @@ gst_multi_queue_finalize (GObject * object)
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
+/* WITH LOCK TAKEN */
+static GstStructure *
+gst_single_queue_get_stats (GstSingleQueue * sq)
+{
+  GstStructure *s;
+
+  s = gst_queue_stats_to_structure (&sq->stats, "GstSingleQueueStats");
+  gst_structure_set (s, "id", G_TYPE_UINT, sq->id, NULL);
+
+  return s;
+}
+
+/* WITH LOCK TAKEN */
+static GstStructure *
+gst_multi_queue_get_stats (GstMultiQueue * mq)
+{
+  GValue queues = G_VALUE_INIT;
+  GValue val = G_VALUE_INIT;
+  GstStructure *s;
+  GList *tmp;
+
+  g_value_init (&queues, GST_TYPE_ARRAY);
+  for (tmp = mq->queues; tmp; tmp = g_list_next (tmp)) {
+    GstSingleQueue *sq = (GstSingleQueue *) tmp->data;
+
+    g_value_init (&val, GST_TYPE_STRUCTURE);
+    g_value_take_boxed (&val, gst_single_queue_get_stats (sq));
+    gst_value_array_append_and_take_value (&queues, &val);
+  }
+
+  s = gst_structure_new_empty ("GstMultiQueueStats");
+  gst_structure_take_value (s, "queues", &queues);
+
+  return s;
+}
+
 #define SET_CHILD_PROPERTY(mq,format) G_STMT_START {	        \
     GList * tmp = mq->queues;					\
     while (tmp) {						\
@@ -607,6 +711,12 @@ gst_multi_queue_set_property (GObject * object, guint prop_id,
     case PROP_SYNC_BY_RUNNING_TIME:
       mq->sync_by_running_time = g_value_get_boolean (value);
       break;
+    case PROP_COLLECT_STATS:
+      mq->collect_stats = g_value_get_boolean (value);
+      break;
+    case PROP_STATS_INTERVAL:
+      mq->stats_interval = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -652,6 +762,15 @@ gst_multi_queue_get_property (GObject * object, guint prop_id,
     case PROP_SYNC_BY_RUNNING_TIME:
       g_value_set_boolean (value, mq->sync_by_running_time);
       break;
+    case PROP_COLLECT_STATS:
+      g_value_set_boolean (value, mq->collect_stats);
+      break;
+    case PROP_STATS:
+      g_value_take_boxed (value, gst_multi_queue_get_stats (mq));
+      break;
+    case PROP_STATS_INTERVAL:
+      g_value_set_uint (value, mq->stats_interval);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -916,6 +1035,25 @@ get_percentage (GstSingleQueue * sq)
   return percent;
 }
 
+/* the fill level of the limit that is closest to being reached, in percent.
+ * WITH LOCK TAKEN */
+static guint
+get_fill_level (GstSingleQueue * sq)
+{
+  GstDataQueueSize size;
+  guint percent;
+
+  gst_data_queue_get_level (sq->queue, &size);
+
+  percent = gst_queue_stats_percent (size.visible, sq->max_size.visible);
+  percent = MAX (percent, gst_queue_stats_percent (size.bytes,
+          sq->max_size.bytes));
+  percent = MAX (percent, gst_queue_stats_percent (sq->cur_time,
+          sq->max_size.time));
+
+  return percent;
+}
+
 /* WITH LOCK TAKEN */
 static void
 update_buffering (GstMultiQueue * mq, GstSingleQueue * sq)
@@ -1317,6 +1455,7 @@ gst_multi_queue_buffer_item_new (GstMiniObject * object, guint32 curid)
   if (item->duration == GST_CLOCK_TIME_NONE)
     item->duration = 0;
   item->visible = TRUE;
+  item->in_time = GST_CLOCK_TIME_NONE;
   return item;
 }
 
@@ -1334,6 +1473,7 @@ gst_multi_queue_mo_item_new (GstMiniObject * object, guint32 curid)
   item->size = 0;
   item->duration = 0;
   item->visible = FALSE;
+  item->in_time = GST_CLOCK_TIME_NONE;
   return item;
 }
 
@@ -1352,6 +1492,8 @@ gst_multi_queue_loop (GstPad * pad)
   guint32 newid;
   GstFlowReturn result;
   GstClockTime next_time;
+  GstClockTime in_time;
+  GstStructure *stats = NULL;
   gboolean is_buffer;
   gboolean do_update_buffering = FALSE;
 
@@ -1370,6 +1512,7 @@ gst_multi_queue_loop (GstPad * pad)
 
   item = (GstMultiQueueItem *) sitem;
   newid = item->posid;
+  in_time = item->in_time;
 
   /* steal the object and destroy the item */
   object = gst_multi_queue_item_steal_object (item);
@@ -1482,8 +1625,20 @@ gst_multi_queue_loop (GstPad * pad)
       wake_up_next_non_linked (mq);
     }
   }
+  /* the buffer leaves the queue now, waiting for the other streams when
+   * not-linked included */
+  if (G_UNLIKELY (GST_CLOCK_TIME_IS_VALID (in_time))) {
+    gst_queue_stats_add_time (&sq->stats, gst_util_get_timestamp () - in_time);
+    if (mq->stats_interval > 0 &&
+        sq->stats.buffers % mq->stats_interval == 0)
+      stats = gst_single_queue_get_stats (sq);
+  }
   GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
 
+  if (stats)
+    gst_element_post_message (GST_ELEMENT_CAST (mq),
+        gst_message_new_element (GST_OBJECT_CAST (mq), stats));
+
   /* Try to push out the new object */
   result = gst_single_queue_push_one (mq, sq, object);
   object = NULL;
@@ -1623,6 +1778,10 @@ gst_multi_queue_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
       sq->id, buffer, curid);
 
   item = gst_multi_queue_buffer_item_new (GST_MINI_OBJECT_CAST (buffer), curid);
+  /* the item can be popped before the push below returns, so it has to be
+   * stamped before waiting for space in the queue */
+  if (G_UNLIKELY (mq->collect_stats))
+    item->in_time = gst_util_get_timestamp ();
 
   timestamp = GST_BUFFER_TIMESTAMP (buffer);
   duration = GST_BUFFER_DURATION (buffer);
@@ -1634,6 +1793,12 @@ gst_multi_queue_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
    * that we never end up filling the queue first. */
   apply_buffer (mq, sq, timestamp, duration, &sq->sink_segment);
 
+  if (G_UNLIKELY (mq->collect_stats)) {
+    GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+    gst_queue_stats_add_level (&sq->stats, get_fill_level (sq));
+    GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+  }
+
 done:
   return sq->srcresult;
 
@@ -1675,6 +1840,7 @@ gst_multi_queue_sink_activate_mode (GstPad * pad, GstObject * parent,
         /* All pads start off linked until they push one buffer */
         sq->srcresult = GST_FLOW_OK;
         sq->pushed = FALSE;
+        gst_queue_stats_reset (&sq->stats);
         gst_data_queue_set_flushing (sq->queue, FALSE);
       } else {
         sq->srcresult = GST_FLOW_FLUSHING;
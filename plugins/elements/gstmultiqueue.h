@@ -77,6 +77,9 @@ struct _GstMultiQueue {
 
   gboolean percent_changed;
   GMutex buffering_post_lock; /* assures only one posted at a time */
+
+  gboolean collect_stats;
+  guint stats_interval;
 };
 
 struct _GstMultiQueueClass {
@@ -120,13 +120,18 @@ enum
   PROP_MIN_THRESHOLD_TIME,
   PROP_LEAKY,
   PROP_SILENT,
-  PROP_FLUSH_ON_EOS
+  PROP_FLUSH_ON_EOS,
+  PROP_COLLECT_STATS,
+  PROP_STATS,
+  PROP_STATS_INTERVAL
 };
 
 /* default property values */
 #define DEFAULT_MAX_SIZE_BUFFERS  200   /* 200 buffers */
 #define DEFAULT_MAX_SIZE_BYTES    (10 * 1024 * 1024)    /* 10 MB       */
 #define DEFAULT_MAX_SIZE_TIME     GST_SECOND    /* 1 second    */
+#define DEFAULT_COLLECT_STATS     FALSE
+#define DEFAULT_STATS_INTERVAL    0
 
 #define GST_QUEUE_MUTEX_LOCK(q) G_STMT_START {                          \
   g_mutex_lock (&q->qlock);                                              \
@@ -142,11 +147,26 @@ enum
   g_mutex_unlock (&q->qlock);                                            \
 } G_STMT_END
 
+/* spin budgets, in iterations, of the adaptive spinning before waiting */
+#define QUEUE_SPIN_MIN            16
+#define QUEUE_SPIN_MAX            4096
+
+/* hint to the CPU that we are busy waiting */
+#if defined (__GNUC__) && (defined (__i386__) || defined (__x86_64__))
+#define QUEUE_CPU_RELAX() __asm__ __volatile__ ("pause")
+#elif defined (__GNUC__) && (defined (__aarch64__) || defined (__arm__))
+#define QUEUE_CPU_RELAX() __asm__ __volatile__ ("yield")
+#else
+#define QUEUE_CPU_RELAX() G_STMT_START { } G_STMT_END
+#endif
+
 #define GST_QUEUE_WAIT_DEL_CHECK(q, label) G_STMT_START {               \
   STATUS (q, q->sinkpad, "wait for DEL");                               \
-  q->waiting_del = TRUE;                                                \
-  g_cond_wait (&q->item_del, &q->qlock);                                  \
-  q->waiting_del = FALSE;                                               \
+  if (!gst_queue_locked_spin (q, &q->del_cookie, &q->spin_del)) {       \
+    q->waiting_del = TRUE;                                              \
+    g_cond_wait (&q->item_del, &q->qlock);                              \
+    q->waiting_del = FALSE;                                             \
+  }                                                                     \
   if (q->srcresult != GST_FLOW_OK) {                                    \
     STATUS (q, q->srcpad, "received DEL wakeup");                       \
     goto label;                                                         \
@@ -156,9 +176,11 @@ enum
 
 #define GST_QUEUE_WAIT_ADD_CHECK(q, label) G_STMT_START {               \
   STATUS (q, q->srcpad, "wait for ADD");                                \
-  q->waiting_add = TRUE;                                                \
-  g_cond_wait (&q->item_add, &q->qlock);                                  \
-  q->waiting_add = FALSE;                                               \
+  if (!gst_queue_locked_spin (q, &q->add_cookie, &q->spin_add)) {       \
+    q->waiting_add = TRUE;                                              \
+    g_cond_wait (&q->item_add, &q->qlock);                              \
+    q->waiting_add = FALSE;                                             \
+  }                                                                     \
   if (q->srcresult != GST_FLOW_OK) {                                    \
     STATUS (q, q->srcpad, "received ADD wakeup");                       \
     goto label;                                                         \
@@ -167,6 +189,7 @@ enum
 } G_STMT_END
 
 #define GST_QUEUE_SIGNAL_DEL(q) G_STMT_START {                          \
+  g_atomic_int_inc (&q->del_cookie);                                    \
   if (q->waiting_del) {                                                 \
     STATUS (q, q->srcpad, "signal DEL");                                \
     g_cond_signal (&q->item_del);                                        \
@@ -174,6 +197,7 @@ enum
 } G_STMT_END
 
 #define GST_QUEUE_SIGNAL_ADD(q) G_STMT_START {                          \
+  g_atomic_int_inc (&q->add_cookie);                                    \
   if (q->waiting_add) {                                                 \
     STATUS (q, q->sinkpad, "signal ADD");                               \
     g_cond_signal (&q->item_add);                                        \
@@ -217,6 +241,8 @@ static gboolean gst_queue_sink_activate_mode (GstPad * pad, GstObject * parent,
 
 static gboolean gst_queue_is_empty (GstQueue * queue);
 static gboolean gst_queue_is_filled (GstQueue * queue);
+static gboolean gst_queue_locked_spin (GstQueue * queue, volatile gint * cookie,
+    guint * budget);
 
 
 typedef struct
@@ -224,6 +250,7 @@ typedef struct
   gboolean is_query;
   GstMiniObject *item;
   gsize size;
+  GstClockTime in_time;         /* when the buffer entered, for the stats */
 } GstQueueItem;
 
 #define GST_TYPE_QUEUE_LEAKY (queue_leaky_get_type ())
@@ -248,6 +275,9 @@ queue_leaky_get_type (void)
 
 static guint gst_queue_signals[LAST_SIGNAL] = { 0 };
 
+/* spinning only helps when the other thread can run at the same time */
+static gboolean queue_can_spin = TRUE;
+
 static void
 gst_queue_class_init (GstQueueClass * klass)
 {
@@ -257,6 +287,10 @@ gst_queue_class_init (GstQueueClass * klass)
   gobject_class->set_property = gst_queue_set_property;
   gobject_class->get_property = gst_queue_get_property;
 
+#if GLIB_CHECK_VERSION (2, 36, 0)
+  queue_can_spin = g_get_num_processors () > 1;
+#endif
+
   /* signals */
   /**
    * GstQueue::underrun:
@@ -400,6 +434,67 @@ gst_queue_class_init (GstQueueClass * klass)
           G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
           G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstQueue:collect-stats
+   *
+   * Record how long buffers stay in the queue and how full the queue is
+   * when a buffer enters it. The results are available in the
+   * #GstQueue:stats property. Collecting costs two timestamps per buffer, so
+   * it is disabled by default.
+   *
+   * Since: 1.6
+   */
+  g_object_class_install_property (gobject_class, PROP_COLLECT_STATS,
+      g_param_spec_boolean ("collect-stats", "Collect stats",
+          "Collect residence time and fill level statistics",
+          DEFAULT_COLLECT_STATS,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstQueue:stats
+   *
+   * Statistics collected when #GstQueue:collect-stats is enabled. This
+   * property returns a #GstStructure with name "GstQueueStats" with the
+   * following fields:
+   *
+   * - "buffers"         G_TYPE_UINT64  buffers that left the queue
+   * - "mean-time"       G_TYPE_UINT64  average time a buffer was queued (ns)
+   * - "max-time"        G_TYPE_UINT64  longest time a buffer was queued (ns)
+   * - "time-histogram"  GST_TYPE_ARRAY 24 buffer counts by queued time: the
+   *   first for less than 1 microsecond, entry n for 2^(n-1) up to 2^n
+   *   microseconds and the last for everything longer
+   * - "level-samples"   G_TYPE_UINT64  buffers that entered the queue
+   * - "mean-level"      G_TYPE_UINT    average fill level (percent)
+   * - "level-histogram" GST_TYPE_ARRAY 11 buffer counts by the fill level
+   *   after the buffer entered, in 10 percent steps with the last entry
+   *   for a full queue
+   *
+   * The fill level is that of the max-size limit that is closest to being
+   * reached. The statistics are reset when the queue is activated.
+   *
+   * Since: 1.6
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Residence time and fill level statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstQueue:stats-interval
+   *
+   * Post an element message with the #GstQueue:stats structure every
+   * stats-interval buffers that left the queue. 0 disables posting.
+   *
+   * Since: 1.6
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS_INTERVAL,
+      g_param_spec_uint ("stats-interval", "Stats interval",
+          "Post the stats as element message every this many buffers "
+          "(0 = never)", 0, G_MAXUINT, DEFAULT_STATS_INTERVAL,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
   gobject_class->finalize = gst_queue_finalize;
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -457,6 +552,8 @@ gst_queue_init (GstQueue * queue)
   g_mutex_init (&queue->qlock);
   g_cond_init (&queue->item_add);
   g_cond_init (&queue->item_del);
+  queue->spin_add = QUEUE_SPIN_MIN;
+  queue->spin_del = QUEUE_SPIN_MIN;
   g_cond_init (&queue->query_handled);
 
   queue->queue = gst_queue_array_new (DEFAULT_MAX_SIZE_BUFFERS * 3 / 2);
@@ -469,6 +566,10 @@ gst_queue_init (GstQueue * queue)
 
   queue->newseg_applied_to_src = FALSE;
 
+  queue->collect_stats = DEFAULT_COLLECT_STATS;
+  queue->stats_interval = DEFAULT_STATS_INTERVAL;
+  gst_queue_stats_reset (&queue->stats);
+
   GST_DEBUG_OBJECT (queue,
       "initialized queue's not_empty & not_full conditions");
 }
@@ -657,6 +758,23 @@ gst_queue_locked_flush (GstQueue * queue, gboolean full)
   GST_QUEUE_SIGNAL_DEL (queue);
 }
 
+/* the fill level of the limit that is closest to being reached, in percent,
+ * with QUEUE_LOCK */
+static guint
+gst_queue_fill_level (GstQueue * queue)
+{
+  guint percent;
+
+  percent = gst_queue_stats_percent (queue->cur_level.buffers,
+      queue->max_size.buffers);
+  percent = MAX (percent, gst_queue_stats_percent (queue->cur_level.bytes,
+          queue->max_size.bytes));
+  percent = MAX (percent, gst_queue_stats_percent (queue->cur_level.time,
+          queue->max_size.time));
+
+  return percent;
+}
+
 /* enqueue an item an update the level stats, with QUEUE_LOCK */
 static inline void
 gst_queue_locked_enqueue_buffer (GstQueue * queue, gpointer item)
@@ -674,6 +792,12 @@ gst_queue_locked_enqueue_buffer (GstQueue * queue, gpointer item)
   qitem->item = item;
   qitem->is_query = FALSE;
   qitem->size = bsize;
+  if (G_UNLIKELY (queue->collect_stats)) {
+    qitem->in_time = gst_util_get_timestamp ();
+    gst_queue_stats_add_level (&queue->stats, gst_queue_fill_level (queue));
+  } else {
+    qitem->in_time = GST_CLOCK_TIME_NONE;
+  }
   gst_queue_array_push_tail (queue->queue, qitem);
   GST_QUEUE_SIGNAL_ADD (queue);
 }
@@ -729,6 +853,7 @@ gst_queue_locked_dequeue (GstQueue * queue)
   GstQueueItem *qitem;
   GstMiniObject *item;
   gsize bufsize;
+  GstClockTime in_time;
 
   qitem = gst_queue_array_pop_head (queue->queue);
   if (qitem == NULL)
@@ -736,6 +861,7 @@ gst_queue_locked_dequeue (GstQueue * queue)
 
   item = qitem->item;
   bufsize = qitem->size;
+  in_time = qitem->in_time;
   g_slice_free (GstQueueItem, qitem);
 
   if (GST_IS_BUFFER (item)) {
@@ -752,6 +878,14 @@ gst_queue_locked_dequeue (GstQueue * queue)
     if (queue->cur_level.buffers == 0)
       queue->cur_level.time = 0;
 
+    if (G_UNLIKELY (GST_CLOCK_TIME_IS_VALID (in_time))) {
+      gst_queue_stats_add_time (&queue->stats,
+          gst_util_get_timestamp () - in_time);
+      if (queue->stats_interval > 0 &&
+          queue->stats.buffers % queue->stats_interval == 0)
+        queue->post_stats = TRUE;
+    }
+
   } else if (GST_IS_EVENT (item)) {
     GstEvent *event = GST_EVENT_CAST (item);
 
@@ -975,6 +1109,48 @@ gst_queue_is_empty (GstQueue * queue)
       !gst_queue_is_filled (queue);
 }
 
+/* With one thread on each side, going to sleep on the conditions costs a
+ * futex wait and a wakeup for almost every buffer when the other side is just
+ * a little bit slower. Before waiting, release the lock and spin for a while
+ * on the cookie of the signal we would wait for. The budget adapts: it grows
+ * when the spinning avoided a wait and shrinks when it did not, so that an
+ * idle queue quickly goes back to only sleeping. With a single CPU the other
+ * side can't make progress while we spin, so we never do.
+ *
+ * Called with QUEUE_LOCK, returns with QUEUE_LOCK. Returns TRUE when the
+ * signal was seen or the queue is flushing and there is no need to wait. */
+static gboolean
+gst_queue_locked_spin (GstQueue * queue, volatile gint * cookie,
+    guint * budget)
+{
+  gint old;
+  guint i, spins = *budget;
+  gboolean res;
+
+  if (!queue_can_spin)
+    return queue->srcresult != GST_FLOW_OK;
+
+  old = g_atomic_int_get (cookie);
+  GST_QUEUE_MUTEX_UNLOCK (queue);
+  for (i = 0; i < spins; i++) {
+    if (g_atomic_int_get (cookie) != old)
+      break;
+    QUEUE_CPU_RELAX ();
+  }
+  GST_QUEUE_MUTEX_LOCK (queue);
+
+  /* the cookie is only changed with the lock, so when it did not change now we
+   * can't miss the signal anymore */
+  res = g_atomic_int_get (cookie) != old || queue->srcresult != GST_FLOW_OK;
+
+  if (i < spins)
+    *budget = MIN (spins * 2, QUEUE_SPIN_MAX);
+  else
+    *budget = MAX (spins / 2, QUEUE_SPIN_MIN);
+
+  return res;
+}
+
 static gboolean
 gst_queue_is_filled (GstQueue * queue)
 {
@@ -1163,6 +1339,7 @@ gst_queue_push_one (GstQueue * queue)
 next:
   if (GST_IS_BUFFER (data)) {
     GstBuffer *buffer;
+    GstStructure *stats = NULL;
 
     buffer = GST_BUFFER_CAST (data);
 
@@ -1178,7 +1355,17 @@ next:
       queue->head_needs_discont = FALSE;
     }
 
+    if (G_UNLIKELY (queue->post_stats)) {
+      stats = gst_queue_stats_to_structure (&queue->stats, "GstQueueStats");
+      queue->post_stats = FALSE;
+    }
+
     GST_QUEUE_MUTEX_UNLOCK (queue);
+
+    if (stats)
+      gst_element_post_message (GST_ELEMENT_CAST (queue),
+          gst_message_new_element (GST_OBJECT_CAST (queue), stats));
+
     result = gst_pad_push (queue->srcpad, buffer);
 
     /* need to check for srcresult here as well */
@@ -1471,13 +1658,15 @@ gst_queue_sink_activate_mode (GstPad * pad, GstObject * parent, GstPadMode mode,
         queue->srcresult = GST_FLOW_OK;
         queue->eos = FALSE;
         queue->unexpected = FALSE;
+        gst_queue_stats_reset (&queue->stats);
+        queue->post_stats = FALSE;
         GST_QUEUE_MUTEX_UNLOCK (queue);
       } else {
         /* step 1, unblock chain function */
         GST_QUEUE_MUTEX_LOCK (queue);
         queue->srcresult = GST_FLOW_FLUSHING;
         /* the item del signal will unblock */
-        g_cond_signal (&queue->item_del);
+        GST_QUEUE_SIGNAL_DEL (queue);
         /* unblock query handler */
         queue->last_query = FALSE;
         g_cond_signal (&queue->query_handled);
@@ -1524,7 +1713,7 @@ gst_queue_src_activate_mode (GstPad * pad, GstObject * parent, GstPadMode mode,
         GST_QUEUE_MUTEX_LOCK (queue);
         queue->srcresult = GST_FLOW_FLUSHING;
         /* the item add signal will unblock */
-        g_cond_signal (&queue->item_add);
+        GST_QUEUE_SIGNAL_ADD (queue);
         GST_QUEUE_MUTEX_UNLOCK (queue);
 
         /* step 2, make sure streaming finishes */
@@ -1605,6 +1794,12 @@ gst_queue_set_property (GObject * object,
     case PROP_FLUSH_ON_EOS:
       queue->flush_on_eos = g_value_get_boolean (value);
       break;
+    case PROP_COLLECT_STATS:
+      queue->collect_stats = g_value_get_boolean (value);
+      break;
+    case PROP_STATS_INTERVAL:
+      queue->stats_interval = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1658,6 +1853,16 @@ gst_queue_get_property (GObject * object,
     case PROP_FLUSH_ON_EOS:
       g_value_set_boolean (value, queue->flush_on_eos);
       break;
+    case PROP_COLLECT_STATS:
+      g_value_set_boolean (value, queue->collect_stats);
+      break;
+    case PROP_STATS:
+      g_value_take_boxed (value,
+          gst_queue_stats_to_structure (&queue->stats, "GstQueueStats"));
+      break;
+    case PROP_STATS_INTERVAL:
+      g_value_set_uint (value, queue->stats_interval);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -26,6 +26,7 @@
 
 #include <gst/gst.h>
 #include <gst/base/gstqueuearray.h>
+#include "gstelements_private.h"
 
 G_BEGIN_DECLS
 
@@ -125,6 +126,13 @@ struct _GstQueue {
   gboolean waiting_del;
   GCond item_del;      /* signals space now available for writing */
 
+  /* bumped on every ADD/DEL signal, so that the other side can spin on them
+   * for a while before going to sleep on the conditions */
+  volatile gint add_cookie;
+  volatile gint del_cookie;
+  guint spin_add;      /* current spin budget of the loop function */
+  guint spin_del;      /* current spin budget of the chain function */
+
   gboolean head_needs_discont, tail_needs_discont;
   gboolean push_newsegment;
 
@@ -137,6 +145,12 @@ struct _GstQueue {
   gboolean last_query;
 
   gboolean flush_on_eos; /* flush on EOS */
+
+  /* residence time and fill level statistics, with QUEUE_LOCK */
+  gboolean collect_stats;
+  guint stats_interval;
+  gboolean post_stats;  /* the stats interval was reached */
+  GstQueueStats stats;
 };
 
 struct _GstQueueClass {
@@ -110,6 +110,8 @@ enum
 #define DEFAULT_HIGH_PERCENT       99
 #define DEFAULT_TEMP_REMOVE        TRUE
 #define DEFAULT_RING_BUFFER_MAX_SIZE 0
+#define DEFAULT_COLLECT_STATS      FALSE
+#define DEFAULT_STATS_INTERVAL     0
 
 enum
 {
@@ -128,6 +130,9 @@ enum
   PROP_TEMP_LOCATION,
   PROP_TEMP_REMOVE,
   PROP_RING_BUFFER_MAX_SIZE,
+  PROP_COLLECT_STATS,
+  PROP_STATS,
+  PROP_STATS_INTERVAL,
   PROP_LAST
 };
 
@@ -279,6 +284,7 @@ typedef struct
 {
   GstQueue2ItemType type;
   GstMiniObject *item;
+  GstClockTime in_time;         /* when the item entered, for the stats */
 } GstQueue2Item;
 
 /* static guint gst_queue2_signals[LAST_SIGNAL] = { 0 }; */
@@ -380,6 +386,54 @@ gst_queue2_class_init (GstQueue2Class * klass)
           0, G_MAXUINT64, DEFAULT_RING_BUFFER_MAX_SIZE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstQueue2:collect-stats
+   *
+   * Record how long buffers stay in the queue and how full the queue is
+   * when a buffer enters it. The results are available in the
+   * #GstQueue2:stats property. Collecting costs two timestamps per buffer, so
+   * it is disabled by default.
+   *
+   * Since: 1.6
+   */
+  g_object_class_install_property (gobject_class, PROP_COLLECT_STATS,
+      g_param_spec_boolean ("collect-stats", "Collect stats",
+          "Collect residence time and fill level statistics",
+          DEFAULT_COLLECT_STATS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstQueue2:stats
+   *
+   * Statistics collected when #GstQueue2:collect-stats is enabled. This
+   * property returns a #GstStructure with name "GstQueue2Stats" with the
+   * same fields as the #GstQueue:stats structure of queue. Buffer lists
+   * count as one buffer.
+   *
+   * The residence times are only recorded when the data is kept in memory,
+   * not when it goes to a temp file or ring buffer. In ring buffer mode the
+   * fill level is that of the ring buffer.
+   *
+   * Since: 1.6
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Residence time and fill level statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstQueue2:stats-interval
+   *
+   * Post an element message with the #GstQueue2:stats structure every
+   * stats-interval buffers that left the queue. 0 disables posting.
+   *
+   * Since: 1.6
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS_INTERVAL,
+      g_param_spec_uint ("stats-interval", "Stats interval",
+          "Post the stats as element message every this many buffers "
+          "(0 = never)", 0, G_MAXUINT, DEFAULT_STATS_INTERVAL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /* set several parent class virtual functions */
   gobject_class->finalize = gst_queue2_finalize;
 
@@ -475,6 +529,10 @@ gst_queue2_init (GstQueue2 * queue)
   queue->ring_buffer = NULL;
   queue->ring_buffer_max_size = DEFAULT_RING_BUFFER_MAX_SIZE;
 
+  queue->collect_stats = DEFAULT_COLLECT_STATS;
+  queue->stats_interval = DEFAULT_STATS_INTERVAL;
+  gst_queue_stats_reset (&queue->stats);
+
   GST_DEBUG_OBJECT (queue,
       "initialized queue's not_empty & not_full conditions");
 }
@@ -1990,6 +2048,29 @@ buffer_list_calc_size (GstBuffer ** buf, guint idx, gpointer data)
   return TRUE;
 }
 
+/* the fill level of the limit that is closest to being reached, in percent */
+static guint
+gst_queue2_fill_level (GstQueue2 * queue)
+{
+  guint percent;
+
+  if (QUEUE_IS_USING_RING_BUFFER (queue))
+    return gst_queue_stats_percent (queue->cur_level.bytes,
+        QUEUE_MAX_BYTES (queue));
+
+  percent = gst_queue_stats_percent (queue->cur_level.buffers,
+      queue->max_level.buffers);
+  percent = MAX (percent, gst_queue_stats_percent (queue->cur_level.bytes,
+          queue->max_level.bytes));
+  percent = MAX (percent, gst_queue_stats_percent (queue->cur_level.time,
+          queue->max_level.time));
+  if (queue->use_rate_estimate)
+    percent = MAX (percent, gst_queue_stats_percent (queue->cur_level.rate_time,
+            queue->max_level.rate_time));
+
+  return percent;
+}
+
 /* enqueue an item an update the level stats */
 static void
 gst_queue2_locked_enqueue (GstQueue2 * queue, gpointer item,
@@ -2113,14 +2194,24 @@ gst_queue2_locked_enqueue (GstQueue2 * queue, gpointer item,
   }
 
   if (item) {
+    GstClockTime in_time = GST_CLOCK_TIME_NONE;
+
     /* update the buffering status */
     if (queue->use_buffering)
       update_buffering (queue);
 
+    if (G_UNLIKELY (queue->collect_stats) &&
+        (item_type == GST_QUEUE2_ITEM_TYPE_BUFFER ||
+            item_type == GST_QUEUE2_ITEM_TYPE_BUFFER_LIST)) {
+      in_time = gst_util_get_timestamp ();
+      gst_queue_stats_add_level (&queue->stats, gst_queue2_fill_level (queue));
+    }
+
     if (QUEUE_IS_USING_QUEUE (queue)) {
       GstQueue2Item *qitem = g_slice_new (GstQueue2Item);
       qitem->type = item_type;
       qitem->item = item;
+      qitem->in_time = in_time;
       g_queue_push_tail (&queue->queue, qitem);
     } else {
       gst_mini_object_unref (GST_MINI_OBJECT_CAST (item));
@@ -2148,6 +2239,7 @@ static GstMiniObject *
 gst_queue2_locked_dequeue (GstQueue2 * queue, GstQueue2ItemType * item_type)
 {
   GstMiniObject *item;
+  GstClockTime in_time = GST_CLOCK_TIME_NONE;
 
   if (!QUEUE_IS_USING_QUEUE (queue)) {
     item = gst_queue2_read_item_from_file (queue);
@@ -2158,6 +2250,7 @@ gst_queue2_locked_dequeue (GstQueue2 * queue, GstQueue2ItemType * item_type)
       goto no_item;
 
     item = qitem->item;
+    in_time = qitem->in_time;
     g_slice_free (GstQueue2Item, qitem);
   }
 
@@ -2244,6 +2337,15 @@ gst_queue2_locked_dequeue (GstQueue2 * queue, GstQueue2ItemType * item_type)
     item = NULL;
     *item_type = GST_QUEUE2_ITEM_TYPE_UNKNOWN;
   }
+
+  /* only buffers and buffer lists have a time */
+  if (G_UNLIKELY (GST_CLOCK_TIME_IS_VALID (in_time))) {
+    gst_queue_stats_add_time (&queue->stats,
+        gst_util_get_timestamp () - in_time);
+    if (queue->stats_interval > 0 &&
+        queue->stats.buffers % queue->stats_interval == 0)
+      queue->post_stats = TRUE;
+  }
   GST_QUEUE2_SIGNAL_DEL (queue);
 
   return item;
@@ -2670,6 +2772,7 @@ gst_queue2_push_one (GstQueue2 * queue)
   GstFlowReturn result = queue->srcresult;
   GstMiniObject *data;
   GstQueue2ItemType item_type;
+  GstStructure *stats;
 
   data = gst_queue2_locked_dequeue (queue, &item_type);
   if (data == NULL)
@@ -2680,8 +2783,16 @@ next:
   g_atomic_int_set (&queue->downstream_may_block,
       item_type == GST_QUEUE2_ITEM_TYPE_BUFFER ||
       item_type == GST_QUEUE2_ITEM_TYPE_BUFFER_LIST);
+  stats = NULL;
+  if (G_UNLIKELY (queue->post_stats)) {
+    stats = gst_queue_stats_to_structure (&queue->stats, "GstQueue2Stats");
+    queue->post_stats = FALSE;
+  }
   GST_QUEUE2_MUTEX_UNLOCK (queue);
   gst_queue2_post_buffering (queue);
+  if (stats)
+    gst_element_post_message (GST_ELEMENT_CAST (queue),
+        gst_message_new_element (GST_OBJECT_CAST (queue), stats));
 
   if (item_type == GST_QUEUE2_ITEM_TYPE_BUFFER) {
     GstBuffer *buffer;
@@ -3203,6 +3314,8 @@ gst_queue2_sink_activate_mode (GstPad * pad, GstObject * parent,
         queue->is_eos = FALSE;
         queue->unexpected = FALSE;
         reset_rate_timer (queue);
+        gst_queue_stats_reset (&queue->stats);
+        queue->post_stats = FALSE;
         GST_QUEUE2_MUTEX_UNLOCK (queue);
       } else {
         /* unblock chain function */
@@ -3517,6 +3630,12 @@ gst_queue2_set_property (GObject * object,
     case PROP_RING_BUFFER_MAX_SIZE:
       queue->ring_buffer_max_size = g_value_get_uint64 (value);
       break;
+    case PROP_COLLECT_STATS:
+      queue->collect_stats = g_value_get_boolean (value);
+      break;
+    case PROP_STATS_INTERVAL:
+      queue->stats_interval = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3577,6 +3696,16 @@ gst_queue2_get_property (GObject * object,
     case PROP_RING_BUFFER_MAX_SIZE:
       g_value_set_uint64 (value, queue->ring_buffer_max_size);
       break;
+    case PROP_COLLECT_STATS:
+      g_value_set_boolean (value, queue->collect_stats);
+      break;
+    case PROP_STATS:
+      g_value_take_boxed (value,
+          gst_queue_stats_to_structure (&queue->stats, "GstQueue2Stats"));
+      break;
+    case PROP_STATS_INTERVAL:
+      g_value_set_uint (value, queue->stats_interval);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -26,6 +26,7 @@
 
 #include <gst/gst.h>
 #include <stdio.h>
+#include "gstelements_private.h"
 
 G_BEGIN_DECLS
 
@@ -160,6 +161,12 @@ struct _GstQueue2
   gint avg_out;
   gboolean percent_changed;
   GMutex buffering_post_lock; /* assures only one posted at a time */
+
+  /* residence time and fill level statistics, with QUEUE_LOCK */
+  gboolean collect_stats;
+  guint stats_interval;
+  gboolean post_stats;         /* the stats interval was reached */
+  GstQueueStats stats;
 };
 
 struct _GstQueue2Class
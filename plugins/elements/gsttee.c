@@ -34,6 +34,11 @@
  * provide separate threads for each branch. Otherwise a blocked dataflow in one
  * branch would stall the other branches.
  *
+ * Alternatively, with the #GstTee:parallel property set, every src pad gets its
+ * own streaming thread and a bounded output queue. The size of that queue and
+ * what happens when it is full is configured with the "max-size-buffers" and
+ * "leaky" properties of the requested src pads.
+ *
  * <refsect2>
  * <title>Example launch line</title>
  * |[
@@ -50,6 +55,8 @@
 #include "gsttee.h"
 #include "gst/glib-compat-private.h"
 
+#include <gst/base/gstqueuearray.h>
+
 #include <string.h>
 #include <stdio.h>
 
@@ -79,11 +86,35 @@ gst_tee_pull_mode_get_type (void)
   return type;
 }
 
+#define GST_TYPE_TEE_PAD_LEAKY (gst_tee_pad_leaky_get_type())
+static GType
+gst_tee_pad_leaky_get_type (void)
+{
+  static GType type = 0;
+  static const GEnumValue data[] = {
+    {GST_TEE_PAD_LEAKY_NO, "Not Leaky", "no"},
+    {GST_TEE_PAD_LEAKY_UPSTREAM, "Leaky on upstream (new buffers)",
+        "upstream"},
+    {GST_TEE_PAD_LEAKY_DOWNSTREAM, "Leaky on downstream (old buffers)",
+        "downstream"},
+    {0, NULL, NULL},
+  };
+
+  if (!type) {
+    type = g_enum_register_static ("GstTeePadLeaky", data);
+  }
+  return type;
+}
+
 #define DEFAULT_PROP_NUM_SRC_PADS	0
 #define DEFAULT_PROP_HAS_CHAIN		TRUE
 #define DEFAULT_PROP_SILENT		TRUE
 #define DEFAULT_PROP_LAST_MESSAGE	NULL
 #define DEFAULT_PULL_MODE		GST_TEE_PULL_MODE_NEVER
+#define DEFAULT_PROP_PARALLEL		FALSE
+
+#define DEFAULT_PAD_MAX_SIZE_BUFFERS	16
+#define DEFAULT_PAD_LEAKY		GST_TEE_PAD_LEAKY_NO
 
 enum
 {
@@ -94,6 +125,14 @@ enum
   PROP_LAST_MESSAGE,
   PROP_PULL_MODE,
   PROP_ALLOC_PAD,
+  PROP_PARALLEL,
+};
+
+enum
+{
+  PROP_PAD_0,
+  PROP_PAD_MAX_SIZE_BUFFERS,
+  PROP_PAD_LEAKY,
 };
 
 static GstStaticPadTemplate tee_src_template =
@@ -136,6 +175,22 @@ struct _GstTeePad
   gboolean pushed;
   GstFlowReturn result;
   gboolean removed;
+
+  /* parallel mode */
+  gboolean parallel;            /* start an output thread on activation */
+  gboolean threaded;            /* the output thread is running, ATOMIC */
+
+  GMutex lock;                  /* protects all fields below */
+  GCond cond;
+  GstQueueArray *queue;         /* buffers, buffer lists and events */
+  guint n_buffers;              /* buffers and buffer lists in queue */
+  gboolean busy;                /* output thread is pushing an item */
+  guint waiting;                /* threads waiting on cond for space/drain */
+  gboolean flushing;
+  GstFlowReturn srcresult;      /* last result of the output thread */
+
+  guint max_size_buffers;
+  GstTeePadLeaky leaky;
 };
 
 struct _GstTeePadClass
@@ -145,9 +200,98 @@ struct _GstTeePadClass
 
 G_DEFINE_TYPE (GstTeePad, gst_tee_pad, GST_TYPE_PAD);
 
+#define GST_TEE_PAD_LOCK(pad) g_mutex_lock (&(pad)->lock)
+#define GST_TEE_PAD_UNLOCK(pad) g_mutex_unlock (&(pad)->lock)
+
+/* drop everything that is queued, must be called with the pad lock */
+static void
+gst_tee_pad_clear (GstTeePad * pad)
+{
+  GstMiniObject *item;
+
+  while ((item = gst_queue_array_pop_head (pad->queue)))
+    gst_mini_object_unref (item);
+  pad->n_buffers = 0;
+  g_cond_broadcast (&pad->cond);
+}
+
+static void
+gst_tee_pad_finalize (GObject * object)
+{
+  GstTeePad *pad = GST_TEE_PAD_CAST (object);
+
+  gst_tee_pad_clear (pad);
+  gst_queue_array_free (pad->queue);
+  g_mutex_clear (&pad->lock);
+  g_cond_clear (&pad->cond);
+
+  G_OBJECT_CLASS (gst_tee_pad_parent_class)->finalize (object);
+}
+
+static void
+gst_tee_pad_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstTeePad *pad = GST_TEE_PAD_CAST (object);
+
+  GST_TEE_PAD_LOCK (pad);
+  switch (prop_id) {
+    case PROP_PAD_MAX_SIZE_BUFFERS:
+      pad->max_size_buffers = g_value_get_uint (value);
+      break;
+    case PROP_PAD_LEAKY:
+      pad->leaky = (GstTeePadLeaky) g_value_get_enum (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  /* upstream might be waiting for space */
+  g_cond_broadcast (&pad->cond);
+  GST_TEE_PAD_UNLOCK (pad);
+}
+
+static void
+gst_tee_pad_get_property (GObject * object, guint prop_id, GValue * value,
+    GParamSpec * pspec)
+{
+  GstTeePad *pad = GST_TEE_PAD_CAST (object);
+
+  GST_TEE_PAD_LOCK (pad);
+  switch (prop_id) {
+    case PROP_PAD_MAX_SIZE_BUFFERS:
+      g_value_set_uint (value, pad->max_size_buffers);
+      break;
+    case PROP_PAD_LEAKY:
+      g_value_set_enum (value, pad->leaky);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_TEE_PAD_UNLOCK (pad);
+}
+
 static void
 gst_tee_pad_class_init (GstTeePadClass * klass)
 {
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->finalize = gst_tee_pad_finalize;
+  gobject_class->set_property = gst_tee_pad_set_property;
+  gobject_class->get_property = gst_tee_pad_get_property;
+
+  g_object_class_install_property (gobject_class, PROP_PAD_MAX_SIZE_BUFFERS,
+      g_param_spec_uint ("max-size-buffers", "Max. size (buffers)",
+          "Max. number of buffers queued for the output thread of this pad "
+          "in parallel mode (0=unlimited)", 0, G_MAXUINT,
+          DEFAULT_PAD_MAX_SIZE_BUFFERS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_PAD_LEAKY,
+      g_param_spec_enum ("leaky", "Leaky",
+          "Where the output queue of this pad leaks in parallel mode, if at "
+          "all", GST_TYPE_TEE_PAD_LEAKY, DEFAULT_PAD_LEAKY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -162,6 +306,214 @@ static void
 gst_tee_pad_init (GstTeePad * pad)
 {
   gst_tee_pad_reset (pad);
+
+  g_mutex_init (&pad->lock);
+  g_cond_init (&pad->cond);
+  pad->queue = gst_queue_array_new (DEFAULT_PAD_MAX_SIZE_BUFFERS);
+  pad->flushing = TRUE;
+  pad->srcresult = GST_FLOW_FLUSHING;
+  pad->max_size_buffers = DEFAULT_PAD_MAX_SIZE_BUFFERS;
+  pad->leaky = DEFAULT_PAD_LEAKY;
+}
+
+static gint
+is_data_item (gconstpointer item, gconstpointer unused)
+{
+  return (GST_IS_BUFFER (item) || GST_IS_BUFFER_LIST (item)) ? 0 : 1;
+}
+
+#define IS_RUNNING_RESULT(ret) \
+    ((ret) == GST_FLOW_OK || (ret) == GST_FLOW_NOT_LINKED)
+
+static void gst_tee_pad_loop (GstTeePad * pad);
+
+/* hand @item over to the output thread of @pad, takes ownership of @item.
+ * Returns the last result of the output thread. */
+static GstFlowReturn
+gst_tee_pad_enqueue (GstTeePad * pad, GstMiniObject * item)
+{
+  gboolean is_data = GST_IS_BUFFER (item) || GST_IS_BUFFER_LIST (item);
+  GstFlowReturn ret;
+
+  GST_TEE_PAD_LOCK (pad);
+  /* like queue, start pushing again for a new stream or segment after EOS */
+  if (G_UNLIKELY (pad->srcresult == GST_FLOW_EOS) && !pad->flushing
+      && GST_IS_EVENT (item)
+      && (GST_EVENT_TYPE (item) == GST_EVENT_STREAM_START
+          || GST_EVENT_TYPE (item) == GST_EVENT_SEGMENT)) {
+    GST_DEBUG_OBJECT (pad, "restarting output thread after EOS");
+    pad->srcresult = GST_FLOW_OK;
+    gst_pad_start_task (GST_PAD_CAST (pad),
+        (GstTaskFunction) gst_tee_pad_loop, pad, NULL);
+  }
+
+  while (is_data && item && pad->max_size_buffers > 0
+      && pad->n_buffers >= pad->max_size_buffers
+      && IS_RUNNING_RESULT (pad->srcresult)) {
+    switch (pad->leaky) {
+      case GST_TEE_PAD_LEAKY_UPSTREAM:
+        GST_DEBUG_OBJECT (pad, "queue is full, dropping new buffer");
+        gst_mini_object_unref (item);
+        item = NULL;
+        break;
+      case GST_TEE_PAD_LEAKY_DOWNSTREAM:
+      {
+        guint idx = gst_queue_array_find (pad->queue, is_data_item, NULL);
+
+        GST_DEBUG_OBJECT (pad, "queue is full, dropping oldest buffer");
+        gst_mini_object_unref (gst_queue_array_drop_element (pad->queue, idx));
+        pad->n_buffers--;
+        break;
+      }
+      default:
+        GST_LOG_OBJECT (pad, "queue is full, waiting for space");
+        pad->waiting++;
+        g_cond_wait (&pad->cond, &pad->lock);
+        pad->waiting--;
+        break;
+    }
+  }
+
+  ret = pad->srcresult;
+  if (item) {
+    if (G_UNLIKELY (!IS_RUNNING_RESULT (ret))) {
+      GST_LOG_OBJECT (pad, "dropping %" GST_PTR_FORMAT ", output thread "
+          "stopped with %s", item, gst_flow_get_name (ret));
+      gst_mini_object_unref (item);
+    } else {
+      gst_queue_array_push_tail (pad->queue, item);
+      if (is_data)
+        pad->n_buffers++;
+      /* the output thread only waits when the queue is empty */
+      if (gst_queue_array_get_length (pad->queue) == 1)
+        g_cond_broadcast (&pad->cond);
+    }
+  }
+  GST_TEE_PAD_UNLOCK (pad);
+
+  return ret;
+}
+
+/* wait until the output thread pushed everything that was queued */
+static void
+gst_tee_pad_wait_drained (GstTeePad * pad)
+{
+  GST_TEE_PAD_LOCK (pad);
+  pad->waiting++;
+  while ((!gst_queue_array_is_empty (pad->queue) || pad->busy)
+      && IS_RUNNING_RESULT (pad->srcresult))
+    g_cond_wait (&pad->cond, &pad->lock);
+  pad->waiting--;
+  GST_TEE_PAD_UNLOCK (pad);
+}
+
+static void
+gst_tee_pad_loop (GstTeePad * pad)
+{
+  GstMiniObject *item;
+  GstFlowReturn ret;
+  gboolean is_data;
+
+  GST_TEE_PAD_LOCK (pad);
+  while (!pad->flushing && gst_queue_array_is_empty (pad->queue))
+    g_cond_wait (&pad->cond, &pad->lock);
+  if (pad->flushing)
+    goto flushing;
+
+  item = gst_queue_array_pop_head (pad->queue);
+  is_data = GST_IS_BUFFER (item) || GST_IS_BUFFER_LIST (item);
+  if (is_data)
+    pad->n_buffers--;
+  pad->busy = TRUE;
+  if (pad->waiting)
+    g_cond_broadcast (&pad->cond);
+  GST_TEE_PAD_UNLOCK (pad);
+
+  if (GST_IS_BUFFER (item)) {
+    ret = gst_pad_push (GST_PAD_CAST (pad), GST_BUFFER_CAST (item));
+  } else if (GST_IS_BUFFER_LIST (item)) {
+    ret = gst_pad_push_list (GST_PAD_CAST (pad), GST_BUFFER_LIST_CAST (item));
+  } else {
+    GstEvent *event = GST_EVENT_CAST (item);
+
+    ret = GST_FLOW_OK;
+    if (GST_EVENT_TYPE (event) == GST_EVENT_EOS)
+      ret = GST_FLOW_EOS;
+    gst_pad_push_event (GST_PAD_CAST (pad), event);
+  }
+
+  GST_TEE_PAD_LOCK (pad);
+  pad->busy = FALSE;
+  if (pad->flushing)
+    goto flushing;
+  /* events don't change the result of the buffers */
+  if (is_data || ret == GST_FLOW_EOS)
+    pad->srcresult = ret;
+  if (pad->waiting)
+    g_cond_broadcast (&pad->cond);
+  if (!IS_RUNNING_RESULT (ret))
+    goto pause;
+  GST_TEE_PAD_UNLOCK (pad);
+
+  return;
+
+flushing:
+  {
+    GST_DEBUG_OBJECT (pad, "pausing output thread, flushing");
+    GST_TEE_PAD_UNLOCK (pad);
+    gst_pad_pause_task (GST_PAD_CAST (pad));
+    return;
+  }
+pause:
+  {
+    GST_DEBUG_OBJECT (pad, "pausing output thread, reason %s",
+        gst_flow_get_name (ret));
+    /* upstream gets our result, nothing is pushed anymore until a flush or
+     * a new segment. Pause with the lock so that a restart can't come before
+     * the pause. */
+    gst_tee_pad_clear (pad);
+    gst_pad_pause_task (GST_PAD_CAST (pad));
+    GST_TEE_PAD_UNLOCK (pad);
+    return;
+  }
+}
+
+static gboolean
+gst_tee_pad_start (GstTeePad * pad)
+{
+  GST_TEE_PAD_LOCK (pad);
+  pad->flushing = FALSE;
+  pad->srcresult = GST_FLOW_OK;
+  g_atomic_int_set (&pad->threaded, TRUE);
+  GST_TEE_PAD_UNLOCK (pad);
+
+  GST_DEBUG_OBJECT (pad, "starting output thread");
+  return gst_pad_start_task (GST_PAD_CAST (pad),
+      (GstTaskFunction) gst_tee_pad_loop, pad, NULL);
+}
+
+static void
+gst_tee_pad_set_flushing (GstTeePad * pad)
+{
+  GST_TEE_PAD_LOCK (pad);
+  pad->flushing = TRUE;
+  pad->srcresult = GST_FLOW_FLUSHING;
+  gst_tee_pad_clear (pad);
+  GST_TEE_PAD_UNLOCK (pad);
+}
+
+static gboolean
+gst_tee_pad_stop (GstTeePad * pad)
+{
+  gboolean res;
+
+  GST_DEBUG_OBJECT (pad, "stopping output thread");
+  gst_tee_pad_set_flushing (pad);
+  res = gst_pad_stop_task (GST_PAD_CAST (pad));
+
+  g_atomic_int_set (&pad->threaded, FALSE);
+
+  return res;
 }
 
 static GstPad *gst_tee_request_new_pad (GstElement * element,
@@ -264,6 +616,12 @@ gst_tee_class_init (GstTeeClass * klass)
       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
   g_object_class_install_property (gobject_class, PROP_ALLOC_PAD,
       pspec_alloc_pad);
+  g_object_class_install_property (gobject_class, PROP_PARALLEL,
+      g_param_spec_boolean ("parallel", "Parallel",
+          "Push on every src pad from a separate streaming thread",
+          DEFAULT_PROP_PARALLEL,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
 
   gst_element_class_set_static_metadata (gstelement_class,
       "Tee pipe fitting",
@@ -301,6 +659,7 @@ gst_tee_init (GstTee * tee)
   tee->pad_indexes = g_hash_table_new (NULL, NULL);
 
   tee->last_message = NULL;
+  tee->parallel = DEFAULT_PROP_PARALLEL;
 }
 
 static void
@@ -368,12 +727,17 @@ gst_tee_request_new_pad (GstElement * element, GstPadTemplate * templ,
           "name", name, "direction", templ->direction, "template", templ,
           NULL));
   GST_TEE_PAD_CAST (srcpad)->index = index;
+  GST_TEE_PAD_CAST (srcpad)->parallel = tee->parallel;
   g_free (name);
 
   mode = tee->sink_mode;
 
   GST_OBJECT_UNLOCK (tee);
 
+  /* set before activation, it starts the output thread in parallel mode */
+  gst_pad_set_activatemode_function (srcpad,
+      GST_DEBUG_FUNCPTR (gst_tee_src_activate_mode));
+
   switch (mode) {
     case GST_PAD_MODE_PULL:
       /* we already have a src pad in pull mode, and our pull mode can only be
@@ -389,8 +753,6 @@ gst_tee_request_new_pad (GstElement * element, GstPadTemplate * templ,
   if (!res)
     goto activate_failed;
 
-  gst_pad_set_activatemode_function (srcpad,
-      GST_DEBUG_FUNCPTR (gst_tee_src_activate_mode));
   gst_pad_set_query_function (srcpad, GST_DEBUG_FUNCPTR (gst_tee_src_query));
   gst_pad_set_getrange_function (srcpad,
       GST_DEBUG_FUNCPTR (gst_tee_src_get_range));
@@ -487,6 +849,16 @@ gst_tee_set_property (GObject * object, guint prop_id, const GValue * value,
       GST_OBJECT_UNLOCK (pad);
       break;
     }
+    case PROP_PARALLEL:
+    {
+      GList *pads;
+
+      tee->parallel = g_value_get_boolean (value);
+      /* only takes effect on the next activation of the pads */
+      for (pads = GST_ELEMENT_CAST (tee)->srcpads; pads; pads = pads->next)
+        GST_TEE_PAD_CAST (pads->data)->parallel = tee->parallel;
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -520,6 +892,9 @@ gst_tee_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_ALLOC_PAD:
       g_value_set_object (value, tee->allocpad);
       break;
+    case PROP_PARALLEL:
+      g_value_set_boolean (value, tee->parallel);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -527,26 +902,238 @@ gst_tee_get_property (GObject * object, guint prop_id, GValue * value,
   GST_OBJECT_UNLOCK (tee);
 }
 
+/* returns a copy of the srcpads list with a ref on each pad */
+static GList *
+gst_tee_ref_src_pads (GstTee * tee)
+{
+  GList *pads;
+
+  GST_OBJECT_LOCK (tee);
+  pads = g_list_copy (GST_ELEMENT_CAST (tee)->srcpads);
+  g_list_foreach (pads, (GFunc) gst_object_ref, NULL);
+  GST_OBJECT_UNLOCK (tee);
+
+  return pads;
+}
+
+/* in parallel mode, serialized events are queued behind the data on the
+ * pads that have an output thread */
+static gboolean
+gst_tee_queue_event (GstTee * tee, GstEvent * event)
+{
+  GList *pads, *walk;
+  gboolean res = FALSE, dispatched = FALSE;
+
+  pads = gst_tee_ref_src_pads (tee);
+  for (walk = pads; walk; walk = walk->next) {
+    GstTeePad *tpad = GST_TEE_PAD_CAST (walk->data);
+    GstFlowReturn ret;
+
+    if (GST_PAD_CAST (tpad) == tee->pull_pad)
+      continue;
+
+    dispatched = TRUE;
+    if (g_atomic_int_get (&tpad->threaded)) {
+      ret = gst_tee_pad_enqueue (tpad,
+          GST_MINI_OBJECT_CAST (gst_event_ref (event)));
+      res |= IS_RUNNING_RESULT (ret);
+    } else {
+      res |= gst_pad_push_event (GST_PAD_CAST (tpad), gst_event_ref (event));
+    }
+  }
+  g_list_free_full (pads, gst_object_unref);
+  gst_event_unref (event);
+
+  return dispatched ? res : TRUE;
+}
+
 static gboolean
 gst_tee_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
 {
-  gboolean res;
+  GstTee *tee = GST_TEE_CAST (parent);
+  gboolean res, parallel;
+  GList *pads, *walk;
+
+  GST_OBJECT_LOCK (tee);
+  parallel = tee->parallel;
+  GST_OBJECT_UNLOCK (tee);
 
   switch (GST_EVENT_TYPE (event)) {
-    default:
+    case GST_EVENT_FLUSH_START:
+      res = gst_pad_event_default (pad, parent, event);
+
+      /* downstream is unblocked now, wait for the output threads to stop */
+      pads = gst_tee_ref_src_pads (tee);
+      for (walk = pads; walk; walk = walk->next) {
+        GstTeePad *tpad = GST_TEE_PAD_CAST (walk->data);
+
+        if (g_atomic_int_get (&tpad->threaded)) {
+          gst_tee_pad_set_flushing (tpad);
+          gst_pad_pause_task (GST_PAD_CAST (tpad));
+        }
+      }
+      g_list_free_full (pads, gst_object_unref);
+      break;
+    case GST_EVENT_FLUSH_STOP:
       res = gst_pad_event_default (pad, parent, event);
+
+      pads = gst_tee_ref_src_pads (tee);
+      for (walk = pads; walk; walk = walk->next) {
+        GstTeePad *tpad = GST_TEE_PAD_CAST (walk->data);
+
+        if (g_atomic_int_get (&tpad->threaded))
+          gst_tee_pad_start (tpad);
+      }
+      g_list_free_full (pads, gst_object_unref);
+      break;
+    default:
+      if (parallel && GST_EVENT_IS_SERIALIZED (event))
+        res = gst_tee_queue_event (tee, event);
+      else
+        res = gst_pad_event_default (pad, parent, event);
       break;
   }
 
   return res;
 }
 
+/* before answering a serialized query in parallel mode, everything that was
+ * queued before it has to be pushed downstream */
+static void
+gst_tee_wait_drained (GstTee * tee)
+{
+  GList *pads, *walk;
+
+  pads = gst_tee_ref_src_pads (tee);
+  for (walk = pads; walk; walk = walk->next) {
+    GstTeePad *tpad = GST_TEE_PAD_CAST (walk->data);
+
+    if (g_atomic_int_get (&tpad->threaded))
+      gst_tee_pad_wait_drained (tpad);
+  }
+  g_list_free_full (pads, gst_object_unref);
+}
+
+/* in parallel mode, the branches don't wait for each other so the buffers
+ * can be shared. Merge the allocation answers of all branches into one that
+ * satisfies all of them. */
+static gboolean
+gst_tee_query_allocation (GstTee * tee, GstQuery * query)
+{
+  GList *pads, *walk;
+  GstCaps *caps;
+  gboolean need_pool, res = FALSE, first_alloc = TRUE;
+  GstAllocator *allocator = NULL;
+  GstAllocationParams params;
+  guint size = 0, min_buffers = 0;
+  guint i;
+
+  gst_query_parse_allocation (query, &caps, &need_pool);
+  gst_allocation_params_init (&params);
+
+  pads = gst_tee_ref_src_pads (tee);
+  for (walk = pads; walk; walk = walk->next) {
+    GstPad *srcpad = GST_PAD_CAST (walk->data);
+    GstQuery *q;
+
+    if (srcpad == tee->pull_pad || !gst_pad_is_linked (srcpad))
+      continue;
+
+    q = gst_query_new_allocation (caps, need_pool);
+    if (!gst_pad_peer_query (srcpad, q)) {
+      GST_DEBUG_OBJECT (srcpad, "allocation query failed");
+      gst_query_unref (q);
+      continue;
+    }
+
+    if (!res) {
+      /* the first answer gives the metas */
+      for (i = 0; i < gst_query_get_n_allocation_metas (q); i++) {
+        const GstStructure *mparams;
+        GType api = gst_query_parse_nth_allocation_meta (q, i, &mparams);
+
+        gst_query_add_allocation_meta (query, api, mparams);
+      }
+    } else {
+      /* later answers can only remove metas */
+      for (i = gst_query_get_n_allocation_metas (query); i > 0; i--) {
+        GType api = gst_query_parse_nth_allocation_meta (query, i - 1, NULL);
+
+        if (!gst_query_find_allocation_meta (q, api, NULL))
+          gst_query_remove_nth_allocation_meta (query, i - 1);
+      }
+    }
+
+    if (gst_query_get_n_allocation_params (q) > 0) {
+      GstAllocator *alloc;
+      GstAllocationParams p;
+
+      gst_query_parse_nth_allocation_param (q, 0, &alloc, &p);
+      params.flags |= p.flags;
+      params.align = MAX (params.align, p.align);
+      params.prefix = MAX (params.prefix, p.prefix);
+      params.padding = MAX (params.padding, p.padding);
+
+      /* only use an allocator all branches agree on */
+      if (first_alloc) {
+        allocator = alloc;
+        first_alloc = FALSE;
+      } else {
+        if (alloc != allocator) {
+          if (allocator)
+            gst_object_unref (allocator);
+          allocator = NULL;
+        }
+        if (alloc)
+          gst_object_unref (alloc);
+      }
+    }
+
+    if (gst_query_get_n_allocation_pools (q) > 0) {
+      guint psize, pmin;
+
+      gst_query_parse_nth_allocation_pool (q, 0, NULL, &psize, &pmin, NULL);
+      size = MAX (size, psize);
+      /* every branch can hold on to its buffers at the same time */
+      min_buffers += pmin;
+    }
+
+    res = TRUE;
+    gst_query_unref (q);
+  }
+  g_list_free_full (pads, gst_object_unref);
+
+  if (res) {
+    gst_query_add_allocation_param (query, allocator, &params);
+    if (size > 0 || min_buffers > 0)
+      gst_query_add_allocation_pool (query, NULL, size, min_buffers, 0);
+  }
+  if (allocator)
+    gst_object_unref (allocator);
+
+  return res;
+}
+
 static gboolean
 gst_tee_sink_query (GstPad * pad, GstObject * parent, GstQuery * query)
 {
-  gboolean res;
+  GstTee *tee = GST_TEE_CAST (parent);
+  gboolean res, parallel;
+
+  GST_OBJECT_LOCK (tee);
+  parallel = tee->parallel;
+  GST_OBJECT_UNLOCK (tee);
+
+  if (parallel && GST_QUERY_IS_SERIALIZED (query))
+    gst_tee_wait_drained (tee);
 
   switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_ALLOCATION:
+      if (parallel) {
+        res = gst_tee_query_allocation (tee, query);
+        break;
+      }
+      /* fall through */
     default:
       res = gst_pad_query_default (pad, parent, query);
       break;
@@ -583,6 +1170,9 @@ gst_tee_do_push (GstTee * tee, GstPad * pad, gpointer data, gboolean is_list)
   if (pad == tee->pull_pad) {
     /* don't push on the pad we're pulling from */
     res = GST_FLOW_OK;
+  } else if (g_atomic_int_get (&GST_TEE_PAD_CAST (pad)->threaded)) {
+    res = gst_tee_pad_enqueue (GST_TEE_PAD_CAST (pad),
+        gst_mini_object_ref (GST_MINI_OBJECT_CAST (data)));
   } else if (is_list) {
     res =
         gst_pad_push_list (pad,
@@ -628,6 +1218,9 @@ gst_tee_handle_data (GstTee * tee, gpointer data, gboolean is_list)
 
     if (pad == tee->pull_pad) {
       ret = GST_FLOW_OK;
+    } else if (g_atomic_int_get (&GST_TEE_PAD_CAST (pad)->threaded)) {
+      ret = gst_tee_pad_enqueue (GST_TEE_PAD_CAST (pad),
+          GST_MINI_OBJECT_CAST (data));
     } else if (is_list) {
       ret = gst_pad_push_list (pad, GST_BUFFER_LIST_CAST (data));
     } else {
@@ -801,9 +1394,22 @@ gst_tee_src_activate_mode (GstPad * pad, GstObject * parent, GstPadMode mode,
   gboolean res;
   GstPad *sinkpad;
 
-  tee = GST_TEE (parent);
+  /* can be NULL when the pad is activated before it is added */
+  tee = GST_TEE_CAST (parent);
 
   switch (mode) {
+    case GST_PAD_MODE_PUSH:
+    {
+      GstTeePad *tpad = GST_TEE_PAD_CAST (pad);
+
+      if (active && tpad->parallel)
+        res = gst_tee_pad_start (tpad);
+      else if (!active && g_atomic_int_get (&tpad->threaded))
+        res = gst_tee_pad_stop (tpad);
+      else
+        res = TRUE;
+      break;
+    }
     case GST_PAD_MODE_PULL:
     {
       GST_OBJECT_LOCK (tee);
@@ -57,6 +57,21 @@ typedef enum {
   GST_TEE_PULL_MODE_SINGLE,
 } GstTeePullMode;
 
+/**
+ * GstTeePadLeaky:
+ * @GST_TEE_PAD_LEAKY_NO: Block upstream when the output queue is full.
+ * @GST_TEE_PAD_LEAKY_UPSTREAM: Drop new buffers when the output queue is full.
+ * @GST_TEE_PAD_LEAKY_DOWNSTREAM: Drop the oldest buffer when the output queue
+ *   is full.
+ *
+ * What a src pad does when its output queue is full in parallel mode.
+ */
+typedef enum {
+  GST_TEE_PAD_LEAKY_NO,
+  GST_TEE_PAD_LEAKY_UPSTREAM,
+  GST_TEE_PAD_LEAKY_DOWNSTREAM
+} GstTeePadLeaky;
+
 /**
  * GstTee:
  *
@@ -79,6 +94,8 @@ struct _GstTee {
   GstPadMode      sink_mode;
   GstTeePullMode  pull_mode;
   GstPad         *pull_pad;
+
+  gboolean        parallel;
 };
 
 struct _GstTeeClass {
@@ -1,7 +1,7 @@
 /* GStreamer
  * Copyright (C) 2005 Andy Wingo <wingo@pobox.com>
  *
- * caps.c: benchmark for caps creation and destruction
+ * caps.c: benchmark for caps creation, destruction and intersection
  *
  * This library is free software; you can redistribute it and/or
  * modify it under the terms of the GNU Library General Public
@@ -45,7 +45,7 @@ gint
 main (gint argc, gchar * argv[])
 {
   GstCaps **capses;
-  GstCaps *protocaps;
+  GstCaps *protocaps, *fixedcaps;
   GstClockTime start, end;
   gint i;
 
@@ -69,6 +69,29 @@ main (gint argc, gchar * argv[])
       GST_TIME_ARGS (end - start), i);
 
   g_free (capses);
+
+  /* fixed caps against the template caps, hits the value vs range and value
+   * vs list intersect and subset functions */
+  fixedcaps = gst_caps_from_string ("audio/x-raw, format = (string) S16LE, "
+      "rate = (int) 44100, channels = (int) 2");
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_CAPS; i++) {
+    GstCaps *res = gst_caps_intersect (fixedcaps, protocaps);
+    gst_caps_unref (res);
+  }
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - intersecting %d caps\n",
+      GST_TIME_ARGS (end - start), i);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_CAPS; i++)
+    gst_caps_is_subset (fixedcaps, protocaps);
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - checking %d caps for subset\n",
+      GST_TIME_ARGS (end - start), i);
+
+  gst_caps_unref (fixedcaps);
   gst_caps_unref (protocaps);
 
   return 0;
@@ -23,24 +23,47 @@
 
 #define BUFFER_COUNT (1000)
 
+/* put @e in @depth nested bins, the outer bin gets a ghost pad for the sink
+ * pad of @e. This makes the state changes of the sinks go through all the
+ * levels of the bin hierarchy. */
+static GstElement *
+nest_in_bins (GstElement * e, guint depth)
+{
+  GstElement *bin;
+  GstPad *pad;
+
+  while (depth--) {
+    bin = gst_bin_new (NULL);
+    gst_bin_add (GST_BIN (bin), e);
+    pad = gst_element_get_static_pad (e, "sink");
+    gst_element_add_pad (bin, gst_ghost_pad_new ("sink", pad));
+    gst_object_unref (pad);
+    e = bin;
+  }
+
+  return e;
+}
+
 gint
 main (gint argc, gchar * argv[])
 {
   GstMessage *msg;
   GstElement *pipeline, *src, *e;
   GSList *saved_src_list, *src_list, *new_src_list;
-  guint complexity_order, n_elements, i, j, max_this_level;
+  guint complexity_order, n_elements, depth, i, j, max_this_level;
   GstClockTime start, end;
 
   gst_init (&argc, &argv);
 
-  if (argc != 3) {
-    g_print ("usage: %s COMPLEXITY_ORDER N_ELEMENTS\n", argv[0]);
+  if (argc != 3 && argc != 4) {
+    g_print ("usage: %s COMPLEXITY_ORDER N_ELEMENTS [DEPTH]\n", argv[0]);
     return 1;
   }
 
   complexity_order = atoi (argv[1]);
   n_elements = atoi (argv[2]);
+  /* number of bins around each sink */
+  depth = argc == 4 ? atoi (argv[3]) : 0;
 
   start = gst_util_get_timestamp ();
 
@@ -79,6 +102,8 @@ main (gint argc, gchar * argv[])
       g_object_set (e, "preroll-queue-len", 1, NULL);
     }
     g_object_set (e, "silent", TRUE, NULL);
+    if (depth > 0 && GST_OBJECT_FLAG_IS_SET (e, GST_ELEMENT_FLAG_SINK))
+      e = nest_in_bins (e, depth);
     new_src_list = g_slist_prepend (new_src_list, e);
 
     gst_bin_add (GST_BIN (pipeline), e);
@@ -90,8 +115,9 @@ main (gint argc, gchar * argv[])
   g_slist_free (new_src_list);
 
   end = gst_util_get_timestamp ();
-  g_print ("%" GST_TIME_FORMAT " - creating and linking %u elements\n",
-      GST_TIME_ARGS (end - start), i);
+  g_print ("%" GST_TIME_FORMAT " - creating and linking %u elements, "
+      "fan-out %u, depth %u\n", GST_TIME_ARGS (end - start), i,
+      complexity_order, depth);
 
   start = gst_util_get_timestamp ();
   if (gst_element_set_state (pipeline,
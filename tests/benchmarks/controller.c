@@ -151,19 +151,48 @@ main (gint argc, gchar * argv[])
   printf ("random insert of control-points: %" GST_TIME_FORMAT "\n",
       GST_TIME_ARGS (elapsed));
 
+  /* read the control values in blocks as an audio element would, once for
+   * each interpolation mode */
   {
     GstClockTime sample_duration =
         gst_util_uint64_scale_int (1, GST_SECOND, 44100);
     gdouble *values = g_new0 (gdouble, BLOCK_SIZE * NUM_CP);
-
-    bt = gst_util_get_timestamp ();
-    gst_control_source_get_value_array (cs, 0, sample_duration,
-        BLOCK_SIZE * NUM_CP, values);
-    ct = gst_util_get_timestamp ();
+    GEnumClass *mode_class = g_type_class_ref (GST_TYPE_INTERPOLATION_MODE);
+    GEnumValue *mode;
+    gdouble rate;
+    guint m;
+
+    for (m = 0; m < mode_class->n_values; m++) {
+      mode = &mode_class->values[m];
+      g_object_set (cs, "mode", mode->value, NULL);
+
+      bt = gst_util_get_timestamp ();
+      gst_control_source_get_value_array (cs, 0, sample_duration,
+          BLOCK_SIZE * NUM_CP, values);
+      ct = gst_util_get_timestamp ();
+      elapsed = GST_CLOCK_DIFF (bt, ct);
+      rate = (BLOCK_SIZE * NUM_CP) / ((gdouble) elapsed / GST_SECOND);
+      printf ("%-6s array for control-points  : %" GST_TIME_FORMAT
+          " (%.0f samples/s)\n", mode->value_nick, GST_TIME_ARGS (elapsed),
+          rate);
+
+      bt = gst_util_get_timestamp ();
+      for (j = 0; j < NUM_CP; j++) {
+        gst_control_source_get_value_array (cs, j * BLOCK_SIZE *
+            sample_duration, sample_duration, BLOCK_SIZE,
+            &values[j * BLOCK_SIZE]);
+      }
+      ct = gst_util_get_timestamp ();
+      elapsed = GST_CLOCK_DIFF (bt, ct);
+      rate = (BLOCK_SIZE * NUM_CP) / ((gdouble) elapsed / GST_SECOND);
+      printf ("%-6s blocks for control-points : %" GST_TIME_FORMAT
+          " (%.0f samples/s)\n", mode->value_nick, GST_TIME_ARGS (elapsed),
+          rate);
+    }
+    g_type_class_unref (mode_class);
     g_free (values);
-    elapsed = GST_CLOCK_DIFF (bt, ct);
-    printf ("linear array for control-points: %" GST_TIME_FORMAT "\n",
-        GST_TIME_ARGS (elapsed));
+
+    g_object_set (cs, "mode", GST_INTERPOLATION_MODE_LINEAR, NULL);
   }
 
   /* play, this test sequential reads */
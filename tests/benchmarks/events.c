@@ -0,0 +1,211 @@
+/* GStreamer
+ *
+ * events.c: benchmark for the creation, parsing and destruction of the
+ * frequent events and queries
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gst/gst.h>
+
+#define NUM_ROUNDS 100000
+
+#ifdef __GLIBC__
+/* With glibc the allocations are counted by wrapping malloc. GSlice is told
+ * to use malloc for everything in main() so that GstStructures and other
+ * slices are counted too and not served from its magazines. */
+#define COUNT_ALLOCATIONS 1
+
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t nmemb, size_t size);
+extern void *__libc_realloc (void *ptr, size_t size);
+
+static volatile gint allocations = 0;
+
+void *
+malloc (size_t size)
+{
+  g_atomic_int_inc (&allocations);
+  return __libc_malloc (size);
+}
+
+void *
+calloc (size_t nmemb, size_t size)
+{
+  g_atomic_int_inc (&allocations);
+  return __libc_calloc (nmemb, size);
+}
+
+void *
+realloc (void *ptr, size_t size)
+{
+  if (ptr == NULL)
+    g_atomic_int_inc (&allocations);
+  return __libc_realloc (ptr, size);
+}
+#endif
+
+typedef void (*RoundTripFunc) (void);
+
+static void
+gap_round_trip (void)
+{
+  GstEvent *event;
+  GstClockTime ts, dur;
+
+  event = gst_event_new_gap (GST_SECOND, GST_MSECOND);
+  gst_event_parse_gap (event, &ts, &dur);
+  gst_event_unref (event);
+}
+
+static void
+segment_round_trip (void)
+{
+  GstSegment segment;
+  const GstSegment *parsed;
+  GstEvent *event;
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  event = gst_event_new_segment (&segment);
+  gst_event_parse_segment (event, &parsed);
+  gst_event_unref (event);
+}
+
+static void
+latency_event_round_trip (void)
+{
+  GstEvent *event;
+  GstClockTime latency;
+
+  event = gst_event_new_latency (20 * GST_MSECOND);
+  gst_event_parse_latency (event, &latency);
+  gst_event_unref (event);
+}
+
+static void
+position_round_trip (void)
+{
+  GstQuery *query;
+  gint64 pos;
+
+  query = gst_query_new_position (GST_FORMAT_TIME);
+  gst_query_set_position (query, GST_FORMAT_TIME, GST_SECOND);
+  gst_query_parse_position (query, NULL, &pos);
+  gst_query_unref (query);
+}
+
+static void
+duration_round_trip (void)
+{
+  GstQuery *query;
+  gint64 dur;
+
+  query = gst_query_new_duration (GST_FORMAT_TIME);
+  gst_query_set_duration (query, GST_FORMAT_TIME, GST_SECOND);
+  gst_query_parse_duration (query, NULL, &dur);
+  gst_query_unref (query);
+}
+
+static void
+latency_query_round_trip (void)
+{
+  GstQuery *query;
+  gboolean live;
+  GstClockTime min, max;
+
+  query = gst_query_new_latency ();
+  gst_query_set_latency (query, TRUE, 20 * GST_MSECOND, GST_CLOCK_TIME_NONE);
+  gst_query_parse_latency (query, &live, &min, &max);
+  gst_query_unref (query);
+}
+
+static void
+gap_structure_round_trip (void)
+{
+  GstEvent *event;
+
+  /* forces the structure to be created */
+  event = gst_event_new_gap (GST_SECOND, GST_MSECOND);
+  gst_event_get_structure (event);
+  gst_event_unref (event);
+}
+
+/* A miss is an allocation of a mini object that its cache could not serve
+ * from its blocks, these come from the statistics of the cache. */
+static void
+run_test (const gchar * name, RoundTripFunc func)
+{
+  GstClockTime start, end;
+  guint64 allocs, hits, allocs2, hits2;
+#ifdef COUNT_ALLOCATIONS
+  gint mallocs;
+#endif
+  guint i;
+
+  /* warm up the allocators and type system */
+  func ();
+
+  gst_mini_object_get_cache_stats (&allocs, &hits, NULL, NULL);
+#ifdef COUNT_ALLOCATIONS
+  mallocs = g_atomic_int_get (&allocations);
+#endif
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_ROUNDS; i++)
+    func ();
+  end = gst_util_get_timestamp ();
+
+#ifdef COUNT_ALLOCATIONS
+  mallocs = g_atomic_int_get (&allocations) - mallocs;
+#endif
+  gst_mini_object_get_cache_stats (&allocs2, &hits2, NULL, NULL);
+  allocs = allocs2 - allocs;
+  hits = hits2 - hits;
+
+  g_print ("%-20s %8.1f ns/round trip, ", name,
+      (gdouble) (end - start) / NUM_ROUNDS);
+#ifdef COUNT_ALLOCATIONS
+  g_print ("%6.2f allocations/round trip, ", (gdouble) mallocs / NUM_ROUNDS);
+#endif
+  g_print ("%6.2f misses/round trip\n", (gdouble) (allocs - hits) / NUM_ROUNDS);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+#ifdef COUNT_ALLOCATIONS
+  /* before anything uses GSlice */
+  g_setenv ("G_SLICE", "always-malloc", TRUE);
+#endif
+  gst_init (&argc, &argv);
+#ifdef COUNT_ALLOCATIONS
+  /* GLib 2.76 and newer always use malloc for slices */
+  if (glib_check_version (2, 76, 0) != NULL
+      && !g_slice_get_config (G_SLICE_CONFIG_ALWAYS_MALLOC))
+    g_printerr ("GSlice was used before main(), run with "
+        "G_SLICE=always-malloc to count the slice allocations\n");
+#endif
+
+  run_test ("gap event", gap_round_trip);
+  run_test ("segment event", segment_round_trip);
+  run_test ("latency event", latency_event_round_trip);
+  run_test ("position query", position_round_trip);
+  run_test ("duration query", duration_round_trip);
+  run_test ("latency query", latency_query_round_trip);
+  run_test ("gap event+structure", gap_structure_round_trip);
+
+  return 0;
+}
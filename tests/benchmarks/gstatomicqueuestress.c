@@ -0,0 +1,144 @@
+/* GStreamer
+ *
+ * gstatomicqueuestress.c: measure the throughput of GstAtomicQueue with
+ * several producers and consumers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gst/gst.h>
+#include <gst/gstatomicqueue.h>
+
+#define MAX_THREADS     16
+#define MAX_BATCH       64
+#define ITEMS_PER_THREAD 1000000
+
+static GstAtomicQueue *queue;
+static guint batch;
+static volatile gint producers_left;
+static volatile gint popped = 0;
+
+static gpointer
+run_producer (gpointer user_data)
+{
+  gpointer items[MAX_BATCH];
+  guint i;
+
+  for (i = 0; i < MAX_BATCH; i++)
+    items[i] = GUINT_TO_POINTER (i + 1);
+
+  if (batch == 1) {
+    for (i = 0; i < ITEMS_PER_THREAD; i++)
+      gst_atomic_queue_push (queue, items[0]);
+  } else {
+    for (i = 0; i < ITEMS_PER_THREAD; i += batch)
+      gst_atomic_queue_push_many (queue, items, batch);
+  }
+
+  g_atomic_int_dec_and_test (&producers_left);
+
+  return NULL;
+}
+
+static gpointer
+run_consumer (gpointer user_data)
+{
+  gpointer items[MAX_BATCH];
+  guint n;
+
+  while (TRUE) {
+    if (batch == 1)
+      n = gst_atomic_queue_pop (queue) != NULL;
+    else
+      n = gst_atomic_queue_pop_many (queue, items, batch);
+
+    if (n > 0)
+      g_atomic_int_add (&popped, n);
+    else if (g_atomic_int_get (&producers_left) == 0
+        && gst_atomic_queue_length (queue) == 0)
+      break;
+    else
+      g_thread_yield ();
+  }
+
+  return NULL;
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  GThread *producers[MAX_THREADS], *consumers[MAX_THREADS];
+  GstClockTime start, end;
+  gint num_producers, num_consumers, capacity;
+  gint t;
+
+  gst_init (&argc, &argv);
+
+  if (argc < 3 || argc > 5) {
+    g_print ("usage: %s <producers> <consumers> [<batch size> [<capacity>]]\n",
+        argv[0]);
+    exit (-1);
+  }
+
+  num_producers = atoi (argv[1]);
+  num_consumers = atoi (argv[2]);
+  batch = argc > 3 ? atoi (argv[3]) : 1;
+  /* 0 makes an unbounded queue */
+  capacity = argc > 4 ? atoi (argv[4]) : 0;
+
+  if (num_producers <= 0 || num_producers > MAX_THREADS ||
+      num_consumers <= 0 || num_consumers > MAX_THREADS) {
+    g_print ("number of threads must be between 1 and %d\n", MAX_THREADS);
+    exit (-2);
+  }
+  if (batch == 0 || batch > MAX_BATCH || ITEMS_PER_THREAD % batch != 0) {
+    g_print ("batch size must be between 1 and %d and divide %d\n",
+        MAX_BATCH, ITEMS_PER_THREAD);
+    exit (-2);
+  }
+
+  if (capacity > 0)
+    queue = gst_atomic_queue_new_bounded (capacity);
+  else
+    queue = gst_atomic_queue_new (32);
+
+  producers_left = num_producers;
+
+  start = gst_util_get_timestamp ();
+
+  for (t = 0; t < num_consumers; t++)
+    consumers[t] = g_thread_new ("consumer", run_consumer, NULL);
+  for (t = 0; t < num_producers; t++)
+    producers[t] = g_thread_new ("producer", run_producer, NULL);
+
+  for (t = 0; t < num_producers; t++)
+    g_thread_join (producers[t]);
+  for (t = 0; t < num_consumers; t++)
+    g_thread_join (consumers[t]);
+
+  end = gst_util_get_timestamp ();
+
+  g_print ("%d producers, %d consumers, batch %u, capacity %d: "
+      "%d items in %" GST_TIME_FORMAT " (%.1f ns/item)\n", num_producers,
+      num_consumers, batch, capacity, popped, GST_TIME_ARGS (end - start),
+      (gdouble) (end - start) / MAX (popped, 1));
+
+  gst_atomic_queue_unref (queue);
+
+  return 0;
+}
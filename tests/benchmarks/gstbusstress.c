@@ -0,0 +1,121 @@
+/* GStreamer
+ *
+ * gstbusstress.c: flood a bus with progress and QoS messages from many
+ * threads and measure how many of them reach the application
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gst/gst.h>
+
+#define MAX_THREADS  100
+
+static volatile gint running = TRUE;
+static volatile gint posted = 0;
+
+static GstBus *bus;
+
+static gpointer
+run_test (gpointer user_data)
+{
+  GstObject *src = GST_OBJECT_CAST (user_data);
+  gint i = 0;
+
+  while (g_atomic_int_get (&running)) {
+    GstMessage *message;
+
+    if (i++ % 2) {
+      message = gst_message_new_element (src,
+          gst_structure_new ("progress", "percent", G_TYPE_INT, i % 100,
+              NULL));
+    } else {
+      message = gst_message_new_qos (src, TRUE, i * GST_MSECOND,
+          i * GST_MSECOND, i * GST_MSECOND, GST_MSECOND);
+    }
+    gst_bus_post (bus, message);
+    g_atomic_int_inc (&posted);
+  }
+  return NULL;
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  GThread *threads[MAX_THREADS];
+  GstObject *sources[MAX_THREADS];
+  GstMessage *message;
+  GstClockTime start, end;
+  gint num_threads, interval, delivered = 0;
+  gint t;
+
+  gst_init (&argc, &argv);
+
+  if (argc != 2 && argc != 3) {
+    g_print ("usage: %s <num_threads> [<coalesce interval ms>]\n", argv[0]);
+    exit (-1);
+  }
+
+  num_threads = atoi (argv[1]);
+  /* -1 disables coalescing */
+  interval = argc == 3 ? atoi (argv[2]) : -1;
+
+  if (num_threads <= 0 || num_threads > MAX_THREADS) {
+    g_print ("number of threads must be between 0 and %d\n", MAX_THREADS);
+    exit (-2);
+  }
+
+  bus = gst_bus_new ();
+  if (interval >= 0)
+    gst_bus_set_coalesce (bus, GST_MESSAGE_ELEMENT | GST_MESSAGE_QOS,
+        interval * GST_MSECOND);
+
+  start = gst_util_get_timestamp ();
+
+  for (t = 0; t < num_threads; t++) {
+    sources[t] = gst_object_ref_sink (gst_bin_new (NULL));
+    threads[t] = g_thread_new ("busstresstest", run_test, sources[t]);
+  }
+
+  /* consume for 2 seconds */
+  do {
+    message = gst_bus_timed_pop (bus, 10 * GST_MSECOND);
+    if (message) {
+      delivered++;
+      gst_message_unref (message);
+    }
+    end = gst_util_get_timestamp ();
+  } while (end - start < 2 * GST_SECOND);
+
+  g_atomic_int_set (&running, FALSE);
+
+  for (t = 0; t < num_threads; t++) {
+    g_thread_join (threads[t]);
+    gst_object_unref (sources[t]);
+  }
+
+  /* whatever is left was not delivered in time */
+  gst_bus_set_flushing (bus, TRUE);
+
+  g_print ("posted %d messages, delivered %d (%.2f%%) in %" GST_TIME_FORMAT
+      "\n", posted, delivered, posted ? 100.0 * delivered / posted : 0.0,
+      GST_TIME_ARGS (end - start));
+
+  gst_object_unref (bus);
+
+  return 0;
+}
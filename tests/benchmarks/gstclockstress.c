@@ -23,6 +23,7 @@
 #include <gst/glib-compat-private.h>
 
 #define MAX_THREADS  100
+#define NUM_OBSERVATIONS 1000000
 
 static gboolean running = TRUE;
 static gint count = 0;
@@ -43,35 +44,20 @@ run_test (void *user_data)
   return NULL;
 }
 
-gint
-main (gint argc, gchar * argv[])
+static gint
+run_get_time (GstClock * clock, gint num_threads)
 {
   GThread *threads[MAX_THREADS];
-  gint num_threads;
   gint t;
-  GstClock *sysclock;
-
-  gst_init (&argc, &argv);
-
-  if (argc != 2) {
-    g_print ("usage: %s <num_threads>\n", argv[0]);
-    exit (-1);
-  }
-
-  num_threads = atoi (argv[1]);
 
-  if (num_threads <= 0 || num_threads > MAX_THREADS) {
-    g_print ("number of threads must be between 0 and %d\n", MAX_THREADS);
-    exit (-2);
-  }
-
-  sysclock = gst_system_clock_obtain ();
+  running = TRUE;
+  count = 0;
 
   for (t = 0; t < num_threads; t++) {
     GError *error = NULL;
 
     threads[t] = g_thread_try_new ("clockstresstest", run_test,
-        sysclock, &error);
+        clock, &error);
 
     if (error) {
       printf ("ERROR: g_thread_try_new() %s\n", error->message);
@@ -91,9 +77,82 @@ main (gint argc, gchar * argv[])
     g_thread_join (threads[t]);
   }
 
-  g_print ("performed %d get_time operations\n", count);
+  return count;
+}
+
+/* feeds observations of a master that runs a bit faster than the slave */
+static void
+run_observations (gint window_size)
+{
+  GstClock *slave;
+  GstClockTime start, end;
+  gdouble r_squared;
+  gint i;
+
+  slave = g_object_new (GST_TYPE_SYSTEM_CLOCK, "name", "SlaveClock", NULL);
+  g_object_set (slave, "window-size", window_size, NULL);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_OBSERVATIONS; i++) {
+    gst_clock_add_observation (slave, i * GST_MSECOND,
+        i * GST_MSECOND + i * GST_USECOND + (i % 7) * GST_USECOND, &r_squared);
+  }
+  end = gst_util_get_timestamp ();
+
+  g_print ("window size %4d: %.1f ns/observation\n", window_size,
+      (gdouble) (end - start) / NUM_OBSERVATIONS);
+
+  gst_object_unref (slave);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  gint num_threads;
+  GstClock *sysclock, *slave;
+  GstClockTime internal;
+  gdouble r_squared;
+
+  gst_init (&argc, &argv);
+
+  if (argc != 2) {
+    g_print ("usage: %s <num_threads>\n", argv[0]);
+    exit (-1);
+  }
+
+  num_threads = atoi (argv[1]);
+
+  if (num_threads <= 0 || num_threads > MAX_THREADS) {
+    g_print ("number of threads must be between 0 and %d\n", MAX_THREADS);
+    exit (-2);
+  }
+
+  sysclock = gst_system_clock_obtain ();
+
+  g_print ("performed %d get_time operations\n",
+      run_get_time (sysclock, num_threads));
 
   gst_object_unref (sysclock);
 
+  /* a slave clock that was calibrated against a master, its time needs to be
+   * scaled with the rate found by the regression */
+  slave = g_object_new (GST_TYPE_SYSTEM_CLOCK, "name", "SlaveClock", NULL);
+  internal = gst_clock_get_internal_time (slave);
+  gst_clock_add_observation (slave, internal, internal, &r_squared);
+  gst_clock_add_observation (slave, internal + GST_SECOND,
+      internal + GST_SECOND + 10 * GST_USECOND, &r_squared);
+  gst_clock_add_observation (slave, internal + 2 * GST_SECOND,
+      internal + 2 * GST_SECOND + 20 * GST_USECOND, &r_squared);
+  gst_clock_add_observation (slave, internal + 3 * GST_SECOND,
+      internal + 3 * GST_SECOND + 31 * GST_USECOND, &r_squared);
+
+  g_print ("performed %d slave clock get_time operations\n",
+      run_get_time (slave, num_threads));
+
+  gst_object_unref (slave);
+
+  run_observations (32);
+  run_observations (1024);
+
   return 0;
 }
@@ -0,0 +1,171 @@
+/* GStreamer
+ *
+ * gstnettimeproviderstress.c: let many clients query a GstNetTimeProvider
+ * over the loopback interface and measure its throughput and round trip times
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gst/gst.h>
+#include <gst/net/gstnet.h>
+
+#define MAX_CLIENTS         10000
+#define CLIENT_THREADS      4
+#define REPLY_TIMEOUT       (100 * G_TIME_SPAN_MILLISECOND)
+
+static GstClock *sysclock;
+static GSocketAddress *server_addr;
+static GSocket *sockets[MAX_CLIENTS];
+static gint num_clients;
+
+static volatile gint running = TRUE;
+static volatile gint replies = 0;
+static volatile gint lost = 0;
+static GMutex rtt_lock;
+static GstClockTime total_rtt = 0;
+
+static gpointer
+run_clients (gpointer user_data)
+{
+  gint first = GPOINTER_TO_INT (user_data);
+  GstNetTimePacket *packet;
+  GstClockTime rtt = 0;
+  gint i;
+
+  packet = gst_net_time_packet_new (NULL);
+
+  /* every round, all clients of this thread send one request and then wait
+   * for their reply */
+  while (g_atomic_int_get (&running)) {
+    for (i = first; i < num_clients; i += CLIENT_THREADS) {
+      packet->local_time = gst_clock_get_time (sysclock);
+      gst_net_time_packet_send (packet, sockets[i], server_addr, NULL);
+    }
+
+    for (i = first; i < num_clients; i += CLIENT_THREADS) {
+      GstNetTimePacket *reply;
+
+      if (!g_socket_condition_timed_wait (sockets[i], G_IO_IN, REPLY_TIMEOUT,
+              NULL, NULL)) {
+        g_atomic_int_inc (&lost);
+        continue;
+      }
+      reply = gst_net_time_packet_receive (sockets[i], NULL, NULL);
+      if (reply == NULL) {
+        g_atomic_int_inc (&lost);
+        continue;
+      }
+      rtt += gst_clock_get_time (sysclock) - reply->local_time;
+      g_free (reply);
+
+      g_atomic_int_inc (&replies);
+    }
+  }
+
+  g_free (packet);
+
+  g_mutex_lock (&rtt_lock);
+  total_rtt += rtt;
+  g_mutex_unlock (&rtt_lock);
+
+  return NULL;
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  GThread *threads[CLIENT_THREADS];
+  GstNetTimeProvider *provider;
+  GInetAddress *addr;
+  GError *err = NULL;
+  GstClockTime start, end;
+  gint num_threads, batch_size, port;
+  gint t, i;
+
+  gst_init (&argc, &argv);
+
+  if (argc < 2 || argc > 4) {
+    g_print ("usage: %s <clients> [<server threads> [<batch size>]]\n",
+        argv[0]);
+    exit (-1);
+  }
+
+  num_clients = atoi (argv[1]);
+  num_threads = argc > 2 ? atoi (argv[2]) : 1;
+  batch_size = argc > 3 ? atoi (argv[3]) : 32;
+
+  if (num_clients < CLIENT_THREADS || num_clients > MAX_CLIENTS) {
+    g_print ("number of clients must be between %d and %d\n", CLIENT_THREADS,
+        MAX_CLIENTS);
+    exit (-2);
+  }
+
+  sysclock = gst_system_clock_obtain ();
+
+  provider = g_initable_new (GST_TYPE_NET_TIME_PROVIDER, NULL, &err, "clock",
+      sysclock, "address", "127.0.0.1", "port", 0, "threads", num_threads,
+      "batch-size", batch_size, NULL);
+  if (provider == NULL) {
+    g_print ("could not create the provider: %s\n", err->message);
+    exit (-3);
+  }
+  g_object_get (provider, "port", &port, NULL);
+
+  addr = g_inet_address_new_from_string ("127.0.0.1");
+  server_addr = g_inet_socket_address_new (addr, port);
+  g_object_unref (addr);
+
+  for (i = 0; i < num_clients; i++) {
+    sockets[i] = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_DATAGRAM,
+        G_SOCKET_PROTOCOL_UDP, &err);
+    if (sockets[i] == NULL) {
+      g_print ("could not create client socket %d: %s\n", i, err->message);
+      exit (-3);
+    }
+  }
+
+  start = gst_util_get_timestamp ();
+
+  for (t = 0; t < CLIENT_THREADS; t++)
+    threads[t] = g_thread_new ("nettimeclients", run_clients,
+        GINT_TO_POINTER (t));
+
+  /* query for 2 seconds */
+  g_usleep (2 * G_USEC_PER_SEC);
+  g_atomic_int_set (&running, FALSE);
+
+  for (t = 0; t < CLIENT_THREADS; t++)
+    g_thread_join (threads[t]);
+
+  end = gst_util_get_timestamp ();
+
+  g_print ("%d clients, %d server threads, batch %d: %d replies in %"
+      GST_TIME_FORMAT " (%.0f replies/s), average round trip %"
+      GST_TIME_FORMAT ", %d lost\n", num_clients, num_threads, batch_size,
+      replies, GST_TIME_ARGS (end - start),
+      (gdouble) replies * GST_SECOND / (end - start),
+      GST_TIME_ARGS (replies ? total_rtt / replies : 0), lost);
+
+  for (i = 0; i < num_clients; i++)
+    g_object_unref (sockets[i]);
+  g_object_unref (server_addr);
+  gst_object_unref (provider);
+  gst_object_unref (sysclock);
+
+  return 0;
+}
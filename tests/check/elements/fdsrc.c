@@ -197,6 +197,48 @@ GST_START_TEST (test_seeking)
 
 GST_END_TEST;
 
+GST_START_TEST (test_batch_size)
+{
+  GstElement *src;
+  GstBuffer *buf;
+  gint in_fd;
+  GList *l;
+  guint i;
+
+  fail_if ((in_fd = open (TESTFILE, O_RDONLY)) < 0);
+  src = setup_fdsrc ();
+
+  /* 10 buffers read in batches of 4, the last batch has to be cut short */
+  g_object_set (G_OBJECT (src), "num-buffers", 10, "blocksize", 100,
+      "batch-size", 4, "fd", in_fd, NULL);
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  while (!have_eos)
+    g_usleep (1000);
+
+  fail_unless_equals_int (g_list_length (buffers), 10);
+  for (l = buffers, i = 0; l; l = l->next, i++) {
+    buf = GST_BUFFER (l->data);
+
+    fail_unless_equals_int (gst_buffer_get_size (buf), 100);
+    fail_unless_equals_uint64 (GST_BUFFER_OFFSET (buf), i * 100);
+  }
+
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+
+  /* cleanup */
+  cleanup_fdsrc (src);
+  close (in_fd);
+  g_list_foreach (buffers, (GFunc) gst_mini_object_unref, NULL);
+  g_list_free (buffers);
+  buffers = NULL;
+}
+
+GST_END_TEST;
+
 static Suite *
 fdsrc_suite (void)
 {
@@ -207,6 +249,7 @@ fdsrc_suite (void)
   tcase_add_test (tc_chain, test_num_buffers);
   tcase_add_test (tc_chain, test_nonseeking);
   tcase_add_test (tc_chain, test_seeking);
+  tcase_add_test (tc_chain, test_batch_size);
 
   return s;
 }
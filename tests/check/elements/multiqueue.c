@@ -949,6 +949,86 @@ GST_START_TEST (test_buffering_with_none_pts)
 
 GST_END_TEST;
 
+GST_START_TEST (test_stats)
+{
+  GstElement *pipe, *mq;
+  GstElement *inputs[2];
+  GstElement *outputs[2];
+  GstStructure *stats;
+  const GstStructure *s;
+  const GValue *queues;
+  GstMessage *msg;
+  guint64 count;
+  gint posted = 0;
+  guint id, i;
+
+  pipe = gst_pipeline_new ("pipeline");
+
+  for (i = 0; i < 2; i++) {
+    inputs[i] = gst_element_factory_make ("fakesrc", NULL);
+    fail_unless (inputs[i] != NULL, "failed to create 'fakesrc' element");
+    g_object_set (inputs[i], "num-buffers", 10 * (i + 1), NULL);
+
+    outputs[i] = gst_element_factory_make ("fakesink", NULL);
+    fail_unless (outputs[i] != NULL, "failed to create 'fakesink' element");
+  }
+
+  mq = setup_multiqueue (pipe, inputs, outputs, 2);
+  g_object_set (mq, "collect-stats", TRUE, "stats-interval", 5, NULL);
+
+  gst_element_set_state (pipe, GST_STATE_PLAYING);
+
+  /* the stats are posted before the EOS */
+  while (TRUE) {
+    msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipe),
+        GST_CLOCK_TIME_NONE,
+        GST_MESSAGE_EOS | GST_MESSAGE_ERROR | GST_MESSAGE_ELEMENT);
+    fail_if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR,
+        "Expected EOS message, got ERROR message");
+    if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS)
+      break;
+    if (gst_message_has_name (msg, "GstSingleQueueStats")) {
+      s = gst_message_get_structure (msg);
+      fail_unless (gst_structure_get_uint (s, "id", &id));
+      fail_unless (id < 2);
+      fail_unless (gst_structure_get_uint64 (s, "buffers", &count));
+      fail_unless_equals_uint64 (count % 5, 0);
+      posted++;
+    }
+    gst_message_unref (msg);
+  }
+  gst_message_unref (msg);
+
+  /* every 5 of the 10 and 20 buffers */
+  fail_unless_equals_int (posted, 2 + 4);
+
+  g_object_get (mq, "stats", &stats, NULL);
+  fail_unless (stats != NULL);
+  fail_unless (gst_structure_has_name (stats, "GstMultiQueueStats"));
+  queues = gst_structure_get_value (stats, "queues");
+  fail_unless (queues != NULL);
+  fail_unless (GST_VALUE_HOLDS_ARRAY (queues));
+  fail_unless_equals_int (gst_value_array_get_size (queues), 2);
+
+  for (i = 0; i < 2; i++) {
+    s = gst_value_get_structure (gst_value_array_get_value (queues, i));
+    fail_unless (gst_structure_has_name (s, "GstSingleQueueStats"));
+    fail_unless (gst_structure_get_uint (s, "id", &id));
+    fail_unless (id < 2);
+
+    fail_unless (gst_structure_get_uint64 (s, "buffers", &count));
+    fail_unless_equals_uint64 (count, 10 * (id + 1));
+    fail_unless (gst_structure_get_uint64 (s, "level-samples", &count));
+    fail_unless_equals_uint64 (count, 10 * (id + 1));
+  }
+  gst_structure_free (stats);
+
+  gst_element_set_state (pipe, GST_STATE_NULL);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
 static Suite *
 multiqueue_suite (void)
 {
@@ -971,6 +1051,7 @@ multiqueue_suite (void)
   tcase_add_test (tc_chain, test_limit_changes);
 
   tcase_add_test (tc_chain, test_buffering_with_none_pts);
+  tcase_add_test (tc_chain, test_stats);
 
   return s;
 }
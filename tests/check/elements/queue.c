@@ -937,6 +937,147 @@ GST_START_TEST (test_state_change_when_flushing)
 
 GST_END_TEST;
 
+static gint pushes_started;
+
+static gpointer
+push_buffers_thread (gpointer data)
+{
+  gint i;
+
+  for (i = 0; i < 3; i++) {
+    g_atomic_int_inc (&pushes_started);
+    gst_pad_push (mysrcpad, gst_buffer_new_and_alloc (4));
+  }
+
+  return NULL;
+}
+
+/* deactivate the queue while the loop function waits for data and while the
+ * chain function waits for space, both must wake up and stop */
+GST_START_TEST (test_deactivate_while_waiting)
+{
+  GstSegment segment;
+  GThread *thread;
+  gint i;
+
+  g_object_set (G_OBJECT (queue), "max-size-buffers", 1, NULL);
+  mysinkpad = gst_check_setup_sink_pad (queue, &sinktemplate);
+  gst_pad_set_active (mysinkpad, TRUE);
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+
+  for (i = 0; i < 50; i++) {
+    fail_unless (gst_element_set_state (queue,
+            GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+        "could not set to playing");
+    fail_unless (gst_element_set_state (queue,
+            GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS,
+        "could not set to null");
+
+    /* the loop function blocks on the first event, the queue fills up with
+     * one buffer and the second push waits in the chain function */
+    block_src ();
+    fail_unless (gst_element_set_state (queue,
+            GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+        "could not set to playing");
+    gst_pad_push_event (mysrcpad, gst_event_new_stream_start ("test"));
+    gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment));
+
+    g_atomic_int_set (&pushes_started, 0);
+    thread = g_thread_new ("push", push_buffers_thread, NULL);
+    while (g_atomic_int_get (&pushes_started) < 2)
+      g_usleep (100);
+
+    fail_unless (gst_element_set_state (queue,
+            GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS,
+        "could not set to null");
+    g_thread_join (thread);
+    unblock_src ();
+  }
+}
+
+GST_END_TEST;
+
+static guint64
+histogram_sum (const GstStructure * s, const gchar * field)
+{
+  const GValue *array;
+  guint64 sum = 0;
+  guint i;
+
+  array = gst_structure_get_value (s, field);
+  fail_unless (array != NULL);
+  for (i = 0; i < gst_value_array_get_size (array); i++)
+    sum += g_value_get_uint64 (gst_value_array_get_value (array, i));
+
+  return sum;
+}
+
+GST_START_TEST (test_stats)
+{
+  GstStructure *stats;
+  GstMessage *msg;
+  GstSegment segment;
+  GstBus *bus;
+  guint64 count;
+  gint i;
+
+  g_object_set (G_OBJECT (queue), "collect-stats", TRUE, "stats-interval", 5,
+      NULL);
+  mysinkpad = gst_check_setup_sink_pad (queue, &sinktemplate);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  bus = gst_bus_new ();
+  gst_element_set_bus (queue, bus);
+
+  fail_unless (gst_element_set_state (queue,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (mysrcpad, gst_event_new_stream_start ("test"));
+  gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment));
+
+  for (i = 0; i < 10; i++)
+    fail_unless_equals_int (gst_pad_push (mysrcpad,
+            gst_buffer_new_and_alloc (4)), GST_FLOW_OK);
+
+  g_mutex_lock (&check_mutex);
+  while (g_list_length (buffers) < 10)
+    g_cond_wait (&check_cond, &check_mutex);
+  g_mutex_unlock (&check_mutex);
+
+  g_object_get (G_OBJECT (queue), "stats", &stats, NULL);
+  fail_unless (stats != NULL);
+  fail_unless (gst_structure_has_name (stats, "GstQueueStats"));
+  fail_unless (gst_structure_get_uint64 (stats, "buffers", &count));
+  fail_unless_equals_uint64 (count, 10);
+  fail_unless_equals_uint64 (histogram_sum (stats, "time-histogram"), 10);
+  fail_unless (gst_structure_get_uint64 (stats, "level-samples", &count));
+  fail_unless_equals_uint64 (count, 10);
+  fail_unless_equals_uint64 (histogram_sum (stats, "level-histogram"), 10);
+  gst_structure_free (stats);
+
+  /* the stats were posted after the 5th and the 10th buffer */
+  for (i = 1; i <= 2; i++) {
+    msg = gst_bus_pop_filtered (bus, GST_MESSAGE_ELEMENT);
+    fail_unless (msg != NULL);
+    fail_unless (gst_message_has_name (msg, "GstQueueStats"));
+    fail_unless (gst_structure_get_uint64 (gst_message_get_structure (msg),
+            "buffers", &count));
+    fail_unless_equals_uint64 (count, i * 5);
+    gst_message_unref (msg);
+  }
+  fail_unless (gst_bus_pop_filtered (bus, GST_MESSAGE_ELEMENT) == NULL);
+
+  fail_unless (gst_element_set_state (queue,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+
+  gst_element_set_bus (queue, NULL);
+  gst_object_unref (bus);
+}
+
+GST_END_TEST;
+
 static Suite *
 queue_suite (void)
 {
@@ -957,6 +1098,8 @@ queue_suite (void)
   tcase_add_test (tc_chain, test_newsegment);
 #endif
   tcase_add_test (tc_chain, test_sticky_not_linked);
+  tcase_add_test (tc_chain, test_stats);
+  tcase_add_test (tc_chain, test_deactivate_while_waiting);
 
   return s;
 }
@@ -269,6 +269,105 @@ GST_START_TEST (test_filled_read)
 
 GST_END_TEST;
 
+static guint64
+histogram_sum (const GstStructure * s, const gchar * field)
+{
+  const GValue *array;
+  guint64 sum = 0;
+  guint i;
+
+  array = gst_structure_get_value (s, field);
+  fail_unless (array != NULL);
+  for (i = 0; i < gst_value_array_get_size (array); i++)
+    sum += g_value_get_uint64 (gst_value_array_get_value (array, i));
+
+  return sum;
+}
+
+static void
+do_test_stats (guint64 ring_buffer_max_size)
+{
+  GstElement *pipe, *queue2, *input, *output;
+  GstStructure *stats;
+  GstMessage *msg;
+  guint64 count;
+  gint posted = 0;
+
+  pipe = gst_pipeline_new ("pipeline");
+
+  input = gst_element_factory_make ("fakesrc", NULL);
+  fail_unless (input != NULL, "failed to create 'fakesrc' element");
+  g_object_set (input, "num-buffers", 20, "sizetype", 2, "sizemax", 100,
+      NULL);
+
+  output = gst_element_factory_make ("fakesink", NULL);
+  fail_unless (output != NULL, "failed to create 'fakesink' element");
+
+  queue2 = setup_queue2 (pipe, input, output);
+  g_object_set (queue2, "ring-buffer-max-size", ring_buffer_max_size,
+      "collect-stats", TRUE, "stats-interval", 10, NULL);
+
+  gst_element_set_state (pipe, GST_STATE_PLAYING);
+
+  /* the stats are posted before the EOS */
+  while (TRUE) {
+    msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipe),
+        GST_CLOCK_TIME_NONE,
+        GST_MESSAGE_EOS | GST_MESSAGE_ERROR | GST_MESSAGE_ELEMENT);
+    fail_if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR,
+        "Expected EOS message, got ERROR message");
+    if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS)
+      break;
+    if (gst_message_has_name (msg, "GstQueue2Stats")) {
+      posted++;
+      fail_unless (gst_structure_get_uint64 (gst_message_get_structure (msg),
+              "buffers", &count));
+      fail_unless_equals_uint64 (count, posted * 10);
+    }
+    gst_message_unref (msg);
+  }
+  gst_message_unref (msg);
+
+  g_object_get (queue2, "stats", &stats, NULL);
+  fail_unless (stats != NULL);
+  fail_unless (gst_structure_has_name (stats, "GstQueue2Stats"));
+
+  /* every buffer that entered was sampled for the fill level */
+  fail_unless (gst_structure_get_uint64 (stats, "level-samples", &count));
+  fail_unless_equals_uint64 (count, 20);
+  fail_unless_equals_uint64 (histogram_sum (stats, "level-histogram"), 20);
+
+  /* residence times are only recorded for the in-memory queue */
+  fail_unless (gst_structure_get_uint64 (stats, "buffers", &count));
+  if (ring_buffer_max_size == 0) {
+    fail_unless_equals_uint64 (count, 20);
+    fail_unless_equals_uint64 (histogram_sum (stats, "time-histogram"), 20);
+    fail_unless_equals_int (posted, 2);
+  } else {
+    fail_unless_equals_uint64 (count, 0);
+    fail_unless_equals_uint64 (histogram_sum (stats, "time-histogram"), 0);
+    fail_unless_equals_int (posted, 0);
+  }
+  gst_structure_free (stats);
+
+  gst_element_set_state (pipe, GST_STATE_NULL);
+  gst_object_unref (pipe);
+}
+
+GST_START_TEST (test_stats)
+{
+  do_test_stats (0);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_stats_ringbuffer)
+{
+  do_test_stats (1024 * 50);
+}
+
+GST_END_TEST;
+
 
 static Suite *
 queue2_suite (void)
@@ -283,6 +382,8 @@ queue2_suite (void)
   tcase_add_test (tc_chain, test_simple_shutdown_while_running);
   tcase_add_test (tc_chain, test_simple_shutdown_while_running_ringbuffer);
   tcase_add_test (tc_chain, test_filled_read);
+  tcase_add_test (tc_chain, test_stats);
+  tcase_add_test (tc_chain, test_stats_ringbuffer);
   return s;
 }
 
@@ -110,6 +110,415 @@ GST_START_TEST (test_num_buffers)
 
 GST_END_TEST;
 
+/* fakesrc ! tee parallel=true ! fakesink x N, without queues the branches can
+ * only preroll when every src pad has its own streaming thread */
+GST_START_TEST (test_parallel)
+{
+#define NUM_PARALLEL_SUBSTREAMS 4
+#define NUM_PARALLEL_BUFFERS 20
+  GstElement *pipeline, *src, *tee;
+  GstElement *sinks[NUM_PARALLEL_SUBSTREAMS];
+  GstPad *req_pads[NUM_PARALLEL_SUBSTREAMS];
+  guint counts[NUM_PARALLEL_SUBSTREAMS];
+  GstBus *bus;
+  GstMessage *msg;
+  gint i;
+
+  pipeline = gst_pipeline_new ("pipeline");
+  src = gst_check_setup_element ("fakesrc");
+  g_object_set (src, "num-buffers", NUM_PARALLEL_BUFFERS, NULL);
+  tee = gst_check_setup_element ("tee");
+  g_object_set (tee, "parallel", TRUE, NULL);
+  fail_unless (gst_bin_add (GST_BIN (pipeline), src));
+  fail_unless (gst_bin_add (GST_BIN (pipeline), tee));
+  fail_unless (gst_element_link (src, tee));
+
+  for (i = 0; i < NUM_PARALLEL_SUBSTREAMS; ++i) {
+    GstPad *sinkpad;
+    gchar name[32];
+
+    counts[i] = 0;
+
+    sinks[i] = gst_check_setup_element ("fakesink");
+    g_snprintf (name, 32, "sink%d", i);
+    gst_object_set_name (GST_OBJECT (sinks[i]), name);
+    fail_unless (gst_bin_add (GST_BIN (pipeline), sinks[i]));
+    g_object_set (sinks[i], "signal-handoffs", TRUE, NULL);
+    g_signal_connect (sinks[i], "handoff", (GCallback) handoff, &counts[i]);
+
+    req_pads[i] = gst_element_get_request_pad (tee, "src_%u");
+    fail_unless (req_pads[i] != NULL);
+    g_object_set (req_pads[i], "max-size-buffers", 2, NULL);
+
+    sinkpad = gst_element_get_static_pad (sinks[i], "sink");
+    fail_unless_equals_int (gst_pad_link (req_pads[i], sinkpad),
+        GST_PAD_LINK_OK);
+    gst_object_unref (sinkpad);
+  }
+
+  bus = gst_element_get_bus (pipeline);
+  fail_if (bus == NULL);
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+
+  msg = gst_bus_poll (bus, GST_MESSAGE_EOS | GST_MESSAGE_ERROR, -1);
+  fail_if (GST_MESSAGE_TYPE (msg) != GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+
+  for (i = 0; i < NUM_PARALLEL_SUBSTREAMS; ++i) {
+    fail_unless_equals_int (counts[i], NUM_PARALLEL_BUFFERS);
+  }
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (bus);
+
+  for (i = 0; i < NUM_PARALLEL_SUBSTREAMS; ++i) {
+    gst_element_release_request_pad (tee, req_pads[i]);
+    gst_object_unref (req_pads[i]);
+  }
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
+static GstStaticPadTemplate parallel_src_template =
+GST_STATIC_PAD_TEMPLATE ("src", GST_PAD_SRC, GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+static GstStaticPadTemplate parallel_sink_template =
+GST_STATIC_PAD_TEMPLATE ("sink", GST_PAD_SINK, GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+/* a sink pad that blocks in chain until the gate is opened and records the
+ * offsets of the buffers it got */
+static GMutex gate_lock;
+static GCond gate_cond;
+static gboolean gate_open;
+static gboolean gate_entered;
+static GArray *gate_offsets;
+
+static GstFlowReturn
+gated_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  guint64 offset = GST_BUFFER_OFFSET (buffer);
+
+  g_mutex_lock (&gate_lock);
+  gate_entered = TRUE;
+  g_cond_broadcast (&gate_cond);
+  while (!gate_open)
+    g_cond_wait (&gate_cond, &gate_lock);
+  g_array_append_val (gate_offsets, offset);
+  g_cond_broadcast (&gate_cond);
+  g_mutex_unlock (&gate_lock);
+
+  gst_buffer_unref (buffer);
+
+  return GST_FLOW_OK;
+}
+
+static gboolean
+accept_event (GstPad * pad, GstObject * parent, GstEvent * event)
+{
+  gst_event_unref (event);
+  return TRUE;
+}
+
+static void
+push_offset_buffer (GstPad * srcpad, guint64 offset)
+{
+  GstBuffer *buffer = gst_buffer_new ();
+
+  GST_BUFFER_OFFSET (buffer) = offset;
+  fail_unless_equals_int (gst_pad_push (srcpad, buffer), GST_FLOW_OK);
+}
+
+static void
+push_stream_start (GstPad * srcpad)
+{
+  GstSegment segment;
+
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  fail_unless (gst_pad_push_event (srcpad, gst_event_new_stream_start ("t")));
+  fail_unless (gst_pad_push_event (srcpad, gst_event_new_segment (&segment)));
+}
+
+static void
+wait_for_offsets (guint n)
+{
+  g_mutex_lock (&gate_lock);
+  while (gate_offsets->len < n)
+    g_cond_wait (&gate_cond, &gate_lock);
+  g_mutex_unlock (&gate_lock);
+}
+
+/* tee parallel=true with one src pad that has max-size-buffers=2 and goes to
+ * the gated sink pad */
+static GstElement *
+setup_parallel_tee (GstPad ** srcpad, GstPad ** teepad, GstPad ** sinkpad)
+{
+  GstElement *tee;
+
+  gate_open = FALSE;
+  gate_entered = FALSE;
+  gate_offsets = g_array_new (FALSE, FALSE, sizeof (guint64));
+
+  tee = gst_check_setup_element ("tee");
+  g_object_set (tee, "parallel", TRUE, NULL);
+  *srcpad = gst_check_setup_src_pad (tee, &parallel_src_template);
+
+  *teepad = gst_element_get_request_pad (tee, "src_%u");
+  fail_unless (*teepad != NULL);
+  g_object_set (*teepad, "max-size-buffers", 2, NULL);
+
+  *sinkpad = gst_pad_new_from_static_template (&parallel_sink_template, "sink");
+  gst_pad_set_chain_function (*sinkpad, gated_chain);
+  gst_pad_set_event_function (*sinkpad, accept_event);
+  fail_unless_equals_int (gst_pad_link (*teepad, *sinkpad), GST_PAD_LINK_OK);
+
+  gst_pad_set_active (*sinkpad, TRUE);
+  gst_pad_set_active (*srcpad, TRUE);
+  fail_unless_equals_int (gst_element_set_state (tee, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_SUCCESS);
+
+  return tee;
+}
+
+static void
+teardown_parallel_tee (GstElement * tee, GstPad * teepad, GstPad * sinkpad)
+{
+  /* let the output thread finish its push so it can stop */
+  g_mutex_lock (&gate_lock);
+  gate_open = TRUE;
+  g_cond_broadcast (&gate_cond);
+  g_mutex_unlock (&gate_lock);
+
+  fail_unless_equals_int (gst_element_set_state (tee, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_pad_unlink (teepad, sinkpad);
+  gst_object_unref (sinkpad);
+  gst_element_release_request_pad (tee, teepad);
+  gst_object_unref (teepad);
+  gst_check_teardown_src_pad (tee);
+  gst_check_teardown_element (tee);
+
+  g_array_free (gate_offsets, TRUE);
+  gate_offsets = NULL;
+}
+
+/* block the output thread in the push of buffer 0, fill the queue of the pad
+ * with buffers 1 and 2 and overflow it with buffers 3 and 4 */
+static void
+check_leaky (const gchar * leaky, const guint64 expected[3])
+{
+  GstElement *tee;
+  GstPad *srcpad, *teepad, *sinkpad;
+  GstQuery *query;
+  guint64 i;
+
+  tee = setup_parallel_tee (&srcpad, &teepad, &sinkpad);
+  gst_util_set_object_arg (G_OBJECT (teepad), "leaky", leaky);
+
+  push_stream_start (srcpad);
+  push_offset_buffer (srcpad, 0);
+  g_mutex_lock (&gate_lock);
+  while (!gate_entered)
+    g_cond_wait (&gate_cond, &gate_lock);
+  g_mutex_unlock (&gate_lock);
+
+  /* none of these may block */
+  for (i = 1; i <= 4; i++)
+    push_offset_buffer (srcpad, i);
+
+  g_mutex_lock (&gate_lock);
+  gate_open = TRUE;
+  g_cond_broadcast (&gate_cond);
+  g_mutex_unlock (&gate_lock);
+
+  /* a serialized query waits until everything queued was pushed */
+  query = gst_query_new_drain ();
+  gst_pad_peer_query (srcpad, query);
+  gst_query_unref (query);
+
+  fail_unless_equals_int (gate_offsets->len, 3);
+  for (i = 0; i < 3; i++)
+    fail_unless_equals_uint64 (g_array_index (gate_offsets, guint64, i),
+        expected[i]);
+
+  teardown_parallel_tee (tee, teepad, sinkpad);
+}
+
+GST_START_TEST (test_parallel_leaky_upstream)
+{
+  static const guint64 expected[3] = { 0, 1, 2 };
+
+  check_leaky ("upstream", expected);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_parallel_leaky_downstream)
+{
+  static const guint64 expected[3] = { 0, 3, 4 };
+
+  check_leaky ("downstream", expected);
+}
+
+GST_END_TEST;
+
+/* after EOS a new stream makes the output thread push again */
+GST_START_TEST (test_parallel_restart_after_eos)
+{
+  GstElement *tee;
+  GstPad *srcpad, *teepad, *sinkpad;
+
+  tee = setup_parallel_tee (&srcpad, &teepad, &sinkpad);
+  g_mutex_lock (&gate_lock);
+  gate_open = TRUE;
+  g_mutex_unlock (&gate_lock);
+
+  push_stream_start (srcpad);
+  push_offset_buffer (srcpad, 0);
+  fail_unless (gst_pad_push_event (srcpad, gst_event_new_eos ()));
+
+  /* wait until the output thread pushed the EOS and paused */
+  wait_for_offsets (1);
+  GST_OBJECT_LOCK (teepad);
+  while (gst_task_get_state (GST_PAD_TASK (teepad)) != GST_TASK_PAUSED) {
+    GST_OBJECT_UNLOCK (teepad);
+    g_usleep (G_USEC_PER_SEC / 100);
+    GST_OBJECT_LOCK (teepad);
+  }
+  GST_OBJECT_UNLOCK (teepad);
+
+  push_stream_start (srcpad);
+  push_offset_buffer (srcpad, 1);
+  wait_for_offsets (2);
+  fail_unless_equals_uint64 (g_array_index (gate_offsets, guint64, 1), 1);
+
+  teardown_parallel_tee (tee, teepad, sinkpad);
+}
+
+GST_END_TEST;
+
+/* answers allocation queries with the GstAllocationParams, pool size, pool
+ * min-buffers and metas set on the pad */
+typedef struct
+{
+  guint size;
+  guint min_buffers;
+  gsize align;
+  gsize padding;
+  GType metas[2];
+} AllocAnswer;
+
+static gboolean
+answer_allocation (GstPad * pad, GstObject * parent, GstQuery * query)
+{
+  AllocAnswer *answer = g_object_get_data (G_OBJECT (pad), "answer");
+  GstAllocationParams params;
+  guint i;
+
+  if (GST_QUERY_TYPE (query) != GST_QUERY_ALLOCATION)
+    return gst_pad_query_default (pad, parent, query);
+
+  gst_allocation_params_init (&params);
+  params.align = answer->align;
+  params.padding = answer->padding;
+  gst_query_add_allocation_param (query, NULL, &params);
+  gst_query_add_allocation_pool (query, NULL, answer->size,
+      answer->min_buffers, 0);
+  for (i = 0; i < G_N_ELEMENTS (answer->metas) && answer->metas[i]; i++)
+    gst_query_add_allocation_meta (query, answer->metas[i], NULL);
+
+  return TRUE;
+}
+
+/* in parallel mode the answers of all branches are merged */
+GST_START_TEST (test_parallel_allocation_query)
+{
+  static const gchar *tags[] = { NULL };
+  GstElement *tee;
+  GstPad *srcpad, *teepads[2], *sinkpads[2];
+  AllocAnswer answers[2];
+  GstAllocationParams params;
+  GstAllocator *allocator;
+  GstCaps *caps;
+  GstQuery *query;
+  GType meta1, meta2;
+  guint size, min_buffers, i;
+
+  meta1 = gst_meta_api_type_register ("GstTeeTestMeta1API", tags);
+  meta2 = gst_meta_api_type_register ("GstTeeTestMeta2API", tags);
+
+  answers[0].size = 1000;
+  answers[0].min_buffers = 2;
+  answers[0].align = 15;
+  answers[0].padding = 0;
+  answers[0].metas[0] = meta1;
+  answers[0].metas[1] = meta2;
+  answers[1].size = 2000;
+  answers[1].min_buffers = 3;
+  answers[1].align = 7;
+  answers[1].padding = 16;
+  answers[1].metas[0] = meta2;
+  answers[1].metas[1] = 0;
+
+  tee = gst_check_setup_element ("tee");
+  g_object_set (tee, "parallel", TRUE, NULL);
+  srcpad = gst_check_setup_src_pad (tee, &parallel_src_template);
+  for (i = 0; i < 2; i++) {
+    teepads[i] = gst_element_get_request_pad (tee, "src_%u");
+    sinkpads[i] = gst_pad_new_from_static_template (&parallel_sink_template,
+        "sink");
+    g_object_set_data (G_OBJECT (sinkpads[i]), "answer", &answers[i]);
+    gst_pad_set_query_function (sinkpads[i], answer_allocation);
+    fail_unless_equals_int (gst_pad_link (teepads[i], sinkpads[i]),
+        GST_PAD_LINK_OK);
+    gst_pad_set_active (sinkpads[i], TRUE);
+  }
+  gst_pad_set_active (srcpad, TRUE);
+  fail_unless_equals_int (gst_element_set_state (tee, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_SUCCESS);
+
+  caps = gst_caps_new_empty_simple ("test/x-raw");
+  query = gst_query_new_allocation (caps, TRUE);
+  fail_unless (gst_pad_peer_query (srcpad, query));
+
+  /* only the metas all branches support */
+  fail_unless_equals_int (gst_query_get_n_allocation_metas (query), 1);
+  fail_unless (gst_query_find_allocation_meta (query, meta2, NULL));
+
+  /* the strictest params */
+  fail_unless_equals_int (gst_query_get_n_allocation_params (query), 1);
+  gst_query_parse_nth_allocation_param (query, 0, &allocator, &params);
+  fail_unless (allocator == NULL);
+  fail_unless_equals_int (params.align, 15);
+  fail_unless_equals_int (params.padding, 16);
+
+  /* the biggest size and enough buffers for all branches together */
+  fail_unless_equals_int (gst_query_get_n_allocation_pools (query), 1);
+  gst_query_parse_nth_allocation_pool (query, 0, NULL, &size, &min_buffers,
+      NULL);
+  fail_unless_equals_int (size, 2000);
+  fail_unless_equals_int (min_buffers, 5);
+
+  gst_query_unref (query);
+  gst_caps_unref (caps);
+
+  fail_unless_equals_int (gst_element_set_state (tee, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+  for (i = 0; i < 2; i++) {
+    gst_pad_set_active (sinkpads[i], FALSE);
+    gst_pad_unlink (teepads[i], sinkpads[i]);
+    gst_object_unref (sinkpads[i]);
+    gst_element_release_request_pad (tee, teepads[i]);
+    gst_object_unref (teepads[i]);
+  }
+  gst_check_teardown_src_pad (tee);
+  gst_check_teardown_element (tee);
+}
+
+GST_END_TEST;
+
 /* we use fakesrc ! tee ! fakesink and then randomly request/release and link
  * some pads from tee. This should happily run without any errors. */
 GST_START_TEST (test_stress)
@@ -636,6 +1045,11 @@ tee_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_num_buffers);
+  tcase_add_test (tc_chain, test_parallel);
+  tcase_add_test (tc_chain, test_parallel_leaky_upstream);
+  tcase_add_test (tc_chain, test_parallel_leaky_downstream);
+  tcase_add_test (tc_chain, test_parallel_restart_after_eos);
+  tcase_add_test (tc_chain, test_parallel_allocation_query);
   tcase_add_test (tc_chain, test_stress);
   tcase_add_test (tc_chain, test_release_while_buffer_alloc);
   tcase_add_test (tc_chain, test_release_while_second_buffer_alloc);
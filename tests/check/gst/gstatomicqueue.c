@@ -31,6 +31,75 @@ GST_START_TEST (test_create_free)
 
 GST_END_TEST;
 
+GST_START_TEST (test_push_pop_many)
+{
+  GstAtomicQueue *aq;
+  gpointer items[100], popped[100];
+  guint i, n;
+
+  for (i = 0; i < G_N_ELEMENTS (items); i++)
+    items[i] = GUINT_TO_POINTER (i + 1);
+
+  /* make the queue grow while pushing */
+  aq = gst_atomic_queue_new (16);
+  gst_atomic_queue_push (aq, GUINT_TO_POINTER (1000));
+  gst_atomic_queue_push_many (aq, items, G_N_ELEMENTS (items));
+  fail_unless_equals_int (gst_atomic_queue_length (aq), 101);
+
+  fail_unless (gst_atomic_queue_pop (aq) == GUINT_TO_POINTER (1000));
+
+  n = gst_atomic_queue_pop_many (aq, popped, 10);
+  fail_unless_equals_int (n, 10);
+  for (i = 0; i < n; i++)
+    fail_unless (popped[i] == items[i]);
+
+  /* only 90 left */
+  n = gst_atomic_queue_pop_many (aq, popped, G_N_ELEMENTS (popped));
+  fail_unless_equals_int (n, 90);
+  for (i = 0; i < n; i++)
+    fail_unless (popped[i] == items[i + 10]);
+
+  fail_unless_equals_int (gst_atomic_queue_pop_many (aq, popped, 10), 0);
+  fail_unless_equals_int (gst_atomic_queue_length (aq), 0);
+
+  gst_atomic_queue_unref (aq);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_bounded)
+{
+  GstAtomicQueue *aq;
+  gpointer items[10], popped[10];
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (items); i++)
+    items[i] = GUINT_TO_POINTER (i + 1);
+
+  aq = gst_atomic_queue_new_bounded (20);
+
+  for (i = 0; i < 20; i++)
+    fail_unless (gst_atomic_queue_try_push (aq, GUINT_TO_POINTER (i + 1)));
+  /* full, the queue doesn't grow */
+  fail_if (gst_atomic_queue_try_push (aq, GUINT_TO_POINTER (21)));
+  fail_unless_equals_int (gst_atomic_queue_length (aq), 20);
+
+  /* make room and fill it up again */
+  fail_unless_equals_int (gst_atomic_queue_pop_many (aq, popped, 10), 10);
+  gst_atomic_queue_push_many (aq, items, G_N_ELEMENTS (items));
+  fail_if (gst_atomic_queue_try_push (aq, GUINT_TO_POINTER (21)));
+
+  for (i = 0; i < 10; i++)
+    fail_unless (gst_atomic_queue_pop (aq) == GUINT_TO_POINTER (i + 11));
+  for (i = 0; i < 10; i++)
+    fail_unless (gst_atomic_queue_pop (aq) == items[i]);
+  fail_unless (gst_atomic_queue_pop (aq) == NULL);
+
+  gst_atomic_queue_unref (aq);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_atomic_queue_suite (void)
 {
@@ -39,6 +108,8 @@ gst_atomic_queue_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_create_free);
+  tcase_add_test (tc_chain, test_push_pop_many);
+  tcase_add_test (tc_chain, test_bounded);
 
   return s;
 }
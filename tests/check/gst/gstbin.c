@@ -1220,6 +1220,47 @@ GST_START_TEST (test_state_failure_remove)
 
 GST_END_TEST;
 
+GST_START_TEST (test_remove_async_children)
+{
+  GstElement *bin, *sinks[3];
+  GstStateChangeReturn ret;
+  GstState current, pending;
+  guint i;
+
+  bin = gst_bin_new (NULL);
+
+  for (i = 0; i < G_N_ELEMENTS (sinks); i++) {
+    sinks[i] = gst_element_factory_make ("fakesink", NULL);
+    fail_unless (sinks[i] != NULL, "Could not create fakesink");
+    gst_bin_add (GST_BIN (bin), gst_object_ref (sinks[i]));
+  }
+
+  /* the sinks can't preroll without data */
+  ret = gst_element_set_state (bin, GST_STATE_PAUSED);
+  fail_unless_equals_int (ret, GST_STATE_CHANGE_ASYNC);
+
+  /* the bin stays async as long as one of the async sinks is left */
+  for (i = 0; i < G_N_ELEMENTS (sinks); i++) {
+    gst_bin_remove (GST_BIN (bin), sinks[i]);
+    gst_element_set_state (sinks[i], GST_STATE_NULL);
+    gst_object_unref (sinks[i]);
+
+    ret = gst_element_get_state (bin, &current, &pending, 0);
+    if (i < G_N_ELEMENTS (sinks) - 1) {
+      fail_unless_equals_int (ret, GST_STATE_CHANGE_ASYNC);
+      fail_unless_equals_int (pending, GST_STATE_PAUSED);
+    } else {
+      fail_unless_equals_int (ret, GST_STATE_CHANGE_SUCCESS);
+      fail_unless_equals_int (current, GST_STATE_PAUSED);
+    }
+  }
+
+  gst_element_set_state (bin, GST_STATE_NULL);
+  gst_object_unref (bin);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_many_bins)
 {
   GstStateChangeReturn ret;
@@ -1556,6 +1597,7 @@ gst_bin_suite (void)
   tcase_add_test (tc_chain, test_iterate_sorted);
   tcase_add_test (tc_chain, test_link_structure_change);
   tcase_add_test (tc_chain, test_state_failure_remove);
+  tcase_add_test (tc_chain, test_remove_async_children);
   tcase_add_test (tc_chain, test_state_failure_unref);
   tcase_add_test (tc_chain, test_state_change_skip);
   tcase_add_test (tc_chain, test_duration_is_max);
@@ -857,6 +857,63 @@ GST_START_TEST (test_fill)
 
 GST_END_TEST;
 
+GST_START_TEST (test_many_memory)
+{
+  static const guint8 data[100] = { 0, };
+  GstBuffer *buf, *copy;
+  GstMemory *mem;
+  GstMapInfo info;
+  guint8 bytes[100];
+  gint i;
+
+  for (i = 0; i < G_N_ELEMENTS (bytes); i++)
+    bytes[i] = i;
+
+  /* add more memory than fits in the buffer itself, nothing is merged */
+  buf = gst_buffer_new ();
+  for (i = 1; i < G_N_ELEMENTS (bytes); i++)
+    gst_buffer_append_memory (buf,
+        gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY,
+            (gpointer) (bytes + i), 1, 0, 1, NULL, NULL));
+  gst_buffer_prepend_memory (buf,
+      gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY, (gpointer) bytes,
+          1, 0, 1, NULL, NULL));
+  fail_unless_equals_int (gst_buffer_n_memory (buf), 100);
+  fail_unless_equals_int (gst_buffer_get_size (buf), 100);
+  fail_unless (gst_buffer_memcmp (buf, 0, bytes, 100) == 0);
+
+  mem = gst_buffer_peek_memory (buf, 50);
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_READ));
+  fail_unless_equals_int (info.data[0], 50);
+  gst_memory_unmap (mem, &info);
+
+  /* copies keep all memory */
+  copy = gst_buffer_copy (buf);
+  fail_unless_equals_int (gst_buffer_n_memory (copy), 100);
+  fail_unless (gst_buffer_memcmp (copy, 0, bytes, 100) == 0);
+
+  copy = gst_buffer_append (copy, gst_buffer_ref (buf));
+  fail_unless_equals_int (gst_buffer_n_memory (copy), 200);
+  fail_unless (gst_buffer_memcmp (copy, 100, bytes, 100) == 0);
+  gst_buffer_unref (copy);
+
+  /* mapping merges everything */
+  fail_unless (gst_buffer_map (buf, &info, GST_MAP_READ));
+  fail_unless_equals_int (info.size, 100);
+  fail_unless (memcmp (info.data, bytes, 100) == 0);
+  gst_buffer_unmap (buf, &info);
+
+  gst_buffer_remove_memory_range (buf, 0, -1);
+  fail_unless_equals_int (gst_buffer_n_memory (buf), 0);
+  gst_buffer_append_memory (buf,
+      gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY, (gpointer) data,
+          100, 0, 100, NULL, NULL));
+  fail_unless (gst_buffer_memcmp (buf, 0, data, 100) == 0);
+  gst_buffer_unref (buf);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_buffer_suite (void)
 {
@@ -878,6 +935,7 @@ gst_buffer_suite (void)
   tcase_add_test (tc_chain, test_map_range);
   tcase_add_test (tc_chain, test_find);
   tcase_add_test (tc_chain, test_fill);
+  tcase_add_test (tc_chain, test_many_memory);
 
   return s;
 }
@@ -729,6 +729,276 @@ GST_START_TEST (test_custom_main_context)
 
 GST_END_TEST;
 
+static GstMessage *
+new_progress_message (GstObject * src, const gchar * name, gint value)
+{
+  return gst_message_new_element (src, gst_structure_new (name,
+          "value", G_TYPE_INT, value, NULL));
+}
+
+static gint
+get_progress_value (GstMessage * message)
+{
+  gint value = -1;
+
+  gst_structure_get_int (gst_message_get_structure (message), "value", &value);
+  gst_message_unref (message);
+
+  return value;
+}
+
+GST_START_TEST (test_coalesce)
+{
+  GstMessage *message;
+  GstObject *src1, *src2;
+  GstMessageType types;
+  GstClockTime interval;
+  gint i;
+
+  test_bus = gst_bus_new ();
+  src1 = gst_object_ref_sink (gst_bin_new ("src1"));
+  src2 = gst_object_ref_sink (gst_bin_new ("src2"));
+
+  gst_bus_set_coalesce (test_bus, GST_MESSAGE_ELEMENT, 0);
+  gst_bus_get_coalesce (test_bus, &types, &interval);
+  fail_unless_equals_int (types, GST_MESSAGE_ELEMENT);
+  fail_unless_equals_uint64 (interval, 0);
+
+  /* only the latest message of each source and structure name remains,
+   * in the position of the first one */
+  for (i = 0; i < 10; i++) {
+    gst_bus_post (test_bus, new_progress_message (src1, "progress", i));
+    gst_bus_post (test_bus, new_progress_message (src2, "progress", 10 + i));
+    gst_bus_post (test_bus, new_progress_message (src1, "other", 20 + i));
+  }
+  /* not coalesced */
+  gst_bus_post (test_bus, gst_message_new_application (src1,
+          gst_structure_new_empty ("app")));
+  gst_bus_post (test_bus, gst_message_new_application (src1,
+          gst_structure_new_empty ("app")));
+
+  message = gst_bus_peek (test_bus);
+  fail_unless_equals_int (get_progress_value (message), 9);
+
+  fail_unless_equals_int (get_progress_value (gst_bus_pop (test_bus)), 9);
+  fail_unless_equals_int (get_progress_value (gst_bus_pop (test_bus)), 19);
+  fail_unless_equals_int (get_progress_value (gst_bus_pop (test_bus)), 29);
+  for (i = 0; i < 2; i++) {
+    message = gst_bus_pop (test_bus);
+    fail_unless_equals_int (GST_MESSAGE_TYPE (message),
+        GST_MESSAGE_APPLICATION);
+    gst_message_unref (message);
+  }
+  fail_if (gst_bus_have_pending (test_bus), "unexpected messages on bus");
+
+  /* delivered messages are not replaced anymore */
+  gst_bus_post (test_bus, new_progress_message (src1, "progress", 1));
+  fail_unless_equals_int (get_progress_value (gst_bus_pop (test_bus)), 1);
+  gst_bus_post (test_bus, new_progress_message (src1, "progress", 2));
+  fail_unless_equals_int (get_progress_value (gst_bus_pop (test_bus)), 2);
+
+  /* the slots of delivered messages are gone and don't keep their source */
+  ASSERT_OBJECT_REFCOUNT (src1, "src1", 1);
+  ASSERT_OBJECT_REFCOUNT (src2, "src2", 1);
+
+  /* with an interval the messages posted after a delivery are held back and
+   * the latest one is delivered when the interval passed */
+  gst_bus_set_coalesce (test_bus, GST_MESSAGE_ELEMENT, 100 * GST_MSECOND);
+  gst_bus_post (test_bus, new_progress_message (src1, "progress", 1));
+  fail_unless_equals_int (get_progress_value (gst_bus_pop (test_bus)), 1);
+  for (i = 2; i < 10; i++)
+    gst_bus_post (test_bus, new_progress_message (src1, "progress", i));
+  fail_if (gst_bus_have_pending (test_bus), "unexpected messages on bus");
+
+  message = gst_bus_timed_pop (test_bus, GST_SECOND);
+  fail_unless (message != NULL);
+  fail_unless_equals_int (get_progress_value (message), 9);
+  fail_if (gst_bus_have_pending (test_bus), "unexpected messages on bus");
+
+  /* held back messages are dropped when flushing */
+  gst_bus_post (test_bus, new_progress_message (src1, "progress", 10));
+  gst_bus_set_flushing (test_bus, TRUE);
+  gst_bus_set_flushing (test_bus, FALSE);
+  fail_unless (gst_bus_timed_pop (test_bus, 200 * GST_MSECOND) == NULL);
+  ASSERT_OBJECT_REFCOUNT (src1, "src1", 1);
+
+  /* the slot is dropped when the interval passed after the delivery */
+  gst_bus_post (test_bus, new_progress_message (src1, "progress", 11));
+  fail_unless_equals_int (get_progress_value (gst_bus_pop (test_bus)), 11);
+  fail_unless (GST_OBJECT_REFCOUNT_VALUE (src1) > 1);
+  for (i = 0; i < 100 && GST_OBJECT_REFCOUNT_VALUE (src1) > 1; i++)
+    g_usleep (10 * 1000);
+  ASSERT_OBJECT_REFCOUNT (src1, "src1", 1);
+
+  gst_object_unref (src1);
+  gst_object_unref (src2);
+  gst_object_unref (test_bus);
+}
+
+GST_END_TEST;
+
+static gboolean
+count_group_message (GstBus * bus, GstMessage * message, gpointer user_data)
+{
+  gint *counts = user_data;
+  gint idx;
+
+  /* the messages of each bus are dispatched in order */
+  gst_structure_get_int (gst_message_get_structure (message), "idx", &idx);
+  fail_unless_equals_int (idx, counts[0]);
+  counts[0]++;
+
+  /* leave the group after 50 messages */
+  return counts[0] < 50;
+}
+
+static void
+notify_group_bus (gpointer user_data)
+{
+  gint *counts = user_data;
+
+  counts[1]++;
+}
+
+GST_START_TEST (test_bus_group)
+{
+  GstBusGroup *group;
+  GstBus *buses[3];
+  gint counts[3][2] = { {0,}, };
+  GMainContext *ctx;
+  GSource *source;
+  GstMessage *message;
+  guint i, j;
+
+  ctx = g_main_context_new ();
+  group = gst_bus_group_new ();
+
+  for (i = 0; i < G_N_ELEMENTS (buses); i++) {
+    buses[i] = gst_bus_new ();
+    fail_unless (gst_bus_group_add_bus (group, buses[i], count_group_message,
+            counts[i], notify_group_bus));
+  }
+  /* only one group at a time */
+  fail_if (gst_bus_group_add_bus (group, buses[0], count_group_message,
+          counts[0], NULL));
+  /* no separate watch */
+  fail_unless_equals_int (gst_bus_add_watch (buses[0], count_group_message,
+          NULL), 0);
+  fail_unless (gst_bus_create_watch (buses[0]) == NULL);
+
+  source = gst_bus_group_create_watch (group);
+  g_source_attach (source, ctx);
+  g_source_unref (source);
+
+  /* the first bus posts more messages than it handles */
+  for (j = 0; j < 100; j++) {
+    for (i = 0; i < G_N_ELEMENTS (buses); i++) {
+      if (i > 0 && j >= 20)
+        continue;
+      gst_bus_post (buses[i], gst_message_new_application (NULL,
+              gst_structure_new ("test", "idx", G_TYPE_INT, j, NULL)));
+    }
+  }
+
+  while (g_main_context_iteration (ctx, FALSE));
+
+  fail_unless_equals_int (counts[0][0], 50);
+  fail_unless_equals_int (counts[0][1], 1);
+  for (i = 1; i < G_N_ELEMENTS (buses); i++) {
+    fail_unless_equals_int (counts[i][0], 20);
+    fail_unless_equals_int (counts[i][1], 0);
+  }
+
+  /* the messages the first bus didn't handle are still there */
+  for (j = 50; j < 100; j++) {
+    gint idx;
+
+    message = gst_bus_timed_pop (buses[0], 0);
+    fail_unless (message != NULL);
+    gst_structure_get_int (gst_message_get_structure (message), "idx", &idx);
+    fail_unless_equals_int (idx, j);
+    gst_message_unref (message);
+  }
+  fail_if (gst_bus_have_pending (buses[0]));
+
+  /* and it can wait for messages on its own again */
+  gst_bus_post (buses[0], gst_message_new_eos (NULL));
+  message = gst_bus_timed_pop (buses[0], GST_SECOND);
+  fail_unless (message != NULL);
+  gst_message_unref (message);
+
+  /* a bus in a group can't wait for messages */
+  ASSERT_CRITICAL (gst_bus_timed_pop (buses[1], GST_SECOND));
+
+  fail_unless (gst_bus_group_remove_bus (group, buses[1]));
+  fail_if (gst_bus_group_remove_bus (group, buses[1]));
+  fail_unless_equals_int (counts[1][1], 1);
+
+  /* the remaining bus leaves the group when it is freed */
+  g_main_context_unref (ctx);
+  gst_bus_group_unref (group);
+  fail_unless_equals_int (counts[2][1], 1);
+
+  for (i = 0; i < G_N_ELEMENTS (buses); i++)
+    gst_object_unref (buses[i]);
+}
+
+GST_END_TEST;
+
+static gpointer
+post_group_messages (GstBus * bus)
+{
+  gint i;
+
+  for (i = 0; i < 1000; i++)
+    gst_bus_post (bus, gst_message_new_application (NULL,
+            gst_structure_new_empty ("test")));
+
+  return NULL;
+}
+
+static gboolean
+keep_group_message (GstBus * bus, GstMessage * message, gpointer user_data)
+{
+  return TRUE;
+}
+
+/* a pipeline bus can join and leave a group while its elements post */
+GST_START_TEST (test_bus_group_post_thread)
+{
+  GstBusGroup *group;
+  GstBus *bus;
+  GstMessage *message;
+  GThread *thread;
+  gint i, count = 0;
+
+  group = gst_bus_group_new ();
+  bus = gst_bus_new ();
+
+  thread = g_thread_new ("poster", (GThreadFunc) post_group_messages, bus);
+  for (i = 0; i < 100; i++) {
+    fail_unless (gst_bus_group_add_bus (group, bus, keep_group_message, NULL,
+            NULL));
+    fail_unless (gst_bus_group_remove_bus (group, bus));
+  }
+  /* and the group can go away with the bus in it */
+  fail_unless (gst_bus_group_add_bus (group, bus, keep_group_message, NULL,
+          NULL));
+  gst_bus_group_unref (group);
+  g_thread_join (thread);
+
+  /* no message and no wakeup got lost */
+  while ((message = gst_bus_timed_pop (bus, 0))) {
+    count++;
+    gst_message_unref (message);
+  }
+  fail_unless_equals_int (count, 1000);
+
+  gst_object_unref (bus);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_bus_suite (void)
 {
@@ -748,6 +1018,9 @@ gst_bus_suite (void)
   tcase_add_test (tc_chain, test_timed_pop_thread);
   tcase_add_test (tc_chain, test_timed_pop_filtered);
   tcase_add_test (tc_chain, test_timed_pop_filtered_with_timeout);
+  tcase_add_test (tc_chain, test_coalesce);
+  tcase_add_test (tc_chain, test_bus_group);
+  tcase_add_test (tc_chain, test_bus_group_post_thread);
   tcase_add_test (tc_chain, test_custom_main_context);
   return s;
 }
@@ -109,6 +109,44 @@ GST_START_TEST (test_set_master_refcount)
 
 GST_END_TEST;
 
+GST_START_TEST (test_add_observation)
+{
+  GstClock *clock;
+  GstClockTime slave, master, mapped;
+  GstClockTime internal, external, num, denom;
+  gdouble r_squared;
+  gint i;
+
+  clock = g_object_new (TYPE_TEST_CLOCK, "name", "TestClock", NULL);
+  g_object_set (clock, "window-size", 8, "window-threshold", 4, NULL);
+
+  /* the master runs 0.1% faster than the slave. Add enough observations to
+   * wrap around the window a couple of times */
+  for (i = 0; i < 50; i++) {
+    slave = 10 * GST_SECOND + i * 100 * GST_MSECOND;
+    master = 1000 * GST_SECOND + i * 100100 * GST_USECOND;
+
+    if (i < 3) {
+      fail_if (gst_clock_add_observation (clock, slave, master, &r_squared));
+      continue;
+    }
+    fail_unless (gst_clock_add_observation (clock, slave, master,
+            &r_squared));
+    fail_unless (r_squared > 0.999, "bad correlation %g", r_squared);
+
+    gst_clock_get_calibration (clock, &internal, &external, &num, &denom);
+    fail_unless (slave >= internal);
+    mapped = external + gst_util_uint64_scale (slave - internal, num, denom);
+    fail_unless (ABS (GST_CLOCK_DIFF (master, mapped)) < GST_USECOND,
+        "observation %d: expected %" GST_TIME_FORMAT ", got %" GST_TIME_FORMAT,
+        i, GST_TIME_ARGS (master), GST_TIME_ARGS (mapped));
+  }
+
+  gst_object_unref (clock);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_clock_suite (void)
 {
@@ -117,6 +155,7 @@ gst_clock_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_set_master_refcount);
+  tcase_add_test (tc_chain, test_add_observation);
 
   return s;
 }
@@ -78,6 +78,25 @@ GST_START_TEST (create_events)
     fail_unless_equals_int64 (ts, 90 * GST_SECOND);
     gst_event_parse_gap (event, &ts, &dur);
     fail_unless_equals_int64 (dur, GST_SECOND);
+
+    /* copies keep the values */
+    event2 = gst_event_copy (event);
+    gst_event_parse_gap (event2, &ts, &dur);
+    fail_unless_equals_int64 (ts, 90 * GST_SECOND);
+    fail_unless_equals_int64 (dur, GST_SECOND);
+    gst_event_unref (event2);
+
+    /* the structure has the same values and changes to it are visible */
+    fail_unless (gst_event_has_name (event, "GstEventGap"));
+    structure = gst_event_writable_structure (event);
+    fail_unless (structure != NULL);
+    fail_unless (gst_event_get_structure (event) == structure);
+    fail_unless (gst_structure_get_clock_time (structure, "timestamp", &ts));
+    fail_unless_equals_int64 (ts, 90 * GST_SECOND);
+    gst_structure_set (structure, "duration", GST_TYPE_CLOCK_TIME,
+        2 * GST_SECOND, NULL);
+    gst_event_parse_gap (event, &ts, &dur);
+    fail_unless_equals_int64 (dur, 2 * GST_SECOND);
     gst_event_unref (event);
   }
   /* SEGMENT */
@@ -446,6 +446,57 @@ GST_START_TEST (test_dup_null_mini_object)
 
 GST_END_TEST;
 
+GST_START_TEST (test_allocation_cache)
+{
+  guint64 allocs, hits, frees, allocs2, hits2, frees2;
+  GstBuffer *buf, *bufs[5];
+  GstEvent *event;
+  guint limit, cached, cached2, i;
+
+  /* the cache is disabled when running in valgrind */
+  limit = gst_mini_object_get_cache_limit ();
+  gst_mini_object_set_cache_limit (1024);
+
+  /* make sure there is an event in the cache */
+  gst_event_unref (gst_event_new_eos ());
+
+  gst_mini_object_get_cache_stats (&allocs, &hits, &frees, NULL);
+  for (i = 0; i < 10; i++) {
+    buf = gst_buffer_new ();
+    event = gst_event_new_flush_start ();
+    gst_buffer_unref (buf);
+    gst_event_unref (event);
+  }
+  gst_mini_object_get_cache_stats (&allocs2, &hits2, &frees2, &cached);
+
+  /* only the first buffer can miss the cache */
+  fail_unless (allocs2 - allocs >= 20);
+  fail_unless (frees2 - frees >= 20);
+  fail_unless (hits2 - hits >= 19);
+  fail_unless (cached > 0);
+
+  /* every freed buffer goes into the cache */
+  for (i = 0; i < G_N_ELEMENTS (bufs); i++)
+    bufs[i] = gst_buffer_new ();
+  gst_mini_object_get_cache_stats (NULL, NULL, NULL, &cached);
+  for (i = 0; i < G_N_ELEMENTS (bufs); i++)
+    gst_buffer_unref (bufs[i]);
+  gst_mini_object_get_cache_stats (NULL, NULL, NULL, &cached2);
+  fail_unless_equals_int (cached2 - cached, G_N_ELEMENTS (bufs));
+
+  /* and comes out of it again */
+  for (i = 0; i < G_N_ELEMENTS (bufs); i++)
+    bufs[i] = gst_buffer_new ();
+  gst_mini_object_get_cache_stats (NULL, NULL, NULL, &cached);
+  fail_unless_equals_int (cached2 - cached, G_N_ELEMENTS (bufs));
+  for (i = 0; i < G_N_ELEMENTS (bufs); i++)
+    gst_buffer_unref (bufs[i]);
+
+  gst_mini_object_set_cache_limit (limit);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_mini_object_suite (void)
 {
@@ -465,6 +516,7 @@ gst_mini_object_suite (void)
   //tcase_add_test (tc_chain, test_recycle_threaded);
   tcase_add_test (tc_chain, test_value_collection);
   tcase_add_test (tc_chain, test_dup_null_mini_object);
+  tcase_add_test (tc_chain, test_allocation_cache);
   return s;
 }
 
@@ -1813,6 +1813,69 @@ GST_START_TEST (test_sticky_events)
 
 GST_END_TEST;
 
+static gboolean
+remove_caps_event (GstPad * pad, GstEvent ** event, gpointer user_data)
+{
+  if (GST_EVENT_TYPE (*event) == GST_EVENT_CAPS)
+    gst_event_replace (event, NULL);
+  return TRUE;
+}
+
+GST_START_TEST (test_sticky_events_remove)
+{
+  GstPad *srcpad;
+  GstCaps *caps;
+  GstEvent *event;
+
+  srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  fail_unless (srcpad != NULL);
+  gst_pad_set_active (srcpad, TRUE);
+
+  fail_unless (gst_pad_get_sticky_event (srcpad, GST_EVENT_CAPS, 0) == NULL);
+  fail_unless (gst_pad_get_sticky_event (srcpad, GST_EVENT_TAG, 0) == NULL);
+
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("test"));
+  caps = gst_caps_new_empty_simple ("foo/bar");
+  gst_pad_push_event (srcpad, gst_event_new_caps (caps));
+  gst_caps_unref (caps);
+  gst_pad_push_event (srcpad, gst_event_new_tag (gst_tag_list_new_empty ()));
+
+  event = gst_pad_get_sticky_event (srcpad, GST_EVENT_CAPS, 0);
+  fail_unless (event != NULL);
+  gst_event_unref (event);
+
+  /* remove the caps, the other events should still be found */
+  gst_pad_sticky_events_foreach (srcpad, remove_caps_event, NULL);
+  fail_unless (gst_pad_get_sticky_event (srcpad, GST_EVENT_CAPS, 0) == NULL);
+  fail_unless (gst_pad_get_current_caps (srcpad) == NULL);
+  event = gst_pad_get_sticky_event (srcpad, GST_EVENT_TAG, 0);
+  fail_unless (event != NULL);
+  gst_event_unref (event);
+  event = gst_pad_get_sticky_event (srcpad, GST_EVENT_STREAM_START, 0);
+  fail_unless (event != NULL);
+  gst_event_unref (event);
+
+  /* and can be stored again */
+  caps = gst_caps_new_empty_simple ("foo/baz");
+  gst_pad_push_event (srcpad, gst_event_new_caps (caps));
+  gst_caps_unref (caps);
+  caps = gst_pad_get_current_caps (srcpad);
+  fail_unless (caps != NULL);
+  fail_unless (gst_structure_has_name (gst_caps_get_structure (caps, 0),
+          "foo/baz"));
+  gst_caps_unref (caps);
+
+  /* deactivating removes all of them */
+  gst_pad_set_active (srcpad, FALSE);
+  fail_unless (gst_pad_get_sticky_event (srcpad, GST_EVENT_TAG, 0) == NULL);
+  fail_unless (gst_pad_get_sticky_event (srcpad, GST_EVENT_STREAM_START,
+          0) == NULL);
+
+  gst_object_unref (srcpad);
+}
+
+GST_END_TEST;
+
 static GstFlowReturn next_return;
 
 static GstFlowReturn
@@ -2095,6 +2158,7 @@ gst_pad_suite (void)
   tcase_add_test (tc_chain, test_block_async_full_destroy_dispose);
   tcase_add_test (tc_chain, test_block_async_replace_callback_no_flush);
   tcase_add_test (tc_chain, test_sticky_events);
+  tcase_add_test (tc_chain, test_sticky_events_remove);
   tcase_add_test (tc_chain, test_last_flow_return_push);
   tcase_add_test (tc_chain, test_last_flow_return_pull);
   tcase_add_test (tc_chain, test_flush_stop_inactive);
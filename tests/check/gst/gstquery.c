@@ -40,6 +40,19 @@ GST_START_TEST (create_queries)
     fail_if (format != GST_FORMAT_TIME);
     fail_if (position != 0xdeadbeaf);
 
+    /* the structure has the same values and is used from then on */
+    {
+      GstStructure *s = gst_query_writable_structure (query);
+
+      fail_unless (gst_structure_has_name (s, "GstQueryPosition"));
+      fail_unless (gst_structure_get_int64 (s, "current", &position));
+      fail_if (position != 0xdeadbeaf);
+
+      gst_query_set_position (query, GST_FORMAT_TIME, 0xbeafdead);
+      fail_unless (gst_structure_get_int64 (s, "current", &position));
+      fail_if (position != 0xbeafdead);
+    }
+
     gst_query_unref (query);
   }
   /* DURATION */
@@ -248,6 +248,74 @@ GST_START_TEST (test_create)
 
 GST_END_TEST;
 
+static guint stats_iterations;
+
+static void
+task_stats_func (void *data)
+{
+  GstTask *t = *((GstTask **) data);
+
+  g_usleep (1000);
+
+  g_mutex_lock (&task_lock);
+  if (++stats_iterations == 10) {
+    gst_task_pause (t);
+    g_cond_signal (&task_cond);
+  }
+  g_mutex_unlock (&task_lock);
+}
+
+GST_START_TEST (test_stats)
+{
+  GstTask *t;
+  GstStructure *stats;
+  guint64 iterations, busy_time, wait_time, cpu_time;
+
+  t = gst_task_new (task_stats_func, &t, NULL);
+  fail_if (t == NULL);
+
+  g_rec_mutex_init (&task_mutex);
+  gst_task_set_lock (t, &task_mutex);
+
+  g_cond_init (&task_cond);
+  g_mutex_init (&task_lock);
+
+  /* nothing is collected by default */
+  fail_unless (gst_task_get_stats (t) == NULL);
+  gst_task_set_collect_stats (t, TRUE);
+
+  g_mutex_lock (&task_lock);
+  stats_iterations = 0;
+  fail_unless (gst_task_start (t));
+  while (stats_iterations < 10)
+    g_cond_wait (&task_cond, &task_lock);
+  g_mutex_unlock (&task_lock);
+
+  fail_unless (gst_task_stop (t));
+  fail_unless (gst_task_join (t));
+
+  stats = gst_task_get_stats (t);
+  fail_unless (stats != NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "iterations", &iterations));
+  fail_unless (gst_structure_get_uint64 (stats, "busy-time", &busy_time));
+  fail_unless (gst_structure_get_uint64 (stats, "wait-time", &wait_time));
+  fail_unless (gst_structure_get_uint64 (stats, "cpu-time", &cpu_time));
+  gst_structure_free (stats);
+
+  fail_unless_equals_uint64 (iterations, 10);
+  fail_unless (busy_time >= 10 * GST_MSECOND);
+  /* the task mostly slept */
+  if (GST_CLOCK_TIME_IS_VALID (cpu_time))
+    fail_unless (cpu_time < busy_time);
+
+  g_cond_clear (&task_cond);
+  g_mutex_clear (&task_lock);
+
+  gst_object_unref (t);
+}
+
+GST_END_TEST;
+
 
 static Suite *
 gst_task_suite (void)
@@ -262,6 +330,7 @@ gst_task_suite (void)
   tcase_add_test (tc_chain, test_lock_start);
   tcase_add_test (tc_chain, test_join);
   tcase_add_test (tc_chain, test_pause_stop_race);
+  tcase_add_test (tc_chain, test_stats);
 
   return s;
 }
@@ -164,6 +164,187 @@ GST_START_TEST (test_element_make_from_uri)
 
 GST_END_TEST;
 
+typedef GstElement TestURISrc;
+typedef GstElementClass TestURISrcClass;
+
+static GstURIType
+test_uri_src_get_uri_type (GType type)
+{
+  return GST_URI_SRC;
+}
+
+static const gchar *const *
+test_uri_src_get_protocols (GType type)
+{
+  static const gchar *protocols[] = { "gstchecktest", NULL };
+
+  return protocols;
+}
+
+static gchar *
+test_uri_src_get_uri (GstURIHandler * handler)
+{
+  return NULL;
+}
+
+static gboolean
+test_uri_src_set_uri (GstURIHandler * handler, const gchar * uri,
+    GError ** error)
+{
+  return TRUE;
+}
+
+static void
+test_uri_src_handler_init (gpointer g_iface, gpointer iface_data)
+{
+  GstURIHandlerInterface *iface = (GstURIHandlerInterface *) g_iface;
+
+  iface->get_type = test_uri_src_get_uri_type;
+  iface->get_protocols = test_uri_src_get_protocols;
+  iface->get_uri = test_uri_src_get_uri;
+  iface->set_uri = test_uri_src_set_uri;
+}
+
+G_DEFINE_TYPE_WITH_CODE (TestURISrc, test_uri_src, GST_TYPE_ELEMENT,
+    G_IMPLEMENT_INTERFACE (GST_TYPE_URI_HANDLER, test_uri_src_handler_init));
+
+static void
+test_uri_src_class_init (TestURISrcClass * klass)
+{
+  gst_element_class_set_static_metadata (klass, "Test URI source", "Source",
+      "Test URI handler", "GStreamer developers");
+}
+
+static void
+test_uri_src_init (TestURISrc * src)
+{
+}
+
+typedef TestURISrc TestURISrc2;
+typedef TestURISrcClass TestURISrc2Class;
+
+G_DEFINE_TYPE (TestURISrc2, test_uri_src2, test_uri_src_get_type ());
+
+static void
+test_uri_src2_class_init (TestURISrc2Class * klass)
+{
+}
+
+static void
+test_uri_src2_init (TestURISrc2 * src)
+{
+}
+
+GST_START_TEST (test_element_make_from_uri_rank)
+{
+  GstPluginFeature *feature;
+  GstElement *element;
+
+  fail_unless (gst_element_register (NULL, "testurisrc", GST_RANK_MARGINAL,
+          test_uri_src_get_type ()));
+  fail_unless (gst_element_register (NULL, "testurisrc2", GST_RANK_PRIMARY,
+          test_uri_src2_get_type ()));
+
+  fail_unless (gst_uri_protocol_is_supported (GST_URI_SRC, "gstchecktest"));
+  fail_unless (gst_uri_protocol_is_supported (GST_URI_SRC, "GstCheckTest"));
+  fail_if (gst_uri_protocol_is_supported (GST_URI_SINK, "gstchecktest"));
+  fail_if (gst_uri_protocol_is_supported (GST_URI_SRC, "gstchecktest2"));
+
+  /* the factory with the highest rank is used */
+  element = gst_element_make_from_uri (GST_URI_SRC, "gstchecktest://foo",
+      NULL, NULL);
+  fail_unless (element != NULL);
+  fail_unless (G_OBJECT_TYPE (element) == test_uri_src2_get_type ());
+  gst_object_unref (element);
+
+  /* also when the rank changes after the factories were looked up */
+  feature = gst_registry_lookup_feature (gst_registry_get (), "testurisrc");
+  fail_unless (feature != NULL);
+  gst_plugin_feature_set_rank (feature, GST_RANK_PRIMARY + 1);
+  gst_object_unref (feature);
+
+  element = gst_element_make_from_uri (GST_URI_SRC, "GSTCHECKTEST://foo",
+      NULL, NULL);
+  fail_unless (element != NULL);
+  fail_unless (G_OBJECT_TYPE (element) == test_uri_src_get_type ());
+  gst_object_unref (element);
+}
+
+GST_END_TEST;
+
+typedef GstElement TestURISink;
+typedef GstElementClass TestURISinkClass;
+
+static GstURIType
+test_uri_sink_get_uri_type (GType type)
+{
+  return GST_URI_SINK;
+}
+
+static void
+test_uri_sink_handler_init (gpointer g_iface, gpointer iface_data)
+{
+  GstURIHandlerInterface *iface = (GstURIHandlerInterface *) g_iface;
+
+  iface->get_type = test_uri_sink_get_uri_type;
+  iface->get_protocols = test_uri_src_get_protocols;
+  iface->get_uri = test_uri_src_get_uri;
+  iface->set_uri = test_uri_src_set_uri;
+}
+
+G_DEFINE_TYPE_WITH_CODE (TestURISink, test_uri_sink, GST_TYPE_ELEMENT,
+    G_IMPLEMENT_INTERFACE (GST_TYPE_URI_HANDLER, test_uri_sink_handler_init));
+
+static void
+test_uri_sink_class_init (TestURISinkClass * klass)
+{
+  gst_element_class_set_static_metadata (klass, "Test URI sink", "Sink",
+      "Test URI handler", "GStreamer developers");
+}
+
+static void
+test_uri_sink_init (TestURISink * sink)
+{
+}
+
+typedef TestURISink TestURISink2;
+typedef TestURISinkClass TestURISink2Class;
+
+G_DEFINE_TYPE (TestURISink2, test_uri_sink2, test_uri_sink_get_type ());
+
+static void
+test_uri_sink2_class_init (TestURISink2Class * klass)
+{
+}
+
+static void
+test_uri_sink2_init (TestURISink2 * sink)
+{
+}
+
+GST_START_TEST (test_element_make_from_uri_equal_rank)
+{
+  GstElement *element;
+  gint i;
+
+  fail_unless (gst_element_register (NULL, "testurisink", GST_RANK_PRIMARY,
+          test_uri_sink_get_type ()));
+  fail_unless (gst_element_register (NULL, "testurisink2", GST_RANK_PRIMARY,
+          test_uri_sink2_get_type ()));
+
+  /* with equal ranks the factory that was registered first is used, also
+   * when the index is looked up again */
+  for (i = 0; i < 2; i++) {
+    element = gst_element_make_from_uri (GST_URI_SINK, "gstchecktest://foo",
+        NULL, NULL);
+    fail_unless (element != NULL);
+    fail_unless (G_OBJECT_TYPE (element) == test_uri_sink_get_type ());
+    gst_object_unref (element);
+  }
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_url_parsing)
 {
   GstUri *url;
@@ -765,6 +946,8 @@ gst_uri_suite (void)
   tcase_add_test (tc_chain, test_uri_get_location);
   tcase_add_test (tc_chain, test_uri_misc);
   tcase_add_test (tc_chain, test_element_make_from_uri);
+  tcase_add_test (tc_chain, test_element_make_from_uri_rank);
+  tcase_add_test (tc_chain, test_element_make_from_uri_equal_rank);
 #ifdef G_OS_WIN32
   tcase_add_test (tc_chain, test_win32_uri);
 #endif
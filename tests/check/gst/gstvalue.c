@@ -2865,6 +2865,130 @@ GST_START_TEST (test_stepped_int_range_ops)
 
 GST_END_TEST;
 
+static GstCaps *
+check_binary_round_trip (const GValue * value)
+{
+  GValue res = G_VALUE_INIT;
+  GByteArray *data;
+  gsize consumed, len;
+  GstCaps *caps = NULL;
+
+  data = g_byte_array_new ();
+  /* something in front to check that the value is appended */
+  g_byte_array_append (data, (const guint8 *) "x", 1);
+  fail_unless (gst_value_serialize_binary (value, data));
+
+  fail_unless (gst_value_deserialize_binary (&res, data->data + 1,
+          data->len - 1, &consumed));
+  fail_unless_equals_int (consumed, data->len - 1);
+  fail_unless (G_VALUE_TYPE (&res) == G_VALUE_TYPE (value));
+  if (G_VALUE_TYPE (value) == GST_TYPE_CAPS) {
+    fail_unless (gst_value_compare (&res, value) == GST_VALUE_EQUAL);
+    caps = g_value_dup_boxed (&res);
+  }
+  g_value_unset (&res);
+
+  /* all truncated versions must be rejected */
+  for (len = 0; len < data->len - 1; len++)
+    fail_if (gst_value_deserialize_binary (&res, data->data + 1, len, NULL));
+
+  /* and so must a wrong version */
+  data->data[1]++;
+  fail_if (gst_value_deserialize_binary (&res, data->data + 1,
+          data->len - 1, NULL));
+
+  g_byte_array_free (data, TRUE);
+
+  return caps;
+}
+
+GST_START_TEST (test_serialize_deserialize_binary)
+{
+  GValue value = G_VALUE_INIT;
+  GValue v = G_VALUE_INIT;
+  GValue res = G_VALUE_INIT;
+  GByteArray *data;
+  GstStructure *s;
+  GstTagList *tags;
+  GstCaps *caps, *caps2;
+  GstBuffer *buf;
+
+  caps = gst_caps_from_string ("video/x-raw(memory:Foo, meta:Bar), "
+      "format=(string){ I420, NV12 }, width=(int)[ 16, 4096, 16 ], "
+      "framerate=(fraction)[ 0/1, 2147483647/1 ], "
+      "pixel-aspect-ratio=(fraction)-1/3, rate=(double)[ 0.5, 2.5 ], "
+      "interlaced=(boolean)true, views=(int)< 1, -2, 2147483647 >, "
+      "empty=(string)\"\", level=(uint)4294967295; "
+      "audio/x-raw(ANY), channels=(int)-2147483648; "
+      "audio/x-raw, layout=(string)interleaved");
+  fail_unless (caps != NULL);
+
+  s = gst_structure_new ("test/fields", "mask", GST_TYPE_BITMASK,
+      G_GUINT64_CONSTANT (0xf0000000000000f0), "i64", G_TYPE_INT64,
+      G_MININT64, "u64", G_TYPE_UINT64, G_MAXUINT64, "float", G_TYPE_FLOAT,
+      -1.25f, "null-string", G_TYPE_STRING, NULL, "state", GST_TYPE_STATE,
+      GST_STATE_PLAYING, "flags", GST_TYPE_SEEK_FLAGS,
+      GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT, NULL);
+  g_value_init (&v, GST_TYPE_INT64_RANGE);
+  gst_value_set_int64_range_step (&v, -100, 1000, 10);
+  gst_structure_set_value (s, "range64", &v);
+  g_value_unset (&v);
+  /* goes through the string serialization */
+  buf = gst_buffer_new_wrapped (g_strdup ("data"), 4);
+  gst_structure_set (s, "buffer", GST_TYPE_BUFFER, buf, NULL);
+  gst_buffer_unref (buf);
+  gst_caps_append_structure (caps, s);
+
+  g_value_init (&value, GST_TYPE_CAPS);
+  g_value_take_boxed (&value, caps);
+  caps2 = check_binary_round_trip (&value);
+  fail_unless (gst_caps_is_strictly_equal (caps, caps2));
+  gst_caps_unref (caps2);
+
+  g_value_set_boxed (&value, GST_CAPS_ANY);
+  caps2 = check_binary_round_trip (&value);
+  fail_unless (gst_caps_is_any (caps2));
+  gst_caps_unref (caps2);
+
+  g_value_set_boxed (&value, GST_CAPS_NONE);
+  caps2 = check_binary_round_trip (&value);
+  fail_unless (gst_caps_is_empty (caps2));
+  gst_caps_unref (caps2);
+  g_value_unset (&value);
+
+  /* taglists */
+  tags = gst_tag_list_new (GST_TAG_TITLE, "title", GST_TAG_ARTIST, "a",
+      GST_TAG_TRACK_NUMBER, 5, NULL);
+  gst_tag_list_add (tags, GST_TAG_MERGE_APPEND, GST_TAG_ARTIST, "b", NULL);
+  gst_tag_list_set_scope (tags, GST_TAG_SCOPE_GLOBAL);
+  g_value_init (&value, GST_TYPE_TAG_LIST);
+  g_value_take_boxed (&value, tags);
+  check_binary_round_trip (&value);
+
+  data = g_byte_array_new ();
+  fail_unless (gst_value_serialize_binary (&value, data));
+  fail_unless (gst_value_deserialize_binary (&res, data->data, data->len,
+          NULL));
+  fail_unless (gst_tag_list_is_equal (tags, g_value_get_boxed (&res)));
+  fail_unless_equals_int (gst_tag_list_get_tag_size (g_value_get_boxed (&res),
+          GST_TAG_ARTIST), 2);
+  fail_unless_equals_int (gst_tag_list_get_scope (g_value_get_boxed (&res)),
+      GST_TAG_SCOPE_GLOBAL);
+  g_value_unset (&res);
+  g_byte_array_free (data, TRUE);
+  g_value_unset (&value);
+
+  /* values that can't be serialized leave the array untouched */
+  g_value_init (&value, G_TYPE_POINTER);
+  data = g_byte_array_new ();
+  fail_if (gst_value_serialize_binary (&value, data));
+  fail_unless_equals_int (data->len, 0);
+  g_byte_array_free (data, TRUE);
+  g_value_unset (&value);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_value_suite (void)
 {
@@ -2907,6 +3031,7 @@ gst_value_suite (void)
   tcase_add_test (tc_chain, test_stepped_range_collection);
   tcase_add_test (tc_chain, test_stepped_int_range_parsing);
   tcase_add_test (tc_chain, test_stepped_int_range_ops);
+  tcase_add_test (tc_chain, test_serialize_deserialize_binary);
 
   return s;
 }
@@ -23,6 +23,7 @@
 #endif
 #include <gst/gst.h>
 #include <gst/check/gstcheck.h>
+#include <gst/check/gsttestclock.h>
 #include <gst/base/gstbasesink.h>
 
 GST_START_TEST (basesink_last_sample_enabled)
@@ -242,6 +243,257 @@ GST_START_TEST (basesink_test_eos_after_playing)
 
 GST_END_TEST;
 
+static void
+handoff_cb (GstElement * sink, GstBuffer * buffer, GstPad * pad,
+    GstClockTime * last_pts)
+{
+  /* buffers are rendered in order */
+  fail_unless (*last_pts == GST_CLOCK_TIME_NONE
+      || GST_BUFFER_PTS (buffer) > *last_pts);
+  *last_pts = GST_BUFFER_PTS (buffer);
+}
+
+GST_START_TEST (basesink_test_render_window)
+{
+  GstElement *pipeline, *sink;
+  GstBufferList *list;
+  GstBuffer *buffer;
+  GstSample *last_sample;
+  GstSegment segment;
+  GstClockTime last_pts = GST_CLOCK_TIME_NONE;
+  GstPad *pad;
+  gint64 window;
+  guint i;
+
+  sink = gst_element_factory_make ("fakesink", "sink");
+  g_object_set (sink, "sync", TRUE, "signal-handoffs", TRUE,
+      "render-window", 2 * GST_MSECOND, NULL);
+  g_signal_connect (sink, "handoff", G_CALLBACK (handoff_cb), &last_pts);
+
+  window = gst_base_sink_get_render_window (GST_BASE_SINK (sink));
+  fail_unless_equals_int64 (window, 2 * GST_MSECOND);
+
+  pipeline = gst_pipeline_new (NULL);
+  gst_bin_add (GST_BIN (pipeline), sink);
+  pad = gst_element_get_static_pad (sink, "sink");
+
+  fail_unless (gst_element_set_state (pipeline, GST_STATE_PLAYING)
+      == GST_STATE_CHANGE_ASYNC);
+
+  fail_unless (gst_pad_send_event (pad, gst_event_new_stream_start ("test")));
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_send_event (pad, gst_event_new_segment (&segment)));
+
+  /* sink without render_list, the buffers are rendered one by one in runs
+   * of 3 */
+  list = gst_buffer_list_new ();
+  for (i = 0; i < 6; i++) {
+    buffer = gst_buffer_new ();
+    GST_BUFFER_PTS (buffer) = i * GST_MSECOND;
+    GST_BUFFER_DURATION (buffer) = GST_MSECOND;
+    gst_buffer_list_add (list, buffer);
+  }
+  fail_unless_equals_int (gst_pad_chain_list (pad, list), GST_FLOW_OK);
+
+  fail_unless_equals_uint64 (last_pts, 5 * GST_MSECOND);
+
+  /* the last sample is the last buffer of the list */
+  g_object_get (sink, "last-sample", &last_sample, NULL);
+  fail_unless (last_sample != NULL);
+  fail_unless_equals_uint64 (GST_BUFFER_PTS (gst_sample_get_buffer
+          (last_sample)), 5 * GST_MSECOND);
+  gst_sample_unref (last_sample);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+
+  gst_object_unref (pad);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
+/* a sink that records the PTS of the first buffer and the number of buffers
+ * of every render_list call */
+typedef GstBaseSink TestRenderSink;
+typedef GstBaseSinkClass TestRenderSinkClass;
+
+static GType test_render_sink_get_type (void);
+G_DEFINE_TYPE (TestRenderSink, test_render_sink, GST_TYPE_BASE_SINK);
+
+static GstStaticPadTemplate test_render_sink_template =
+GST_STATIC_PAD_TEMPLATE ("sink", GST_PAD_SINK, GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+static GArray *render_first_pts;
+static GArray *render_lengths;
+
+static GstFlowReturn
+test_render_sink_render_list (GstBaseSink * sink, GstBufferList * list)
+{
+  GstClockTime pts = GST_BUFFER_PTS (gst_buffer_list_get (list, 0));
+  guint len = gst_buffer_list_length (list);
+
+  g_array_append_val (render_first_pts, pts);
+  g_array_append_val (render_lengths, len);
+
+  return GST_FLOW_OK;
+}
+
+static void
+test_render_sink_class_init (TestRenderSinkClass * klass)
+{
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+
+  gst_element_class_add_pad_template (element_class,
+      gst_static_pad_template_get (&test_render_sink_template));
+  gst_element_class_set_static_metadata (element_class, "Test render sink",
+      "Sink", "Records the render_list calls", "GStreamer");
+
+  klass->render_list = test_render_sink_render_list;
+}
+
+static void
+test_render_sink_init (TestRenderSink * sink)
+{
+}
+
+static GstPad *chain_pad;
+
+static gpointer
+chain_list_func (GstBufferList * list)
+{
+  return GINT_TO_POINTER (gst_pad_chain_list (chain_pad, list));
+}
+
+static GstBufferList *
+make_list (guint first_ms, guint n)
+{
+  GstBufferList *list;
+  GstBuffer *buffer;
+  guint i;
+
+  list = gst_buffer_list_new ();
+  for (i = 0; i < n; i++) {
+    buffer = gst_buffer_new ();
+    GST_BUFFER_PTS (buffer) = (first_ms + i) * GST_MSECOND;
+    GST_BUFFER_DURATION (buffer) = GST_MSECOND;
+    gst_buffer_list_add (list, buffer);
+  }
+  return list;
+}
+
+/* let the pending clock wait for @time return, with the clock at @time */
+static void
+release_clock_wait (GstClock * clock, GstClockTime time)
+{
+  GstClockID id;
+
+  gst_test_clock_wait_for_next_pending_id (GST_TEST_CLOCK (clock), &id);
+  fail_unless_equals_uint64 (gst_clock_id_get_time (id), time);
+  gst_clock_id_unref (id);
+  if (gst_clock_get_time (clock) < time)
+    gst_test_clock_set_time (GST_TEST_CLOCK (clock), time);
+  id = gst_test_clock_process_next_clock_id (GST_TEST_CLOCK (clock));
+  fail_unless (id != NULL);
+  gst_clock_id_unref (id);
+}
+
+static void
+check_render (guint idx, GstClockTime first_pts, guint len)
+{
+  fail_unless_equals_uint64 (g_array_index (render_first_pts, GstClockTime,
+          idx), first_pts);
+  fail_unless_equals_int (g_array_index (render_lengths, guint, idx), len);
+}
+
+/* one clock wait and one render_list call per run, lateness and QoS for
+ * every buffer */
+GST_START_TEST (basesink_test_render_window_runs)
+{
+  GstElement *pipeline, *sink;
+  GstClock *clock;
+  GstSegment segment;
+  GstMessage *msg;
+  GstFormat format;
+  GstBus *bus;
+  GThread *thread;
+  guint64 timestamp, rendered, dropped;
+
+  render_first_pts = g_array_new (FALSE, FALSE, sizeof (GstClockTime));
+  render_lengths = g_array_new (FALSE, FALSE, sizeof (guint));
+
+  clock = gst_test_clock_new ();
+  sink = g_object_new (test_render_sink_get_type (), NULL);
+  g_object_set (sink, "sync", TRUE, "qos", TRUE, "max-lateness", (gint64) 0,
+      "render-window", (gint64) (2 * GST_MSECOND), NULL);
+
+  pipeline = gst_pipeline_new (NULL);
+  gst_pipeline_use_clock (GST_PIPELINE (pipeline), clock);
+  gst_bin_add (GST_BIN (pipeline), sink);
+  chain_pad = gst_element_get_static_pad (sink, "sink");
+  bus = gst_element_get_bus (pipeline);
+
+  fail_unless (gst_element_set_state (pipeline, GST_STATE_PLAYING)
+      == GST_STATE_CHANGE_ASYNC);
+
+  fail_unless (gst_pad_send_event (chain_pad,
+          gst_event_new_stream_start ("test")));
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_send_event (chain_pad,
+          gst_event_new_segment (&segment)));
+
+  /* 0-5 ms are rendered in the runs 0-2 ms and 3-5 ms, waiting on the clock
+   * for the first buffer of each run only */
+  thread = g_thread_new ("chain", (GThreadFunc) chain_list_func,
+      make_list (0, 6));
+  release_clock_wait (clock, 0);
+  release_clock_wait (clock, 3 * GST_MSECOND);
+  fail_unless_equals_int (GPOINTER_TO_INT (g_thread_join (thread)),
+      GST_FLOW_OK);
+  fail_unless_equals_int (gst_test_clock_peek_id_count (GST_TEST_CLOCK
+          (clock)), 0);
+
+  fail_unless_equals_int (render_lengths->len, 2);
+  check_render (0, 0, 3);
+  check_render (1, 3 * GST_MSECOND, 3);
+
+  /* 10-12 ms is one run, but the clock is at 11.5 ms already. Only the
+   * first buffer is too late, the others are still rendered */
+  gst_test_clock_set_time (GST_TEST_CLOCK (clock),
+      11 * GST_MSECOND + GST_MSECOND / 2);
+  thread = g_thread_new ("chain", (GThreadFunc) chain_list_func,
+      make_list (10, 3));
+  release_clock_wait (clock, 10 * GST_MSECOND);
+  fail_unless_equals_int (GPOINTER_TO_INT (g_thread_join (thread)),
+      GST_FLOW_OK);
+
+  fail_unless_equals_int (render_lengths->len, 3);
+  check_render (2, 11 * GST_MSECOND, 2);
+
+  /* one QoS message, for the dropped buffer */
+  msg = gst_bus_pop_filtered (bus, GST_MESSAGE_QOS);
+  fail_unless (msg != NULL);
+  gst_message_parse_qos (msg, NULL, NULL, NULL, &timestamp, NULL);
+  fail_unless_equals_uint64 (timestamp, 10 * GST_MSECOND);
+  gst_message_parse_qos_stats (msg, &format, &rendered, &dropped);
+  fail_unless_equals_int (format, GST_FORMAT_BUFFERS);
+  fail_unless_equals_uint64 (rendered, 6);
+  fail_unless_equals_uint64 (dropped, 1);
+  gst_message_unref (msg);
+  fail_unless (gst_bus_pop_filtered (bus, GST_MESSAGE_QOS) == NULL);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+
+  gst_object_unref (chain_pad);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+  gst_object_unref (clock);
+  g_array_free (render_first_pts, TRUE);
+  g_array_free (render_lengths, TRUE);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_basesrc_suite (void)
 {
@@ -253,6 +505,8 @@ gst_basesrc_suite (void)
   tcase_add_test (tc, basesink_last_sample_disabled);
   tcase_add_test (tc, basesink_test_gap);
   tcase_add_test (tc, basesink_test_eos_after_playing);
+  tcase_add_test (tc, basesink_test_render_window);
+  tcase_add_test (tc, basesink_test_render_window_runs);
 
   return s;
 }
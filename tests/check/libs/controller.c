@@ -662,6 +662,49 @@ GST_START_TEST (controller_interpolation_linear_value_array)
 
 GST_END_TEST;
 
+/* test retrieval of a large array of unboxed values with get_value_array() */
+GST_START_TEST (controller_interpolation_linear_large_value_array)
+{
+  GstControlSource *cs;
+  GstTimedValueControlSource *tvcs;
+  GstElement *elem;
+  gfloat *values;
+  gint i;
+
+  elem = gst_element_factory_make ("testobj", NULL);
+
+  /* new interpolation control source */
+  cs = gst_interpolation_control_source_new ();
+  tvcs = (GstTimedValueControlSource *) cs;
+
+  fail_unless (gst_object_add_control_binding (GST_OBJECT (elem),
+          gst_direct_control_binding_new (GST_OBJECT (elem), "float", cs)));
+
+  /* set interpolation mode */
+  g_object_set (cs, "mode", GST_INTERPOLATION_MODE_LINEAR, NULL);
+
+  /* set control values */
+  fail_unless (gst_timed_value_control_source_set (tvcs, 0, 0.0));
+  fail_unless (gst_timed_value_control_source_set (tvcs, 1000 * GST_MSECOND,
+          1.0));
+
+  /* now pull in mapped values for more timestamps than one conversion block */
+  values = g_new0 (gfloat, 1001);
+
+  fail_unless (gst_object_get_value_array (GST_OBJECT (elem), "float",
+          0, GST_MSECOND, 1001, values));
+  for (i = 0; i <= 1000; i++)
+    fail_unless (fabs (values[i] - i / 10.0) < 0.0001, "values[%d] = %f", i,
+        values[i]);
+
+  g_free (values);
+
+  gst_object_unref (cs);
+  gst_object_unref (elem);
+}
+
+GST_END_TEST;
+
 /* test if values below minimum and above maximum are clipped */
 GST_START_TEST (controller_interpolation_linear_invalid_values)
 {
@@ -1478,6 +1521,7 @@ gst_controller_suite (void)
   tcase_add_test (tc, controller_interpolation_unset);
   tcase_add_test (tc, controller_interpolation_unset_all);
   tcase_add_test (tc, controller_interpolation_linear_value_array);
+  tcase_add_test (tc, controller_interpolation_linear_large_value_array);
   tcase_add_test (tc, controller_interpolation_linear_invalid_values);
   tcase_add_test (tc, controller_interpolation_linear_default_values);
   tcase_add_test (tc, controller_interpolation_linear_disabled);
@@ -0,0 +1,240 @@
+/* GStreamer
+ *
+ * unit test for GstHarness
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <glib/gstdio.h>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>             /* for close() */
+#endif
+
+#include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
+
+GST_START_TEST (test_push_pull)
+{
+  GstHarness *h;
+  GstBuffer *buf;
+  GstEvent *event;
+  gint i;
+
+  h = gst_harness_new ("identity");
+  fail_unless (h != NULL);
+  fail_unless (h->srcpad != NULL);
+  fail_unless (h->sinkpad != NULL);
+
+  gst_harness_set_src_caps_str (h, "application/x-test");
+
+  /* stream-start, caps and segment came out */
+  fail_unless_equals_int (gst_harness_events_received (h), 3);
+  event = gst_harness_pull_event (h);
+  fail_unless_equals_int (GST_EVENT_TYPE (event), GST_EVENT_STREAM_START);
+  gst_event_unref (event);
+  event = gst_harness_pull_event (h);
+  fail_unless_equals_int (GST_EVENT_TYPE (event), GST_EVENT_CAPS);
+  gst_event_unref (event);
+  event = gst_harness_pull_event (h);
+  fail_unless_equals_int (GST_EVENT_TYPE (event), GST_EVENT_SEGMENT);
+  gst_event_unref (event);
+  fail_unless (gst_harness_try_pull_event (h) == NULL);
+
+  for (i = 0; i < 10; i++) {
+    buf = gst_buffer_new_allocate (NULL, i + 1, NULL);
+    fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+  }
+  fail_unless_equals_int (gst_harness_buffers_received (h), 10);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h), 10);
+
+  for (i = 0; i < 10; i++) {
+    buf = gst_harness_pull (h);
+    fail_unless (buf != NULL);
+    fail_unless_equals_int (gst_buffer_get_size (buf), i + 1);
+    gst_buffer_unref (buf);
+  }
+  fail_unless (gst_harness_try_pull (h) == NULL);
+
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+  event = gst_harness_pull_event (h);
+  fail_unless_equals_int (GST_EVENT_TYPE (event), GST_EVENT_EOS);
+  gst_event_unref (event);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_stats)
+{
+  GstHarness *h;
+  GstHarnessStats stats;
+  gint i;
+
+  h = gst_harness_new ("identity");
+  gst_harness_set_src_caps_str (h, "application/x-test");
+  gst_harness_set_drop_buffers (h, TRUE);
+
+  gst_harness_get_stats (h, &stats);
+  fail_unless_equals_uint64 (stats.buffers_pushed, 0);
+  fail_unless_equals_uint64 (stats.buffers_received, 0);
+  fail_unless_equals_uint64 (stats.latency_50, GST_CLOCK_TIME_NONE);
+
+  for (i = 0; i < 100; i++)
+    gst_harness_push (h, gst_buffer_new_allocate (NULL, 10, NULL));
+
+  fail_unless_equals_int (gst_harness_buffers_received (h), 100);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h), 0);
+
+  gst_harness_get_stats (h, &stats);
+  fail_unless_equals_uint64 (stats.buffers_pushed, 100);
+  fail_unless_equals_uint64 (stats.buffers_received, 100);
+  fail_unless_equals_uint64 (stats.bytes_received, 1000);
+  fail_unless (GST_CLOCK_TIME_IS_VALID (stats.latency_min));
+  fail_unless (stats.latency_min <= stats.latency_50);
+  fail_unless (stats.latency_50 <= stats.latency_90);
+  fail_unless (stats.latency_90 <= stats.latency_99);
+  fail_unless (stats.latency_99 <= stats.latency_max);
+  fail_unless (stats.latency_max <= stats.elapsed);
+
+  gst_harness_reset_stats (h);
+  gst_harness_get_stats (h, &stats);
+  fail_unless_equals_uint64 (stats.buffers_pushed, 0);
+  fail_unless_equals_uint64 (stats.buffers_received, 0);
+  fail_unless_equals_uint64 (stats.bytes_received, 0);
+  fail_unless_equals_uint64 (stats.elapsed, 0);
+  /* the total count is not part of the statistics */
+  fail_unless_equals_int (gst_harness_buffers_received (h), 100);
+
+  /* the push times are kept in a bounded ring, latencies are still counted
+   * after it wrapped around */
+  for (i = 0; i < 10000; i++)
+    gst_harness_push (h, gst_buffer_new ());
+
+  gst_harness_get_stats (h, &stats);
+  fail_unless_equals_uint64 (stats.buffers_pushed, 10000);
+  fail_unless_equals_uint64 (stats.buffers_received, 10000);
+  fail_unless (GST_CLOCK_TIME_IS_VALID (stats.latency_min));
+  fail_unless (stats.latency_min <= stats.latency_50);
+  fail_unless (stats.latency_50 <= stats.latency_99);
+  fail_unless (stats.latency_99 <= stats.latency_max);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_allocation)
+{
+  GstHarness *h;
+  GstHarnessStats stats;
+  GstElement *src;
+  GstBuffer *buf;
+  GstEvent *event;
+  GstEventType type;
+  gchar data[300] = { 0, };
+  gchar *path;
+  gint fd, i;
+
+  fd = g_file_open_tmp ("gstharness-XXXXXX", &path, NULL);
+  fail_unless (fd >= 0);
+  close (fd);
+  fail_unless (g_file_set_contents (path, data, sizeof (data), NULL));
+
+  /* filesrc fills buffers that basesrc allocates from the allocator the
+   * harness proposes in the allocation query */
+  src = gst_element_factory_make ("filesrc", NULL);
+  g_object_set (src, "location", path, "blocksize", 100, NULL);
+  h = gst_harness_new_with_element (src, NULL, "src");
+  fail_unless (h != NULL);
+
+  for (i = 0; i < 3; i++) {
+    buf = gst_harness_pull (h);
+    fail_unless (buf != NULL);
+    fail_unless_equals_int (gst_buffer_get_size (buf), 100);
+    gst_buffer_unref (buf);
+  }
+  do {
+    event = gst_harness_pull_event (h);
+    fail_unless (event != NULL);
+    type = GST_EVENT_TYPE (event);
+    gst_event_unref (event);
+  } while (type != GST_EVENT_EOS);
+
+  gst_harness_get_stats (h, &stats);
+  fail_unless_equals_uint64 (stats.allocations, 3);
+
+  gst_harness_teardown (h);
+  g_unlink (path);
+  g_free (path);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_clock_wait)
+{
+  GstHarness *h;
+  GstTestClock *testclock;
+  GstBuffer *buf;
+
+  /* the queue decouples the pushing thread from the waiting identity */
+  h = gst_harness_new_parse ("queue ! identity sync=true");
+  fail_unless (h != NULL);
+  gst_harness_set_src_caps_str (h, "application/x-test");
+
+  testclock = gst_harness_get_testclock (h);
+  fail_unless (testclock != NULL);
+
+  buf = gst_buffer_new ();
+  GST_BUFFER_PTS (buf) = 1 * GST_SECOND;
+  fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+
+  fail_unless (gst_harness_crank_single_clock_wait (h));
+  fail_unless_equals_uint64 (gst_clock_get_time (GST_CLOCK (testclock)),
+      1 * GST_SECOND);
+
+  buf = gst_harness_pull (h);
+  fail_unless (buf != NULL);
+  fail_unless_equals_uint64 (GST_BUFFER_PTS (buf), 1 * GST_SECOND);
+  gst_buffer_unref (buf);
+
+  gst_object_unref (testclock);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+static Suite *
+gst_harness_suite (void)
+{
+  Suite *s = suite_create ("GstHarness");
+  TCase *tc_chain = tcase_create ("harness");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, test_push_pull);
+  tcase_add_test (tc_chain, test_stats);
+  tcase_add_test (tc_chain, test_allocation);
+  tcase_add_test (tc_chain, test_clock_wait);
+
+  return s;
+}
+
+GST_CHECK_MAIN (gst_harness);
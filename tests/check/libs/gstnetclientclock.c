@@ -126,6 +126,86 @@ GST_START_TEST (test_functioning)
 
 GST_END_TEST;
 
+GST_START_TEST (test_shared)
+{
+  GstNetTimeProvider *ntp;
+  GstClock *client, *client2, *server;
+  GstClockTime basex, basey, rate_num, rate_denom;
+  GstClockTime servtime, clienttime;
+  GstClockTime timeout;
+  GstClockTimeDiff diff = 0;
+  gint port, window_size, i;
+
+  server = gst_system_clock_obtain ();
+  fail_unless (server != NULL, "failed to get system clock");
+
+  /* move the clock ahead 100 seconds */
+  gst_clock_get_calibration (server, &basex, &basey, &rate_num, &rate_denom);
+  basey += 100 * GST_SECOND;
+  gst_clock_set_calibration (server, basex, basey, rate_num, rate_denom);
+
+  ntp = gst_net_time_provider_new (server, "127.0.0.1", 0);
+  fail_unless (ntp != NULL, "failed to create network time provider");
+
+  g_object_get (ntp, "port", &port, NULL);
+
+  client = gst_net_client_clock_new (NULL, "127.0.0.1", port, GST_SECOND);
+  fail_unless (client != NULL, "failed to get network client clock");
+
+  /* let the first clock synchronize */
+  for (i = 0; i < 11; ++i) {
+    servtime = gst_clock_get_time (server);
+    clienttime = gst_clock_get_time (client);
+    diff = ABS (GST_CLOCK_DIFF (servtime, clienttime));
+
+    if (diff < 100 * GST_MSECOND)
+      break;
+
+    g_usleep (G_USEC_PER_SEC / 20);
+  }
+  if (diff > 100 * GST_MSECOND)
+    fail ("clocks not in sync (%" GST_TIME_FORMAT ")", GST_TIME_ARGS (diff));
+
+  /* a second clock for the same provider shares the synchronization and is
+   * in sync right away, even with a bogus base time */
+  client2 = gst_net_client_clock_new (NULL, "127.0.0.1", port, GST_SECOND);
+  fail_unless (client2 != NULL, "failed to get network client clock");
+  fail_unless (client2 != client);
+
+  servtime = gst_clock_get_time (server);
+  clienttime = gst_clock_get_time (client2);
+  diff = ABS (GST_CLOCK_DIFF (servtime, clienttime));
+  fail_unless (diff < 100 * GST_MSECOND, "second clock not in sync (%"
+      GST_TIME_FORMAT ")", GST_TIME_ARGS (diff));
+
+  /* the parameters are shared too */
+  g_object_set (client2, "timeout", 2 * GST_SECOND, "window-size", 16, NULL);
+  g_object_get (client, "timeout", &timeout, "window-size", &window_size,
+      NULL);
+  fail_unless_equals_uint64 (timeout, 2 * GST_SECOND);
+  fail_unless_equals_int (window_size, 16);
+
+  /* the second clock keeps working when the first one is gone */
+  gst_object_unref (client);
+
+  servtime = gst_clock_get_time (server);
+  clienttime = gst_clock_get_time (client2);
+  diff = ABS (GST_CLOCK_DIFF (servtime, clienttime));
+  fail_unless (diff < 100 * GST_MSECOND, "second clock not in sync (%"
+      GST_TIME_FORMAT ")", GST_TIME_ARGS (diff));
+
+  ASSERT_OBJECT_REFCOUNT (client2, "network client clock", 1);
+
+  gst_object_unref (client2);
+  gst_object_unref (ntp);
+
+  ASSERT_OBJECT_REFCOUNT (server, "system clock", 2);
+
+  gst_object_unref (server);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_net_client_clock_suite (void)
 {
@@ -137,6 +217,7 @@ gst_net_client_clock_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_instantiation);
   tcase_add_test (tc_chain, test_functioning);
+  tcase_add_test (tc_chain, test_shared);
 
   return s;
 }
@@ -106,6 +106,78 @@ GST_START_TEST (test_functioning)
 
 GST_END_TEST;
 
+#define NUM_REQUESTS 100
+
+GST_START_TEST (test_batched)
+{
+  GstNetTimeProvider *ntp;
+  GstNetTimePacket *packet;
+  GstClock *clock;
+  GSocketAddress *server_addr;
+  GInetAddress *addr;
+  GSocket *socket;
+  GError *err = NULL;
+  gboolean seen[NUM_REQUESTS] = { FALSE, };
+  guint threads = 0, batch_size = 0;
+  gint port = -1;
+  gint i;
+
+  clock = gst_system_clock_obtain ();
+  fail_unless (clock != NULL, "failed to get system clock");
+
+  ntp = g_initable_new (GST_TYPE_NET_TIME_PROVIDER, NULL, &err, "clock",
+      clock, "address", "127.0.0.1", "port", 0, "threads", 4, "batch-size",
+      8, NULL);
+  fail_unless (ntp != NULL, "failed to create net time provider: %s",
+      err ? err->message : "");
+
+  g_object_get (ntp, "port", &port, "threads", &threads, "batch-size",
+      &batch_size, NULL);
+  fail_unless (port > 0);
+  fail_unless_equals_int (threads, 4);
+  fail_unless_equals_int (batch_size, 8);
+
+  socket = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_DATAGRAM,
+      G_SOCKET_PROTOCOL_UDP, NULL);
+  fail_unless (socket != NULL, "could not create socket");
+  g_socket_set_timeout (socket, 5);
+
+  addr = g_inet_address_new_from_string ("127.0.0.1");
+  server_addr = g_inet_socket_address_new (addr, port);
+  g_object_unref (addr);
+
+  /* send all requests at once so that they are served in batches, the
+   * local time identifies the request */
+  packet = gst_net_time_packet_new (NULL);
+  for (i = 0; i < NUM_REQUESTS; i++) {
+    packet->local_time = i;
+    fail_unless (gst_net_time_packet_send (packet, socket, server_addr, NULL));
+  }
+  g_free (packet);
+
+  for (i = 0; i < NUM_REQUESTS; i++) {
+    packet = gst_net_time_packet_receive (socket, NULL, NULL);
+
+    fail_unless (packet != NULL, "failed to receive packet %d", i);
+    fail_unless (packet->local_time < NUM_REQUESTS, "unknown local time");
+    fail_if (seen[packet->local_time], "duplicate reply");
+    seen[packet->local_time] = TRUE;
+    fail_unless (GST_CLOCK_TIME_IS_VALID (packet->remote_time));
+    fail_unless (packet->remote_time <= gst_clock_get_time (clock),
+        "remote time in the future");
+
+    g_free (packet);
+  }
+
+  g_object_unref (socket);
+  g_object_unref (server_addr);
+
+  gst_object_unref (ntp);
+  gst_object_unref (clock);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_net_time_provider_suite (void)
 {
@@ -115,6 +187,7 @@ gst_net_time_provider_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_refcounts);
   tcase_add_test (tc_chain, test_functioning);
+  tcase_add_test (tc_chain, test_batched);
 
   return s;
 }
@@ -383,6 +383,126 @@ GST_START_TEST (basetransform_chain_ip2)
 
 GST_END_TEST;
 
+static void
+check_stats (TestTransData * trans, guint64 in_place, guint64 copied,
+    guint64 bytes_copied)
+{
+  GstStructure *stats;
+  guint64 val;
+
+  g_object_get (trans->trans, "stats", &stats, NULL);
+  fail_unless (stats != NULL);
+  fail_unless (gst_structure_has_name (stats, "GstBaseTransformStats"));
+
+  fail_unless (gst_structure_get_uint64 (stats, "passthrough", &val));
+  fail_unless_equals_uint64 (val, 0);
+  fail_unless (gst_structure_get_uint64 (stats, "in-place", &val));
+  fail_unless_equals_uint64 (val, in_place);
+  fail_unless (gst_structure_get_uint64 (stats, "copied", &val));
+  fail_unless_equals_uint64 (val, copied);
+  fail_unless (gst_structure_get_uint64 (stats, "allocated", &val));
+  fail_unless_equals_uint64 (val, 0);
+  fail_unless (gst_structure_get_uint64 (stats, "bytes-copied", &val));
+  fail_unless_equals_uint64 (val, bytes_copied);
+
+  gst_structure_free (stats);
+}
+
+/* in-place, check that the stats count the copies made for writability and
+ * that prefer-pool copies into recycled buffers */
+GST_START_TEST (basetransform_chain_ip_stats)
+{
+  TestTransData *trans;
+  GstBuffer *buffer, *outbuf;
+  GstMemory *mem;
+  GstFlowReturn res;
+  guint8 data[20];
+  guint i;
+
+  klass_transform_ip = transform_ip_1;
+  trans = gst_test_trans_new ();
+
+  gst_test_trans_push_segment (trans);
+
+  check_stats (trans, 0, 0, 0);
+
+  buffer = gst_buffer_new_and_alloc (20);
+  res = gst_test_trans_push (trans, buffer);
+  fail_unless (res == GST_FLOW_OK);
+  gst_buffer_unref (gst_test_trans_pop (trans));
+
+  check_stats (trans, 1, 0, 0);
+
+  g_object_set (trans->trans, "prefer-pool", TRUE, NULL);
+
+  for (i = 0; i < 20; i++)
+    data[i] = i;
+  buffer = gst_buffer_new_and_alloc (20);
+  gst_buffer_fill (buffer, 0, data, 20);
+  GST_BUFFER_PTS (buffer) = GST_SECOND;
+
+  /* take additional ref to make it non-writable */
+  gst_buffer_ref (buffer);
+  transform_ip_1_writable = FALSE;
+  res = gst_test_trans_push (trans, buffer);
+  fail_unless (res == GST_FLOW_OK);
+  fail_unless (transform_ip_1_writable == TRUE);
+
+  outbuf = gst_test_trans_pop (trans);
+  fail_unless (outbuf != NULL);
+  fail_unless (outbuf != buffer);
+  fail_unless (gst_buffer_get_size (outbuf) == 20);
+  fail_unless (gst_buffer_memcmp (outbuf, 0, data, 20) == 0);
+  fail_unless_equals_uint64 (GST_BUFFER_PTS (outbuf), GST_SECOND);
+  mem = gst_buffer_peek_memory (outbuf, 0);
+  gst_buffer_unref (outbuf);
+
+  /* the released buffer is recycled for the next copy */
+  gst_buffer_ref (buffer);
+  res = gst_test_trans_push (trans, buffer);
+  fail_unless (res == GST_FLOW_OK);
+
+  outbuf = gst_test_trans_pop (trans);
+  fail_unless (outbuf != NULL);
+  fail_unless (gst_buffer_peek_memory (outbuf, 0) == mem);
+  fail_unless (gst_buffer_memcmp (outbuf, 0, data, 20) == 0);
+  gst_buffer_unref (outbuf);
+  gst_buffer_unref (buffer);
+
+  /* a buffer of another size is copied without replacing the pool */
+  buffer = gst_buffer_new_and_alloc (10);
+  gst_buffer_fill (buffer, 0, data, 10);
+  gst_buffer_ref (buffer);
+  res = gst_test_trans_push (trans, buffer);
+  fail_unless (res == GST_FLOW_OK);
+
+  outbuf = gst_test_trans_pop (trans);
+  fail_unless (outbuf != NULL);
+  fail_unless (outbuf != buffer);
+  fail_unless (gst_buffer_get_size (outbuf) == 10);
+  fail_unless (gst_buffer_memcmp (outbuf, 0, data, 10) == 0);
+  gst_buffer_unref (outbuf);
+  gst_buffer_unref (buffer);
+
+  buffer = gst_buffer_new_and_alloc (20);
+  gst_buffer_fill (buffer, 0, data, 20);
+  gst_buffer_ref (buffer);
+  res = gst_test_trans_push (trans, buffer);
+  fail_unless (res == GST_FLOW_OK);
+
+  outbuf = gst_test_trans_pop (trans);
+  fail_unless (outbuf != NULL);
+  fail_unless (gst_buffer_peek_memory (outbuf, 0) == mem);
+  gst_buffer_unref (outbuf);
+  gst_buffer_unref (buffer);
+
+  check_stats (trans, 1, 4, 70);
+
+  gst_test_trans_free (trans);
+}
+
+GST_END_TEST;
+
 static GstStaticPadTemplate sink_template_ct1 = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -893,6 +1013,7 @@ gst_basetransform_suite (void)
   /* in place */
   tcase_add_test (tc, basetransform_chain_ip1);
   tcase_add_test (tc, basetransform_chain_ip2);
+  tcase_add_test (tc, basetransform_chain_ip_stats);
   /* copy transform */
   tcase_add_test (tc, basetransform_chain_ct1);
   tcase_add_test (tc, basetransform_chain_ct2);
@@ -65,6 +65,7 @@ static gboolean toc = FALSE;
 static gboolean messages = FALSE;
 static gboolean is_live = FALSE;
 static gboolean waiting_eos = FALSE;
+static gboolean stats = FALSE;
 
 /* convenience macro so we don't have to litter the code with if(!quiet) */
 #define PRINT if(!quiet)g_print
@@ -858,6 +859,593 @@ exit:
   }
 }
 
+/* statistics for --stats, collected with pad probes that are only installed
+ * when the option is given.
+ *
+ * Every thread keeps a stack of the elements it is currently in: a buffer
+ * arriving on a sink pad enters the element, and the idle probe on the src
+ * pad that pushed the buffer fires when the element returned. The time
+ * between these points, minus the time spent downstream, is the processing
+ * time of the element for that buffer.
+ *
+ * The time a thread spends outside of any pushed buffer is not processing
+ * time: a queue spends it waiting for data and a live source waiting in
+ * create(). It goes to the separate loop time of the element that pushes
+ * next, measured from the previous push or, for the first push, from the
+ * moment the streaming thread started. */
+typedef struct
+{
+  GstElement *element;
+
+  guint64 processed;
+  GstClockTime total_time;
+  GstClockTime max_time;
+
+  /* time in the streaming thread of the element, between pushes */
+  GstClockTime loop_time;
+
+  /* fill level of queues, sampled every STATS_SAMPLE_INTERVAL ms */
+  gboolean is_queue;
+  guint64 level_samples;
+  guint level_buffers;
+  guint level_bytes;
+  guint64 level_time;
+  guint64 level_buffers_sum;
+  guint64 level_bytes_sum;
+  guint level_buffers_max;
+  guint level_bytes_max;
+} ElementStats;
+
+typedef struct
+{
+  GstPad *pad;
+  ElementStats *element;
+
+  guint64 buffers;
+  guint64 bytes;
+  GstClockTime first_ts;
+  GstClockTime last_ts;
+} PadStats;
+
+typedef struct
+{
+  ElementStats *element;
+  PadStats *srcpad;
+  GstClockTime self_time;
+  GstClockTime resumed;
+} StatsFrame;
+
+typedef struct
+{
+  GArray *frames;
+  PadStats *last_srcpad;
+  GstClockTime root_resumed;
+} ThreadStats;
+
+#define STATS_SAMPLE_INTERVAL 100
+
+static void thread_stats_free (gpointer data);
+
+static GMutex stats_lock;
+static GList *element_stats;
+static GList *pad_stats;
+static GList *task_stats;
+static GPrivate thread_stats = G_PRIVATE_INIT (thread_stats_free);
+static GstClockTime stats_start;
+static guint stats_sample_id;
+static guint stats_print_id;
+
+static void
+thread_stats_free (gpointer data)
+{
+  ThreadStats *ts = data;
+
+  g_array_free (ts->frames, TRUE);
+  g_free (ts);
+}
+
+static ThreadStats *
+get_thread_stats (void)
+{
+  ThreadStats *ts = g_private_get (&thread_stats);
+
+  if (G_UNLIKELY (ts == NULL)) {
+    ts = g_new0 (ThreadStats, 1);
+    ts->frames = g_array_new (FALSE, FALSE, sizeof (StatsFrame));
+    ts->root_resumed = GST_CLOCK_TIME_NONE;
+    g_private_set (&thread_stats, ts);
+  }
+  return ts;
+}
+
+static void
+record_processing (ElementStats * es, GstClockTime time)
+{
+  g_mutex_lock (&stats_lock);
+  es->processed++;
+  es->total_time += time;
+  es->max_time = MAX (es->max_time, time);
+  g_mutex_unlock (&stats_lock);
+}
+
+static void
+record_loop (ElementStats * es, GstClockTime time)
+{
+  g_mutex_lock (&stats_lock);
+  es->loop_time += time;
+  g_mutex_unlock (&stats_lock);
+}
+
+/* called from the sync handler in each streaming thread when it starts */
+static void
+stats_enter_thread (void)
+{
+  get_thread_stats ()->root_resumed = gst_util_get_timestamp ();
+}
+
+static void
+record_data (PadStats * ps, GstPadProbeInfo * info, GstClockTime now)
+{
+  guint64 buffers, bytes = 0;
+
+  if (info->type & GST_PAD_PROBE_TYPE_BUFFER) {
+    buffers = 1;
+    bytes = gst_buffer_get_size (GST_PAD_PROBE_INFO_BUFFER (info));
+  } else {
+    GstBufferList *list = GST_PAD_PROBE_INFO_BUFFER_LIST (info);
+    guint i;
+
+    buffers = gst_buffer_list_length (list);
+    for (i = 0; i < buffers; i++)
+      bytes += gst_buffer_get_size (gst_buffer_list_get (list, i));
+  }
+
+  g_mutex_lock (&stats_lock);
+  ps->buffers += buffers;
+  ps->bytes += bytes;
+  if (!GST_CLOCK_TIME_IS_VALID (ps->first_ts))
+    ps->first_ts = now;
+  ps->last_ts = now;
+  g_mutex_unlock (&stats_lock);
+}
+
+static GstPadProbeReturn
+stats_src_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  PadStats *ps = user_data;
+
+  record_data (ps, info, gst_util_get_timestamp ());
+
+  /* remember who is pushing for the sink pad probe of the peer */
+  get_thread_stats ()->last_srcpad = ps;
+
+  return GST_PAD_PROBE_OK;
+}
+
+static GstPadProbeReturn
+stats_sink_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  PadStats *ps = user_data;
+  ThreadStats *ts = get_thread_stats ();
+  GstClockTime now = gst_util_get_timestamp ();
+  StatsFrame frame, *top;
+  guint i;
+
+  record_data (ps, info, now);
+
+  if (ts->last_srcpad == NULL)
+    return GST_PAD_PROBE_OK;
+
+  /* a pad can't push recursively, so a frame for the same src pad is left
+   * over from a push whose idle probe ran in another thread */
+  for (i = 0; i < ts->frames->len; i++) {
+    if (g_array_index (ts->frames, StatsFrame, i).srcpad == ts->last_srcpad) {
+      g_array_set_size (ts->frames, i);
+      break;
+    }
+  }
+
+  if (ts->frames->len == 0) {
+    if (GST_CLOCK_TIME_IS_VALID (ts->root_resumed))
+      record_loop (ts->last_srcpad->element, now - ts->root_resumed);
+  } else {
+    top = &g_array_index (ts->frames, StatsFrame, ts->frames->len - 1);
+    top->self_time += now - top->resumed;
+  }
+
+  frame.element = ps->element;
+  frame.srcpad = ts->last_srcpad;
+  frame.self_time = 0;
+  frame.resumed = now;
+  g_array_append_val (ts->frames, frame);
+
+  ts->last_srcpad = NULL;
+
+  return GST_PAD_PROBE_OK;
+}
+
+static GstPadProbeReturn
+stats_idle_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  PadStats *ps = user_data;
+  ThreadStats *ts = get_thread_stats ();
+  GstClockTime now;
+  StatsFrame *top;
+
+  /* only the end of a buffer push that we saw starting is interesting */
+  if (ts->frames->len == 0)
+    return GST_PAD_PROBE_OK;
+  top = &g_array_index (ts->frames, StatsFrame, ts->frames->len - 1);
+  if (top->srcpad != ps)
+    return GST_PAD_PROBE_OK;
+
+  now = gst_util_get_timestamp ();
+  top->self_time += now - top->resumed;
+  record_processing (top->element, top->self_time);
+  g_array_set_size (ts->frames, ts->frames->len - 1);
+
+  if (ts->frames->len > 0) {
+    top = &g_array_index (ts->frames, StatsFrame, ts->frames->len - 1);
+    top->resumed = now;
+  } else {
+    ts->root_resumed = now;
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+stats_add_pad (ElementStats * es, GstPad * pad)
+{
+  PadStats *ps;
+
+  ps = g_new0 (PadStats, 1);
+  ps->pad = gst_object_ref (pad);
+  ps->element = es;
+  ps->first_ts = GST_CLOCK_TIME_NONE;
+  ps->last_ts = GST_CLOCK_TIME_NONE;
+
+  g_mutex_lock (&stats_lock);
+  pad_stats = g_list_append (pad_stats, ps);
+  g_mutex_unlock (&stats_lock);
+
+  if (GST_PAD_IS_SRC (pad)) {
+    gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER |
+        GST_PAD_PROBE_TYPE_BUFFER_LIST | GST_PAD_PROBE_TYPE_PUSH,
+        stats_src_probe, ps, NULL);
+    /* an idle probe is called when a push returns, it never blocks */
+    gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_IDLE | GST_PAD_PROBE_TYPE_PUSH,
+        stats_idle_probe, ps, NULL);
+  } else {
+    gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER |
+        GST_PAD_PROBE_TYPE_BUFFER_LIST | GST_PAD_PROBE_TYPE_PUSH,
+        stats_sink_probe, ps, NULL);
+  }
+}
+
+static void
+stats_pad_added (GstElement * element, GstPad * pad, gpointer user_data)
+{
+  stats_add_pad ((ElementStats *) user_data, pad);
+}
+
+static void
+stats_add_pad_foreach (const GValue * item, gpointer user_data)
+{
+  stats_add_pad ((ElementStats *) user_data, g_value_get_object (item));
+}
+
+static void stats_add_element (GstElement * element);
+
+static void
+stats_element_added (GstBin * bin, GstElement * element, gpointer user_data)
+{
+  stats_add_element (element);
+}
+
+static void
+stats_add_element_foreach (const GValue * item, gpointer user_data)
+{
+  stats_add_element (g_value_get_object (item));
+}
+
+static void
+stats_add_element (GstElement * element)
+{
+  ElementStats *es;
+  GstIterator *it;
+
+  /* bins only pass the data on through their ghost pads, instrument their
+   * children instead */
+  if (GST_IS_BIN (element)) {
+    g_signal_connect (element, "element-added",
+        G_CALLBACK (stats_element_added), NULL);
+    it = gst_bin_iterate_elements (GST_BIN (element));
+    gst_iterator_foreach (it, stats_add_element_foreach, NULL);
+    gst_iterator_free (it);
+    return;
+  }
+
+  es = g_new0 (ElementStats, 1);
+  es->element = gst_object_ref (element);
+  es->is_queue = g_object_class_find_property (G_OBJECT_GET_CLASS (element),
+      "current-level-buffers") != NULL;
+
+  g_mutex_lock (&stats_lock);
+  element_stats = g_list_append (element_stats, es);
+  g_mutex_unlock (&stats_lock);
+
+  g_signal_connect (element, "pad-added", G_CALLBACK (stats_pad_added), es);
+  it = gst_element_iterate_pads (element);
+  gst_iterator_foreach (it, stats_add_pad_foreach, es);
+  gst_iterator_free (it);
+}
+
+/* called from the sync handler for each new streaming thread */
+static void
+stats_add_task (GstTask * task)
+{
+  gst_task_set_collect_stats (task, TRUE);
+
+  g_mutex_lock (&stats_lock);
+  task_stats = g_list_append (task_stats, gst_object_ref (task));
+  g_mutex_unlock (&stats_lock);
+}
+
+static gboolean
+stats_sample_levels (gpointer user_data)
+{
+  GList *elements, *walk;
+
+  /* don't hold the lock while the queues take theirs */
+  g_mutex_lock (&stats_lock);
+  elements = g_list_copy (element_stats);
+  g_mutex_unlock (&stats_lock);
+
+  for (walk = elements; walk; walk = g_list_next (walk)) {
+    ElementStats *es = walk->data;
+    guint buffers, bytes;
+    guint64 time;
+
+    if (!es->is_queue)
+      continue;
+
+    g_object_get (es->element, "current-level-buffers", &buffers,
+        "current-level-bytes", &bytes, "current-level-time", &time, NULL);
+
+    g_mutex_lock (&stats_lock);
+    es->level_samples++;
+    es->level_buffers = buffers;
+    es->level_bytes = bytes;
+    es->level_time = time;
+    es->level_buffers_sum += buffers;
+    es->level_bytes_sum += bytes;
+    es->level_buffers_max = MAX (es->level_buffers_max, buffers);
+    es->level_bytes_max = MAX (es->level_bytes_max, bytes);
+    g_mutex_unlock (&stats_lock);
+  }
+  g_list_free (elements);
+
+  return TRUE;
+}
+
+static gdouble
+pad_stats_rate (PadStats * ps, guint64 value)
+{
+  GstClockTime duration = ps->last_ts - ps->first_ts;
+
+  if (ps->buffers < 2 || duration == 0)
+    return 0.0;
+
+  return (gdouble) value * GST_SECOND / duration;
+}
+
+static gchar *
+pad_stats_name (PadStats * ps)
+{
+  return g_strdup_printf ("%s:%s", GST_ELEMENT_NAME (ps->element->element),
+      GST_PAD_NAME (ps->pad));
+}
+
+static void
+json_append_string (GString * json, const gchar * str)
+{
+  g_string_append_c (json, '"');
+  for (; *str; str++) {
+    if (*str == '"' || *str == '\\')
+      g_string_append_printf (json, "\\%c", *str);
+    else if ((guchar) * str < 0x20)
+      g_string_append_printf (json, "\\u%04x", (guint) * str);
+    else
+      g_string_append_c (json, *str);
+  }
+  g_string_append_c (json, '"');
+}
+
+static void
+print_stats_json (void)
+{
+  GString *json;
+  GList *walk;
+
+  json = g_string_new (NULL);
+
+  g_mutex_lock (&stats_lock);
+  g_string_append_printf (json, "{\"time\": %" G_GUINT64_FORMAT
+      ", \"elements\": [", gst_util_get_timestamp () - stats_start);
+  for (walk = element_stats; walk; walk = g_list_next (walk)) {
+    ElementStats *es = walk->data;
+
+    g_string_append (json, "{\"name\": ");
+    json_append_string (json, GST_ELEMENT_NAME (es->element));
+    g_string_append_printf (json, ", \"buffers\": %" G_GUINT64_FORMAT
+        ", \"total-time\": %" G_GUINT64_FORMAT ", \"max-time\": %"
+        G_GUINT64_FORMAT ", \"loop-time\": %" G_GUINT64_FORMAT, es->processed,
+        es->total_time, es->max_time, es->loop_time);
+    if (es->is_queue)
+      g_string_append_printf (json, ", \"level-buffers\": %u"
+          ", \"level-bytes\": %u, \"level-time\": %" G_GUINT64_FORMAT,
+          es->level_buffers, es->level_bytes, es->level_time);
+    g_string_append (json, walk->next ? "}, " : "}");
+  }
+  g_string_append (json, "], \"pads\": [");
+  for (walk = pad_stats; walk; walk = g_list_next (walk)) {
+    PadStats *ps = walk->data;
+    gchar *name = pad_stats_name (ps);
+
+    g_string_append (json, "{\"name\": ");
+    json_append_string (json, name);
+    g_string_append_printf (json, ", \"buffers\": %" G_GUINT64_FORMAT
+        ", \"bytes\": %" G_GUINT64_FORMAT ", \"bytes-per-second\": %.0f}%s",
+        ps->buffers, ps->bytes, pad_stats_rate (ps, ps->bytes),
+        walk->next ? ", " : "");
+    g_free (name);
+  }
+  g_string_append (json, "], \"tasks\": [");
+  for (walk = task_stats; walk; walk = g_list_next (walk)) {
+    GstTask *task = walk->data;
+    GstStructure *s = gst_task_get_stats (task);
+    guint64 iterations = 0, busy_time = 0, wait_time = 0;
+    guint64 cpu_time = GST_CLOCK_TIME_NONE;
+
+    if (s) {
+      gst_structure_get (s, "iterations", G_TYPE_UINT64, &iterations,
+          "busy-time", G_TYPE_UINT64, &busy_time, "wait-time", G_TYPE_UINT64,
+          &wait_time, "cpu-time", G_TYPE_UINT64, &cpu_time, NULL);
+      gst_structure_free (s);
+    }
+
+    g_string_append (json, "{\"name\": ");
+    json_append_string (json, GST_OBJECT_NAME (task));
+    g_string_append_printf (json, ", \"iterations\": %" G_GUINT64_FORMAT
+        ", \"busy-time\": %" G_GUINT64_FORMAT ", \"wait-time\": %"
+        G_GUINT64_FORMAT, iterations, busy_time, wait_time);
+    if (GST_CLOCK_TIME_IS_VALID (cpu_time))
+      g_string_append_printf (json, ", \"cpu-time\": %" G_GUINT64_FORMAT,
+          cpu_time);
+    g_string_append (json, walk->next ? "}, " : "}");
+  }
+  g_string_append (json, "]}");
+  g_mutex_unlock (&stats_lock);
+
+  g_print ("%s\n", json->str);
+  g_string_free (json, TRUE);
+}
+
+static gboolean
+print_stats_json_cb (gpointer user_data)
+{
+  print_stats_json ();
+
+  return TRUE;
+}
+
+static void
+print_stats (void)
+{
+  GList *walk;
+
+  g_mutex_lock (&stats_lock);
+  g_print (_("Element statistics:\n"));
+  for (walk = element_stats; walk; walk = g_list_next (walk)) {
+    ElementStats *es = walk->data;
+
+    g_print (_("  %s: %" G_GUINT64_FORMAT " buffers, processing time "
+            "average %" GST_TIME_FORMAT ", maximum %" GST_TIME_FORMAT
+            ", total %" GST_TIME_FORMAT "\n"), GST_ELEMENT_NAME (es->element),
+        es->processed,
+        GST_TIME_ARGS (es->processed ? es->total_time / es->processed : 0),
+        GST_TIME_ARGS (es->max_time), GST_TIME_ARGS (es->total_time));
+    if (es->loop_time > 0)
+      g_print (_("    streaming thread between pushes %" GST_TIME_FORMAT "\n"),
+          GST_TIME_ARGS (es->loop_time));
+    if (es->is_queue && es->level_samples > 0) {
+      g_print (_("    fill level average %" G_GUINT64_FORMAT " buffers / %"
+              G_GUINT64_FORMAT " bytes, maximum %u buffers / %u bytes\n"),
+          es->level_buffers_sum / es->level_samples,
+          es->level_bytes_sum / es->level_samples, es->level_buffers_max,
+          es->level_bytes_max);
+    }
+  }
+  g_print (_("Pad statistics:\n"));
+  for (walk = pad_stats; walk; walk = g_list_next (walk)) {
+    PadStats *ps = walk->data;
+    gchar *name;
+
+    if (ps->buffers == 0)
+      continue;
+
+    name = pad_stats_name (ps);
+    g_print (_("  %s: %" G_GUINT64_FORMAT " buffers, %" G_GUINT64_FORMAT
+            " bytes, %.1f buffers/s, %.0f bytes/s\n"), name, ps->buffers,
+        ps->bytes, pad_stats_rate (ps, ps->buffers),
+        pad_stats_rate (ps, ps->bytes));
+    g_free (name);
+  }
+  g_print (_("Thread statistics:\n"));
+  for (walk = task_stats; walk; walk = g_list_next (walk)) {
+    GstTask *task = walk->data;
+    GstStructure *s = gst_task_get_stats (task);
+    guint64 iterations = 0, busy_time = 0, wait_time = 0;
+    guint64 cpu_time = GST_CLOCK_TIME_NONE;
+
+    if (s) {
+      gst_structure_get (s, "iterations", G_TYPE_UINT64, &iterations,
+          "busy-time", G_TYPE_UINT64, &busy_time, "wait-time", G_TYPE_UINT64,
+          &wait_time, "cpu-time", G_TYPE_UINT64, &cpu_time, NULL);
+      gst_structure_free (s);
+    }
+
+    g_print (_("  %s: %" G_GUINT64_FORMAT " iterations, busy %"
+            GST_TIME_FORMAT ", paused %" GST_TIME_FORMAT ", CPU %"
+            GST_TIME_FORMAT "\n"), GST_OBJECT_NAME (task), iterations,
+        GST_TIME_ARGS (busy_time), GST_TIME_ARGS (wait_time),
+        GST_TIME_ARGS (cpu_time));
+  }
+  g_mutex_unlock (&stats_lock);
+}
+
+static void
+stats_setup (GstElement * pipeline, gint interval)
+{
+  stats_start = gst_util_get_timestamp ();
+
+  stats_add_element (pipeline);
+
+  stats_sample_id = g_timeout_add (STATS_SAMPLE_INTERVAL,
+      stats_sample_levels, NULL);
+  if (interval > 0)
+    stats_print_id = g_timeout_add_seconds (interval, print_stats_json_cb,
+        NULL);
+}
+
+static void
+element_stats_free (ElementStats * es)
+{
+  gst_object_unref (es->element);
+  g_free (es);
+}
+
+static void
+pad_stats_free (PadStats * ps)
+{
+  gst_object_unref (ps->pad);
+  g_free (ps);
+}
+
+static void
+stats_cleanup (void)
+{
+  if (stats_sample_id)
+    g_source_remove (stats_sample_id);
+  if (stats_print_id)
+    g_source_remove (stats_print_id);
+
+  g_list_free_full (task_stats, (GDestroyNotify) gst_object_unref);
+  g_list_free_full (pad_stats, (GDestroyNotify) pad_stats_free);
+  g_list_free_full (element_stats, (GDestroyNotify) element_stats_free);
+}
+
 static GstBusSyncReply
 bus_sync_handler (GstBus * bus, GstMessage * message, gpointer data)
 {
@@ -895,6 +1483,23 @@ bus_sync_handler (GstBus * bus, GstMessage * message, gpointer data)
         g_free (state_transition_name);
       }
       break;
+    case GST_MESSAGE_STREAM_STATUS:
+      /* collect the statistics of all streaming threads */
+      if (stats) {
+        GstStreamStatusType type;
+        const GValue *val;
+
+        gst_message_parse_stream_status (message, &type, NULL);
+        val = gst_message_get_stream_status_object (message);
+        if (type == GST_STREAM_STATUS_TYPE_CREATE && val != NULL
+            && G_VALUE_HOLDS_OBJECT (val)
+            && GST_IS_TASK (g_value_get_object (val)))
+          stats_add_task (g_value_get_object (val));
+        /* posted from the new thread itself */
+        else if (type == GST_STREAM_STATUS_TYPE_ENTER)
+          stats_enter_thread ();
+      }
+      break;
     default:
       break;
   }
@@ -913,6 +1518,7 @@ main (int argc, char *argv[])
 #endif
   gchar *savefile = NULL;
   gchar *exclude_args = NULL;
+  gint stats_interval = 0;
 #ifndef GST_DISABLE_OPTION_PARSING
   GOptionEntry options[] = {
     {"tags", 't', 0, G_OPTION_ARG_NONE, &tags,
@@ -931,6 +1537,10 @@ main (int argc, char *argv[])
         N_("Do not install a fault handler"), NULL},
     {"eos-on-shutdown", 'e', 0, G_OPTION_ARG_NONE, &eos_on_shutdown,
         N_("Force EOS on sources before shutting the pipeline down"), NULL},
+    {"stats", 'S', 0, G_OPTION_ARG_NONE, &stats,
+        N_("Print per element and per pad statistics at the end"), NULL},
+    {"stats-interval", 0, 0, G_OPTION_ARG_INT, &stats_interval,
+        N_("Also print the statistics as JSON every SECONDS"), N_("SECONDS")},
 #if 0
     {"index", 'i', 0, G_OPTION_ARG_NONE, &check_index,
         N_("Gather and print index statistics"), NULL},
@@ -1032,6 +1642,10 @@ main (int argc, char *argv[])
       deep_notify_id = g_signal_connect (pipeline, "deep-notify",
           G_CALLBACK (gst_object_default_deep_notify), exclude_list);
     }
+    if (stats || stats_interval > 0) {
+      stats = TRUE;
+      stats_setup (pipeline, stats_interval);
+    }
 #if 0
     if (check_index) {
       /* gst_index_new() creates a null-index, it does not store anything, but
@@ -1151,6 +1765,12 @@ main (int argc, char *argv[])
 
       PRINT (_("Execution ended after %" GST_TIME_FORMAT "\n"),
           GST_TIME_ARGS (diff));
+
+      if (stats) {
+        print_stats ();
+        if (stats_interval > 0)
+          print_stats_json ();
+      }
     }
 
     PRINT (_("Setting pipeline to PAUSED ...\n"));
@@ -1184,6 +1804,9 @@ main (int argc, char *argv[])
   PRINT (_("Freeing pipeline ...\n"));
   gst_object_unref (pipeline);
 
+  if (stats)
+    stats_cleanup ();
+
   gst_deinit ();
 
   return res;